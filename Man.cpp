@@ -85,8 +85,9 @@ Man::Man (shared_ptr<Sensors> _sensors,
     vision = shared_ptr<Vision>(new Vision(pose, profiler));
     comm = shared_ptr<Comm>(new Comm(synchro, sensors, vision));
 #ifdef USE_NOGGIN
-    noggin = shared_ptr<Noggin>(new Noggin(profiler,vision,comm,guardian,
-                                           sensors, motion->getInterface()));
+    noggin = shared_ptr<Noggin>(new Noggin(synchro,profiler,vision,comm,
+                                           guardian, sensors,
+                                           motion->getInterface()));
 #endif// USE_NOGGIN
 	PROF_ENTER(profiler.get(), P_GETIMAGE);
 }
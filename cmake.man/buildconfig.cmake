@@ -81,6 +81,11 @@ OPTION(
 SET(
     MAN_IS_REMOTE ${MAN_IS_REMOTE_}
     )
+OPTION(
+    SIM_BACKEND
+    "Also build sim_soccer_player, which runs Man headless against a synthetic world"
+    OFF
+    )
 OPTION(
   DEBUG_MAN_INITIALIZATION
   "Turn on/off debug printing while initializing the Man class"
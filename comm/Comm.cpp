@@ -23,6 +23,15 @@
 #include "Comm.h"
 #include "NaoPose.h"
 
+#ifdef USE_COMM_EPOLL
+#  include <sys/eventfd.h> // eventfd()
+#  include "CommEventLoop.h"
+#  if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 12))
+#    define COMM_HAVE_RECVMMSG
+#  endif
+#endif
+
 #undef USE_GAMECONTROLLER
 #define USE_GAMECONTROLLER
 
@@ -432,8 +441,9 @@ PyMODINIT_FUNC init_comm (void)
 Comm::Comm (shared_ptr<Synchro> _synchro, shared_ptr<Sensors> s,
             shared_ptr<Vision> v)
     : Thread(_synchro, "Comm"), data(NUM_PACKET_DATA_ELEMENTS,0),
-	  latest(new list<vector<float> >), sensors(s), timer(&micro_time),
-	  gc(new GameController()), tool(_synchro, s, v, gc)
+	  latest(&latest_buffers[0]), sensors(s), timer(&micro_time),
+	  gc(new GameController()), tool(_synchro, s, v, gc),
+      wake_fd(-1)
 {
     pthread_mutex_init(&comm_mutex,NULL);
     // initialize broadcast address structure
@@ -448,6 +458,8 @@ Comm::Comm (shared_ptr<Synchro> _synchro, shared_ptr<Sensors> s,
 
 Comm::~Comm ()
 {
+    if (wake_fd != -1)
+        ::close(wake_fd);
     pthread_mutex_destroy(&comm_mutex);
 }
 
@@ -466,15 +478,18 @@ void Comm::run ()
     running = true;
     trigger->on();
 
-	struct timespec interval, remainder;
-	interval.tv_sec = 0;
-	interval.tv_nsec = SLEEP_MILLIS * 1000;
-
     try {
         bind();
 
         //discover_broadcast();
 
+#ifdef USE_COMM_EPOLL
+        run_event_loop();
+#else
+        struct timespec interval, remainder;
+        interval.tv_sec = 0;
+        interval.tv_nsec = SLEEP_MILLIS * 1000;
+
         while (running) {
             send();
 
@@ -483,6 +498,7 @@ void Comm::run ()
                 nanosleep(&interval, &remainder);
             }
         }
+#endif
     }catch (socket_error &e) {
         fprintf(stderr, "Error occurred in Comm, thread has stopped.\n");
         fprintf(stderr, "%s\n", e.what());
@@ -501,6 +517,105 @@ void Comm::stop ()
     tool.stop();
 
     Thread::stop();
+    wake();
+}
+
+// Interrupt a blocked event loop so it notices running has changed
+void Comm::wake ()
+{
+#ifdef USE_COMM_EPOLL
+    CommEventLoop::wake(wake_fd);
+#endif
+}
+
+void Comm::run_event_loop () throw(socket_error)
+{
+#ifdef USE_COMM_EPOLL
+    // The wakeup lives as long as the Comm, so stop() can always signal it
+    if (wake_fd == -1) {
+        wake_fd = eventfd(0, EFD_NONBLOCK);
+        if (wake_fd == -1) {
+            stop();
+            throw SOCKET_ERROR(errno);
+        }
+    }
+
+    try {
+        CommEventLoop events(MICROS_PER_PACKET, wake_fd);
+#ifdef COMM_LISTEN
+        events.watch(sockn);
+#  ifdef USE_GAMECONTROLLER
+        events.watch(gc_sockn);
+#  endif
+#endif
+
+        send();
+
+        int ready[COMM_EVENT_MAX_FDS];
+        bool send_due;
+        while (running) {
+            const int n = events.wait(ready, send_due);
+            if (running && send_due)
+                send();
+            for (int i = 0; running && i < n; ++i)
+                drain(ready[i], ready[i] == gc_sockn);
+        }
+    } catch (socket_error&) {
+        stop();
+        throw;
+    }
+#endif
+}
+
+void Comm::drain (int fd, bool game_controller) throw(socket_error)
+{
+#ifdef COMM_HAVE_RECVMMSG
+    struct mmsghdr msgs[COMM_RECV_BATCH];
+    struct iovec iovs[COMM_RECV_BATCH];
+    struct sockaddr_in addrs[COMM_RECV_BATCH];
+
+    int result = COMM_RECV_BATCH;
+    while (running && result == COMM_RECV_BATCH) {
+        for (int i = 0; i < COMM_RECV_BATCH; ++i) {
+            iovs[i].iov_base = &recv_bufs[i][0];
+            iovs[i].iov_len = UDP_BUF_SIZE;
+            memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        result = ::recvmmsg(fd, msgs, COMM_RECV_BATCH, MSG_DONTWAIT, NULL);
+        for (int i = 0; i < result; ++i) {
+            if (game_controller)
+                handle_gc(addrs[i], &recv_bufs[i][0], msgs[i].msg_len);
+            else
+                handle_comm(addrs[i], &recv_bufs[i][0], msgs[i].msg_len);
+        }
+    }
+#else
+    struct sockaddr_in recv_addr;
+    socklen_t addr_len = sizeof(sockaddr_in);
+
+    int result;
+    do {
+        result = ::recvfrom(fd, &recv_bufs[0][0], UDP_BUF_SIZE, 0,
+                            (struct sockaddr*)&recv_addr, &addr_len);
+        if (result > 0) {
+            if (game_controller)
+                handle_gc(recv_addr, &recv_bufs[0][0], result);
+            else
+                handle_comm(recv_addr, &recv_bufs[0][0], result);
+        }
+    } while (running && result > 0);
+#endif
+
+    // if an error occured (other than nonblocking EAGAIN error)
+    if (running && result == -1 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        stop();
+        throw SOCKET_ERROR(errno);
+    }
 }
 
 int Comm::startTOOL ()
@@ -689,14 +804,14 @@ void Comm::send () throw(socket_error)
         const CommPacketHeader header = {PACKET_HEADER, timer.timestamp(),
                                          gc->team(), gc->player(), gc->color()};
         memcpy(&buf[0], &header, sizeof(header));
-        // variable Python extra data
-        memcpy(&buf[sizeof(header)], &data[0], sizeof(float) * data.size());
+        // Quantized Python data, only the fields that changed
+        const int len = encoder.encode(data, &buf[sizeof(header)],
+                                       UDP_BUF_SIZE - sizeof(header));
 
         // Unlock mutex before leaving method
         pthread_mutex_unlock (&comm_mutex);
 
-        send(&buf[0], sizeof(header) + sizeof(float) * data.size(),
-             broadcast_addr);
+        send(&buf[0], sizeof(header) + len, broadcast_addr);
     }
 
 }
@@ -879,17 +994,23 @@ bool Comm::validate_packet (const char* msg, int len, CommPacketHeader& packet)
 void Comm::parse_packet (const CommPacketHeader &packet, const char* data, int size)
     throw()
 {
-    int len = size / sizeof(float);
+    if (!decoder.decode(packet.player, data, size))
+        return;
 
-    vector<float> v(len + 3);
-    v[0] = static_cast<float>(packet.team);
-    v[1] = static_cast<float>(packet.player);
-    v[2] = static_cast<float>(packet.color);
-    memcpy(&v[3], data, len * sizeof(float));
+    vector<float> v;
+    v.reserve(TEAM_PACKET_OFFSET + NUM_TEAM_PACKET_FIELDS);
+    v.push_back(static_cast<float>(packet.team));
+    v.push_back(static_cast<float>(packet.player));
+    v.push_back(static_cast<float>(packet.color));
+    decoder.append(packet.player, v);
+
+    pthread_mutex_lock (&comm_mutex);
 
     if (latest->size() >= MAX_MESSAGE_MEMORY)
         latest->pop_front();
     latest->push_back(v);
+
+    pthread_mutex_unlock (&comm_mutex);
 }
 
 void Comm::add_to_module ()
@@ -907,10 +1028,19 @@ void Comm::add_to_module ()
     }
 }
 
+// Returns the messages received since the last call.  The caller consumes
+// the returned list before calling again, at which point it becomes the
+// receiving buffer once more.
 list<vector<float> >* Comm::latestComm()
 {
+    pthread_mutex_lock (&comm_mutex);
+
     list<vector<float> >* old = latest;
-    latest = new list<vector<float> >();
+    latest = (old == &latest_buffers[0]) ? &latest_buffers[1] :
+        &latest_buffers[0];
+    latest->clear();
+
+    pthread_mutex_unlock (&comm_mutex);
     return old;
 }
 
@@ -921,17 +1051,22 @@ TeammateBallMeasurement Comm::getTeammateBallReport()
     list<vector<float> >::iterator i;
     TeammateBallMeasurement m;
     float minUncert = 10000.0f;
+
+    pthread_mutex_lock (&comm_mutex);
     for (i = latest->begin(); i != latest->end(); ++i) {
+        const float *fields = &(*i)[TEAM_PACKET_OFFSET];
         // Get the combined uncert x and y
-        float curUncert = static_cast<float>( hypot((*i)[6],(*i)[7]) );
+        float curUncert = static_cast<float>( hypot(fields[TP_UNCERT_X],
+                                                    fields[TP_UNCERT_Y]) );
         // If the teammate sees the ball and its uncertainty is less than the
         // Current minimum, then we
-        if ((*i)[13] > 0.0 && curUncert < minUncert) {
+        if (fields[TP_BALL_DIST] > 0.0 && curUncert < minUncert) {
             minUncert = curUncert;
-            m.ballX = (*i)[9];
-            m.ballY = (*i)[10];
+            m.ballX = fields[TP_BALL_X];
+            m.ballY = fields[TP_BALL_Y];
         }
     }
+    pthread_mutex_unlock (&comm_mutex);
     return m;
 }
 
@@ -21,6 +21,7 @@
 #include "TOOLConnect.h"
 #include "Vision.h"
 #include "CommTimer.h"
+#include "TeamPacket.h"
 #include "NogginStructs.h"
 
 class Comm
@@ -56,7 +57,10 @@ public:
     void setData(std::vector<float> &data);
 
     void add_to_module();
-    static const int NUM_PACKET_DATA_ELEMENTS = 16;
+    static const int NUM_PACKET_DATA_ELEMENTS = NUM_TEAM_PACKET_FIELDS;
+    // Received messages are team, player and color followed by the
+    // TeamPacket fields, so field f is at index TEAM_PACKET_OFFSET + f
+    static const int TEAM_PACKET_OFFSET = 3;
 private:
     void bind() throw(socket_error);
     void bind_gc() throw(socket_error);
@@ -72,6 +76,14 @@ private:
     void receive_gc()           throw(socket_error);
     void send()                 throw(socket_error);
 
+    // Waits on both sockets, the send timer and the stop wakeup at once, so
+    // the thread only runs when there is a packet to handle or send
+    void run_event_loop()       throw(socket_error);
+    // Reads every pending datagram on fd, in batches where the platform
+    // supports recvmmsg(), and hands each to handle_comm() or handle_gc()
+    void drain(int fd, bool game_controller) throw(socket_error);
+    void wake();
+
     void parse_packet(const CommPacketHeader& packet, const char* data,
                       int size)  throw();
     bool validate_packet(const char* msg, int len, CommPacketHeader& packet)
@@ -82,12 +94,17 @@ private:
     pthread_mutex_t comm_mutex;
     // Sending packet data
     std::vector<float> data;
-    // Received data
+    // Received data.  Packets are parsed into *latest; latestComm() hands
+    // that list to the caller and switches to the other buffer, so no lists
+    // are allocated per call
     std::list<std::vector<float> >* latest;
+    std::list<std::vector<float> > latest_buffers[2];
 
     // References to global data structures
     boost::shared_ptr<Sensors> sensors; // thread-safe access to sensors
     CommTimer timer;
+    TeamPacketEncoder encoder;
+    TeamPacketDecoder decoder;
     boost::shared_ptr<GameController> gc;
 
     // TOOLConnect sub-thread controller
@@ -102,6 +119,9 @@ private:
     struct sockaddr_in gc_broadcast_addr;
     char buf[UDP_BUF_SIZE];
 
+    // Signalled to interrupt the event loop, -1 until the loop first runs
+    int wake_fd;
+    char recv_bufs[COMM_RECV_BATCH][UDP_BUF_SIZE];
 };
 
 bool c_init_comm(void);
@@ -0,0 +1,103 @@
+#include "CommEventLoop.h"
+
+#ifdef __linux__
+
+#include <errno.h>         // errno
+#include <stdint.h>        // uint64_t
+#include <unistd.h>        // close(), read(), write()
+#include <sys/epoll.h>     // epoll_create(), epoll_ctl(), epoll_wait()
+#include <sys/timerfd.h>   // timerfd_create(), timerfd_settime()
+
+CommEventLoop::CommEventLoop (llong period_us, int _wake_fd)
+    throw(socket_error)
+    : epoll_fd(-1), timer_fd(-1), wake_fd(_wake_fd), watched(0)
+{
+    epoll_fd = epoll_create(COMM_EVENT_MAX_FDS);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+
+    // Fire the send timer once per period
+    struct itimerspec period;
+    period.it_interval.tv_sec = period_us / MICROS_PER_SECOND;
+    period.it_interval.tv_nsec = (period_us % MICROS_PER_SECOND) * 1000;
+    period.it_value = period.it_interval;
+
+    if (epoll_fd == -1 || timer_fd == -1 ||
+        timerfd_settime(timer_fd, 0, &period, NULL) == -1) {
+        const int err = errno;
+        close();
+        throw SOCKET_ERROR(err);
+    }
+
+    try {
+        watch(timer_fd);
+        watch(wake_fd);
+    } catch (socket_error&) {
+        close();
+        throw;
+    }
+}
+
+CommEventLoop::~CommEventLoop ()
+{
+    close();
+}
+
+void CommEventLoop::close ()
+{
+    if (epoll_fd != -1)
+        ::close(epoll_fd);
+    if (timer_fd != -1)
+        ::close(timer_fd);
+    epoll_fd = timer_fd = -1;
+}
+
+void CommEventLoop::watch (int fd) throw(socket_error)
+{
+    if (watched == COMM_EVENT_MAX_FDS)
+        throw SOCKET_ERROR("Too many descriptors for the Comm event loop");
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1)
+        throw SOCKET_ERROR(errno);
+    ++watched;
+}
+
+int CommEventLoop::wait (int ready[COMM_EVENT_MAX_FDS], bool &send_due)
+    throw(socket_error)
+{
+    struct epoll_event events[COMM_EVENT_MAX_FDS];
+    int n;
+    do {
+        n = epoll_wait(epoll_fd, events, COMM_EVENT_MAX_FDS, -1);
+    } while (n == -1 && errno == EINTR);
+    if (n == -1)
+        throw SOCKET_ERROR(errno);
+
+    send_due = false;
+    int sockets = 0;
+    for (int i = 0; i < n; ++i) {
+        const int fd = events[i].data.fd;
+        uint64_t count;
+        if (fd == timer_fd) {
+            ::read(timer_fd, &count, sizeof(count));
+            send_due = true;
+        } else if (fd == wake_fd) {
+            ::read(wake_fd, &count, sizeof(count));
+        } else {
+            ready[sockets++] = fd;
+        }
+    }
+    return sockets;
+}
+
+void CommEventLoop::wake (int wake_fd)
+{
+    if (wake_fd != -1) {
+        const uint64_t one = 1;
+        ::write(wake_fd, &one, sizeof(one));
+    }
+}
+
+#endif // __linux__
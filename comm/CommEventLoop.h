@@ -0,0 +1,54 @@
+#ifndef _CommEventLoop_h_DEFINED
+#define _CommEventLoop_h_DEFINED
+
+#ifdef __linux__
+
+#include "CommDef.h"
+#include "DataSerializer.h"
+
+// Most descriptors one loop waits on: the send timer, the wakeup and the
+// team and GameController sockets
+static const int COMM_EVENT_MAX_FDS = 4;
+
+//
+// The Comm thread's wait: an epoll set holding a timerfd that fires once per
+// send period, an eventfd another thread signals to interrupt the wait, and
+// the sockets to read.  The epoll set and the timer are closed when the loop
+// goes out of scope, however the thread leaves it.  The wakeup descriptor
+// belongs to the caller, so it stays valid for other threads while loops come
+// and go.
+//
+class CommEventLoop
+{
+  public:
+    // Throws if the epoll set or the timer can't be made; nothing is left
+    // open then
+    CommEventLoop(llong period_us, int wake_fd) throw(socket_error);
+    ~CommEventLoop();
+
+    void watch(int fd) throw(socket_error);
+
+    // Blocks until a watched socket has data, the send period is up or the
+    // wakeup is signalled.  Stores the sockets with data in ready and
+    // returns how many there are; send_due is set when the period is up.
+    int wait(int ready[COMM_EVENT_MAX_FDS], bool &send_due)
+        throw(socket_error);
+
+    // Interrupt a wait on a loop watching wake_fd
+    static void wake(int wake_fd);
+
+  private:
+    CommEventLoop(const CommEventLoop&);
+    CommEventLoop& operator=(const CommEventLoop&);
+
+    void close();
+
+    int epoll_fd;
+    int timer_fd;
+    int wake_fd;
+    int watched;
+};
+
+#endif // __linux__
+
+#endif // _CommEventLoop_h_DEFINED
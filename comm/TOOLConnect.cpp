@@ -233,8 +233,15 @@ void
 TOOLConnect::handle_command (int cmd) throw(socket_error&)
 {
     switch (cmd) {
-    case CMD_TABLE:
+    case CMD_TABLE: {
+        // A whole color table, which vision takes up at its next frame.
+        // This thread blocks until all of its 2 MB has come in; vision
+        // carries on with the old table meanwhile.
+        vector<byte> table(ColorTable::BYTES);
+        serial.read_bytes(&table[0], ColorTable::BYTES);
+        vision->thresh->initTableFromBuffer(&table[0]);
         break;
+    }
 
     case CMD_MOTION:
         break;
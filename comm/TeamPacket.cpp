@@ -0,0 +1,124 @@
+#include <string.h>   // memcpy()
+#include <math.h>     // floorf()
+#include <limits.h>   // SHRT_MAX, SHRT_MIN
+
+#include "TeamPacket.h"
+
+using namespace std;
+
+#define TEAM_PACKET_STEP(name, step) step,
+static const float TEAM_PACKET_STEPS[NUM_TEAM_PACKET_FIELDS] = {
+    TEAM_PACKET_FIELDS(TEAM_PACKET_STEP)
+};
+#undef TEAM_PACKET_STEP
+
+static int16_t quantize(TeamPacketField field, float value)
+{
+    const float steps = floorf(value / TEAM_PACKET_STEPS[field] + 0.5f);
+    if (steps > SHRT_MAX)
+        return SHRT_MAX;
+    if (steps < SHRT_MIN)
+        return SHRT_MIN;
+    return static_cast<int16_t>(steps);
+}
+
+
+TeamPacketState::TeamPacketState()
+    : valid(false)
+{
+    memset(values, 0, sizeof(values));
+}
+
+float TeamPacketState::get(TeamPacketField field) const
+{
+    return values[field] * TEAM_PACKET_STEPS[field];
+}
+
+void TeamPacketState::set(TeamPacketField field, float value)
+{
+    values[field] = quantize(field, value);
+}
+
+
+TeamPacketEncoder::TeamPacketEncoder()
+    : last(), packets_since_keyframe(TEAM_PACKET_KEYFRAME_INTERVAL)
+{
+}
+
+int TeamPacketEncoder::encode(const vector<float> &data, char *buf, int size)
+{
+    if (size < TEAM_PACKET_MAX_SIZE)
+        return -1;
+
+    const bool keyframe =
+        packets_since_keyframe >= TEAM_PACKET_KEYFRAME_INTERVAL;
+    packets_since_keyframe = keyframe ? 1 : packets_since_keyframe + 1;
+
+    uint32_t mask = 0;
+    int len = TEAM_PACKET_PREFIX_SIZE;
+    for (int i = 0; i < NUM_TEAM_PACKET_FIELDS; ++i) {
+        const TeamPacketField field = static_cast<TeamPacketField>(i);
+        const int16_t value = quantize(field, i < static_cast<int>(data.size())
+                                       ? data[i] : 0.0f);
+        if (keyframe || value != last.values[i]) {
+            mask |= 1u << i;
+            memcpy(&buf[len], &value, sizeof(value));
+            len += sizeof(value);
+            last.values[i] = value;
+        }
+    }
+    last.valid = true;
+
+    buf[0] = static_cast<char>(TEAM_PACKET_VERSION);
+    buf[1] = static_cast<char>(keyframe ? TEAM_PACKET_KEYFRAME : 0);
+    memcpy(&buf[2], &mask, sizeof(mask));
+    return len;
+}
+
+
+TeamPacketDecoder::TeamPacketDecoder()
+{
+}
+
+bool TeamPacketDecoder::decode(int player, const char *buf, int size)
+{
+    if (player < 1 || player > NUM_PLAYERS_PER_TEAM ||
+        size < TEAM_PACKET_PREFIX_SIZE ||
+        static_cast<uint8_t>(buf[0]) != TEAM_PACKET_VERSION)
+        return false;
+
+    const bool keyframe = (buf[1] & TEAM_PACKET_KEYFRAME) != 0;
+    uint32_t mask;
+    memcpy(&mask, &buf[2], sizeof(mask));
+
+    // Check the length before touching the state, so a truncated packet
+    // leaves it as it was
+    int len = TEAM_PACKET_PREFIX_SIZE;
+    for (int i = 0; i < NUM_TEAM_PACKET_FIELDS; ++i) {
+        if (mask & (1u << i))
+            len += sizeof(int16_t);
+    }
+    if (len != size)
+        return false;
+
+    TeamPacketState &state = teammates[player - 1];
+    len = TEAM_PACKET_PREFIX_SIZE;
+    for (int i = 0; i < NUM_TEAM_PACKET_FIELDS; ++i) {
+        if (mask & (1u << i)) {
+            memcpy(&state.values[i], &buf[len], sizeof(int16_t));
+            len += sizeof(int16_t);
+        }
+    }
+    if (keyframe)
+        state.valid = true;
+
+    return state.valid;
+}
+
+void TeamPacketDecoder::append(int player, vector<float> &out) const
+{
+    const TeamPacketState &state = teammate(player);
+    for (int i = 0; i < NUM_TEAM_PACKET_FIELDS; ++i) {
+        out.push_back(state.get(static_cast<TeamPacketField>(i)));
+    }
+}
@@ -0,0 +1,117 @@
+
+#ifndef _TeamPacket_h_DEFINED
+#define _TeamPacket_h_DEFINED
+
+#include <vector>
+#include <stdint.h>
+
+#include "CommDef.h"
+
+//
+// Team message schema.  Every field is sent as a signed 16 bit count of
+// quantization steps; the second column is the size of one step in the
+// field's own units.  The order is the order of the values Brain.py passes
+// to setData() and of the list Python receives back from latestComm(), so
+// changing this table means changing Packet.py and TEAM_PACKET_VERSION too.
+// A field saturates at 32767 steps, so a step must be coarse enough to
+// reach the field's largest real value: chase times, for one, run from
+// about -1 s with the ball close to minutes with it across the field.
+//
+#define TEAM_PACKET_FIELDS(FIELD)                                       \
+    FIELD(PLAYER_X,      0.1f)  /* cm                               */  \
+    FIELD(PLAYER_Y,      0.1f)  /* cm                               */  \
+    FIELD(PLAYER_H,      0.01f) /* degrees                          */  \
+    FIELD(UNCERT_X,      0.1f)  /* cm                               */  \
+    FIELD(UNCERT_Y,      0.1f)  /* cm                               */  \
+    FIELD(UNCERT_H,      0.01f) /* degrees                          */  \
+    FIELD(BALL_X,        0.1f)  /* cm                               */  \
+    FIELD(BALL_Y,        0.1f)  /* cm                               */  \
+    FIELD(BALL_UNCERT_X, 0.1f)  /* cm                               */  \
+    FIELD(BALL_UNCERT_Y, 0.1f)  /* cm                               */  \
+    FIELD(BALL_DIST,     0.1f)  /* cm, or a special playbook value  */  \
+    FIELD(ROLE,          1.0f)  /* playbook role                    */  \
+    FIELD(SUB_ROLE,      1.0f)  /* playbook sub role                */  \
+    FIELD(CHASE_TIME,    10.0f) /* ms, up to 327 s                  */  \
+    FIELD(BALL_VEL_X,    0.1f)  /* cm/s                             */  \
+    FIELD(BALL_VEL_Y,    0.1f)  /* cm/s                             */
+
+#define TEAM_PACKET_ENUM(name, step) TP_##name,
+enum TeamPacketField {
+    TEAM_PACKET_FIELDS(TEAM_PACKET_ENUM)
+    NUM_TEAM_PACKET_FIELDS
+};
+#undef TEAM_PACKET_ENUM
+
+// Bump whenever the schema or wire layout changes; mismatched packets are
+// dropped rather than misread
+static const uint8_t TEAM_PACKET_VERSION = 2;
+// Set in the flags byte when every field is present
+static const uint8_t TEAM_PACKET_KEYFRAME = 0x1;
+// A keyframe is sent every this many packets so teammates that missed a
+// packet, or just started listening, catch up within a second
+static const int TEAM_PACKET_KEYFRAME_INTERVAL = PACKETS_PER_SECOND;
+
+// Wire layout, after the CommPacketHeader:
+//   uint8  version
+//   uint8  flags
+//   uint32 mask of fields present, bit i for field i
+//   int16  quantized value of each present field, in schema order
+static const int TEAM_PACKET_PREFIX_SIZE = 2 + 4;
+static const int TEAM_PACKET_MAX_SIZE = TEAM_PACKET_PREFIX_SIZE +
+    NUM_TEAM_PACKET_FIELDS * 2;
+
+// Quantized values of every field of one robot's message
+class TeamPacketState
+{
+  public:
+    TeamPacketState();
+
+    float get(TeamPacketField field) const;
+    void set(TeamPacketField field, float value);
+
+  public:
+    int16_t values[NUM_TEAM_PACKET_FIELDS];
+    // False until a keyframe has been applied
+    bool valid;
+};
+
+// Quantizes outgoing data and writes only the fields that have changed since
+// the last packet, with a full keyframe every TEAM_PACKET_KEYFRAME_INTERVAL.
+class TeamPacketEncoder
+{
+  public:
+    TeamPacketEncoder();
+
+    // Encode data, in schema order, into buf.  Missing trailing values are
+    // sent as zero.  Returns the number of bytes written, which is at most
+    // TEAM_PACKET_MAX_SIZE, or -1 if size is too small.
+    int encode(const std::vector<float> &data, char *buf, int size);
+    // Make the next packet a keyframe
+    void reset() { packets_since_keyframe = TEAM_PACKET_KEYFRAME_INTERVAL; }
+
+  private:
+    TeamPacketState last;
+    int packets_since_keyframe;
+};
+
+// Applies incoming packets to the last known state of each teammate.
+class TeamPacketDecoder
+{
+  public:
+    TeamPacketDecoder();
+
+    // Apply a packet from player (1 based).  Returns false if the packet is
+    // malformed, from another schema version, or a delta for a teammate we
+    // have not yet had a keyframe from.
+    bool decode(int player, const char *buf, int size);
+    const TeamPacketState& teammate(int player) const {
+        return teammates[player - 1];
+    }
+    // Append the dequantized fields of player's state to out
+    void append(int player, std::vector<float> &out) const;
+
+  private:
+    TeamPacketState teammates[NUM_PLAYERS_PER_TEAM];
+};
+
+#endif // _TeamPacket_h_DEFINED
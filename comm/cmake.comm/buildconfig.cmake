@@ -38,4 +38,9 @@ OPTION(
   "Build with the Python GameController interface"
   ON
   )
+OPTION(
+  USE_COMM_EPOLL
+  "Drive the Comm thread with epoll and a timerfd instead of sleeping (Linux only)"
+  ON
+  )
 
@@ -0,0 +1,364 @@
+/**
+ * commLoopback.cpp - team messages over loopback, with simulated teammates
+ *
+ * Each simulated teammate is a thread with its own UDP socket, sending a
+ * CommPacketHeader and a TeamPacket to the robot's socket on 127.0.0.1 at
+ * the team packet rate, as Comm::send() does, with its positions and ball
+ * estimate moving a little each packet so deltas carry something.
+ *
+ * The robot is a receiving thread that waits the way the Comm thread does:
+ *  - epoll: a CommEventLoop, as Comm::run_event_loop(), draining the socket
+ *    with recvmmsg() where there is one,
+ *  - sleep: a nonblocking recvfrom() every SLEEP_MILLIS, the loop Comm::run()
+ *    falls back to without USE_COMM_EPOLL.
+ * Either way it sends its own packet every MICROS_PER_PACKET and decodes
+ * every teammate packet it receives.
+ *
+ * For each loop prints how many packets arrived, their latency (from the
+ * teammate's send to the robot decoding it), how often the robot woke up
+ * and how much CPU its thread used.
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "CommEventLoop.h"
+#include "TeamPacket.h"
+
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 12))
+#  define COMM_HAVE_RECVMMSG
+#endif
+
+using namespace std;
+
+static const int TEAM = 1;
+// The robot is player 1, its teammates the rest of the team
+static const int ROBOT_PLAYER = 1;
+
+struct Teammate
+{
+    int player;
+    int packetsPerSecond;
+    sockaddr_in robot;
+    volatile bool running;
+};
+
+struct Robot
+{
+    bool epoll;
+    int sockn;
+    int sink;
+    sockaddr_in sinkAddr;
+    int wake_fd;
+    volatile bool running;
+
+    TeamPacketEncoder encoder;
+    TeamPacketDecoder decoder;
+    vector<float> data;
+    char buf[UDP_BUF_SIZE];
+    char recv_bufs[COMM_RECV_BATCH][UDP_BUF_SIZE];
+
+    long long wakeups;
+    long long sent;
+    long long bad;
+    vector<long long> latencies;
+    long long cpu;
+};
+
+static long long clockMicros(clockid_t clock)
+{
+    struct timespec t;
+    clock_gettime(clock, &t);
+    return t.tv_sec * MICROS_PER_SECOND + t.tv_nsec / 1000;
+}
+
+static void sleepUntil(long long micros)
+{
+    struct timespec t;
+    t.tv_sec = micros / MICROS_PER_SECOND;
+    t.tv_nsec = (micros % MICROS_PER_SECOND) * 1000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR)
+        ;
+}
+
+static int openSocket(sockaddr_in &addr)
+{
+    const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (fd == -1 ||
+        ::bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 ||
+        getsockname(fd, (struct sockaddr*)&addr, &len) == -1) {
+        perror("socket");
+        exit(1);
+    }
+    return fd;
+}
+
+static int packetSize(TeamPacketEncoder &encoder, const vector<float> &data,
+                      int player, char *buf)
+{
+    const CommPacketHeader header = {PACKET_HEADER, micro_time(), TEAM,
+                                     player, 0};
+    memcpy(buf, &header, sizeof(header));
+    const int len = encoder.encode(data, buf + sizeof(header),
+                                   UDP_BUF_SIZE - sizeof(header));
+    return sizeof(header) + len;
+}
+
+static void * teammateThread(void *arg)
+{
+    Teammate *t = reinterpret_cast<Teammate*>(arg);
+    sockaddr_in addr;
+    const int fd = openSocket(addr);
+
+    TeamPacketEncoder encoder;
+    vector<float> data(NUM_TEAM_PACKET_FIELDS, 0.0f);
+    data[TP_PLAYER_X] = 100.0f * t->player;
+    data[TP_ROLE] = static_cast<float>(t->player);
+    char buf[UDP_BUF_SIZE];
+
+    // Teammates' clocks aren't in step, so spread their sends over a period
+    const long long period = MICROS_PER_SECOND / t->packetsPerSecond;
+    long long next = clockMicros(CLOCK_MONOTONIC) +
+        period * t->player / NUM_PLAYERS_PER_TEAM;
+
+    for (int n = 0; t->running; ++n) {
+        next += period;
+        sleepUntil(next);
+
+        data[TP_PLAYER_X] += 0.5f;
+        data[TP_BALL_X] = 200.0f + (n % 50);
+        data[TP_CHASE_TIME] = 1000.0f + 10.0f * (n % 20);
+        const int len = packetSize(encoder, data, t->player, buf);
+        ::sendto(fd, buf, len, 0, (struct sockaddr*)&t->robot,
+                 sizeof(t->robot));
+    }
+    ::close(fd);
+    return NULL;
+}
+
+static void handle(Robot *r, const char *msg, int len)
+{
+    if (static_cast<unsigned int>(len) < sizeof(CommPacketHeader)) {
+        ++r->bad;
+        return;
+    }
+    const CommPacketHeader &packet =
+        *reinterpret_cast<const CommPacketHeader*>(msg);
+    if (memcmp(packet.header, PACKET_HEADER, sizeof(PACKET_HEADER)) != 0 ||
+        !r->decoder.decode(packet.player, msg + sizeof(packet),
+                           len - sizeof(packet))) {
+        ++r->bad;
+        return;
+    }
+    r->latencies.push_back(micro_time() - packet.timestamp);
+}
+
+static void send(Robot *r)
+{
+    const int len = packetSize(r->encoder, r->data, ROBOT_PLAYER, r->buf);
+    ::sendto(r->sockn, r->buf, len, 0, (struct sockaddr*)&r->sinkAddr,
+             sizeof(r->sinkAddr));
+    ++r->sent;
+}
+
+static void drain(Robot *r)
+{
+#ifdef COMM_HAVE_RECVMMSG
+    struct mmsghdr msgs[COMM_RECV_BATCH];
+    struct iovec iovs[COMM_RECV_BATCH];
+
+    int result = COMM_RECV_BATCH;
+    while (result == COMM_RECV_BATCH) {
+        for (int i = 0; i < COMM_RECV_BATCH; ++i) {
+            iovs[i].iov_base = &r->recv_bufs[i][0];
+            iovs[i].iov_len = UDP_BUF_SIZE;
+            memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        result = ::recvmmsg(r->sockn, msgs, COMM_RECV_BATCH, MSG_DONTWAIT,
+                            NULL);
+        for (int i = 0; i < result; ++i)
+            handle(r, &r->recv_bufs[i][0], msgs[i].msg_len);
+    }
+#else
+    int result;
+    while ((result = ::recv(r->sockn, &r->recv_bufs[0][0], UDP_BUF_SIZE,
+                            MSG_DONTWAIT)) > 0)
+        handle(r, &r->recv_bufs[0][0], result);
+#endif
+}
+
+// As Comm::run_event_loop()
+static void runEventLoop(Robot *r) throw(socket_error)
+{
+    CommEventLoop events(MICROS_PER_PACKET, r->wake_fd);
+    events.watch(r->sockn);
+
+    send(r);
+
+    int ready[COMM_EVENT_MAX_FDS];
+    bool send_due;
+    while (r->running) {
+        const int n = events.wait(ready, send_due);
+        ++r->wakeups;
+        if (send_due)
+            send(r);
+        if (n > 0)
+            drain(r);
+    }
+}
+
+// As Comm::run() without USE_COMM_EPOLL
+static void runSleepLoop(Robot *r)
+{
+    struct timespec interval, remainder;
+    interval.tv_sec = 0;
+    interval.tv_nsec = SLEEP_MILLIS * 1000;
+
+    while (r->running) {
+        send(r);
+        const long long sent = micro_time();
+
+        while (r->running && micro_time() - sent <= MICROS_PER_PACKET) {
+            ++r->wakeups;
+            int result;
+            while ((result = ::recv(r->sockn, &r->recv_bufs[0][0],
+                                    UDP_BUF_SIZE, MSG_DONTWAIT)) > 0)
+                handle(r, &r->recv_bufs[0][0], result);
+            nanosleep(&interval, &remainder);
+        }
+    }
+}
+
+static void * robotThread(void *arg)
+{
+    Robot *r = reinterpret_cast<Robot*>(arg);
+    const long long cpu = clockMicros(CLOCK_THREAD_CPUTIME_ID);
+    try {
+        if (r->epoll)
+            runEventLoop(r);
+        else
+            runSleepLoop(r);
+    } catch (socket_error &e) {
+        fprintf(stderr, "%s\n", e.what());
+    }
+    r->cpu = clockMicros(CLOCK_THREAD_CPUTIME_ID) - cpu;
+    return NULL;
+}
+
+static void run(bool epoll, int seconds, int teammates, int rate)
+{
+    Robot robot;
+    sockaddr_in robotAddr;
+    robot.epoll = epoll;
+    robot.sockn = openSocket(robotAddr);
+    robot.sink = openSocket(robot.sinkAddr);
+    robot.wake_fd = eventfd(0, EFD_NONBLOCK);
+    robot.running = true;
+    robot.data.assign(NUM_TEAM_PACKET_FIELDS, 0.0f);
+    robot.wakeups = robot.sent = robot.bad = 0;
+    robot.latencies.reserve(seconds * rate * teammates * 2);
+
+    pthread_t robot_thread;
+    pthread_create(&robot_thread, NULL, robotThread, &robot);
+
+    vector<Teammate> team(teammates);
+    vector<pthread_t> threads(teammates);
+    for (int i = 0; i < teammates; ++i) {
+        team[i].player = ROBOT_PLAYER + 1 + i;
+        team[i].packetsPerSecond = rate;
+        team[i].robot = robotAddr;
+        team[i].running = true;
+        pthread_create(&threads[i], NULL, teammateThread, &team[i]);
+    }
+
+    sleep(seconds);
+
+    for (int i = 0; i < teammates; ++i) {
+        team[i].running = false;
+        pthread_join(threads[i], NULL);
+    }
+    robot.running = false;
+    CommEventLoop::wake(robot.wake_fd);
+    pthread_join(robot_thread, NULL);
+    ::close(robot.wake_fd);
+    ::close(robot.sink);
+    ::close(robot.sockn);
+
+    vector<long long> &l = robot.latencies;
+    sort(l.begin(), l.end());
+    long long total = 0;
+    for (unsigned int i = 0; i < l.size(); ++i)
+        total += l[i];
+
+    printf("%s loop: %u packets from %d teammates, %lld sent, %lld bad\n",
+           epoll ? "epoll" : "sleep", static_cast<unsigned int>(l.size()),
+           teammates, robot.sent, robot.bad);
+    if (!l.empty())
+        printf("  latency mean %lld us, median %lld us, 99%% %lld us, "
+               "max %lld us\n",
+               total / static_cast<long long>(l.size()), l[l.size() / 2],
+               l[l.size() * 99 / 100], l.back());
+    printf("  %.1f wakeups/s, cpu %.3f%% (%lld us)\n",
+           static_cast<double>(robot.wakeups) / seconds,
+           100.0 * robot.cpu / (seconds * MICROS_PER_SECOND), robot.cpu);
+}
+
+int main(int argc, char **argv)
+{
+    int seconds = 10;
+    int teammates = NUM_PLAYERS_PER_TEAM - 1;
+    int rate = PACKETS_PER_SECOND;
+    int loops = 3;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:t:r:e")) != -1) {
+        switch (opt) {
+        case 's':
+            seconds = atoi(optarg);
+            break;
+        case 't':
+            teammates = atoi(optarg);
+            break;
+        case 'r':
+            rate = atoi(optarg);
+            break;
+        case 'e':
+            loops = 1;
+            break;
+        default:
+            seconds = 0;
+            break;
+        }
+    }
+    if (seconds < 1 || teammates < 1 || rate < 1) {
+        fprintf(stderr, "usage: %s [-s seconds] [-t teammates] "
+                "[-r packets/s] [-e]\n"
+                "  -e runs only the epoll loop\n", argv[0]);
+        return 1;
+    }
+
+    if (loops & 1)
+        run(true, seconds, teammates, rate);
+    if (loops & 2)
+        run(false, seconds, teammates, rate);
+    return 0;
+}
@@ -0,0 +1,294 @@
+/**
+ * teamPacketTest.cpp - round trip of team messages through the wire format
+ *
+ * Encodes and decodes the values Brain.py sends, with chase times worked
+ * out the way GoTeam.determineChaseTime does it (ms to walk to the ball at
+ * CHASE_SPEED, less BALL_ON_BONUS when the ball is seen, plus the time to
+ * stand up when fallen), and checks that:
+ *  - every field comes back within half a step of what was sent,
+ *  - chase times keep their order and their differences to within a step,
+ *    so the chaser is picked the same on every robot,
+ *  - deltas carry only what changed, and a teammate's state stays right
+ *    across them.
+ *
+ * Then times encoding and decoding a stream of messages in which the robot
+ * and ball move every packet, against the old format that sent the raw
+ * floats Brain.py passed to setData() and copied them back out into a
+ * vector, and prints the cost and size of a packet for each.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "TeamPacket.h"
+
+using namespace std;
+
+// From noggin/playbook/PBConstants.py
+static const float CHASE_SPEED = 7.0f;           // cm/s
+static const float SEC_TO_MILLIS = 1000.0f;
+static const float BALL_ON_BONUS = 1000.0f;      // ms
+// About SweetMoves.getMoveTime(STAND_UP_FRONT)
+static const float STAND_UP_S = 10.0f;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+static float chaseTime(float ballDist, bool seeBall, bool fallen)
+{
+    float time = ballDist / CHASE_SPEED * SEC_TO_MILLIS;
+    if (seeBall)
+        time -= BALL_ON_BONUS;
+    if (fallen)
+        time += STAND_UP_S * SEC_TO_MILLIS;
+    return time;
+}
+
+static vector<float> message(float chase)
+{
+    vector<float> data(NUM_TEAM_PACKET_FIELDS, 0.0f);
+    data[TP_PLAYER_X] = 245.3f;
+    data[TP_PLAYER_Y] = -118.7f;
+    data[TP_PLAYER_H] = 173.25f;
+    data[TP_UNCERT_X] = 32.1f;
+    data[TP_UNCERT_Y] = 40.6f;
+    data[TP_UNCERT_H] = 12.5f;
+    data[TP_BALL_X] = 420.0f;
+    data[TP_BALL_Y] = 180.4f;
+    data[TP_BALL_UNCERT_X] = 15.5f;
+    data[TP_BALL_UNCERT_Y] = 18.2f;
+    data[TP_BALL_DIST] = 213.9f;
+    data[TP_ROLE] = 2.0f;
+    data[TP_SUB_ROLE] = 7.0f;
+    data[TP_CHASE_TIME] = chase;
+    data[TP_BALL_VEL_X] = -35.2f;
+    data[TP_BALL_VEL_Y] = 4.4f;
+    return data;
+}
+
+// Sends data from player 1 and returns what the teammate makes of it
+static vector<float> roundTrip(TeamPacketEncoder &encoder,
+                               TeamPacketDecoder &decoder,
+                               const vector<float> &data, int &size)
+{
+    char buf[TEAM_PACKET_MAX_SIZE];
+    size = encoder.encode(data, buf, sizeof(buf));
+    vector<float> out;
+    if (size < 0 || !decoder.decode(1, buf, size))
+        return out;
+    decoder.append(1, out);
+    return out;
+}
+
+static void checkFields()
+{
+    TeamPacketEncoder encoder;
+    TeamPacketDecoder decoder;
+    const vector<float> data = message(chaseTime(213.9f, true, false));
+    int size;
+    const vector<float> out = roundTrip(encoder, decoder, data, size);
+
+    check(size == TEAM_PACKET_MAX_SIZE, "the first packet is a keyframe");
+    check(out.size() == data.size(), "a keyframe is decoded");
+    for (unsigned int i = 0; i < out.size(); ++i) {
+        const TeamPacketField field = static_cast<TeamPacketField>(i);
+        TeamPacketState one;
+        one.values[field] = 1;
+        if (fabsf(out[i] - data[i]) > one.get(field) / 2.0f) {
+            printf("field %u sent %g came back %g\n", i, data[i], out[i]);
+            check(false, "every field comes back within half a step");
+        }
+    }
+}
+
+static void checkChaseTimes()
+{
+    // Ball distances from at the feet to across the field, seen or not,
+    // standing or fallen
+    const float dists[] = {15.0f, 40.0f, 90.0f, 150.0f, 230.0f, 300.0f,
+                           450.0f, 600.0f, 750.0f, 900.0f};
+    const int NUM_DISTS = sizeof(dists) / sizeof(dists[0]);
+
+    vector<float> sent, received;
+    for (int fallen = 0; fallen < 2; ++fallen) {
+        for (int seeBall = 0; seeBall < 2; ++seeBall) {
+            for (int i = 0; i < NUM_DISTS; ++i) {
+                TeamPacketEncoder encoder;
+                TeamPacketDecoder decoder;
+                const float chase = chaseTime(dists[i], seeBall != 0,
+                                              fallen != 0);
+                int size;
+                const vector<float> out =
+                    roundTrip(encoder, decoder, message(chase), size);
+                if (out.empty()) {
+                    check(false, "a chase time packet is decoded");
+                    return;
+                }
+                sent.push_back(chase);
+                received.push_back(out[TP_CHASE_TIME]);
+            }
+        }
+    }
+
+    TeamPacketState one;
+    one.values[TP_CHASE_TIME] = 1;
+    const float step = one.get(TP_CHASE_TIME);
+    for (unsigned int i = 0; i < sent.size(); ++i) {
+        if (fabsf(received[i] - sent[i]) > step / 2.0f) {
+            printf("chase time sent %g ms came back %g ms\n",
+                   sent[i], received[i]);
+            check(false, "chase times come back within half a step");
+        }
+        for (unsigned int j = 0; j < sent.size(); ++j) {
+            if (sent[i] < sent[j] && !(received[i] < received[j]))
+                check(false, "chase times keep their order");
+            if (fabsf((received[i] - received[j]) - (sent[i] - sent[j])) >
+                step)
+                check(false, "chase time differences are kept");
+        }
+    }
+}
+
+static void checkDeltas()
+{
+    TeamPacketEncoder encoder;
+    TeamPacketDecoder decoder;
+    vector<float> data = message(chaseTime(300.0f, true, false));
+    int size;
+    roundTrip(encoder, decoder, data, size);
+
+    const vector<float> same = roundTrip(encoder, decoder, data, size);
+    check(size == TEAM_PACKET_PREFIX_SIZE, "nothing changed, no fields sent");
+    check(!same.empty(), "an empty delta is decoded");
+
+    data[TP_CHASE_TIME] = chaseTime(150.0f, true, false);
+    const vector<float> out = roundTrip(encoder, decoder, data, size);
+    check(size == TEAM_PACKET_PREFIX_SIZE + 2, "a delta sends what changed");
+    check(!out.empty() &&
+          fabsf(out[TP_CHASE_TIME] - data[TP_CHASE_TIME]) <= 5.0f &&
+          fabsf(out[TP_PLAYER_X] - data[TP_PLAYER_X]) <= 0.05f,
+          "the teammate's state is right after a delta");
+}
+
+static const int BENCH_PACKETS = 1000000;
+// Header fields Comm puts ahead of a teammate's fields in latestComm()
+static const int MESSAGE_OFFSET = 3;
+
+static double nanos()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// What the robot sends in packet n: it walks, its heading and uncertainty
+// drift and the ball rolls, while roles hold for seconds at a time
+static void nextMessage(vector<float> &data, int n)
+{
+    data[TP_PLAYER_X] = 245.3f + 0.3f * (n % 1000);
+    data[TP_PLAYER_H] = 173.25f + 0.05f * (n % 200);
+    data[TP_UNCERT_X] = 32.1f + 0.2f * (n % 50);
+    data[TP_BALL_X] = 420.0f - 0.7f * (n % 500);
+    data[TP_BALL_DIST] = 213.9f - 0.7f * (n % 300);
+    data[TP_CHASE_TIME] = chaseTime(data[TP_BALL_DIST], true, false);
+    data[TP_ROLE] = static_cast<float>((n / 60) % 4);
+}
+
+static void report(const char *what, double start, double end, long bytes)
+{
+    printf("  %-7s %6.1f ns/packet, %5.1f bytes/packet\n", what,
+           (end - start) / BENCH_PACKETS,
+           static_cast<double>(bytes) / BENCH_PACKETS);
+}
+
+static void benchmark()
+{
+    vector<float> data = message(chaseTime(213.9f, true, false));
+    vector<char> bufs(static_cast<size_t>(BENCH_PACKETS) *
+                      TEAM_PACKET_MAX_SIZE);
+    vector<int> sizes(BENCH_PACKETS);
+    float sum = 0.0f;
+
+    printf("%d packets:\n", BENCH_PACKETS);
+
+    // Quantized deltas
+    TeamPacketEncoder encoder;
+    long bytes = 0;
+    double start = nanos();
+    for (int n = 0; n < BENCH_PACKETS; ++n) {
+        nextMessage(data, n);
+        char *buf = &bufs[static_cast<size_t>(n) * TEAM_PACKET_MAX_SIZE];
+        sizes[n] = encoder.encode(data, buf, TEAM_PACKET_MAX_SIZE);
+        bytes += sizes[n];
+    }
+    double end = nanos();
+    report("encode", start, end, bytes);
+
+    TeamPacketDecoder decoder;
+    start = nanos();
+    for (int n = 0; n < BENCH_PACKETS; ++n) {
+        const char *buf = &bufs[static_cast<size_t>(n) * TEAM_PACKET_MAX_SIZE];
+        if (!decoder.decode(1, buf, sizes[n]))
+            check(false, "a benchmark packet is decoded");
+        // As Comm::parse_packet()
+        vector<float> v;
+        v.reserve(MESSAGE_OFFSET + NUM_TEAM_PACKET_FIELDS);
+        v.resize(MESSAGE_OFFSET);
+        decoder.append(1, v);
+        sum += v[MESSAGE_OFFSET + TP_BALL_X];
+    }
+    end = nanos();
+    report("decode", start, end, bytes);
+
+    // The old format: the raw floats, copied in and out
+    printf("old format:\n");
+    const int OLD_SIZE = NUM_TEAM_PACKET_FIELDS * sizeof(float);
+    vector<char> oldBufs(static_cast<size_t>(BENCH_PACKETS) * OLD_SIZE);
+    start = nanos();
+    for (int n = 0; n < BENCH_PACKETS; ++n) {
+        nextMessage(data, n);
+        memcpy(&oldBufs[static_cast<size_t>(n) * OLD_SIZE], &data[0],
+               OLD_SIZE);
+    }
+    end = nanos();
+    report("encode", start, end, static_cast<long>(OLD_SIZE) * BENCH_PACKETS);
+
+    start = nanos();
+    for (int n = 0; n < BENCH_PACKETS; ++n) {
+        // As Comm::parse_packet() did
+        const int len = OLD_SIZE / sizeof(float);
+        vector<float> v(len + MESSAGE_OFFSET);
+        memcpy(&v[MESSAGE_OFFSET], &oldBufs[static_cast<size_t>(n) * OLD_SIZE],
+               len * sizeof(float));
+        sum += v[MESSAGE_OFFSET + TP_BALL_X];
+    }
+    end = nanos();
+    report("decode", start, end, static_cast<long>(OLD_SIZE) * BENCH_PACKETS);
+
+    // Keep the decoded values live so the loops aren't optimized away
+    if (sum == 0.0f)
+        printf("\n");
+}
+
+int main()
+{
+    checkFields();
+    checkChaseTimes();
+    checkDeltas();
+
+    if (failures)
+        return 1;
+    printf("all checks passed\n");
+
+    benchmark();
+    return failures ? 1 : 0;
+}
@@ -59,7 +59,7 @@ const NBMath::ufmatrix3 CoordFrame3D::rotation3D(const Axis axis,
 
 const NBMath::ufmatrix3 CoordFrame3D::translation3D(const float dx,
                                                     const float dy) {
-    boost::numeric::ublas::matrix <float> trans =
+    NBMath::ufmatrix3 trans =
         boost::numeric::ublas::identity_matrix <float>(3);
     trans(X_AXIS, Z_AXIS) = dx;
     trans(Y_AXIS, Z_AXIS) = dy;
@@ -0,0 +1,161 @@
+#include "DCMCommandBuilder.h"
+#include "ALNames.h"
+#include "Lights.h"
+#include "NBMath.h"
+
+using std::string;
+using std::vector;
+
+const unsigned int DCMCommandBuilder::JOINT_GROUP;
+const unsigned int DCMCommandBuilder::STIFFNESS_GROUP;
+const unsigned int DCMCommandBuilder::FIRST_LED_GROUP;
+const unsigned int DCMCommandBuilder::ULTRASOUND_GROUP;
+const unsigned int DCMCommandBuilder::NUM_GROUPS;
+const unsigned int DCMCommandBuilder::JOINT_POSITIONS;
+const unsigned int DCMCommandBuilder::JOINT_STIFFNESSES;
+const unsigned int DCMCommandBuilder::LEDS;
+const int DCMCommandBuilder::JOINT_DELAY_MS;
+const int DCMCommandBuilder::STIFFNESS_DELAY_MS;
+const int DCMCommandBuilder::LED_DELAY_MS;
+const int DCMCommandBuilder::US_DELAY_MS;
+
+DCMCommandBuilder::DCMCommandBuilder()
+    : actuators(), names(), starts(), delays(),
+      given(NUM_GROUPS, false), sentOnce(NUM_GROUPS, false),
+      ledsChanged(false)
+{
+    makeLayout();
+
+    const unsigned int n = actuators.size();
+    next.resize(n, 0.0f);
+    sent.resize(n, 0.0f);
+    nextLeds.resize(groupStart(ULTRASOUND_GROUP) - LEDS, 0.0f);
+
+    // The LEDs are all set the first time, as they are on a new NaoLights
+    for (unsigned int g = FIRST_LED_GROUP; g < ULTRASOUND_GROUP; ++g) {
+        given[g] = true;
+    }
+
+    pthread_mutex_init(&leds_mutex, NULL);
+}
+
+DCMCommandBuilder::~DCMCommandBuilder()
+{
+    pthread_mutex_destroy(&leds_mutex);
+}
+
+/**
+ * Lays out the groups: joints, stiffnesses, each LED group, ultrasound.
+ * The aliases are named as NaoEnactor and NaoRGBLight named them.
+ */
+void DCMCommandBuilder::makeLayout()
+{
+    addGroup("AllActuatorPosition", JOINT_DELAY_MS);
+    for (unsigned int i = 0; i < Kinematics::NUM_JOINTS; ++i) {
+        actuators.push_back(ALNames::jointsP[i]);
+    }
+    addGroup("AllActuatorHardness", STIFFNESS_DELAY_MS);
+    for (unsigned int i = 0; i < Kinematics::NUM_JOINTS; ++i) {
+        actuators.push_back(ALNames::jointsH[i]);
+    }
+
+    for (unsigned int led = 0; led < ALNames::NUM_UNIQUE_LEDS; ++led) {
+        addGroup(Lights::LED_NAMES[led], LED_DELAY_MS);
+        const unsigned int colors = ALNames::LED_END_COLOR[led] -
+            ALNames::LED_START_COLOR[led];
+        const unsigned int leds = ALNames::NUM_RGB_LEDS[led] * colors;
+        for (unsigned int i = 0; i < leds; ++i) {
+            actuators.push_back(ALNames::RGB_LED_STRINGS[led][i]);
+        }
+    }
+
+    addGroup("US/Actuator/Value", US_DELAY_MS);
+    actuators.push_back("US/Actuator/Value");
+
+    starts.push_back(actuators.size());
+}
+
+void DCMCommandBuilder::addGroup(const string &name, int delay)
+{
+    names.push_back(name);
+    starts.push_back(actuators.size());
+    delays.push_back(delay);
+}
+
+void DCMCommandBuilder::setJoints(const vector<float> &joints)
+{
+    for (unsigned int i = 0; i < Kinematics::NUM_JOINTS; ++i) {
+        next[JOINT_POSITIONS + i] = joints[i];
+    }
+    given[JOINT_GROUP] = true;
+}
+
+void DCMCommandBuilder::setStiffnesses(const vector<float> &stiffnesses)
+{
+    for (unsigned int i = 0; i < Kinematics::NUM_JOINTS; ++i) {
+        next[JOINT_STIFFNESSES + i] =
+            NBMath::clip(stiffnesses[i], -1.0f, 1.0f);
+    }
+    given[STIFFNESS_GROUP] = true;
+}
+
+void DCMCommandBuilder::setUltraSound(float mode)
+{
+    next[ultraSoundIndex()] = mode;
+    given[ULTRASOUND_GROUP] = true;
+}
+
+void DCMCommandBuilder::setLeds(unsigned int led, const float *values)
+{
+    const unsigned int start = ledGroupStart(led) - LEDS;
+    const unsigned int size = ledGroupSize(led);
+
+    pthread_mutex_lock(&leds_mutex);
+    for (unsigned int i = 0; i < size; ++i) {
+        nextLeds[start + i] = values[i];
+    }
+    ledsChanged = true;
+    pthread_mutex_unlock(&leds_mutex);
+}
+
+unsigned int DCMCommandBuilder::flush(DCMSender &dcm)
+{
+    pthread_mutex_lock(&leds_mutex);
+    if (ledsChanged) {
+        for (unsigned int i = 0; i < nextLeds.size(); ++i) {
+            next[LEDS + i] = nextLeds[i];
+        }
+        ledsChanged = false;
+    }
+    pthread_mutex_unlock(&leds_mutex);
+
+    unsigned int commands = 0;
+    int now = 0;
+    for (unsigned int g = 0; g < NUM_GROUPS; ++g) {
+        if (!given[g]) {
+            continue;
+        }
+
+        const unsigned int start = starts[g];
+        const unsigned int end = starts[g + 1];
+        bool changed = !sentOnce[g];
+        for (unsigned int i = start; i < end && !changed; ++i) {
+            changed = next[i] != sent[i];
+        }
+        if (!changed) {
+            continue;
+        }
+
+        // One time for the whole cycle, asked for only when it is needed
+        if (commands == 0) {
+            now = dcm.getTime(0);
+        }
+        for (unsigned int i = start; i < end; ++i) {
+            sent[i] = next[i];
+        }
+        sentOnce[g] = true;
+        dcm.send(g, &next[start], now + delays[g]);
+        ++commands;
+    }
+    return commands;
+}
@@ -0,0 +1,135 @@
+#ifndef DCMCommandBuilder_h_DEFINED
+#define DCMCommandBuilder_h_DEFINED
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+#include "ALLedNames.h"
+#include "Kinematics.h"
+
+/**
+ * Whatever takes the builder's commands to the DCM: NaoDCMSender on the
+ * robot, or something that just counts them.
+ */
+class DCMSender
+{
+public:
+    virtual ~DCMSender() { }
+
+    // The DCM's time, in ms, offset ms from now
+    virtual int getTime(int offset) = 0;
+
+    // Sends every actuator of one of DCMCommandBuilder's groups, to reach
+    // values (in the group's order) at time
+    virtual void send(unsigned int group, const float *values, int time) = 0;
+};
+
+/**
+ * Collects everything the enactor and the lights send to the DCM in a
+ * cycle, and at the end of it sends only the groups that differ from what
+ * was sent last. A cycle where nothing changes sends nothing at all.
+ *
+ * Each group is one command, as NaoEnactor and NaoLights sent them on
+ * their own: the joint positions, the joint stiffnesses and each LED group
+ * are an alias each, sent whole with "ClearAll", and the ultrasound mode
+ * is its own actuator. The layout is fixed when the builder is made; the
+ * actuators of every group are also numbered in one list, joint positions
+ * first, then stiffnesses, then the LED groups (a color channel at a time,
+ * for every LED of the group), and the ultrasound last.
+ *
+ * The lights are set from the vision thread and everything else, including
+ * flush(), from the DCM's; setLeds() only holds a lock long enough to copy
+ * the values.
+ */
+class DCMCommandBuilder
+{
+public:
+    DCMCommandBuilder();
+    ~DCMCommandBuilder();
+
+    static const unsigned int JOINT_GROUP = 0;
+    static const unsigned int STIFFNESS_GROUP = 1;
+    static const unsigned int FIRST_LED_GROUP = 2;
+    static const unsigned int ULTRASOUND_GROUP =
+        FIRST_LED_GROUP + ALNames::NUM_UNIQUE_LEDS;
+    static const unsigned int NUM_GROUPS = ULTRASOUND_GROUP + 1;
+
+    // Where each kind of actuator starts in the list of all of them
+    static const unsigned int JOINT_POSITIONS = 0;
+    static const unsigned int JOINT_STIFFNESSES = Kinematics::NUM_JOINTS;
+    static const unsigned int LEDS = 2 * Kinematics::NUM_JOINTS;
+
+    // How far ahead of the DCM's time each kind of command is sent, in ms.
+    // The joints' delay removes the jitter; 20 ms works better than less.
+    static const int JOINT_DELAY_MS = 20;
+    static const int STIFFNESS_DELAY_MS = 0;
+    static const int LED_DELAY_MS = 20;
+    static const int US_DELAY_MS = 250;
+
+    // Every actuator name, in order
+    const std::vector<std::string>& getActuators() const { return actuators; }
+    unsigned int numActuators() const { return actuators.size(); }
+
+    // The alias (or for the ultrasound, actuator) name of a group, and
+    // where its actuators start in the list and how many it has
+    const std::string& groupName(unsigned int group) const {
+        return names[group];
+    }
+    unsigned int groupStart(unsigned int group) const {
+        return starts[group];
+    }
+    unsigned int groupSize(unsigned int group) const {
+        return starts[group + 1] - starts[group];
+    }
+    int groupDelay(unsigned int group) const { return delays[group]; }
+
+    // An LED group, by its ALNames number
+    unsigned int ledGroupStart(unsigned int led) const {
+        return groupStart(FIRST_LED_GROUP + led);
+    }
+    unsigned int ledGroupSize(unsigned int led) const {
+        return groupSize(FIRST_LED_GROUP + led);
+    }
+    unsigned int ultraSoundIndex() const { return actuators.size() - 1; }
+
+    void setJoints(const std::vector<float> &joints);
+    // Clipped to [-1, 1]
+    void setStiffnesses(const std::vector<float> &stiffnesses);
+    void setUltraSound(float mode);
+    // values holds ledGroupSize(led) values, in the group's order
+    void setLeds(unsigned int led, const float *values);
+
+    // Sends the groups that have changed since the last flush, if any;
+    // returns the number of commands sent
+    unsigned int flush(DCMSender &dcm);
+
+private:
+    // Not copyable
+    DCMCommandBuilder(const DCMCommandBuilder &other);
+    DCMCommandBuilder& operator=(const DCMCommandBuilder &other);
+
+    void makeLayout();
+    void addGroup(const std::string &name, int delay);
+
+private:
+    std::vector<std::string> actuators;
+    std::vector<std::string> names;
+    // One more than there are groups, so the last ends the last group
+    std::vector<unsigned int> starts;
+    std::vector<int> delays;
+
+    // What we want each actuator at, and what it was last sent
+    std::vector<float> next;
+    std::vector<float> sent;
+    // Whether a group has been set at all, and whether it has been sent
+    std::vector<char> given;
+    std::vector<char> sentOnce;
+
+    // Set from the vision thread and copied into next by flush()
+    std::vector<float> nextLeds;
+    bool ledsChanged;
+    pthread_mutex_t leds_mutex;
+};
+
+#endif // DCMCommandBuilder_h_DEFINED
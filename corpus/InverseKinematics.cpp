@@ -76,6 +76,27 @@ const Kinematics::IKLegResult
 
 }
 
+const Kinematics::IKLegPairResult
+Kinematics::legIKPair(const IKLegPairGoal &goal){
+    static const ChainID chainIDs[NUM_IK_LEGS] = {LLEG_CHAIN, RLEG_CHAIN};
+    static const float noHYP[NUM_IK_LEGS] = {HYP_NOT_SET, HYP_NOT_SET};
+
+    IKLegPairResult result;
+    analyticLegsIK(NUM_IK_LEGS, chainIDs, goal.footGoal,
+                   goal.footOrientation, goal.bodyGoal, goal.bodyOrientation,
+                   noHYP, result.leg);
+
+    for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+        if(result.leg[leg].outcome != Kinematics::SUCCESS){
+            cout << "IK ERROR with leg"<<chainIDs[leg] <<" :"
+                 <<"    tried to put foot to "<<goal.footGoal[0][leg]
+                 <<", "<<goal.footGoal[1][leg]<<", "<<goal.footGoal[2][leg]
+                 <<endl;
+        }
+    }
+    return result;
+}
+
 /**
  * This method will destructively clip the chain angles that are passed to it.
  * This means that it will modify the array that was passed by reference
@@ -154,123 +175,79 @@ const float Kinematics::getMaxValue(const ChainID id, const int jointNumber) {
     return 0;
 }
 
-const ufvector3 Kinematics::forwardKinematics(const ChainID id,
-                                              const float angles[]){
-    float x=0.0f,y=0.0f,z=0.0f;
-    if(id == LLEG_CHAIN || id == RLEG_CHAIN||
-       id == LANKLE_CHAIN || id == RANKLE_CHAIN){
-        const float HYP = angles[0];
-        const float HR = angles[1];
-        const float HP = angles[2];
-        const float KP = angles[3];
-        const float AP = angles[4];
-        const float AR = angles[5];
-
-        float sinHYP,cosHYP,sinHR,cosHR,sinHP,cosHP,sinKP,cosKP,sinAP,cosAP,sinAR,cosAR;
-        sincosf(HYP,&sinHYP,&cosHYP);
-        sincosf(HR,&sinHR,&cosHR);
-        sincosf(HP,&sinHP,&cosHP);
-        sincosf(KP,&sinKP,&cosKP);
-        sincosf(AP,&sinAP,&cosAP);
-        sincosf(AR,&sinAR,&cosAR);
-
-        //Other odd angles:
-        const float cosHRPlusPiFourth = std::cos(HR+M_PI_FLOAT*0.25f);
-        const float cosHRMinusPiFourth = std::cos(HR-M_PI_FLOAT*0.25f);
-        const float sinHRPlusPiFourth = std::sin(HR+M_PI_FLOAT*0.25f);
-        const float sinHRMinusPiFourth = std::sin(HR-M_PI_FLOAT*0.25f);
-        const float sqrt2 = std::sqrt(2.0f);
-
-        switch(id){
-        case LLEG_CHAIN:
-            x = -THIGH_LENGTH*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)-TIBIA_LENGTH*(cosKP*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRPlusPiFourth*sinHP*sinHYP)*sinKP)-FOOT_HEIGHT*(cosAR*(sinAP*(cosKP*(cosHP*cosHYP-cosHRPlusPiFourth*sinHP*sinHYP)-(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)*sinKP)+cosAP*(cosKP*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRPlusPiFourth*sinHP*sinHYP)*sinKP))-sinAR*sinHYP*sinHRPlusPiFourth);
-            y = HIP_OFFSET_Y-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2)))-FOOT_HEIGHT*(-sinAR*(cosHRPlusPiFourth/sqrt2+(cosHYP*sinHRPlusPiFourth)/sqrt2)+cosAR*(sinAP*(-sinKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))+cosKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2)))+cosAP*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2)))));
-            z = -HIP_OFFSET_Z-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2)))-FOOT_HEIGHT*(-sinAR*(-cosHRPlusPiFourth/sqrt2+(cosHYP*sinHRPlusPiFourth)/sqrt2)+cosAR*(sinAP*(-sinKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))+cosKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2)))+cosAP*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2)))));
-            break;
-        case LANKLE_CHAIN:
-            x = -THIGH_LENGTH*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)-TIBIA_LENGTH*(cosKP*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRPlusPiFourth*sinHP*sinHYP)*sinKP);
-            y = HIP_OFFSET_Y-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2)));
-            z = -HIP_OFFSET_Z-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2)));
-            break;
-        case RLEG_CHAIN:
-            x = -THIGH_LENGTH*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)-TIBIA_LENGTH*(cosKP*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRMinusPiFourth*sinHP*sinHYP)*sinKP)-FOOT_HEIGHT*(cosAR*(sinAP*(cosKP*(cosHP*cosHYP-cosHRMinusPiFourth*sinHP*sinHYP)-(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)*sinKP)+cosAP*(cosKP*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRMinusPiFourth*sinHP*sinHYP)*sinKP))-sinAR*sinHYP*sinHRMinusPiFourth);
-            y = -HIP_OFFSET_Y-THIGH_LENGTH*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*((cosHP*sinHYP)/sqrt2-sinHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))-FOOT_HEIGHT*(-sinAR*(cosHRMinusPiFourth/sqrt2-(cosHYP*sinHRMinusPiFourth)/sqrt2)+cosAR*(sinAP*(-sinKP*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+cosKP*((cosHP*sinHYP)/sqrt2-sinHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))+cosAP*(cosKP*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*((cosHP*sinHYP)/sqrt2-sinHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))));
-            z = -HIP_OFFSET_Z-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))-FOOT_HEIGHT*(-sinAR*(cosHRMinusPiFourth/sqrt2+(cosHYP*sinHRMinusPiFourth)/sqrt2)+cosAR*(sinAP*(-sinKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+cosKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))+cosAP*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))));
-            break;
-        case RANKLE_CHAIN:
-            x = -THIGH_LENGTH*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)-TIBIA_LENGTH*(cosKP*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRMinusPiFourth*sinHP*sinHYP)*sinKP);
-            y = -HIP_OFFSET_Y-THIGH_LENGTH*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*((cosHP*sinHYP)/sqrt2-sinHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)));
-            z = -HIP_OFFSET_Z-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)));
-            break;
-        case LARM_CHAIN:
-        case RARM_CHAIN:
-        case HEAD_CHAIN:
-            throw "Should not be possible";
-        }
+/**
+ * Sines and cosines of a leg's joint angles. The forward kinematics and the
+ * Jacobians are both written in terms of these, so dls works them out once
+ * per iteration and uses them for both.
+ */
+Kinematics::LegTrig::LegTrig(const float angles[])
+{
+    const float HR = angles[1];
+    sincosf(angles[0],&sinHYP,&cosHYP);
+    sincosf(angles[2],&sinHP,&cosHP);
+    sincosf(angles[3],&sinKP,&cosKP);
+    sincosf(angles[4],&sinAP,&cosAP);
+    sincosf(angles[5],&sinAR,&cosAR);
 
+    //Other odd angles:
+    sincosf(HR+M_PI_FLOAT*0.25f,&sinHRPlusPiFourth,&cosHRPlusPiFourth);
+    sincosf(HR-M_PI_FLOAT*0.25f,&sinHRMinusPiFourth,&cosHRMinusPiFourth);
+}
 
-    }else if( id == LARM_CHAIN || id == RARM_CHAIN ){
-        // Variables for arms.
-        const float SP = angles[0];
-        const float SR = angles[1];
-        const float EY = angles[2];
-        const float ER = angles[3];
+const ufvector3 Kinematics::legForwardKinematics(const ChainID id,
+                                                 const LegTrig &t){
+    const float sinHYP = t.sinHYP, cosHYP = t.cosHYP;
+    const float sinHP = t.sinHP, cosHP = t.cosHP;
+    const float sinKP = t.sinKP, cosKP = t.cosKP;
+    const float sinAP = t.sinAP, cosAP = t.cosAP;
+    const float sinAR = t.sinAR, cosAR = t.cosAR;
+    const float cosHRPlusPiFourth = t.cosHRPlusPiFourth;
+    const float cosHRMinusPiFourth = t.cosHRMinusPiFourth;
+    const float sinHRPlusPiFourth = t.sinHRPlusPiFourth;
+    const float sinHRMinusPiFourth = t.sinHRMinusPiFourth;
+    const float sqrt2 = std::sqrt(2.0f);
 
-        float sinSP, cosSP, sinSR, cosSR, sinEY, cosEY, sinER, cosER;
-		sincosf(SP, &sinSP, &cosSP);
-		sincosf(SR, &sinSR, &cosSR);
-		sincosf(EY, &sinEY, &cosEY);
-		sincosf(ER, &sinER, &cosER);
-        switch(id){
-        case LARM_CHAIN:
-            x = LOWER_ARM_LENGTH*sinER*sinEY*sinSP + cosSP*((UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*cosSR - LOWER_ARM_LENGTH*cosEY*sinER*sinSR);
-            y = SHOULDER_OFFSET_Y + LOWER_ARM_LENGTH*cosEY*cosSR*sinER + (UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*sinSR;
-            z = SHOULDER_OFFSET_Z + LOWER_ARM_LENGTH*cosSP*sinER*sinEY - (UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*cosSR*sinSP + LOWER_ARM_LENGTH*cosEY*sinER*sinSP*sinSR;
-            break;
-        case RARM_CHAIN:
-            x = LOWER_ARM_LENGTH*sinER*sinEY*sinSP + cosSP* ((UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*cosSR - LOWER_ARM_LENGTH*cosEY*sinER*sinSR);
-            y = - SHOULDER_OFFSET_Y + LOWER_ARM_LENGTH*cosEY*cosSR*sinER + (UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*sinSR;
-            z = SHOULDER_OFFSET_Z + LOWER_ARM_LENGTH*cosSP*sinER*sinEY - (UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*cosSR*sinSP + LOWER_ARM_LENGTH*cosEY*sinER*sinSP*sinSR;
-            break;
-        case LLEG_CHAIN:
-        case RLEG_CHAIN:
-        case RANKLE_CHAIN:
-        case LANKLE_CHAIN:
-        case HEAD_CHAIN:
-            throw "Should not be a possible chain id";
-        }
-    }else if(id == HEAD_CHAIN){
-        x = 0.0f;
-        y = 0.0f;
-        z = NECK_OFFSET_Z;
-    }else
-        throw "Invalid chain name in InverseKinematics";
+    float x=0.0f,y=0.0f,z=0.0f;
+    switch(id){
+    case LLEG_CHAIN:
+        x = -THIGH_LENGTH*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)-TIBIA_LENGTH*(cosKP*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRPlusPiFourth*sinHP*sinHYP)*sinKP)-FOOT_HEIGHT*(cosAR*(sinAP*(cosKP*(cosHP*cosHYP-cosHRPlusPiFourth*sinHP*sinHYP)-(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)*sinKP)+cosAP*(cosKP*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRPlusPiFourth*sinHP*sinHYP)*sinKP))-sinAR*sinHYP*sinHRPlusPiFourth);
+        y = HIP_OFFSET_Y-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2)))-FOOT_HEIGHT*(-sinAR*(cosHRPlusPiFourth/sqrt2+(cosHYP*sinHRPlusPiFourth)/sqrt2)+cosAR*(sinAP*(-sinKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))+cosKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2)))+cosAP*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2)))));
+        z = -HIP_OFFSET_Z-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2)))-FOOT_HEIGHT*(-sinAR*(-cosHRPlusPiFourth/sqrt2+(cosHYP*sinHRPlusPiFourth)/sqrt2)+cosAR*(sinAP*(-sinKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))+cosKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2)))+cosAP*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2)))));
+        break;
+    case LANKLE_CHAIN:
+        x = -THIGH_LENGTH*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)-TIBIA_LENGTH*(cosKP*(cosHYP*sinHP+cosHP*cosHRPlusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRPlusPiFourth*sinHP*sinHYP)*sinKP);
+        y = HIP_OFFSET_Y-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2-sinHRPlusPiFourth/sqrt2)));
+        z = -HIP_OFFSET_Z-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRPlusPiFourth)/sqrt2+sinHRPlusPiFourth/sqrt2)));
+        break;
+    case RLEG_CHAIN:
+        x = -THIGH_LENGTH*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)-TIBIA_LENGTH*(cosKP*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRMinusPiFourth*sinHP*sinHYP)*sinKP)-FOOT_HEIGHT*(cosAR*(sinAP*(cosKP*(cosHP*cosHYP-cosHRMinusPiFourth*sinHP*sinHYP)-(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)*sinKP)+cosAP*(cosKP*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRMinusPiFourth*sinHP*sinHYP)*sinKP))-sinAR*sinHYP*sinHRMinusPiFourth);
+        y = -HIP_OFFSET_Y-THIGH_LENGTH*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*((cosHP*sinHYP)/sqrt2-sinHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))-FOOT_HEIGHT*(-sinAR*(cosHRMinusPiFourth/sqrt2-(cosHYP*sinHRMinusPiFourth)/sqrt2)+cosAR*(sinAP*(-sinKP*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+cosKP*((cosHP*sinHYP)/sqrt2-sinHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))+cosAP*(cosKP*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*((cosHP*sinHYP)/sqrt2-sinHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))));
+        z = -HIP_OFFSET_Z-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))-FOOT_HEIGHT*(-sinAR*(cosHRMinusPiFourth/sqrt2+(cosHYP*sinHRMinusPiFourth)/sqrt2)+cosAR*(sinAP*(-sinKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+cosKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))+cosAP*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)))));
+        break;
+    case RANKLE_CHAIN:
+        x = -THIGH_LENGTH*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)-TIBIA_LENGTH*(cosKP*(cosHYP*sinHP+cosHP*cosHRMinusPiFourth*sinHYP)+(cosHP*cosHYP-cosHRMinusPiFourth*sinHP*sinHYP)*sinKP);
+        y = -HIP_OFFSET_Y-THIGH_LENGTH*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*((sinHP*sinHYP)/sqrt2+cosHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*((cosHP*sinHYP)/sqrt2-sinHP*(-(cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)));
+        z = -HIP_OFFSET_Z-THIGH_LENGTH*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))-TIBIA_LENGTH*(cosKP*(-(sinHP*sinHYP)/sqrt2+cosHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2))+sinKP*(-(cosHP*sinHYP)/sqrt2-sinHP*((cosHYP*cosHRMinusPiFourth)/sqrt2-sinHRMinusPiFourth/sqrt2)));
+        break;
+    case LARM_CHAIN:
+    case RARM_CHAIN:
+    case HEAD_CHAIN:
+        throw "Should not be possible";
+    }
     return CoordFrame3D::vector3D(x,y,z);
 }
 
-
-const ufmatrix3 Kinematics::buildJacobians(const ChainID id,
-                               const float angles[]){
-    const float HYP = angles[0];
-    const float HR = angles[1];
-    const float HP = angles[2];
-    const float KP = angles[3];
-    const float AP = angles[4];
-    const float AR = angles[5];
-
-    float sinHYP,cosHYP,sinHR,cosHR,sinHP,cosHP,sinKP,cosKP,sinAP,cosAP,sinAR,cosAR;
-    sincosf(HYP,&sinHYP,&cosHYP);
-    sincosf(HR,&sinHR,&cosHR);
-    sincosf(HP,&sinHP,&cosHP);
-    sincosf(KP,&sinKP,&cosKP);
-    sincosf(AP,&sinAP,&cosAP);
-    sincosf(AR,&sinAR,&cosAR);
-
-    //Other odd angles:
-    const float cosHRPlusPiFourth = std::cos(HR+M_PI_FLOAT*0.25f);
-    const float cosHRMinusPiFourth = std::cos(HR-M_PI_FLOAT*0.25f);
-    const float sinHRPlusPiFourth = std::sin(HR+M_PI_FLOAT*0.25f);
-    const float sinHRMinusPiFourth = std::sin(HR-M_PI_FLOAT*0.25f);
+const ufmatrix3 Kinematics::legJacobian(const ChainID id,
+                                        const LegTrig &t){
+    const float sinHYP = t.sinHYP, cosHYP = t.cosHYP;
+    const float sinHP = t.sinHP, cosHP = t.cosHP;
+    const float sinKP = t.sinKP, cosKP = t.cosKP;
+    const float sinAP = t.sinAP, cosAP = t.cosAP;
+    const float sinAR = t.sinAR, cosAR = t.cosAR;
+    const float cosHRPlusPiFourth = t.cosHRPlusPiFourth;
+    const float cosHRMinusPiFourth = t.cosHRMinusPiFourth;
+    const float sinHRPlusPiFourth = t.sinHRPlusPiFourth;
+    const float sinHRMinusPiFourth = t.sinHRMinusPiFourth;
     const float sqrt2 = std::sqrt(2.0f);
     if( id == LANKLE_CHAIN){
 //Jacobians
@@ -343,6 +320,57 @@ const ufmatrix3 Kinematics::buildJacobians(const ChainID id,
         throw "Not a valid chain to get a jacobian from";
 }
 
+const ufvector3 Kinematics::forwardKinematics(const ChainID id,
+                                              const float angles[]){
+    float x=0.0f,y=0.0f,z=0.0f;
+    if(id == LLEG_CHAIN || id == RLEG_CHAIN||
+       id == LANKLE_CHAIN || id == RANKLE_CHAIN){
+        return legForwardKinematics(id, LegTrig(angles));
+    }else if( id == LARM_CHAIN || id == RARM_CHAIN ){
+        // Variables for arms.
+        const float SP = angles[0];
+        const float SR = angles[1];
+        const float EY = angles[2];
+        const float ER = angles[3];
+
+        float sinSP, cosSP, sinSR, cosSR, sinEY, cosEY, sinER, cosER;
+		sincosf(SP, &sinSP, &cosSP);
+		sincosf(SR, &sinSR, &cosSR);
+		sincosf(EY, &sinEY, &cosEY);
+		sincosf(ER, &sinER, &cosER);
+        switch(id){
+        case LARM_CHAIN:
+            x = LOWER_ARM_LENGTH*sinER*sinEY*sinSP + cosSP*((UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*cosSR - LOWER_ARM_LENGTH*cosEY*sinER*sinSR);
+            y = SHOULDER_OFFSET_Y + LOWER_ARM_LENGTH*cosEY*cosSR*sinER + (UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*sinSR;
+            z = SHOULDER_OFFSET_Z + LOWER_ARM_LENGTH*cosSP*sinER*sinEY - (UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*cosSR*sinSP + LOWER_ARM_LENGTH*cosEY*sinER*sinSP*sinSR;
+            break;
+        case RARM_CHAIN:
+            x = LOWER_ARM_LENGTH*sinER*sinEY*sinSP + cosSP* ((UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*cosSR - LOWER_ARM_LENGTH*cosEY*sinER*sinSR);
+            y = - SHOULDER_OFFSET_Y + LOWER_ARM_LENGTH*cosEY*cosSR*sinER + (UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*sinSR;
+            z = SHOULDER_OFFSET_Z + LOWER_ARM_LENGTH*cosSP*sinER*sinEY - (UPPER_ARM_LENGTH + LOWER_ARM_LENGTH*cosER)*cosSR*sinSP + LOWER_ARM_LENGTH*cosEY*sinER*sinSP*sinSR;
+            break;
+        case LLEG_CHAIN:
+        case RLEG_CHAIN:
+        case RANKLE_CHAIN:
+        case LANKLE_CHAIN:
+        case HEAD_CHAIN:
+            throw "Should not be a possible chain id";
+        }
+    }else if(id == HEAD_CHAIN){
+        x = 0.0f;
+        y = 0.0f;
+        z = NECK_OFFSET_Z;
+    }else
+        throw "Invalid chain name in InverseKinematics";
+    return CoordFrame3D::vector3D(x,y,z);
+}
+
+
+const ufmatrix3 Kinematics::buildJacobians(const ChainID id,
+                               const float angles[]){
+    return legJacobian(id, LegTrig(angles));
+}
+
 const bool Kinematics::adjustAnkle(const ChainID chainID,
                                    const ufvector3 &goal,
                                    float startAngles[],
@@ -359,14 +387,9 @@ const bool Kinematics::adjustAnkle(const ChainID chainID,
 
     while (iterations < maxAnkleIterations) {
         iterations++;
-        // Define the Jacobian that describes the linear approximation at the
-        // current angle values.
-        const ufmatrix3 j = buildJacobians(ankleChainID, startAngles);
-        const ufmatrix3 j_t = trans(j);
-
+        const LegTrig trig(startAngles);
         const ufvector3 currentAnklePosition =
-            forwardKinematics(ankleChainID,
-                              startAngles);
+            legForwardKinematics(ankleChainID, trig);
         const ufvector3 e = goal - currentAnklePosition;
 
         // Check if we have gotten close enough
@@ -375,6 +398,11 @@ const bool Kinematics::adjustAnkle(const ChainID chainID,
         if (dist_e < maxError)
             return true;
 
+        // Define the Jacobian that describes the linear approximation at the
+        // current angle values.
+        const ufmatrix3 j = legJacobian(ankleChainID, trig);
+        const ufmatrix3 j_t = trans(j);
+
         ufmatrix3 temp = prod(j, j_t);
         temp += dampenMatrix;
         // Now we need to find a vector that we'll call 'result' such that
@@ -404,8 +432,6 @@ const bool Kinematics::adjustHeel(const ChainID chainID,
                                   const ufvector3 &goal,
                                   float startAngles[],
                                   const float maxError = .1) {
-    ChainID ankleChainID = (chainID == LLEG_CHAIN ?
-                            LANKLE_CHAIN : RANKLE_CHAIN);
     const ufmatrix3 dampenMatrix =
         ublas::identity_matrix<float> (3)*(dampFactor*dampFactor);
 
@@ -414,18 +440,18 @@ const bool Kinematics::adjustHeel(const ChainID chainID,
 
     while (iterations < maxHeelIterations) {
         iterations++;
-        const ufmatrix3 jHeel =
-            buildJacobians(chainID, startAngles);
-        const ufmatrix3 jHeel_t = trans(jHeel);
-
+        const LegTrig trig(startAngles);
         const ufvector3 currentHeelPosition =
-            forwardKinematics(chainID,startAngles);
+            legForwardKinematics(chainID, trig);
         const ufvector3 eHeel = goal - currentHeelPosition;
 
         dist_e_heel = norm_2(eHeel);
         if (dist_e_heel < maxError)
             return true;
 
+        const ufmatrix3 jHeel = legJacobian(chainID, trig);
+        const ufmatrix3 jHeel_t = trans(jHeel);
+
         ufmatrix3 temp = prod(jHeel, jHeel_t);
         temp += dampenMatrix;
 
@@ -465,6 +491,25 @@ Kinematics::dls(const ChainID chainID,
     float currentAngles[LEG_JOINTS];
     memcpy(currentAngles, startAngles, LEG_JOINTS*sizeof(float));
 
+    // Warm start from the analytic solution for a flat foot, keeping our
+    // HYP. If the goal is in reach that already puts the heel on it and
+    // there is nothing left to iterate on; otherwise we start from whichever
+    // of it and startAngles gets closer.
+    const ufvector3 zero = CoordFrame3D::vector3D(0.0f,0.0f,0.0f);
+    IKLegResult analytic = analyticLegIK(chainID, goal, zero, zero, zero,
+                                         startAngles[0]);
+    clipChainAngles(chainID, analytic.angles);
+    const float analyticError =
+        norm_2(goal - forwardKinematics(chainID, analytic.angles));
+    if (analyticError < maxError) {
+        analytic.outcome = SUCCESS;
+        return analytic;
+    }
+    if (analyticError <
+        norm_2(goal - forwardKinematics(chainID, currentAngles))) {
+        memcpy(currentAngles, analytic.angles, LEG_JOINTS*sizeof(float));
+    }
+
     // The optimization method hits a singularity if the leg is perfectly
     // straight, so we can virtually bend the knee .3 radians and go around
     // that.
@@ -523,198 +568,258 @@ const Kinematics::IKLegResult Kinematics::analyticLegIK(const ChainID chainID,
                                       const ufvector3 &bodyOrientation,
                                       const float givenHYPAngle)
 {
-    bool success = true;
-#ifdef DEBUG_ANA
-    cout << "anaIK inputs:"<<endl
-         <<"  footGoal: "<<footGoal<<endl
-         <<"  footOrientation: "<<footOrientation<<endl
-         <<"  bodyGoal: "<<bodyGoal<<endl
-         <<"  bodyOrientation: "<<bodyOrientation<<endl
-         <<"  HYP Angle: " <<givenHYPAngle<<endl;
-#endif
-    //fo - translate from f to o
-    const ufmatrix4 fo_Transform = CoordFrame4D::get6DTransform(footGoal(0),
-                                                footGoal(1),footGoal(2),
-                                                footOrientation(0),
-                                                footOrientation(1),
-                                                footOrientation(2));
-    //co - translate from c to o
-    const ufmatrix4 co_Transform = CoordFrame4D::get6DTransform(bodyGoal(0),
-                                                bodyGoal(1),bodyGoal(2),
-                                                bodyOrientation(0),
-                                                bodyOrientation(1),
-                                                bodyOrientation(2));
-#ifdef DEBUG_ANA
-    cout << "fo_Transform: "<<endl<< "  "<<fo_Transform<<endl;
-    cout << "co_Transform: "<<endl<< "  "<<co_Transform<<endl;
-#endif
-    //fc - translate from f to o to c
-    const ufmatrix4 fc_Transform =
-        prod(CoordFrame4D::invertHomogenous(co_Transform),fo_Transform);
-
-    //cf - translate from c to o to f
-    const ufmatrix4 cf_Transform =
-        prod(CoordFrame4D::invertHomogenous(fo_Transform),co_Transform);
-
-#ifdef DEBUG_ANA
-    cout << "cf_Transform: "<<endl<< "  "<<cf_Transform<<endl;
-    cout << "fc_Transform: "<<endl<< "  "<<fc_Transform<<endl;
-#endif
+    float footGoals[3][NUM_IK_LEGS];
+    float footOrientations[3][NUM_IK_LEGS];
+    float body[3], bodyRot[3];
+    for (int i = 0; i < 3; ++i) {
+        footGoals[i][0] = footGoal(i);
+        footOrientations[i][0] = footOrientation(i);
+        body[i] = bodyGoal(i);
+        bodyRot[i] = bodyOrientation(i);
+    }
 
-    const float leg_sign = (chainID == LLEG_CHAIN ? 1.0f : -1.0f);
+    IKLegResult result;
+    analyticLegsIK(1, &chainID, footGoals, footOrientations, body, bodyRot,
+                   &givenHYPAngle, &result);
+    return result;
+}
 
-    //The location of the hip rotation center in the C frame
-    const ufvector4 hipOffset_c = CoordFrame4D::vector4D(0.0f,
-                                                         leg_sign*HIP_OFFSET_Y,
-                                                         -HIP_OFFSET_Z);
-    const ufvector4 ankleOffset_f =CoordFrame4D::vector4D(0.0f,
-                                                          0.0f,
-                                                          FOOT_HEIGHT);
+/**
+ * The fixed size solver behind analyticLegIK and legIKPair. It follows the
+ * frames described above, but on plain floats instead of ublas 4x4
+ * matrices, and since the body pose is shared by all the legs its rotation
+ * is only found once.
+ *
+ * Only the rotations of the transforms are kept: cf_Rot = fo_Rot^T*co_Rot,
+ * and fc_Rot is its transpose. The translations are applied by hand.
+ */
+void Kinematics::analyticLegsIK(const int numLegs,
+                                const ChainID chainIDs[],
+                                const float footGoal[][NUM_IK_LEGS],
+                                const float footOrientation[][NUM_IK_LEGS],
+                                const float bodyGoal[],
+                                const float bodyOrientation[],
+                                const float givenHYPAngles[],
+                                IKLegResult result[])
+{
+    const float sqrt2 = std::sqrt(2.0f);
 
-    //Find the location of the hip in the F frame that is shifted
-    //to the ankle from the bottom of the foot
-    const ufvector4 hipPosition_fprime =
-        prod(cf_Transform,hipOffset_c) - ankleOffset_f;
+    //co - rotation from c to o
+    float co_Rot[3][3];
+    rotation6D(bodyOrientation[0], bodyOrientation[1], bodyOrientation[2],
+               co_Rot);
 
+    for (int leg = 0; leg < numLegs; ++leg) {
+        bool success = true;
 #ifdef DEBUG_ANA
-    cout<< "Hip position in fprime: "<< hipPosition_fprime<<endl;
+        cout << "anaIK inputs for leg " << chainIDs[leg] << ":" << endl
+             << "  footGoal: " << footGoal[0][leg] << ", "
+             << footGoal[1][leg] << ", " << footGoal[2][leg] << endl
+             << "  footOrientation: " << footOrientation[0][leg] << ", "
+             << footOrientation[1][leg] << ", " << footOrientation[2][leg]
+             << endl
+             << "  bodyGoal: " << bodyGoal[0] << ", " << bodyGoal[1] << ", "
+             << bodyGoal[2] << endl
+             << "  bodyOrientation: " << bodyOrientation[0] << ", "
+             << bodyOrientation[1] << ", " << bodyOrientation[2] << endl
+             << "  HYP Angle: " << givenHYPAngles[leg] << endl;
 #endif
+        //fo - rotation from f to o
+        float fo_Rot[3][3];
+        rotation6D(footOrientation[0][leg], footOrientation[1][leg],
+                   footOrientation[2][leg], fo_Rot);
+
+        //cf - rotation from c to o to f
+        float cf_Rot[3][3];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                cf_Rot[i][j] = fo_Rot[0][i]*co_Rot[0][j] +
+                    fo_Rot[1][i]*co_Rot[1][j] +
+                    fo_Rot[2][i]*co_Rot[2][j];
+            }
+        }
 
-    //squared dist from ankle to hip
-    const float legLength = norm_2(hipPosition_fprime);
-    const float legLengthSq = std::pow(legLength,2);
-    if(legLength > THIGH_LENGTH+TIBIA_LENGTH)
-        success = false;
-#ifdef DEBUG_ANA
-    cout<< "LegLength: "<< legLength << ", sqrd = "<<legLengthSq<<endl;
-#endif
+        //The body relative to the foot in the O frame, which is where the
+        //origin of C lands in F (cf) and, negated, the origin of F in C (fc)
+        const float footToBody[3] = {bodyGoal[0] - footGoal[0][leg],
+                                     bodyGoal[1] - footGoal[1][leg],
+                                     bodyGoal[2] - footGoal[2][leg]};
+        float cf_Trans[3], fc_Trans[3];
+        for (int i = 0; i < 3; ++i) {
+            cf_Trans[i] = fo_Rot[0][i]*footToBody[0] +
+                fo_Rot[1][i]*footToBody[1] + fo_Rot[2][i]*footToBody[2];
+            fc_Trans[i] = -(co_Rot[0][i]*footToBody[0] +
+                            co_Rot[1][i]*footToBody[1] +
+                            co_Rot[2][i]*footToBody[2]);
+        }
 
-    //Using the law of cosines to find knee pitch in TTL triangle
-    const float kneeCosine =
-        (legLengthSq -TIBIA_LENGTH*TIBIA_LENGTH - THIGH_LENGTH*THIGH_LENGTH)/
-                  (2.0f*TIBIA_LENGTH*THIGH_LENGTH);
-#ifdef DEBUG_ANA
-    cout<< "KneeCosine: "<<kneeCosine
-        << " unclipped cos"<< std::acos(kneeCosine)<<endl;
-#endif
+        const float leg_sign = (chainIDs[leg] == LLEG_CHAIN ? 1.0f : -1.0f);
 
-    const float KP = std::acos(std::min(std::max(kneeCosine,-1.0f),
-                                               1.0f));
-#ifdef DEBUG_ANA
-    cout<< "Calculated KP: "<<KP<<endl;
-#endif
-    //Now, we can find the ankle roll using only the position of hip in f:
-    const float AR = std::atan2(hipPosition_fprime(CoordFrame4D::Y_AXIS),
-                                hipPosition_fprime(CoordFrame4D::Z_AXIS));
+        //The location of the hip rotation center in the C frame
+        const float hipOffset_c[3] = {0.0f,
+                                      leg_sign*HIP_OFFSET_Y,
+                                      -HIP_OFFSET_Z};
 
-#ifdef DEBUG_ANA
-    cout<< "Calculated AR: "<<AR<<endl;
-#endif
+        //Find the location of the hip in the F frame that is shifted
+        //to the ankle from the bottom of the foot
+        float hipPosition_fprime[3];
+        for (int i = 0; i < 3; ++i) {
+            hipPosition_fprime[i] = cf_Rot[i][1]*hipOffset_c[1] +
+                cf_Rot[i][2]*hipOffset_c[2] + cf_Trans[i];
+        }
+        hipPosition_fprime[2] -= FOOT_HEIGHT;
+
+        //dist from ankle to hip
+        const float legLengthSq =
+            hipPosition_fprime[0]*hipPosition_fprime[0] +
+            hipPosition_fprime[1]*hipPosition_fprime[1] +
+            hipPosition_fprime[2]*hipPosition_fprime[2];
+        const float legLength = std::sqrt(legLengthSq);
+        if(legLength > THIGH_LENGTH+TIBIA_LENGTH)
+            success = false;
+
+        //Using the law of cosines to find knee pitch in TTL triangle
+        const float kneeCosine =
+            (legLengthSq -TIBIA_LENGTH*TIBIA_LENGTH -
+             THIGH_LENGTH*THIGH_LENGTH)/
+            (2.0f*TIBIA_LENGTH*THIGH_LENGTH);
+        const float KP = std::acos(std::min(std::max(kneeCosine,-1.0f),
+                                            1.0f));
+        const float sinKP = std::sin(KP);
+
+        //Now, we can find the ankle roll using only the position of hip in f:
+        const float AR = std::atan2(hipPosition_fprime[CoordFrame3D::Y_AXIS],
+                                    hipPosition_fprime[CoordFrame3D::Z_AXIS]);
+
+        //To find AP, we first use the law of sines to find angle opposite
+        //the THIGH in the TTL tri.
+        //Also, note, even though the TTL triangle is not in the plane XZ
+        //plane of the F frame, the following still works, since scaling the
+        //triangle into that frame creates a similar triangle with the same
+        //angles
+        const float pitch0 = std::asin(THIGH_LENGTH*sinKP/legLength);
+        const float AP =
+            std::asin(-hipPosition_fprime[CoordFrame3D::X_AXIS]/legLength)
+            - pitch0;
+
+        //If the HYP was not passed in, we need to find it:
+        float HYP = givenHYPAngles[leg];
+        if(HYP == HYP_NOT_SET){
+            //find the rotation-only transform from C to F back to Hip,
+            //cfh_Rot = RotY(AP+KP)*RotX(AR)*cf_Rot. Only its Y row is
+            //needed, and RotY leaves that alone, so it is the Y row of
+            //RotX(AR)*cf_Rot.
+            //(This used to be built with CoordFrame3D::rotation3D, which
+            //only does Z rotations, so the AR rotation was left out and
+            //the foot orientation was off whenever AR was not zero)
+            float sinAR, cosAR;
+            sincosf(AR,&sinAR,&cosAR);
+            float cfh_RotY[3];
+            for (int j = 0; j < 3; ++j) {
+                cfh_RotY[j] = cosAR*cf_Rot[1][j] - sinAR*cf_Rot[2][j];
+            }
+
+            // next, grab the hipYawPitch angle from the cfh_Rot matrix.
+            // What? that's right!
+            // Here's how it works. The rHip rotation describes C->after_hip
+            // transform. If we assume that the HYP was the only joint one
+            // could use in the hip, then to modify rHip to be a C->C
+            // transform (i.e. I), you could do the following:
+            // find the the matrix RHYP, such that I = RHYP*rHip, let
+            // RHYP^-1 = rHip
+            // If you find RHYP = Rotx[-3Pi/4].Rotx[HYP].Rotx[3Pi/4] (for
+            // left), then you can evaluate (symbolicaly) RHYP^-1 with a
+            // transpose, and see that to solve for HYP, you can apply the
+            // formulas below
+            // neat stuff...
+            if(chainIDs[leg] == LLEG_CHAIN){
+                HYP = std::atan2(sqrt2*cfh_RotY[CoordFrame3D::X_AXIS],
+                                 cfh_RotY[CoordFrame3D::Y_AXIS] +
+                                 cfh_RotY[CoordFrame3D::Z_AXIS]);
+            }else{
+                HYP = std::atan2(-sqrt2*cfh_RotY[CoordFrame3D::X_AXIS],
+                                 cfh_RotY[CoordFrame3D::Y_AXIS] -
+                                 cfh_RotY[CoordFrame3D::Z_AXIS]);
+            }
+        }
 
-    //To find AP, we first use the law of sines to find angle opposite
-    //the THIGH in the TTL tri.
-    //Also, note, even though the TTL triangle is not in the plane XZ plane of
-    //the F frame, the following still works, since scaling the triangle into
-    //that frame creates a similar triangle with the same angles
-    const float pitch0 = std::asin(THIGH_LENGTH*std::sin(KP)/legLength);
-    const float AP =
-        std::asin(-hipPosition_fprime(CoordFrame4D::X_AXIS)/legLength) - pitch0;
+        //Now we are left only to find the HipRoll and HipPitch
 
-#ifdef DEBUG_ANA
-    cout<< "Calculated AP: "<<AP<<endl;
-#endif
+        //Find the location of the ankle in a C frame shifted to hip
+        float anklePosition_cprime[3];
+        for (int i = 0; i < 3; ++i) {
+            anklePosition_cprime[i] = cf_Rot[2][i]*FOOT_HEIGHT +
+                fc_Trans[i] - hipOffset_c[i];
+        }
 
-    float tempHYP = givenHYPAngle;
-    //If the HYP was not passed in, we need to find it:
-    if(givenHYPAngle == HYP_NOT_SET){
-        //find the rotation-only transform from C to F back to Hip
-        const ufmatrix3 cf_Rot  = subrange(cf_Transform,0,3,0,3);
-        const ufmatrix3 temp =
-            prod(CoordFrame3D::rotation3D(CoordFrame3D::Y_AXIS,
-                                          AP+KP),
-                 CoordFrame3D::rotation3D(CoordFrame3D::X_AXIS,
-                                          AR));
-        const ufmatrix3 cfh_Transform =
-            prod(temp,
-                 cf_Rot);
-
-        // next, grab the hipYawPitch angle from the cfh_Transform matrix.
-        // What? that's right!
-        // Here's how it works. The rHip rotation describes C->after_hip
-        // transform. If we assume that the HYP was the only joint one could use
-        // in the hip, then to modify rHip to be a C->C transform (i.e. I),
-        // you could do the following:
-        // find the the matrix RHYP, such that I = RHYP*rHip, let
-        // RHYP^-1 = rHip
-        // If you find RHYP = Rotx[-3Pi/4].Rotx[HYP].Rotx[3Pi/4] (for left),
-        // then you can evaluate (symbolicaly) RHYP^-1 with a transpose,
-        // and see that to solve for HYP, you can apply the formulas below
-        // neat stuff...
-        if(chainID == LLEG_CHAIN){
-            tempHYP =
-                std::atan2(std::sqrt(2.0f)*cfh_Transform(CoordFrame3D::Y_AXIS,
-                                                         CoordFrame3D::X_AXIS),
-                           cfh_Transform(CoordFrame3D::Y_AXIS,
-                                         CoordFrame3D::Y_AXIS) +
-                           cfh_Transform(CoordFrame3D::Y_AXIS,
-                                         CoordFrame3D::Z_AXIS));
+        //Shift the cprime frame to the d frame, which adds the HYP rotation
+        //(rotationHYPLeftInv/rotationHYPRightInv, multiplied out)
+        float sinHYP, cosHYP;
+        sincosf(HYP,&sinHYP,&cosHYP);
+        const float s = sinHYP/sqrt2;
+        const float c = cosHYP/2;
+        const float ax = anklePosition_cprime[0];
+        const float ay = anklePosition_cprime[1];
+        const float az = anklePosition_cprime[2];
+        float anklePosition_d[3];
+        if(chainIDs[leg] == LLEG_CHAIN){
+            anklePosition_d[0] = cosHYP*ax - s*ay - s*az;
+            anklePosition_d[1] = s*ax + (0.5f+c)*ay + (-0.5f+c)*az;
+            anklePosition_d[2] = s*ax + (-0.5f+c)*ay + (0.5f+c)*az;
         }else{
-            tempHYP =
-                std::atan2(-std::sqrt(2.0f)*cfh_Transform(CoordFrame3D::Y_AXIS,
-                                                         CoordFrame3D::X_AXIS),
-                           cfh_Transform(CoordFrame3D::Y_AXIS,
-                                         CoordFrame3D::Y_AXIS) -
-                           cfh_Transform(CoordFrame3D::Y_AXIS,
-                                         CoordFrame3D::Z_AXIS));
+            anklePosition_d[0] = cosHYP*ax + s*ay - s*az;
+            anklePosition_d[1] = -s*ax + (0.5f+c)*ay + (0.5f-c)*az;
+            anklePosition_d[2] = s*ax + (0.5f-c)*ay + (0.5f+c)*az;
         }
-    }
-    const float HYP = tempHYP;
-#ifdef DEBUG_ANA
-    cout<< "Calculated HYP: "<<HYP<<endl;
-#endif
 
-    //Now we are left only to find the HipRoll and HipPitch
+        //Finding the hip Roll easy in the d frame:
+        const float HR = std::atan2(anklePosition_d[CoordFrame3D::Y_AXIS],
+                                    -anklePosition_d[CoordFrame3D::Z_AXIS]);
 
-    //Find the location of the ankle in a C frame shifted to hip
-    const ufvector4 anklePosition_cprime = prod(fc_Transform,
-                                                ankleOffset_f) - hipOffset_c;
-
-    //Now, we have already found HYP, so we will shift the cprime
-    //frame to the d frame. The d frame is positioned at the hip,
-    //and parrallel to the cprime EXCEPT for the HYP rotation, which is added:
-    const ufvector4 anklePosition_d = prod(( chainID == LLEG_CHAIN ?
-                                             rotationHYPLeftInv(HYP) :
-                                             rotationHYPRightInv(HYP)),
-                                           anklePosition_cprime);
-
-
-    //Finding the hip Roll easy in the d frame:
-    const float HR = std::atan2(anklePosition_d(CoordFrame4D::Y_AXIS),
-                                -anklePosition_d(CoordFrame4D::Z_AXIS));
-#ifdef DEBUG_ANA
-    cout<< "Calculated HR: "<<HR<<endl;
-#endif
-
-    //Again, using the law of sines, we can find the angle accross from
-    //TIBIA_LENGTH in the triangle TTL:
-    const float pitch1 = std::asin(TIBIA_LENGTH*std::sin(KP)/legLength);
-    const float HP = std::asin(-anklePosition_d(CoordFrame4D::X_AXIS)
-                               /legLength) - pitch1;
+        //Again, using the law of sines, we can find the angle accross from
+        //TIBIA_LENGTH in the triangle TTL:
+        const float pitch1 = std::asin(TIBIA_LENGTH*sinKP/legLength);
+        const float HP =
+            std::asin(-anklePosition_d[CoordFrame3D::X_AXIS]/legLength)
+            - pitch1;
 #ifdef DEBUG_ANA
-    cout<< "Calculated HP: "<<HP<<endl;
+        cout << "Calculated HYP: " << HYP << ", HR: " << HR
+             << ", HP: " << HP << ", KP: " << KP
+             << ", AP: " << AP << ", AR: " << AR << endl;
 #endif
 
-    //Setup the return value:
-    IKLegResult result;
+        result[leg].angles[0] = HYP;
+        result[leg].angles[1] = HR;
+        result[leg].angles[2] = HP;
+        result[leg].angles[3] = KP;
+        result[leg].angles[4] = AP;
+        result[leg].angles[5] = AR;
+        result[leg].outcome = (success ? SUCCESS : STUCK);
+    }
+}
 
-    result.angles[0] = HYP;
-    result.angles[1] = HR;
-    result.angles[2] = HP;
-    result.angles[3] = KP;
-    result.angles[4] = AP;
-    result.angles[5] = AR;
-    result.outcome = (success ? SUCCESS : STUCK);
-    return result;
+/**
+ * The rotation part of CoordFrame4D::get6DTransform
+ */
+void Kinematics::rotation6D(const float wx, const float wy, const float wz,
+                            float r[3][3]){
+    float cwx,cwy,cwz,
+        swx,swy,swz;
+    sincosf(wx,&swx,&cwx);
+    sincosf(wy,&swy,&cwy);
+    sincosf(wz,&swz,&cwz);
+
+    r[0][0] = cwy*cwz;
+    r[0][1] = cwz*swx*swy-cwx*swz;
+    r[0][2] = cwx*cwz*swy+swx*swz;
+
+    r[1][0] = cwy*swz;
+    r[1][1] = cwx*cwz+swx*swy*swz;
+    r[1][2] = -cwz*swx+cwx*swy*swz;
+
+    r[2][0] = -swy;
+    r[2][1] = cwy*swx;
+    r[2][2] = cwx*cwy;
 }
 
 ufmatrix4 Kinematics::rotationHYPLeftInv(const float HYP){
@@ -32,6 +32,28 @@ namespace Kinematics{
         float angles[6];
     };
 
+    // legIKPair solves the legs in this order
+    static const int NUM_IK_LEGS = 2;
+    static const int IK_LEFT_LEG = 0;
+    static const int IK_RIGHT_LEG = 1;
+
+    /**
+     * Goals for both legs relative to one body pose. The per leg goals are
+     * stored [component][leg] so that the left and right values of each
+     * component sit next to each other and both legs go through the solver
+     * in step.
+     */
+    struct IKLegPairGoal {
+        float footGoal[3][NUM_IK_LEGS];
+        float footOrientation[3][NUM_IK_LEGS];
+        float bodyGoal[3];
+        float bodyOrientation[3];
+    };
+
+    struct IKLegPairResult {
+        IKLegResult leg[NUM_IK_LEGS];
+    };
+
     const IKLegResult simpleLegIK(const ChainID chainID,
                                   const NBMath::ufvector3 & legGoal,
                                   float startAngles []);
@@ -42,6 +64,11 @@ namespace Kinematics{
                             const NBMath::ufvector3 &bodyGoal,
                             const NBMath::ufvector3 &bodyOrientation,
                             const float HYPAngle = HYP_NOT_SET);
+    /**
+     * Solves both legs in one call. The body transform is only built once,
+     * and the result is the same as calling legIK on each leg.
+     */
+    const IKLegPairResult legIKPair(const IKLegPairGoal &goal);
     /**
      * Wrapper method for IK which finds leg angles given a location
      * for the leg, and angles for the body relative to the world
@@ -62,8 +89,24 @@ namespace Kinematics{
     const NBMath::ufmatrix3 buildJacobians(const ChainID chainID,
                                               const float angles[]);
 
+    // Sines and cosines of a leg's angles, as used by the leg forward
+    // kinematics and Jacobians
+    struct LegTrig {
+        LegTrig(const float angles[]);
+        float sinHYP, cosHYP, sinHP, cosHP, sinKP, cosKP,
+            sinAP, cosAP, sinAR, cosAR;
+        float sinHRPlusPiFourth, cosHRPlusPiFourth,
+            sinHRMinusPiFourth, cosHRMinusPiFourth;
+    };
+    const NBMath::ufvector3 legForwardKinematics(const ChainID id,
+                                                 const LegTrig &t);
+    const NBMath::ufmatrix3 legJacobian(const ChainID id,
+                                        const LegTrig &t);
+
 
     // Both adjustment methods return whether the search was successful.
+    // They stop as soon as the goal is within maxError, before building the
+    // Jacobian for that iteration.
     // The correct angles required to fulfill the goal are returned through
     // startAngles by reference.
     const bool adjustAnkle(const ChainID chainID,
@@ -74,6 +117,10 @@ namespace Kinematics{
                           const NBMath::ufvector3 &goal,
                           float startAngles[],
                           const float maxError);
+    // Iterative solver for the heel position only. It tries the analytic
+    // solution (with startAngles' HYP) first and only iterates if that
+    // misses, e.g. when the goal is out of reach or past a joint limit,
+    // starting from whichever of the two is closer.
     const IKLegResult dls(const ChainID chainID,
                           const NBMath::ufvector3 &goal,
                           const float startAngles[],
@@ -87,6 +134,16 @@ namespace Kinematics{
                                     const NBMath::ufvector3 &bodyGoal,
                                     const NBMath::ufvector3 &bodyOrientation,
                                     const float givenHYPAngle = HYP_NOT_SET);
+    void analyticLegsIK(const int numLegs,
+                        const ChainID chainIDs[],
+                        const float footGoal[][NUM_IK_LEGS],
+                        const float footOrientation[][NUM_IK_LEGS],
+                        const float bodyGoal[],
+                        const float bodyOrientation[],
+                        const float givenHYPAngles[],
+                        IKLegResult result[]);
+    void rotation6D(const float wx, const float wy, const float wz,
+                    float r[3][3]);
 
 
     NBMath::ufmatrix4 rotationHYPRightInv(const float HYP);
@@ -55,6 +55,9 @@ public:
 
     virtual void sendCommands() = 0;
     virtual void postSensors() = 0;
+    // True for enactors that step the switchboard a frame at a time rather
+    // than keep to the robot's clock
+    virtual bool lockStep() const { return false; }
 
     void setSwitchboard(MotionSwitchboard * s){
         std::cout << "Switchboard Set" <<std::endl;
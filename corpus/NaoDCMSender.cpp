@@ -0,0 +1,91 @@
+#include <iostream>
+
+#include "NaoDCMSender.h"
+
+using std::string;
+using std::vector;
+
+NaoDCMSender::NaoDCMSender(AL::ALPtr<AL::DCMProxy> dcm,
+                           const DCMCommandBuilder &builder)
+    : dcmProxy(dcm), commands(DCMCommandBuilder::NUM_GROUPS),
+      sizes(DCMCommandBuilder::NUM_GROUPS, 1)
+{
+    for (unsigned int g = 0; g < DCMCommandBuilder::ULTRASOUND_GROUP; ++g) {
+        makeAlias(builder, g);
+    }
+
+    AL::ALValue &us = commands[DCMCommandBuilder::ULTRASOUND_GROUP];
+    us.arraySetSize(3);
+    us[0] = builder.groupName(DCMCommandBuilder::ULTRASOUND_GROUP);
+    us[1] = string("Merge");
+    us[2].arraySetSize(1);
+    us[2][0].arraySetSize(2);
+}
+
+/**
+ * Creates a group's alias and lays out its command, which clears whatever
+ * the DCM still has queued for the group and sets every actuator in it
+ */
+void NaoDCMSender::makeAlias(const DCMCommandBuilder &builder,
+                             unsigned int group)
+{
+    const vector<string> &actuators = builder.getActuators();
+    const unsigned int start = builder.groupStart(group);
+    const unsigned int size = builder.groupSize(group);
+    sizes[group] = size;
+
+    AL::ALValue alias;
+    alias.arraySetSize(2);
+    alias[0] = builder.groupName(group);
+    alias[1].arraySetSize(size);
+    for (unsigned int i = 0; i < size; ++i) {
+        alias[1][i] = actuators[start + i];
+    }
+
+    try {
+        dcmProxy->createAlias(alias);
+    } catch(AL::ALError &e) {
+        std::cout << "Failed to create DCM alias "
+                  << builder.groupName(group) << ": "
+                  << e.toString() << std::endl;
+    }
+
+    AL::ALValue &command = commands[group];
+    command.arraySetSize(6);
+    command[0] = builder.groupName(group);
+    command[1] = string("ClearAll");
+    command[2] = string("time-separate");
+    command[3] = 0; //importance level
+    command[4].arraySetSize(1); //list of time to send commands
+    command[5].arraySetSize(size);
+    for (unsigned int i = 0; i < size; ++i) {
+        command[5][i].arraySetSize(1);
+        command[5][i][0] = 0.0f;
+    }
+}
+
+int NaoDCMSender::getTime(int offset)
+{
+    return dcmProxy->getTime(offset);
+}
+
+void NaoDCMSender::send(unsigned int group, const float *values, int time)
+{
+    AL::ALValue &command = commands[group];
+
+    try {
+        if (group == DCMCommandBuilder::ULTRASOUND_GROUP) {
+            command[2][0][0] = values[0];
+            command[2][0][1] = time;
+            dcmProxy->set(command);
+        } else {
+            command[4][0] = time;
+            for (unsigned int i = 0; i < sizes[group]; ++i) {
+                command[5][i][0] = values[i];
+            }
+            dcmProxy->setAlias(command);
+        }
+    } catch(AL::ALError &e) {
+        std::cout << "DCM set error " << e.toString() << std::endl;
+    }
+}
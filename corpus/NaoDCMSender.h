@@ -0,0 +1,40 @@
+#ifndef NaoDCMSender_h_DEFINED
+#define NaoDCMSender_h_DEFINED
+
+#include <vector>
+
+#include "alvalue.h"
+#include "alptr.h"
+#include "dcmproxy.h"
+#include "DCMCommandBuilder.h"
+
+/**
+ * Sends a DCMCommandBuilder's groups to the DCM as the enactor and the
+ * lights always have: each alias as a "ClearAll", "time-separate" setAlias
+ * of every actuator in it at one time, and the ultrasound mode as a
+ * "Merge" set of its actuator.
+ *
+ * Each group's command is laid out once; send() only fills in the values
+ * and the time.
+ */
+class NaoDCMSender : public DCMSender
+{
+public:
+    // Creates the builder's aliases with the DCM
+    NaoDCMSender(AL::ALPtr<AL::DCMProxy> dcm,
+                 const DCMCommandBuilder &builder);
+    virtual ~NaoDCMSender() { }
+
+    int getTime(int offset);
+    void send(unsigned int group, const float *values, int time);
+
+private:
+    void makeAlias(const DCMCommandBuilder &builder, unsigned int group);
+
+private:
+    AL::ALPtr<AL::DCMProxy> dcmProxy;
+    std::vector<AL::ALValue> commands;
+    std::vector<unsigned int> sizes;
+};
+
+#endif // NaoDCMSender_h_DEFINED
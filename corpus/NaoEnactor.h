@@ -13,13 +13,17 @@
 #include <string>
 #include "Transcriber.h"
 #include "Common.h"
+#include "DCMCommandBuilder.h"
+#include "NaoDCMSender.h"
 
 class NaoEnactor : public MotionEnactor {
 
 public:
+	// The lights share commands, so their changes go out with ours
 	NaoEnactor(boost::shared_ptr<Sensors> s,
                boost::shared_ptr<Transcriber> transcriber,
-               AL::ALPtr<AL::ALBroker> broker);
+               AL::ALPtr<AL::ALBroker> broker,
+               boost::shared_ptr<DCMCommandBuilder> commands);
     virtual ~NaoEnactor() { };
     void sendCommands();
     void postSensors();
@@ -32,21 +36,13 @@ private: // Members
     boost::shared_ptr<Sensors> sensors;
     boost::shared_ptr<Transcriber> transcriber;
     std::vector<float> motionValues;
-    std::vector<float> motionHardness;
-    std::vector<float> lastMotionHardness;
-    AL::ALValue hardness_command;
-    AL::ALValue joint_command;
-    AL::ALValue us_command;
-
-
+    boost::shared_ptr<DCMCommandBuilder> dcmCommands;
+    boost::shared_ptr<NaoDCMSender> dcmSender;
+    int usCounter;
+    int usMode;
 
 private: // Helper methods
-    void sendHardness();
-    void sendJoints();
-    void sendUltraSound();
-
-    void initDCMAliases();
-    void initDCMCommands();
+    void setUltraSound();
 };
 
 #endif
@@ -1,34 +1,49 @@
+#include <algorithm>
+#include <iostream>
+
 #include "NaoLights.h"
 #include "ALLedNames.h"
 
 #define LEDS_ENABLED
-//#define DEBUG_NAOLIGHTS_INIT
 //#define DEBUG_NAOLIGHTS_COMMAND
 
-NaoLights::NaoLights(AL::ALPtr<AL::ALBroker> broker)
+NaoLights::NaoLights(AL::ALPtr<AL::ALBroker> broker,
+                     boost::shared_ptr<DCMCommandBuilder> commands)
     :Lights(),
-     hexList(ALNames::NUM_UNIQUE_LEDS,0x000000)
+     dcmCommands(commands),
+     hexList(ALNames::NUM_UNIQUE_LEDS,0x000000),
+     sentHexList(ALNames::NUM_UNIQUE_LEDS,0x000000)
 {
-    try {
-        dcmProxy = AL::ALPtr<AL::DCMProxy>(new AL::DCMProxy(broker));
-    } catch(AL::ALError &e) {
-		std::cout << "Failed to initialize proxy to DCM" << std::endl;
+    if (!dcmCommands) {
+        try {
+            dcmProxy = AL::ALPtr<AL::DCMProxy>(new AL::DCMProxy(broker));
+        } catch(AL::ALError &e) {
+            std::cout << "Failed to initialize proxy to DCM" << std::endl;
+        }
+        dcmCommands =
+            boost::shared_ptr<DCMCommandBuilder>(new DCMCommandBuilder());
+        dcmSender = boost::shared_ptr<NaoDCMSender>(
+            new NaoDCMSender(dcmProxy, *dcmCommands));
     }
 
-    generateLeds();
-    //We need to set each LED initially, no matter what
+    unsigned int largest = 0;
     for(unsigned int i = 0; i < ALNames::NUM_UNIQUE_LEDS; i++){
-        sendLightCommand(*ledList[i]->getCommand());
+        largest = std::max(largest, dcmCommands->ledGroupSize(i));
     }
+    ledValues.resize(largest);
 
     pthread_mutex_init(&lights_mutex,NULL);
+
+    //The builder sets each LED initially, no matter what
+#ifdef LEDS_ENABLED
+    if (dcmSender) {
+        dcmCommands->flush(*dcmSender);
+    }
+#endif
 }
 
 
 NaoLights::~NaoLights(){
-    for(unsigned int i = 0; i < ALNames::NUM_UNIQUE_LEDS; i++){
-        delete ledList[i];
-    }
     pthread_mutex_destroy(&lights_mutex);
 }
 
@@ -51,51 +66,54 @@ void NaoLights::setRGB(const unsigned int led_id, const int newRgbHex){
 }
 
 void NaoLights::sendLights(){
-#ifdef DEBUG_NAOLIGHTS_INIT
-    // std::cout << "  NaoLights::sendLights() start" << std::endl;
-#endif
     pthread_mutex_lock(&lights_mutex);
 
-    for(unsigned int i = 0; i < ALNames::NUM_UNIQUE_LEDS; i++){ //HAack
-        if(ledList[i]->updateCommand(hexList[i])){
-            sendLightCommand(*ledList[i]->getCommand());
+    for(unsigned int i = 0; i < ALNames::NUM_UNIQUE_LEDS; i++){
+        if(hexList[i] != sentHexList[i]){
+            sentHexList[i] = hexList[i];
+            setLedValues(i, hexList[i]);
         }
     }
 
-    //sendLightCommand(*(ledList[0]->getCommand()));
-
     pthread_mutex_unlock(&lights_mutex);
-#ifdef DEBUG_NAOLIGHTS_INIT
-    // std::cout << "  NaoLights::sendLights() end" << std::endl;
+
+#ifdef LEDS_ENABLED
+    if (dcmSender) {
+        dcmCommands->flush(*dcmSender);
+    }
 #endif
 }
 
 /**
- * This method generates all the NaoRGBLed objects for each LED group
+ * Hands the builder the value of every actuator in an LED group: each
+ * color channel in turn, for every LED of the group.
  */
-void NaoLights::generateLeds(){
-    for(unsigned int i = 0; i < ALNames::NUM_UNIQUE_LEDS; i++){
-        ledList.push_back(new NaoRGBLight(LED_NAMES[i],
-                                          i,
-                                          ALNames::NUM_RGB_LEDS[i],
-                                          ALNames::LED_START_COLOR[i],
-                                          ALNames::LED_END_COLOR[i]));
-        AL::ALValue newAlias = *ledList[i]->getAlias();
-        dcmProxy->createAlias(newAlias);
-    }
-}
-
-void NaoLights::sendLightCommand(AL::ALValue & command){
+void NaoLights::setLedValues(const unsigned int led_id, const int rgbHex){
 #ifdef DEBUG_NAOLIGHTS_COMMAND
-    std::cout << "  NaoLights::sendCommand() " <<command.serializeToText()<< std::endl;
+    std::cout << "  NaoLights::setLedValues() " << LED_NAMES[led_id]
+              << " " << std::hex << rgbHex << std::dec << std::endl;
 #endif
-    command[4][0] = dcmProxy->getTime(20);
-#ifdef LEDS_ENABLED
-    try {
-        dcmProxy->setAlias(command);
-    } catch(AL::ALError& e) {
-        std::cout << "dcm value set error " << e.toString() << std::endl;
+    unsigned int ledIndex = 0;
+    for(unsigned int c = ALNames::LED_START_COLOR[led_id];
+        c < ALNames::LED_END_COLOR[led_id]; c++){
+        const float color =
+            getColor(static_cast<ALNames::LedColor>(c), rgbHex);
+        for(unsigned int led = 0; led < ALNames::NUM_RGB_LEDS[led_id]; led++){
+            ledValues[ledIndex] = color;
+            ledIndex++;
+        }
     }
+#ifdef LEDS_ENABLED
+    dcmCommands->setLeds(led_id, &ledValues[0]);
 #endif
+}
 
+/*
+ * Returns a float between 0.0 and 1.0 corresponding to the 'c' channel
+ * of the hex value
+ */
+float NaoLights::getColor(const ALNames::LedColor c, const int rgbHex){
+    const int channelColor = (rgbHex >> ((2-c)*8)) % 256;
+    const float fchannelColor= static_cast<float>(channelColor);
+    return fchannelColor * (1.0f/255.0f);
 }
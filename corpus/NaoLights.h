@@ -3,16 +3,21 @@
 
 #include <pthread.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include "Lights.h"
 #include "dcmproxy.h"
 #include "ALLedNames.h"
-#include "NaoRGBLight.h"
+#include "DCMCommandBuilder.h"
+#include "NaoDCMSender.h"
 /**
  *  This class implements LED capability on the Nao robot using the DCM in Naoqi
  *
- *  The basic design is to make a NaoRGBLight for each LED group.  That instance
- *  handles the creation of the appropropriatly formatted ALValue to send to
- *  the DCM low level.
+ *  Each LED group is one of a DCMCommandBuilder's groups, with its own alias.
+ *  sendLights() works out the red, green and blue values of the groups
+ *  whose color has changed and hands them to the builder. When the builder
+ *  is shared with NaoEnactor they go to the DCM at the end of its cycle;
+ *  otherwise NaoLights has a builder of its own and sends it straight away.
  *
  *  Led groups can be referenced either by ID or by string name, through
  *  the latter is currently not as fast as it could be (TODO: fix that)
@@ -25,7 +30,9 @@
 
 class NaoLights : public Lights{
 public:
-    NaoLights(AL::ALPtr<AL::ALBroker> broker);
+    NaoLights(AL::ALPtr<AL::ALBroker> broker,
+              boost::shared_ptr<DCMCommandBuilder> commands =
+              boost::shared_ptr<DCMCommandBuilder>());
     virtual ~NaoLights();
 
 public:
@@ -34,13 +41,17 @@ public:
 
     void sendLights();
 private:
-    void generateLeds();
-    void sendLightCommand(AL::ALValue &command);
+    void setLedValues(const unsigned int led_id, const int rgbHex);
+    static float getColor(const ALNames::LedColor c, const int rgbHex);
 private:
     AL::ALPtr<AL::DCMProxy> dcmProxy;
-    AL::ALValue leftFaceLedCommand;
-    std::vector<NaoRGBLight*> ledList;
+    boost::shared_ptr<DCMCommandBuilder> dcmCommands;
+    // Only when the builder is our own
+    boost::shared_ptr<NaoDCMSender> dcmSender;
     std::vector<int> hexList;
+    std::vector<int> sentHexList;
+    // One group's values, reused
+    std::vector<float> ledValues;
 
     mutable pthread_mutex_t lights_mutex;
 };
@@ -388,6 +388,47 @@ const estimate NaoPose::bodyEstimate(const int x, const int y,
 }
 
 
+  /**
+   * The inverse of pixEstimate: takes a point objectHeight cm above the
+   * ground, at the given distance (cm) and bearing from the body, and finds
+   * the pixel it appears at.  The pixel may lie outside of the image.
+   * Returns false if the point is behind the camera.  The distance is taken
+   * to be one pixEstimate would report, so its correction is undone first.
+   */
+const bool NaoPose::projectToImage(const float dist, const float bearing,
+                                   const float objectHeight,
+                                   point <int> &pixel) const {
+  const float groundDist = uncorrectDistance(dist);
+  // vector from the focal point to the object in the world frame
+  const float dx = groundDist * CM_TO_MM * std::cos(bearing) -
+    focalPointInWorldFrame.x;
+  const float dy = groundDist * CM_TO_MM * std::sin(bearing) -
+    focalPointInWorldFrame.y;
+  const float dz = -comHeight + objectHeight * CM_TO_MM -
+    focalPointInWorldFrame.z;
+
+  // cameraToWorldFrame is a rigid transform, so its rotation's transpose
+  // takes us back into the camera frame
+  const float camX = cameraToWorldFrame(X,X) * dx +
+    cameraToWorldFrame(Y,X) * dy + cameraToWorldFrame(Z,X) * dz;
+  const float camY = cameraToWorldFrame(X,Y) * dx +
+    cameraToWorldFrame(Y,Y) * dy + cameraToWorldFrame(Z,Y) * dz;
+  const float camZ = cameraToWorldFrame(X,Z) * dx +
+    cameraToWorldFrame(Y,Z) * dy + cameraToWorldFrame(Z,Z) * dz;
+
+  if (camX <= 0.0f) {
+    return false;
+  }
+
+  // scale onto the image plane, then undo pixEstimate's pixel to mm mapping
+  const float scale = FOCAL_LENGTH_MM / camX;
+  pixel.x = static_cast<int>(std::floor(IMAGE_CENTER_X -
+                                        camY * scale * MM_TO_PIX_X + 0.5f));
+  pixel.y = static_cast<int>(std::floor(IMAGE_CENTER_Y -
+                                        camZ * scale * MM_TO_PIX_Y + 0.5f));
+  return true;
+}
+
 const float NaoPose::correctDistance(const float uncorrectedDist) {
 	if (uncorrectedDist > 706.0f) {
 		return uncorrectedDist - 387.0f;
@@ -396,6 +437,27 @@ const float NaoPose::correctDistance(const float uncorrectedDist) {
         0.858283f * uncorrectedDist + 2.18768F;
 }
 
+/**
+ * The inverse of correctDistance.  The fit is increasing up to where it
+ * switches to the straight line at 706 cm, but jumps up a few cm there, so
+ * corrected distances in that gap all come back as 706 cm.
+ */
+const float NaoPose::uncorrectDistance(const float correctedDist) {
+	const float SWITCH_DIST = 706.0f;
+	if (correctedDist > SWITCH_DIST - 387.0f) {
+		return correctedDist + 387.0f;
+	}
+	if (correctedDist >= correctDistance(SWITCH_DIST)) {
+		return SWITCH_DIST;
+	}
+	// smaller root of the quadratic, which is the one below its peak
+	const float a = 0.000591972f;
+	const float b = 0.858283f;
+	const float c = correctedDist - 2.18768f;
+	const float root = b * b - 4.0f * a * c;
+	return max(0.0f, (b - std::sqrt(root)) / (2.0f * a));
+}
+
 
 /**
  * Method to populate an estimate with an vector4D in homogenous coordinates.
@@ -161,6 +161,9 @@ public:
     const estimate pixEstimate(const int pixelX, const int pixelY,
                                const float objectHeight);
     const estimate bodyEstimate(const int x, const int y, const float dist);
+    const bool projectToImage(const float dist, const float bearing,
+                              const float objectHeight,
+                              point <int> &pixel) const;
 
     /********** Getters **********/
     const int getHorizonY(const int x) const;
@@ -212,6 +215,7 @@ protected: // helper methods
     // so we have a fitting function which tries to correct the noise. This is
     // that function.
     static const float correctDistance(const float uncorrectedDist);
+    static const float uncorrectDistance(const float correctedDist);
 
 protected: // members
     float bodyInclinationX;
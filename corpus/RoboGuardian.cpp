@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <cerrno>
+#include <ctime>
 
 using namespace std;
 
@@ -17,6 +19,12 @@ const int RoboGuardian::GUARDIAN_FRAME_RATE = MOTION_FRAME_RATE;
 const float RoboGuardian::GUARDIAN_FRAME_LENGTH_uS = 1.0f * 1000.0f * 1000.0f /
     RoboGuardian::GUARDIAN_FRAME_RATE;
 
+// If the motion sensors stop being updated, still run every two frames so
+// the buttons keep working
+const long long RoboGuardian::SENSOR_TIMEOUT_uS =
+    static_cast<long long>(2.0f * RoboGuardian::GUARDIAN_FRAME_LENGTH_uS);
+const long long RoboGuardian::SLOW_CHECK_PERIOD_uS = 1000 * 1000;
+
 const int RoboGuardian::NO_CLICKS = -1;
 
 static const string quiet = " -q ";
@@ -45,6 +53,12 @@ static const boost::shared_ptr<UnfreezeCommand> ENABLE_GAINS =
     boost::shared_ptr<UnfreezeCommand>
     (new UnfreezeCommand());
 
+static long long monotonicMicros(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<long long>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
 //Non blocking!!
 void RoboGuardian::playFile(string str)const{
     int result = system((sout+str+" &").c_str()); // system returns an int. 
@@ -68,12 +82,32 @@ RoboGuardian::RoboGuardian(boost::shared_ptr<Synchro> _synchro,
       notFallingFrames(0),fallenCounter(0),
       registeredFalling(false),registeredShutdown(false),
       falling(false),fallen(false),
-      useFallProtection(false)
+      useFallProtection(false),
+      pendingGroups(0), motionUpdateTime(0),
+      batteryChanged(true), temperaturesChanged(true), lastSlowCheck(0),
+      inertialTime(0), fallDetectionLatency(0)
 {
     pthread_mutex_init(&click_mutex,NULL);
+
+    // Timeouts are on the monotonic clock, like the update times
+    pthread_mutex_init(&sensor_mutex,NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sensor_cond,&attr);
+    pthread_condattr_destroy(&attr);
+
+    sensors->subscribe(MOTION_SENSORS, this);
+    sensors->subscribe(BATTERY_SENSORS, this);
+    sensors->subscribe(TEMPERATURE_SENSORS, this);
     executeStartupAction();
 }
 RoboGuardian::~RoboGuardian(){
+    sensors->unsubscribe(MOTION_SENSORS, this);
+    sensors->unsubscribe(BATTERY_SENSORS, this);
+    sensors->unsubscribe(TEMPERATURE_SENSORS, this);
+    pthread_cond_destroy(&sensor_cond);
+    pthread_mutex_destroy(&sensor_mutex);
     pthread_mutex_destroy(&click_mutex);
 }
 
@@ -83,24 +117,75 @@ void RoboGuardian::run(){
     Thread::running = true;
     Thread::trigger->on();
 
-	struct timespec interval, remainder;
-	interval.tv_sec = 0;
-	interval.tv_nsec = static_cast<long long int>(GUARDIAN_FRAME_LENGTH_uS * 1000);
     while(Thread::running){
+        const int groups = waitForSensors();
+        if(groups & (1 << BATTERY_SENSORS))
+            batteryChanged = true;
+        if(groups & (1 << TEMPERATURE_SENSORS))
+            temperaturesChanged = true;
 
         countButtonPushes();
         checkFalling();
         checkFallen();
-        checkBatteryLevels();
-        checkTemperatures();
         processFallingProtection();
         processChestButtonPushes();
-		nanosleep(&interval, &remainder);
+
+        const long long now = monotonicMicros();
+        if(now - lastSlowCheck >= SLOW_CHECK_PERIOD_uS){
+            if(batteryChanged)
+                checkBatteryLevels();
+            if(temperaturesChanged)
+                checkTemperatures();
+            batteryChanged = temperaturesChanged = false;
+            lastSlowCheck = now;
+        }
     }
 
     Thread::trigger->off();
 }
 
+/**
+ * Called by Sensors from whichever thread updated them (the DCM callbacks
+ * for the motion sensors), so it only records the update and wakes us.
+ */
+void RoboGuardian::notifySensorUpdate(SensorGroup group){
+    pthread_mutex_lock(&sensor_mutex);
+    pendingGroups |= (1 << group);
+    if(group == MOTION_SENSORS){
+        motionUpdateTime = monotonicMicros();
+        pthread_cond_signal(&sensor_cond);
+    }
+    pthread_mutex_unlock(&sensor_mutex);
+}
+
+/**
+ * Waits for the next update to the motion sensors, or SENSOR_TIMEOUT_uS if
+ * none comes. Returns the groups that were updated in the meantime, as bits.
+ */
+int RoboGuardian::waitForSensors(){
+    static const int MOTION_BIT = 1 << MOTION_SENSORS;
+
+    pthread_mutex_lock(&sensor_mutex);
+    if(!(pendingGroups & MOTION_BIT)){
+        const long long deadline = monotonicMicros() + SENSOR_TIMEOUT_uS;
+        struct timespec until;
+        until.tv_sec = deadline / 1000000;
+        until.tv_nsec = (deadline % 1000000) * 1000;
+        while(Thread::running && !(pendingGroups & MOTION_BIT)){
+            if(pthread_cond_timedwait(&sensor_cond, &sensor_mutex,
+                                      &until) == ETIMEDOUT)
+                break;
+        }
+    }
+    const int groups = pendingGroups;
+    pendingGroups = 0;
+    if(groups & MOTION_BIT)
+        inertialTime = motionUpdateTime;
+    pthread_mutex_unlock(&sensor_mutex);
+
+    return groups;
+}
+
 void RoboGuardian::shutoffGains(){
     cout << "RoboGuardian::shutoffGains()" <<endl;
     if(motion_interface != NULL)
@@ -218,6 +303,10 @@ void RoboGuardian::checkFalling(){
 void RoboGuardian::processFallingProtection(){
     if(falling && !registeredFalling){
         registeredFalling = true;
+        fallDetectionLatency = monotonicMicros() - inertialTime;
+        cout << Thread::name << ": fall registered "
+             << fallDetectionLatency << "us after the inertial update"
+             << endl;
         executeFallProtection();
     }else if(notFallingFrames > FALLING_RESET_FRAMES_THRESH){
         registeredFalling = false;
@@ -27,6 +27,7 @@
 
 #include "synchro.h"
 #include "Sensors.h"
+#include "SensorSubscriber.h"
 #include "MotionInterface.h"
 #include "ClickableButton.h"
 
@@ -37,7 +38,13 @@ enum  ButtonID {
     RIGHT_FOOT_BUTTON
 };
 
-class RoboGuardian : public Thread {
+/**
+ * The guardian runs its fall detection and button counting each time the
+ * motion sensors are updated, rather than on its own timer, so a fall is
+ * seen as soon as the inertial data shows it. Battery and temperatures are
+ * only looked at once they change, and at most once a second.
+ */
+class RoboGuardian : public Thread, public SensorSubscriber {
 public:
     RoboGuardian(boost::shared_ptr<Synchro>,
                  boost::shared_ptr<Sensors>);
@@ -45,6 +52,8 @@ public:
 
     void run();
 
+    void notifySensorUpdate(SensorGroup group);
+
     void executeShutdownAction()const;
     void executeStartupAction()const;
     void speakIPAddress()const;
@@ -52,6 +61,9 @@ public:
     //getters
     bool isRobotFalling()const { return falling; }
     bool isRobotFallen()const { return fallen; }
+    // Microseconds from the inertial update that showed the last fall to
+    // the guardian registering it
+    long long getFallDetectionLatency()const { return fallDetectionLatency; }
 
     boost::shared_ptr<ClickableButton> getButton(ButtonID)const;
 
@@ -71,6 +83,7 @@ public:
     static const int NO_CLICKS;
 
 private:
+    int waitForSensors();
     void checkFalling();
     void checkFallen();
     void checkBatteryLevels();
@@ -107,8 +120,27 @@ private:
     mutable bool useFallProtection;
 
     mutable pthread_mutex_t click_mutex;
+
+    // Sensor groups updated since the guardian last looked, and when the
+    // motion sensors were last updated
+    pthread_mutex_t sensor_mutex;
+    pthread_cond_t sensor_cond;
+    int pendingGroups;
+    long long motionUpdateTime;
+
+    // Set when a slow group changes, cleared when it is checked
+    bool batteryChanged, temperaturesChanged;
+    long long lastSlowCheck;
+
+    // When the inertial data being processed was updated
+    long long inertialTime;
+    long long fallDetectionLatency;
+
     static const int GUARDIAN_FRAME_RATE;
     static const float GUARDIAN_FRAME_LENGTH_uS;
+    // How long to wait for the motion sensors before running anyway
+    static const long long SENSOR_TIMEOUT_uS;
+    static const long long SLOW_CHECK_PERIOD_uS;
 
 
 };
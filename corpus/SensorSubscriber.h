@@ -0,0 +1,24 @@
+#ifndef SENSOR_SUBSCRIBER_H
+#define SENSOR_SUBSCRIBER_H
+
+// Groups of sensors that are updated together, which is what a
+// SensorSubscriber can be told about
+enum SensorGroup {
+    // Inertial, FSRs and chest button, every DCM cycle
+    MOTION_SENSORS = 0,
+    // Battery charge, when it changes
+    BATTERY_SENSORS,
+    // Joint temperatures, when one of them changes by a degree or more
+    TEMPERATURE_SENSORS,
+    NUM_SENSOR_GROUPS
+};
+
+class SensorSubscriber {
+public:
+    // Called from the thread that updated the sensors, so just take note
+    // and return
+    virtual void notifySensorUpdate(SensorGroup group) = 0;
+    virtual ~SensorSubscriber() {}
+};
+
+#endif
@@ -22,6 +22,7 @@
 #include <fstream>
 #include <algorithm>
 #include <cstdlib>
+#include <cmath>
 using namespace std;
 
 #include <boost/assign/std/vector.hpp>
@@ -61,7 +62,9 @@ Sensors::Sensors ()
       supportFoot(LEFT_SUPPORT),
       unfilteredInertial(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f),
       chestButton(0.0f),batteryCharge(0.0f),batteryCurrent(0.0f),
-      FRM_FOLDER("/home/nao/naoqi/frames")
+      FRM_FOLDER("/home/nao/naoqi/frames"),
+      notifiedBatteryCharge(0.0f),
+      notifiedTemperatures(NUM_ACTUATORS, 0.0f)
 {
     pthread_mutex_init(&angles_mutex, NULL);
     pthread_mutex_init(&vision_angles_mutex, NULL);
@@ -75,6 +78,7 @@ Sensors::Sensors ()
     pthread_mutex_init(&ultra_sound_mutex, NULL);
     pthread_mutex_init(&support_foot_mutex, NULL);
     pthread_mutex_init(&battery_mutex, NULL);
+    pthread_mutex_init(&subscriber_mutex, NULL);
 #ifdef USE_SENSORS_IMAGE_LOCKING
     pthread_mutex_init(&image_mutex, NULL);
 #endif
@@ -94,6 +98,7 @@ Sensors::~Sensors ()
     pthread_mutex_destroy(&ultra_sound_mutex);
     pthread_mutex_destroy(&support_foot_mutex);
     pthread_mutex_destroy(&battery_mutex);
+    pthread_mutex_destroy(&subscriber_mutex);
 #ifdef USE_SENSORS_IMAGE_LOCKING
     pthread_mutex_destroy(&image_mutex);
 #endif
@@ -458,13 +463,33 @@ void Sensors::setBodyAngleErrors (const vector<float>& v)
 }
 
 
+// Smallest change in a joint temperature, in degrees, that is reported
+static const float TEMPERATURE_NOTIFY_THRESHOLD = 1.0f;
+
 void Sensors::setBodyTemperatures (const vector<float>& v)
 {
     pthread_mutex_lock (&temperatures_mutex);
 
     bodyTemperatures = v;
 
+    bool changed = false;
+    for (unsigned int i = 0; i < v.size() && i < notifiedTemperatures.size();
+         ++i) {
+        if (std::abs(v[i] - notifiedTemperatures[i]) >=
+            TEMPERATURE_NOTIFY_THRESHOLD) {
+            changed = true;
+            break;
+        }
+    }
+    if (changed) {
+        notifiedTemperatures = v;
+    }
+
     pthread_mutex_unlock (&temperatures_mutex);
+
+    if (changed) {
+        notifySubscribers(TEMPERATURE_SENSORS);
+    }
 }
 
 void Sensors::setLeftFootFSR(const float frontLeft, const float frontRight,
@@ -624,6 +649,8 @@ void Sensors::setMotionSensors (const FSR &_leftFoot, const FSR &_rightFoot,
     pthread_mutex_unlock(&inertial_mutex);
     pthread_mutex_unlock(&fsr_mutex);
     pthread_mutex_unlock(&button_mutex);
+
+    notifySubscribers(MOTION_SENSORS);
 }
 
 /**
@@ -646,10 +673,16 @@ void Sensors::setVisionSensors (const FootBumper &_leftBumper,
     batteryCharge = bCharge;
     batteryCurrent = bCurrent;
 
+    const bool batteryChanged = (bCharge != notifiedBatteryCharge);
+    notifiedBatteryCharge = bCharge;
+
     pthread_mutex_unlock(&ultra_sound_mutex);
     pthread_mutex_unlock (&button_mutex);
     pthread_mutex_unlock (&battery_mutex);
 
+    if (batteryChanged) {
+        notifySubscribers(BATTERY_SENSORS);
+    }
 }
 
 void Sensors::setAllSensors (vector<float> sensorValues) {
@@ -706,6 +739,43 @@ void Sensors::releaseImage()
 #endif
 }
 
+void Sensors::subscribe(SensorGroup group, SensorSubscriber *subscriber)
+{
+    pthread_mutex_lock (&subscriber_mutex);
+
+    subscribers[group].push_back(subscriber);
+
+    pthread_mutex_unlock (&subscriber_mutex);
+}
+
+void Sensors::unsubscribe(SensorGroup group, SensorSubscriber *subscriber)
+{
+    pthread_mutex_lock (&subscriber_mutex);
+
+    subscribers[group].erase(remove(subscribers[group].begin(),
+                                    subscribers[group].end(), subscriber),
+                             subscribers[group].end());
+
+    pthread_mutex_unlock (&subscriber_mutex);
+}
+
+/**
+ * Called with none of the sensor mutexes held, so a subscriber may read the
+ * new values straight away. Holding the subscriber mutex means a subscriber
+ * can not be told about an update after it has unsubscribed.
+ */
+void Sensors::notifySubscribers(SensorGroup group)
+{
+    pthread_mutex_lock (&subscriber_mutex);
+
+    for (vector<SensorSubscriber*>::iterator i = subscribers[group].begin();
+         i != subscribers[group].end(); ++i) {
+        (*i)->notifySensorUpdate(group);
+    }
+
+    pthread_mutex_unlock (&subscriber_mutex);
+}
+
 /**
  * Beware!!! I am toying with the possibility that a possible deadlock condition
  * exists here. If we somehow are able to lock body_angles, but unable to lock
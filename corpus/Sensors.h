@@ -27,6 +27,7 @@
 #include "SensorDef.h"
 #include "NaoDef.h"
 #include "VisionDef.h"
+#include "SensorSubscriber.h"
 
 enum SupportFoot {
     LEFT_SUPPORT = 0,
@@ -164,6 +165,13 @@ class Sensors {
     // this method is very useful for serialization and parsing sensors
     void setAllSensors(const std::vector<float> sensorValues);
 
+    // Subscribers are notified after every update to a group of sensors
+    // made through setMotionSensors, setVisionSensors and
+    // setBodyTemperatures, so they can react to new values instead of
+    // polling for them
+    void subscribe(SensorGroup group, SensorSubscriber *subscriber);
+    void unsubscribe(SensorGroup group, SensorSubscriber *subscriber);
+
 
     // special methods
     //   the image retrieval and locking methods are a little different, as we
@@ -196,6 +204,7 @@ class Sensors {
 private:
 
     void add_to_module();
+    void notifySubscribers(SensorGroup group);
 
     // Locking mutexes
     mutable pthread_mutex_t angles_mutex;
@@ -211,6 +220,7 @@ private:
     mutable pthread_mutex_t support_foot_mutex;
     mutable pthread_mutex_t battery_mutex;
     mutable pthread_mutex_t image_mutex;
+    mutable pthread_mutex_t subscriber_mutex;
 
     // Joint angles and sensors
     // Make the following distinction: bodyAngles is a vector of the most current
@@ -256,6 +266,12 @@ private:
 
     static int saved_frames;
     std::string FRM_FOLDER;
+
+    std::vector<SensorSubscriber*> subscribers[NUM_SENSOR_GROUPS];
+    // The values subscribers were last told about, for the groups that
+    // are only reported when they change
+    float notifiedBatteryCharge;
+    std::vector<float> notifiedTemperatures;
 };
 
 
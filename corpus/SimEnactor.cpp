@@ -0,0 +1,34 @@
+#include "SimEnactor.h"
+
+using boost::shared_ptr;
+using namespace std;
+
+SimEnactor::SimEnactor(shared_ptr<Sensors> _sensors,
+                       shared_ptr<Transcriber> _transcriber,
+                       shared_ptr<SimWorld> _world)
+    :MotionEnactor(),
+     sensors(_sensors),
+     transcriber(_transcriber),
+     world(_world)
+{
+}
+
+SimEnactor::~SimEnactor(){}
+
+void SimEnactor::postSensors(){
+    sensors->setMotionBodyAngles(world->getJoints());
+    transcriber->postMotionSensors();
+
+    if(!switchboard){
+        return;
+    }
+    switchboard->signalNextFrame();
+}
+
+void SimEnactor::sendCommands(){
+    if(!switchboard){
+        return;
+    }
+    switchboard->awaitFrameDone();
+    world->setJoints(switchboard->getNextJoints());
+}
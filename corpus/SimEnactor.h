@@ -0,0 +1,32 @@
+#ifndef SimEnactor_h_DEFINED
+#define SimEnactor_h_DEFINED
+
+#include "Sensors.h"
+#include "Transcriber.h"
+#include "MotionEnactor.h"
+#include "SimWorld.h"
+
+/**
+ * Sends the switchboard's joints straight to a SimWorld. There is no clock
+ * to keep to: sendCommands() waits for the switchboard to finish the frame
+ * postSensors() started, so motion moves one frame per step however fast
+ * or slow the steps come. The switchboard's own timer is left off for it.
+ */
+class SimEnactor : public MotionEnactor {
+public:
+    SimEnactor(boost::shared_ptr<Sensors> _sensors,
+               boost::shared_ptr<Transcriber> _transcriber,
+               boost::shared_ptr<SimWorld> _world);
+    virtual ~SimEnactor();
+
+    void postSensors();
+    void sendCommands();
+    bool lockStep() const { return true; }
+
+private:
+    boost::shared_ptr<Sensors> sensors;
+    boost::shared_ptr<Transcriber> transcriber;
+    boost::shared_ptr<SimWorld> world;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include "SimImageTranscriber.h"
+#include "VisionDef.h"
+
+using boost::shared_ptr;
+
+SimImageTranscriber::SimImageTranscriber(shared_ptr<Sensors> s,
+                                         shared_ptr<SimWorld> _world)
+    :ImageTranscriber(s),
+     world(_world),
+     image(new unsigned char[IMAGE_BYTE_SIZE])
+{
+}
+
+SimImageTranscriber::~SimImageTranscriber(){
+    delete [] image;
+}
+
+void SimImageTranscriber::releaseImage(){}
+
+void SimImageTranscriber::waitForImage(){
+    world->render(image);
+
+    sensors->lockImage();
+    sensors->setImage(image);
+    sensors->releaseImage();
+
+    subscriber->notifyNextVisionImage();
+}
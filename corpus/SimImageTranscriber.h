@@ -0,0 +1,25 @@
+#ifndef SimImageTranscriber_h_DEFINED
+#define SimImageTranscriber_h_DEFINED
+
+#include "ImageTranscriber.h"
+#include "SimWorld.h"
+
+/**
+ * Draws the SimWorld from where the robot's camera is and hands it to
+ * vision, which processes it before waitForImage() returns.
+ */
+class SimImageTranscriber : public ImageTranscriber {
+public:
+    SimImageTranscriber(boost::shared_ptr<Sensors> s,
+                        boost::shared_ptr<SimWorld> _world);
+    ~SimImageTranscriber();
+
+    void releaseImage();
+    void waitForImage();
+
+private:
+    boost::shared_ptr<SimWorld> world;
+    unsigned char *image;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "SimTranscriber.h"
+#include "BasicWorldConstants.h"
+#include "Kinematics.h"
+
+using boost::shared_ptr;
+using namespace std;
+
+namespace {
+    // The Nao's weight in kg, spread over the four sensors of a foot
+    const float FSR_WEIGHT = 4.5f / 4.0f;
+    // How close to the carpet, in cm, the free foot has to be to bear
+    // half the weight
+    const float FOOT_DOWN_HEIGHT = 0.2f;
+    const float NO_ECHO_DIST = 2.55f;
+}
+
+SimTranscriber::SimTranscriber(shared_ptr<Sensors> s,
+                               shared_ptr<SimWorld> _world)
+    :Transcriber(s),
+     world(_world),
+     jointTemps(Kinematics::NUM_JOINTS, 0.0f)
+{
+}
+
+SimTranscriber::~SimTranscriber(){}
+
+void SimTranscriber::postVisionSensors(){
+    //Nothing to bump into or echo off, and the battery never runs down
+    sensors->
+        setVisionSensors(FootBumper(0.0f, 0.0f),
+                         FootBumper(0.0f, 0.0f),
+                         NO_ECHO_DIST,
+                         static_cast<UltraSoundMode>(0),
+                         1.0f,
+                         0.0f);
+}
+
+void SimTranscriber::postMotionSensors(){
+    //Upright and still, so only gravity shows up
+    const Inertial inertial(0.0f, 0.0f, GRAVITY_mss,
+                            0.0f, 0.0f, 0.0f, 0.0f);
+
+    float left = FSR_WEIGHT, right = FSR_WEIGHT;
+    if (world->getSwingHeight() < FOOT_DOWN_HEIGHT) {
+        left = right = FSR_WEIGHT * 0.5f;
+    } else if (world->isLeftFootPlanted()) {
+        right = 0.0f;
+    } else {
+        left = 0.0f;
+    }
+
+    sensors->setMotionSensors(FSR(left, left, left, left),
+                              FSR(right, right, right, right),
+                              0.0f,
+                              inertial, inertial);
+
+    //Joints go exactly where they were sent
+    sensors->setBodyAngles(world->getJoints());
+    sensors->setBodyTemperatures(jointTemps);
+}
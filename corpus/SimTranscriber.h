@@ -0,0 +1,26 @@
+#ifndef SimTranscriber_h_DEFINED
+#define SimTranscriber_h_DEFINED
+
+#include "Transcriber.h"
+#include "SimWorld.h"
+
+/**
+ * Reads the sensors off a SimWorld. The robot never tips, so the inertials
+ * only ever see gravity, and all the weight is on the planted foot until
+ * the other one comes down beside it.
+ */
+class SimTranscriber : public Transcriber {
+public:
+    SimTranscriber(boost::shared_ptr<Sensors> s,
+                   boost::shared_ptr<SimWorld> _world);
+    virtual ~SimTranscriber();
+
+    void postMotionSensors();
+    void postVisionSensors();
+
+private:
+    boost::shared_ptr<SimWorld> world;
+    std::vector<float> jointTemps;
+};
+
+#endif
@@ -0,0 +1,290 @@
+
+// This file is part of Man, a robotic perception, locomotion, and
+// team strategy application created by the Northern Bites RoboCup
+// team of Bowdoin College in Brunswick, Maine, for the Aldebaran
+// Nao robot.
+//
+// Man is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Man is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and the GNU Lesser Public License along with Man.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+
+#include "SimWorld.h"
+#include "InverseKinematics.h"
+#include "FieldConstants.h"
+#include "VisionDef.h"
+#include "YUVConverter.h"
+
+using namespace std;
+using namespace Kinematics;
+
+namespace {
+    const float LINE_HALF_WIDTH = 2.5f;
+    const float BALL_RADIUS = 3.25f;
+    // The other foot has to come this far below the planted one, in cm,
+    // before the weight goes over onto it
+    const float PLANT_MARGIN = 0.1f;
+
+    const int NUM_POSTS = 4;
+    const float POSTS[NUM_POSTS][2] = {
+        { LANDMARK_YELLOW_GOAL_BOTTOM_POST_X,
+          LANDMARK_YELLOW_GOAL_BOTTOM_POST_Y },
+        { LANDMARK_YELLOW_GOAL_TOP_POST_X, LANDMARK_YELLOW_GOAL_TOP_POST_Y },
+        { LANDMARK_BLUE_GOAL_BOTTOM_POST_X, LANDMARK_BLUE_GOAL_BOTTOM_POST_Y },
+        { LANDMARK_BLUE_GOAL_TOP_POST_X, LANDMARK_BLUE_GOAL_TOP_POST_Y }
+    };
+
+    // RGB of each SimWorld::Color, close to what Webots draws, so the
+    // Webots color table goes with these images too
+    const int RGB[SimWorld::NUM_COLORS][3] = {
+        {  40, 140,  40 },
+        { 255, 255, 255 },
+        { 255, 110,   0 },
+        { 230, 210,   0 },
+        {   0,  90, 210 },
+        { 110, 110, 110 }
+    };
+}
+
+SimWorld::SimWorld()
+    : joints(NUM_JOINTS, 0.0f),
+      x(MIDFIELD_X - CENTER_CIRCLE_RADIUS), y(MIDFIELD_Y), heading(0.0f),
+      bodyHeight(0.0f), ballX(MIDFIELD_X), ballY(MIDFIELD_Y),
+      leftPlanted(true), plantedX(0.0f), plantedY(0.0f), plantedYaw(0.0f),
+      swingHeight(0.0f)
+{
+    for (int c = 0; c < NUM_COLORS; ++c) {
+        YUVConverter::toYUV(RGB[c][0], RGB[c][1], RGB[c][2],
+                            palette[c][0], palette[c][1], palette[c][2]);
+    }
+    plantFoot(leftPlanted);
+    setJoints(joints);
+}
+
+/**
+ * Where a foot is relative to the body, in cm, and which way it points.
+ * The hip yaw pitch joints turn about axes 45 degrees between the y and z
+ * axes, so a foot's yaw is the joint angle over root two.
+ */
+void SimWorld::footPose(bool left, float &fx, float &fy, float &fz,
+                        float &yaw) const
+{
+    const ChainID chain = left ? LLEG_CHAIN : RLEG_CHAIN;
+    const unsigned int first = left ? L_HIP_YAW_PITCH : R_HIP_YAW_PITCH;
+    const NBMath::ufvector3 foot = forwardKinematics(chain, &joints[first]);
+
+    fx = foot(0) * 0.1f;
+    fy = foot(1) * 0.1f;
+    fz = foot(2) * 0.1f;
+    const float hyp = joints[first] / sqrt(2.0f);
+    yaw = left ? -hyp : hyp;
+}
+
+void SimWorld::plantFoot(bool left)
+{
+    float fx, fy, fz, yaw;
+    footPose(left, fx, fy, fz, yaw);
+
+    const float c = cos(heading), s = sin(heading);
+    leftPlanted = left;
+    plantedX = x + c * fx - s * fy;
+    plantedY = y + s * fx + c * fy;
+    plantedYaw = heading + yaw;
+}
+
+void SimWorld::setJoints(const vector<float> &_joints)
+{
+    joints = _joints;
+
+    float lx, ly, lz, lyaw, rx, ry, rz, ryaw;
+    footPose(true, lx, ly, lz, lyaw);
+    footPose(false, rx, ry, rz, ryaw);
+
+    // Move the body so the planted foot stays put
+    const float fx = leftPlanted ? lx : rx;
+    const float fy = leftPlanted ? ly : ry;
+    heading = plantedYaw - (leftPlanted ? lyaw : ryaw);
+    const float c = cos(heading), s = sin(heading);
+    x = plantedX - (c * fx - s * fy);
+    y = plantedY - (s * fx + c * fy);
+
+    // then put the weight on the other foot if it has come down lower
+    const float planted = leftPlanted ? lz : rz;
+    const float other = leftPlanted ? rz : lz;
+    if (other < planted - PLANT_MARGIN) {
+        plantFoot(!leftPlanted);
+    }
+    bodyHeight = -min(lz, rz);
+    swingHeight = fabs(lz - rz);
+}
+
+void SimWorld::setPose(float _x, float _y, float _heading)
+{
+    x = _x;
+    y = _y;
+    heading = _heading;
+    plantFoot(leftPlanted);
+}
+
+void SimWorld::setBall(float _x, float _y)
+{
+    ballX = _x;
+    ballY = _y;
+}
+
+bool SimWorld::onLine(float gx, float gy) const
+{
+    const float w = LINE_HALF_WIDTH;
+    const bool inLength = gx > FIELD_WHITE_LEFT_SIDELINE_X - w &&
+        gx < FIELD_WHITE_RIGHT_SIDELINE_X + w;
+    const bool inWidth = gy > FIELD_WHITE_BOTTOM_SIDELINE_Y - w &&
+        gy < FIELD_WHITE_TOP_SIDELINE_Y + w;
+
+    if (inLength && (fabs(gy - FIELD_WHITE_BOTTOM_SIDELINE_Y) < w ||
+                     fabs(gy - FIELD_WHITE_TOP_SIDELINE_Y) < w)) {
+        return true;
+    }
+    if (inWidth && (fabs(gx - FIELD_WHITE_LEFT_SIDELINE_X) < w ||
+                    fabs(gx - FIELD_WHITE_RIGHT_SIDELINE_X) < w ||
+                    fabs(gx - MIDFIELD_X) < w)) {
+        return true;
+    }
+
+    const float cx = gx - CENTER_FIELD_X, cy = gy - CENTER_FIELD_Y;
+    const float r2 = cx * cx + cy * cy;
+    const float inner = CENTER_CIRCLE_RADIUS - w, outer = CENTER_CIRCLE_RADIUS + w;
+    if (r2 > inner * inner && r2 < outer * outer) {
+        return true;
+    }
+
+    // The goal boxes
+    const bool inBoxWidth = gy > BLUE_GOALBOX_BOTTOM_Y - w &&
+        gy < BLUE_GOALBOX_TOP_Y + w;
+    if (inBoxWidth && (fabs(gx - BLUE_GOALBOX_RIGHT_X) < w ||
+                       fabs(gx - YELLOW_GOALBOX_LEFT_X) < w)) {
+        return true;
+    }
+    const bool inBoxDepth =
+        (gx > BLUE_GOALBOX_LEFT_X && gx < BLUE_GOALBOX_RIGHT_X + w) ||
+        (gx > YELLOW_GOALBOX_LEFT_X - w && gx < YELLOW_GOALBOX_RIGHT_X);
+    return inBoxDepth && (fabs(gy - BLUE_GOALBOX_BOTTOM_Y) < w ||
+                          fabs(gy - BLUE_GOALBOX_TOP_Y) < w);
+}
+
+SimWorld::Color SimWorld::groundColor(float gx, float gy) const
+{
+    if (gx < 0.0f || gx > FIELD_GREEN_WIDTH ||
+        gy < 0.0f || gy > FIELD_GREEN_HEIGHT) {
+        return BACKGROUND;
+    }
+    return onLine(gx, gy) ? LINE : CARPET;
+}
+
+SimWorld::Color SimWorld::trace(float px, float py, float pz,
+                                float dx, float dy, float dz) const
+{
+    Color color = BACKGROUND;
+    float nearest = HUGE_VAL;
+
+    if (dz < 0.0f) {
+        nearest = -pz / dz;
+        color = groundColor(px + nearest * dx, py + nearest * dy);
+    }
+
+    // The posts are upright cylinders, so only x and y matter until we
+    // know where the ray meets one
+    const float a = dx * dx + dy * dy;
+    if (a > 0.0f) {
+        for (int i = 0; i < NUM_POSTS; ++i) {
+            const float ox = px - POSTS[i][0], oy = py - POSTS[i][1];
+            const float b = ox * dx + oy * dy;
+            const float c = ox * ox + oy * oy -
+                GOAL_POST_RADIUS * GOAL_POST_RADIUS;
+            const float disc = b * b - a * c;
+            if (disc < 0.0f) {
+                continue;
+            }
+            const float t = (-b - sqrt(disc)) / a;
+            const float z = pz + t * dz;
+            if (t > 0.0f && t < nearest &&
+                z >= 0.0f && z <= GOAL_POST_CM_HEIGHT) {
+                nearest = t;
+                color = i < 2 ? YELLOW_POST : BLUE_POST;
+            }
+        }
+    }
+
+    const float ox = px - ballX, oy = py - ballY, oz = pz - BALL_RADIUS;
+    const float b = ox * dx + oy * dy + oz * dz;
+    const float c = ox * ox + oy * oy + oz * oz - BALL_RADIUS * BALL_RADIUS;
+    const float dd = dx * dx + dy * dy + dz * dz;
+    const float disc = b * b - dd * c;
+    if (disc >= 0.0f) {
+        const float t = (-b - sqrt(disc)) / dd;
+        if (t > 0.0f && t < nearest) {
+            color = BALL;
+        }
+    }
+    return color;
+}
+
+/**
+ * Casts a ray through every pixel from the camera, which sits on the head
+ * at the height the planted foot holds the body. The torso is taken to be
+ * upright. The chroma of each pair of pixels comes from the first of them,
+ * as it does from the camera.
+ */
+void SimWorld::render(unsigned char *yuv) const
+{
+    const float yaw = heading + joints[HEAD_YAW];
+    const float pitch = joints[HEAD_PITCH] + CAMERA_PITCH_ANGLE;
+    const float cy = cos(yaw), sy = sin(yaw);
+    const float cp = cos(pitch), sp = sin(pitch);
+
+    // The camera's forward, left and up directions
+    const float f[3] = { cp * cy, cp * sy, -sp };
+    const float l[3] = { -sy, cy, 0.0f };
+    const float u[3] = { sp * cy, sp * sy, cp };
+
+    const float neckZ = bodyHeight + NECK_OFFSET_Z * 0.1f;
+    const float offX = CAMERA_OFF_X * 0.1f, offZ = CAMERA_OFF_Z * 0.1f;
+    const float camX = x + offX * f[0] + offZ * u[0];
+    const float camY = y + offX * f[1] + offZ * u[1];
+    const float camZ = neckZ + offX * f[2] + offZ * u[2];
+
+    const float focalX = (IMAGE_WIDTH * 0.5f) / tan(FOV_X_DEG * TO_RAD * 0.5f);
+    const float focalY = (IMAGE_HEIGHT * 0.5f) / tan(FOV_Y_DEG * TO_RAD * 0.5f);
+
+    unsigned char *out = yuv;
+    for (int j = 0; j < IMAGE_HEIGHT; ++j) {
+        const float v = (IMAGE_HEIGHT * 0.5f - j - 0.5f) / focalY;
+        const float row[3] = { f[0] + v * u[0], f[1] + v * u[1],
+                               f[2] + v * u[2] };
+
+        for (int i = 0; i < IMAGE_WIDTH; i += 2) {
+            const float h1 = (IMAGE_WIDTH * 0.5f - i - 0.5f) / focalX;
+            const float h2 = h1 - 1.0f / focalX;
+            const Color c1 = trace(camX, camY, camZ, row[0] + h1 * l[0],
+                                   row[1] + h1 * l[1], row[2]);
+            const Color c2 = trace(camX, camY, camZ, row[0] + h2 * l[0],
+                                   row[1] + h2 * l[1], row[2]);
+
+            out[0] = palette[c1][0];
+            out[1] = palette[c1][1];
+            out[2] = palette[c2][0];
+            out[3] = palette[c1][2];
+            out += 4;
+        }
+    }
+}
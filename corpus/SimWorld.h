@@ -0,0 +1,82 @@
+#ifndef SimWorld_h_DEFINED
+#define SimWorld_h_DEFINED
+
+#include <vector>
+
+/**
+ * A stand in for the world, for running Man without a robot or Webots.
+ *
+ * The robot is rigid and its joints go exactly where they are sent. Each
+ * time the joints are set, whichever foot is lower is taken to be planted
+ * on the ground, and the body moves so that foot stays where it is, so
+ * walking the legs walks the robot around the field. Nothing tips over
+ * and nothing pushes back.
+ *
+ * The field is flat carpet with the lines, the four goal posts and a ball
+ * that stays where it is put. render() draws what the camera on the head
+ * would see as a YUV422 image the size vision expects.
+ *
+ * Positions are in field coordinates, centimeters, with the blue goal at
+ * x = 0; angles are in radians and a heading of zero faces the yellow goal.
+ */
+class SimWorld
+{
+public:
+    enum Color {
+        CARPET,
+        LINE,
+        BALL,
+        YELLOW_POST,
+        BLUE_POST,
+        BACKGROUND,
+        NUM_COLORS
+    };
+
+    SimWorld();
+
+    void setJoints(const std::vector<float> &joints);
+    const std::vector<float>& getJoints() const { return joints; }
+
+    void setPose(float x, float y, float heading);
+    void setBall(float x, float y);
+
+    float getX() const { return x; }
+    float getY() const { return y; }
+    float getHeading() const { return heading; }
+    // Height of the torso above the carpet
+    float getBodyHeight() const { return bodyHeight; }
+    bool isLeftFootPlanted() const { return leftPlanted; }
+    // How far the free foot is off the carpet
+    float getSwingHeight() const { return swingHeight; }
+
+    // yuv holds IMAGE_BYTE_SIZE bytes
+    void render(unsigned char *yuv) const;
+
+    // What the ray from (px, py, pz) along (dx, dy, dz) first runs into
+    Color trace(float px, float py, float pz,
+                float dx, float dy, float dz) const;
+
+private:
+    void plantFoot(bool left);
+    void footPose(bool left, float &fx, float &fy, float &fz,
+                  float &yaw) const;
+    Color groundColor(float gx, float gy) const;
+    bool onLine(float gx, float gy) const;
+
+private:
+    std::vector<float> joints;
+
+    float x, y, heading;
+    float bodyHeight;
+    float ballX, ballY;
+
+    // Where the planted foot is on the field
+    bool leftPlanted;
+    float plantedX, plantedY, plantedYaw;
+    float swingHeight;
+
+    // Y, U, V of each Color
+    unsigned char palette[NUM_COLORS][3];
+};
+
+#endif // SimWorld_h_DEFINED
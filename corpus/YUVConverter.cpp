@@ -0,0 +1,321 @@
+
+// This file is part of Man, a robotic perception, locomotion, and
+// team strategy application created by the Northern Bites RoboCup
+// team of Bowdoin College in Brunswick, Maine, for the Aldebaran
+// Nao robot.
+//
+// Man is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Man is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and the GNU Lesser Public License along with Man.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <cassert>
+#include <cstring>
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+#include "YUVConverter.h"
+
+using namespace std;
+
+// Offsets of the values in a pair of pixels
+static const int Y1_OFFSET = 0;
+static const int U_OFFSET = 1;
+static const int Y2_OFFSET = 2;
+static const int V_OFFSET = 3;
+
+// Rounds up like the SSE2 average does
+static inline unsigned char average(unsigned char a, unsigned char b)
+{
+    return static_cast<unsigned char>((a + b + 1) >> 1);
+}
+
+// Three quarters a, one quarter b
+static inline unsigned char blend(unsigned char a, unsigned char b)
+{
+    return average(a, average(a, b));
+}
+
+YUVConverter::YUVConverter(int _width, int _height, int _scale,
+                           Filter _filter)
+    : width(_width), height(_height), scale(_scale), filter(_filter)
+{
+    assert(width % 2 == 0);
+    assert(scale == 1 || scale == 2);
+
+    for (int c = 0; c < 3; ++c) {
+        planes[c].resize(width * height);
+        rows[c].resize(width + 2 * PAD);
+        wide[c].resize(width * scale + 2 * PAD);
+    }
+}
+
+/**
+ * The formula was reverse engineered from the one in the TOOL, and is the
+ * published one with R and B switched in the input (and so U and V
+ * switched in the output).  Every intermediate fits in 16 bits, which the
+ * vector version relies on.
+ */
+void YUVConverter::toYUV(int r, int g, int b, unsigned char &y,
+                         unsigned char &u, unsigned char &v)
+{
+    y = static_cast<unsigned char>(16 + ((25 * r + 129 * g + 66 * b) >> 8));
+    v = static_cast<unsigned char>(128 + ((112 * r - 74 * g - 37 * b) >> 8));
+    u = static_cast<unsigned char>(128 + ((-18 * r - 94 * g + 112 * b) >> 8));
+}
+
+void YUVConverter::convert(const unsigned char *rgb, unsigned char *yuv)
+{
+    run(rgb, yuv, true);
+}
+
+void YUVConverter::convertScalar(const unsigned char *rgb, unsigned char *yuv)
+{
+    run(rgb, yuv, false);
+}
+
+void YUVConverter::run(const unsigned char *rgb, unsigned char *yuv,
+                       bool vector)
+{
+    toPlanes(rgb, width * height, &planes[0][0], &planes[1][0],
+             &planes[2][0], vector);
+
+    const int outWidth = getOutputWidth();
+    const int rowBytes = outWidth * 2;
+    for (int outRow = 0; outRow < getOutputHeight(); ++outRow) {
+        unsigned char *out = yuv + outRow * rowBytes;
+        if (scale == 2 && filter == NEAREST && outRow % 2 == 1) {
+            memcpy(out, out - rowBytes, rowBytes);
+            continue;
+        }
+        makeRow(outRow, vector);
+        packRow(&wide[0][PAD], &wide[1][PAD], &wide[2][PAD], outWidth, out,
+                vector);
+    }
+}
+
+/**
+ * Fills the wide rows with the planes scaled to the given output row, and
+ * the pixel before each row with its first, for the chroma filter.
+ */
+void YUVConverter::makeRow(int outRow, bool vector)
+{
+    for (int c = 0; c < 3; ++c) {
+        unsigned char *out = &wide[c][PAD];
+        if (scale == 1) {
+            memcpy(out, &planes[c][outRow * width], width);
+            out[-1] = out[0];
+            continue;
+        }
+
+        const int near = outRow / 2;
+        unsigned char *row = &rows[c][PAD];
+        if (filter == NEAREST) {
+            memcpy(row, &planes[c][near * width], width);
+        } else {
+            // Output rows sit a quarter of a source row either side
+            int far = (outRow % 2 == 0 ? near - 1 : near + 1);
+            far = (far < 0 ? 0 : (far >= height ? height - 1 : far));
+            blendRows(&planes[c][near * width], &planes[c][far * width],
+                      width, row, vector);
+        }
+        row[-1] = row[0];
+        row[width] = row[width - 1];
+
+        widenRow(row, width, filter, out, vector);
+        out[-1] = out[0];
+    }
+}
+
+void YUVConverter::toPlanes(const unsigned char *rgb, int n,
+                            unsigned char *y, unsigned char *u,
+                            unsigned char *v, bool vector)
+{
+    int i = 0;
+#ifdef __SSE2__
+    if (vector) {
+        const __m128i yr = _mm_set1_epi16(25), yg = _mm_set1_epi16(129);
+        const __m128i yb = _mm_set1_epi16(66);
+        const __m128i vr = _mm_set1_epi16(112), vg = _mm_set1_epi16(-74);
+        const __m128i vb = _mm_set1_epi16(-37);
+        const __m128i ur = _mm_set1_epi16(-18), ug = _mm_set1_epi16(-94);
+        const __m128i ub = _mm_set1_epi16(112);
+        const __m128i yOffset = _mm_set1_epi16(16);
+        const __m128i uvOffset = _mm_set1_epi16(128);
+
+        // SSE2 has no byte shuffle, so each pixel is read as a 32 bit
+        // lane, with the next pixel's red on top, and the channels masked
+        // out of the lanes. Stops a pixel short to stay inside the image.
+        const __m128i mask = _mm_set1_epi32(0xff);
+        for (; i + 8 < n; i += 8) {
+            const unsigned char *p = rgb + i * 3;
+            int lanes[8];
+            for (int k = 0; k < 8; ++k) {
+                memcpy(&lanes[k], p + 3 * k, sizeof(int));
+            }
+            const __m128i lo = _mm_setr_epi32(lanes[0], lanes[1], lanes[2],
+                                              lanes[3]);
+            const __m128i hi = _mm_setr_epi32(lanes[4], lanes[5], lanes[6],
+                                              lanes[7]);
+
+            const __m128i r16 =
+                _mm_packs_epi32(_mm_and_si128(lo, mask),
+                                _mm_and_si128(hi, mask));
+            const __m128i g16 =
+                _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), mask),
+                                _mm_and_si128(_mm_srli_epi32(hi, 8), mask));
+            const __m128i b16 =
+                _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), mask),
+                                _mm_and_si128(_mm_srli_epi32(hi, 16), mask));
+
+            // Y's sum only fits unsigned, U's and V's only signed
+            __m128i sum = _mm_add_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(r16, yr),
+                              _mm_mullo_epi16(g16, yg)),
+                _mm_mullo_epi16(b16, yb));
+            const __m128i y16 = _mm_add_epi16(_mm_srli_epi16(sum, 8),
+                                              yOffset);
+            sum = _mm_add_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(r16, ur),
+                              _mm_mullo_epi16(g16, ug)),
+                _mm_mullo_epi16(b16, ub));
+            const __m128i u16 = _mm_add_epi16(_mm_srai_epi16(sum, 8),
+                                              uvOffset);
+            sum = _mm_add_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(r16, vr),
+                              _mm_mullo_epi16(g16, vg)),
+                _mm_mullo_epi16(b16, vb));
+            const __m128i v16 = _mm_add_epi16(_mm_srai_epi16(sum, 8),
+                                              uvOffset);
+
+            _mm_storel_epi64((__m128i*)(y + i), _mm_packus_epi16(y16, y16));
+            _mm_storel_epi64((__m128i*)(u + i), _mm_packus_epi16(u16, u16));
+            _mm_storel_epi64((__m128i*)(v + i), _mm_packus_epi16(v16, v16));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const unsigned char *p = rgb + i * 3;
+        toYUV(p[0], p[1], p[2], y[i], u[i], v[i]);
+    }
+}
+
+void YUVConverter::blendRows(const unsigned char *near,
+                             const unsigned char *far, int n,
+                             unsigned char *out, bool vector)
+{
+    int i = 0;
+#ifdef __SSE2__
+    if (vector) {
+        for (; i + 16 <= n; i += 16) {
+            const __m128i a = _mm_loadu_si128((const __m128i*)(near + i));
+            const __m128i b = _mm_loadu_si128((const __m128i*)(far + i));
+            _mm_storeu_si128((__m128i*)(out + i),
+                             _mm_avg_epu8(a, _mm_avg_epu8(a, b)));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = blend(near[i], far[i]);
+    }
+}
+
+/**
+ * Doubles a row.  Bilinear puts the two new pixels a quarter of a pixel
+ * either side of the old one, so it reads one pixel before and one after
+ * the row.
+ */
+void YUVConverter::widenRow(const unsigned char *in, int n, Filter filter,
+                            unsigned char *out, bool vector)
+{
+    int i = 0;
+#ifdef __SSE2__
+    if (vector) {
+        for (; i + 16 <= n; i += 16) {
+            const __m128i c = _mm_loadu_si128((const __m128i*)(in + i));
+            __m128i left = c, right = c;
+            if (filter == BILINEAR) {
+                const __m128i l =
+                    _mm_loadu_si128((const __m128i*)(in + i - 1));
+                const __m128i r =
+                    _mm_loadu_si128((const __m128i*)(in + i + 1));
+                left = _mm_avg_epu8(c, _mm_avg_epu8(c, l));
+                right = _mm_avg_epu8(c, _mm_avg_epu8(c, r));
+            }
+            _mm_storeu_si128((__m128i*)(out + 2 * i),
+                             _mm_unpacklo_epi8(left, right));
+            _mm_storeu_si128((__m128i*)(out + 2 * i + 16),
+                             _mm_unpackhi_epi8(left, right));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (filter == BILINEAR) {
+            out[2 * i] = blend(in[i], in[i - 1]);
+            out[2 * i + 1] = blend(in[i], in[i + 1]);
+        } else {
+            out[2 * i] = out[2 * i + 1] = in[i];
+        }
+    }
+}
+
+/**
+ * Packs a row of n pixels.  The chroma of a pair is its first pixel's,
+ * filtered with half of each neighbour: the second pixel of the pair and
+ * the last of the pair before, so reads one pixel before the row.
+ */
+void YUVConverter::packRow(const unsigned char *y, const unsigned char *u,
+                           const unsigned char *v, int n, unsigned char *out,
+                           bool vector)
+{
+    int i = 0;
+#ifdef __SSE2__
+    if (vector) {
+        const __m128i low = _mm_set1_epi16(0x00ff);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= n; i += 16) {
+            const __m128i ys = _mm_loadu_si128((const __m128i*)(y + i));
+            __m128i chroma[2];
+            const unsigned char *planes[2] = { u, v };
+            for (int c = 0; c < 2; ++c) {
+                const __m128i here =
+                    _mm_loadu_si128((const __m128i*)(planes[c] + i));
+                const __m128i before =
+                    _mm_loadu_si128((const __m128i*)(planes[c] + i - 2));
+                // The first pixels of the pairs, and the second pixels of
+                // this pair and the one before
+                const __m128i first =
+                    _mm_packus_epi16(_mm_and_si128(here, low), zero);
+                const __m128i second =
+                    _mm_packus_epi16(_mm_srli_epi16(here, 8), zero);
+                const __m128i previous =
+                    _mm_packus_epi16(_mm_srli_epi16(before, 8), zero);
+                chroma[c] = _mm_avg_epu8(first,
+                                         _mm_avg_epu8(previous, second));
+            }
+            const __m128i uv = _mm_unpacklo_epi8(chroma[0], chroma[1]);
+            _mm_storeu_si128((__m128i*)(out + 2 * i),
+                             _mm_unpacklo_epi8(ys, uv));
+            _mm_storeu_si128((__m128i*)(out + 2 * i + 16),
+                             _mm_unpackhi_epi8(ys, uv));
+        }
+    }
+#endif
+    for (; i < n; i += 2) {
+        unsigned char *pair = out + 2 * i;
+        pair[Y1_OFFSET] = y[i];
+        pair[Y2_OFFSET] = y[i + 1];
+        pair[U_OFFSET] = average(u[i], average(u[i - 1], u[i + 1]));
+        pair[V_OFFSET] = average(v[i], average(v[i - 1], v[i + 1]));
+    }
+}
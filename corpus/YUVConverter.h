@@ -0,0 +1,79 @@
+#ifndef YUVConverter_h_DEFINED
+#define YUVConverter_h_DEFINED
+
+#include <vector>
+
+/**
+ * Converts packed 24 bit RGB images into the YUV422 images vision expects,
+ * with two pixels in every four bytes, Y1 U Y2 V, optionally doubling
+ * the image in both directions on the way.
+ *
+ * The conversion goes through planar Y, U and V at the source resolution,
+ * which are then scaled a row at a time, nearest or bilinear, and packed.
+ * The chroma of each pair of pixels is sited on the first of the two, as
+ * in the camera's images, and filtered 1-2-1 from the pixels around it so
+ * edges don't alias into false colors. Where SSE2 is available every stage
+ * works on 16 pixels at a time; the results are the same either way, down
+ * to the rounding, so convertScalar() is the reference for convert().
+ *
+ * Knows nothing about Webots, so it can be tested on plain buffers.
+ */
+class YUVConverter
+{
+public:
+    enum Filter {
+        NEAREST,
+        BILINEAR
+    };
+
+    /**
+     * @param width   of the RGB images, in pixels, even
+     * @param height  of the RGB images
+     * @param scale   1 to keep the size, 2 to double it
+     */
+    YUVConverter(int width, int height, int scale = 1,
+                 Filter filter = NEAREST);
+
+    // rgb holds width * height * 3 bytes, yuv getOutputBytes()
+    void convert(const unsigned char *rgb, unsigned char *yuv);
+    void convertScalar(const unsigned char *rgb, unsigned char *yuv);
+
+    int getOutputWidth() const { return width * scale; }
+    int getOutputHeight() const { return height * scale; }
+    int getOutputBytes() const {
+        return getOutputWidth() * getOutputHeight() * 2;
+    }
+
+    // The color of a single pixel, as the whole image computes it
+    static void toYUV(int r, int g, int b, unsigned char &y,
+                      unsigned char &u, unsigned char &v);
+
+private:
+    void run(const unsigned char *rgb, unsigned char *yuv, bool vector);
+    void makeRow(int outRow, bool vector);
+
+    static void toPlanes(const unsigned char *rgb, int n,
+                         unsigned char *y, unsigned char *u,
+                         unsigned char *v, bool vector);
+    static void blendRows(const unsigned char *near, const unsigned char *far,
+                          int n, unsigned char *out, bool vector);
+    static void widenRow(const unsigned char *in, int n, Filter filter,
+                         unsigned char *out, bool vector);
+    static void packRow(const unsigned char *y, const unsigned char *u,
+                        const unsigned char *v, int n, unsigned char *out,
+                        bool vector);
+
+private:
+    // Room on each side of the row buffers for the filters to reach over
+    static const int PAD = 16;
+
+    const int width, height, scale;
+    const Filter filter;
+
+    std::vector<unsigned char> planes[3];
+    // A source row blended for the current output row, then the output row
+    std::vector<unsigned char> rows[3];
+    std::vector<unsigned char> wide[3];
+};
+
+#endif // YUVConverter_h_DEFINED
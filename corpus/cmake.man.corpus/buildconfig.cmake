@@ -38,6 +38,11 @@ OPTION(
     "Turn on/off the actual backend proxy calls to the ALLeds module"
     ON
     )
+OPTION(
+    USE_FUTEX_SYNCHRO
+    "Build Event and Semaphore on futexes rather than pthread condition variables (Linux only)"
+    ON
+    )
 
 OPTION(
     DEBUG_THREAD
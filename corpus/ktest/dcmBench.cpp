@@ -0,0 +1,316 @@
+/**
+ * dcmBench.cpp - what DCMCommandBuilder sends, against a mock DCM
+ *
+ * The mock keeps the value every actuator was last sent, and counts the
+ * calls and roughly how many bytes their ALValues would take (4 for each
+ * number and each list, and the length of each string). Checks that:
+ *  - the first flush sends every group that has been given values,
+ *  - after every flush each actuator holds the value it was last given,
+ *  - a flush where nothing changed sends nothing,
+ *  - a group is sent whole when any of it changes, and only then,
+ *  - stiffnesses are clipped and each kind of actuator gets its delay.
+ * Then runs cycles of standing still and of walking, with the lights
+ * changing now and then, and compares the calls and bytes per cycle with
+ * what NaoEnactor and NaoLights sent before the builder, which was the
+ * same commands but the joints every cycle.
+ */
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "DCMCommandBuilder.h"
+#include "Lights.h"
+#include "Common.h"
+#include "NBMath.h"
+
+using namespace std;
+using namespace Kinematics;
+
+static const int NUM_CYCLES = 10000;
+// The lights change about as often as vision runs
+static const int CYCLES_PER_LIGHT_CHANGE = 3;
+// NaoEnactor sets the ultrasound mode every this many cycles
+static const int CYCLES_PER_US = 13;
+static const int NOW = 1000;
+
+static const int NUMBER_BYTES = 4;
+static const int LIST_BYTES = 4;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+// A "ClearAll", "time-separate" setAlias of n values at one time
+static int aliasBytes(const string &alias, int n)
+{
+    return alias.size() + 8 + 13 + NUMBER_BYTES + // name, mode, importance
+        2 * LIST_BYTES + NUMBER_BYTES +           // the time list
+        n * (LIST_BYTES + NUMBER_BYTES);          // a value list each
+}
+
+// The "Merge" set of the ultrasound mode
+static int usBytes()
+{
+    return 17 + 5 + 2 * LIST_BYTES + 2 * NUMBER_BYTES;
+}
+
+class MockDCM : public DCMSender
+{
+public:
+    MockDCM(const DCMCommandBuilder &_builder)
+        : builder(_builder),
+          values(builder.numActuators(), -100.0f),
+          times(builder.numActuators(), 0),
+          groupCalls(DCMCommandBuilder::NUM_GROUPS, 0),
+          calls(0), bytes(0)
+    {
+    }
+
+    int getTime(int offset) { return NOW + offset; }
+
+    void send(unsigned int group, const float *v, int t) {
+        ++calls;
+        ++groupCalls[group];
+        const unsigned int start = builder.groupStart(group);
+        const unsigned int size = builder.groupSize(group);
+        for (unsigned int i = 0; i < size; ++i) {
+            values[start + i] = v[i];
+            times[start + i] = t;
+        }
+        bytes += group == DCMCommandBuilder::ULTRASOUND_GROUP ? usBytes() :
+            aliasBytes(builder.groupName(group), size);
+    }
+
+    void reset() {
+        calls = bytes = 0;
+        groupCalls.assign(groupCalls.size(), 0);
+    }
+
+    const DCMCommandBuilder &builder;
+    vector<float> values;
+    vector<int> times;
+    vector<long long> groupCalls;
+    long long calls;
+    long long bytes;
+};
+
+/**
+ * What the commands NaoEnactor and NaoLights used to make would take
+ */
+struct OldCommands
+{
+    OldCommands() : calls(0), bytes(0) { }
+
+    void aliasCommand(const string &alias, int n) {
+        ++calls;
+        bytes += aliasBytes(alias, n);
+    }
+    void usCommand() {
+        ++calls;
+        bytes += usBytes();
+    }
+
+    long long calls;
+    long long bytes;
+};
+
+// What each actuator was last given, as the builder should have it
+struct Expected
+{
+    Expected(unsigned int n) : values(n, -100.0f), given(n, false) { }
+
+    void set(unsigned int i, float v) { values[i] = v; given[i] = true; }
+
+    bool matches(const MockDCM &dcm) const {
+        for (unsigned int i = 0; i < values.size(); ++i) {
+            if (given[i] && dcm.values[i] != values[i])
+                return false;
+        }
+        return true;
+    }
+
+    vector<float> values;
+    vector<bool> given;
+};
+
+static void setLeds(DCMCommandBuilder &builder, Expected &expected,
+                    unsigned int group, float level)
+{
+    vector<float> values(builder.ledGroupSize(group));
+    for (unsigned int i = 0; i < values.size(); ++i)
+        values[i] = level * (i % 3) / 2.0f;
+    builder.setLeds(group, &values[0]);
+    for (unsigned int i = 0; i < values.size(); ++i)
+        expected.set(builder.ledGroupStart(group) + i, values[i]);
+}
+
+static void setJoints(DCMCommandBuilder &builder, Expected &expected,
+                      const vector<float> &joints,
+                      const vector<float> &stiffnesses)
+{
+    builder.setJoints(joints);
+    builder.setStiffnesses(stiffnesses);
+    for (unsigned int i = 0; i < NUM_JOINTS; ++i) {
+        expected.set(DCMCommandBuilder::JOINT_POSITIONS + i, joints[i]);
+        float s = stiffnesses[i];
+        s = s > 1.0f ? 1.0f : (s < -1.0f ? -1.0f : s);
+        expected.set(DCMCommandBuilder::JOINT_STIFFNESSES + i, s);
+    }
+}
+
+static void checkBasics()
+{
+    DCMCommandBuilder builder;
+    MockDCM dcm(builder);
+    Expected expected(builder.numActuators());
+
+    unsigned int leds = 0;
+    for (unsigned int g = 0; g < ALNames::NUM_UNIQUE_LEDS; ++g)
+        leds += builder.ledGroupSize(g);
+    check(builder.numActuators() == 2 * NUM_JOINTS + leds + 1,
+          "there is every joint, stiffness, LED and the ultrasound");
+    check(builder.groupName(DCMCommandBuilder::JOINT_GROUP) ==
+          "AllActuatorPosition" &&
+          builder.groupName(DCMCommandBuilder::STIFFNESS_GROUP) ==
+          "AllActuatorHardness" &&
+          builder.groupName(DCMCommandBuilder::FIRST_LED_GROUP) ==
+          Lights::LED_NAMES[0],
+          "the aliases keep the names they had");
+
+    // The LEDs start off, and go out on the first flush
+    for (unsigned int i = DCMCommandBuilder::LEDS;
+         i < DCMCommandBuilder::LEDS + leds; ++i)
+        expected.set(i, 0.0f);
+
+    vector<float> joints(NUM_JOINTS, 0.1f);
+    vector<float> stiffnesses(NUM_JOINTS, 2.0f);
+    setJoints(builder, expected, joints, stiffnesses);
+    check(builder.flush(dcm) == 2 + ALNames::NUM_UNIQUE_LEDS &&
+          dcm.calls == 2 + ALNames::NUM_UNIQUE_LEDS,
+          "the first flush sends every group given, a call each");
+    check(expected.matches(dcm), "the first flush sends the values given");
+    check(dcm.values[DCMCommandBuilder::JOINT_STIFFNESSES] == 1.0f,
+          "stiffnesses are clipped");
+    check(dcm.times[DCMCommandBuilder::JOINT_POSITIONS] ==
+          NOW + DCMCommandBuilder::JOINT_DELAY_MS &&
+          dcm.times[DCMCommandBuilder::JOINT_STIFFNESSES] ==
+          NOW + DCMCommandBuilder::STIFFNESS_DELAY_MS &&
+          dcm.times[DCMCommandBuilder::LEDS] ==
+          NOW + DCMCommandBuilder::LED_DELAY_MS,
+          "each kind of actuator gets its own delay");
+    check(dcm.values[builder.ultraSoundIndex()] == -100.0f,
+          "the ultrasound is not sent until it is set");
+
+    dcm.reset();
+    setJoints(builder, expected, joints, stiffnesses);
+    check(builder.flush(dcm) == 0 && dcm.calls == 0,
+          "nothing changed, nothing sent");
+
+    joints[HEAD_PITCH] = 0.2f;
+    setJoints(builder, expected, joints, stiffnesses);
+    setLeds(builder, expected, 2, 1.0f);
+    builder.setUltraSound(3.0f);
+    expected.set(builder.ultraSoundIndex(), 3.0f);
+    check(builder.flush(dcm) == 3 &&
+          dcm.groupCalls[DCMCommandBuilder::JOINT_GROUP] == 1 &&
+          dcm.groupCalls[DCMCommandBuilder::STIFFNESS_GROUP] == 0 &&
+          dcm.groupCalls[DCMCommandBuilder::FIRST_LED_GROUP + 2] == 1 &&
+          dcm.groupCalls[DCMCommandBuilder::ULTRASOUND_GROUP] == 1,
+          "only the groups that changed are sent");
+    check(expected.matches(dcm), "and they are what was given");
+    bool whole = true;
+    for (unsigned int i = 0; i < NUM_JOINTS; ++i)
+        whole = whole && dcm.times[DCMCommandBuilder::JOINT_POSITIONS + i] ==
+            NOW + DCMCommandBuilder::JOINT_DELAY_MS;
+    check(whole, "a group is sent whole when one of it changes");
+    check(dcm.times[builder.ultraSoundIndex()] ==
+          NOW + DCMCommandBuilder::US_DELAY_MS,
+          "the ultrasound gets its delay");
+}
+
+/**
+ * Joints as they move while walking: the legs and arms swing, the head
+ * holds still
+ */
+static void walkingJoints(int cycle, vector<float> &joints)
+{
+    const float phase = cycle * 2.0f * M_PI_FLOAT / 50.0f;
+    for (unsigned int i = 0; i < NUM_JOINTS; ++i)
+        joints[i] = i < HEAD_JOINTS ? 0.0f : 0.3f * sinf(phase + i);
+}
+
+static void runCycles(const char *what, bool walking)
+{
+    DCMCommandBuilder builder;
+    MockDCM dcm(builder);
+    OldCommands old;
+    Expected expected(builder.numActuators());
+
+    vector<float> joints(NUM_JOINTS, 0.0f);
+    const vector<float> stiffnesses(NUM_JOINTS, 0.85f);
+    vector<int> hex(ALNames::NUM_UNIQUE_LEDS, 0);
+    bool allMatched = true;
+
+    // Settle in first, so the first flush is not counted
+    setJoints(builder, expected, joints, stiffnesses);
+    builder.flush(dcm);
+    dcm.reset();
+
+    for (int cycle = 0; cycle < NUM_CYCLES; ++cycle) {
+        if (walking)
+            walkingJoints(cycle, joints);
+        setJoints(builder, expected, joints, stiffnesses);
+        old.aliasCommand("AllActuatorPosition", NUM_JOINTS);
+
+        // One group changes color each time vision runs
+        if (cycle % CYCLES_PER_LIGHT_CHANGE == 0) {
+            const unsigned int group =
+                (cycle / CYCLES_PER_LIGHT_CHANGE) % ALNames::NUM_UNIQUE_LEDS;
+            hex[group] = hex[group] ? 0 : 1;
+            setLeds(builder, expected, group, static_cast<float>(hex[group]));
+            old.aliasCommand(Lights::LED_NAMES[group],
+                             builder.ledGroupSize(group));
+        }
+
+        if (cycle % CYCLES_PER_US == 0) {
+            const float mode = static_cast<float>((cycle / CYCLES_PER_US) % 4);
+            builder.setUltraSound(mode);
+            expected.set(builder.ultraSoundIndex(), mode);
+            old.usCommand();
+        }
+
+        builder.flush(dcm);
+        allMatched = allMatched && expected.matches(dcm);
+    }
+
+    char message[128];
+    snprintf(message, sizeof(message),
+             "%s: every actuator holds what it was last given", what);
+    check(allMatched, message);
+
+    printf("%-9s builder %5.2f calls %6.1f bytes per cycle;"
+           " before %5.2f calls %6.1f bytes\n", what,
+           dcm.calls / static_cast<double>(NUM_CYCLES),
+           dcm.bytes / static_cast<double>(NUM_CYCLES),
+           old.calls / static_cast<double>(NUM_CYCLES),
+           old.bytes / static_cast<double>(NUM_CYCLES));
+}
+
+int main()
+{
+    checkBasics();
+    runCycles("standing", false);
+    runCycles("walking", true);
+
+    if (failures)
+        return 1;
+    printf("all checks passed\n");
+    return 0;
+}
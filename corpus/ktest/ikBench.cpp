@@ -0,0 +1,311 @@
+/**
+ * ikBench.cpp - accuracy and speed of the leg IK
+ *
+ * Samples foot goals over the walking workspace, with foot and body
+ * orientations like the walk uses, keeping those both legs can reach, and
+ * solves them with legIKPair. forwardKinematics on the resulting angles has
+ * to put the heel back on the goal (taken into the body frame). The same goals are
+ * solved one leg at a time with analyticLegIK, which must agree, and the
+ * heel-only goals go through dls from a cold and a warm start.
+ *
+ * Then each solver is timed over the same samples.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "InverseKinematics.h"
+#include "Common.h"
+
+using namespace NBMath;
+using namespace std;
+using namespace Kinematics;
+
+static const int NUM_SAMPLES = 20000;
+static const int NUM_DLS_SAMPLES = 2000;
+// How far the heel may end up from the goal, in mm
+static const float MAX_FK_ERROR = 0.01f;
+
+static float randomIn(float low, float high)
+{
+    return low + (high - low) * (static_cast<float>(rand()) / RAND_MAX);
+}
+
+static IKLegPairGoal randomGoal()
+{
+    IKLegPairGoal g;
+    for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+        const float sign = (leg == IK_LEFT_LEG ? 1.0f : -1.0f);
+        g.footGoal[0][leg] = randomIn(-70.0f, 70.0f);
+        g.footGoal[1][leg] = sign * randomIn(10.0f, 110.0f);
+        g.footGoal[2][leg] = randomIn(-310.0f, -250.0f);
+        g.footOrientation[0][leg] = randomIn(-0.05f, 0.05f);
+        g.footOrientation[1][leg] = randomIn(-0.2f, 0.2f);
+        g.footOrientation[2][leg] = sign * randomIn(-0.1f, 0.4f);
+    }
+    g.bodyGoal[0] = randomIn(-10.0f, 10.0f);
+    g.bodyGoal[1] = randomIn(-10.0f, 10.0f);
+    g.bodyGoal[2] = randomIn(-5.0f, 5.0f);
+    g.bodyOrientation[0] = randomIn(-0.1f, 0.1f);
+    g.bodyOrientation[1] = randomIn(-0.1f, 0.3f);
+    g.bodyOrientation[2] = 0.0f;
+    return g;
+}
+
+static ufvector3 footGoal(const IKLegPairGoal &g, int leg)
+{
+    return CoordFrame3D::vector3D(g.footGoal[0][leg], g.footGoal[1][leg],
+                                  g.footGoal[2][leg]);
+}
+
+static ufvector3 footOrientation(const IKLegPairGoal &g, int leg)
+{
+    return CoordFrame3D::vector3D(g.footOrientation[0][leg],
+                                  g.footOrientation[1][leg],
+                                  g.footOrientation[2][leg]);
+}
+
+static ufvector3 bodyGoal(const IKLegPairGoal &g)
+{
+    return CoordFrame3D::vector3D(g.bodyGoal[0], g.bodyGoal[1],
+                                  g.bodyGoal[2]);
+}
+
+static ufvector3 bodyOrientation(const IKLegPairGoal &g)
+{
+    return CoordFrame3D::vector3D(g.bodyOrientation[0], g.bodyOrientation[1],
+                                  g.bodyOrientation[2]);
+}
+
+// Where the heel should be in the body frame, which is the frame
+// forwardKinematics works in
+static ufvector3 heelGoal_c(const IKLegPairGoal &g, int leg)
+{
+    float r[3][3];
+    rotation6D(g.bodyOrientation[0], g.bodyOrientation[1],
+               g.bodyOrientation[2], r);
+    float d[3];
+    for (int i = 0; i < 3; ++i) {
+        d[i] = g.footGoal[i][leg] - g.bodyGoal[i];
+    }
+    return CoordFrame3D::vector3D(r[0][0]*d[0] + r[1][0]*d[1] + r[2][0]*d[2],
+                                  r[0][1]*d[0] + r[1][1]*d[1] + r[2][1]*d[2],
+                                  r[0][2]*d[0] + r[1][2]*d[1] + r[2][2]*d[2]);
+}
+
+// How far a foot moves between two motion frames, about
+static ufvector3 nudge()
+{
+    return CoordFrame3D::vector3D(2.0f, -1.0f, 1.5f);
+}
+
+static ChainID chainFor(int leg)
+{
+    return (leg == IK_LEFT_LEG ? LLEG_CHAIN : RLEG_CHAIN);
+}
+
+/**
+ * Samples n goals that both legs can reach. legIKPair reports every goal out
+ * of reach on stdout, so goals are screened with analyticLegIK, which solves
+ * the same way but quietly, and the ones out of reach are only counted.
+ */
+static vector<IKLegPairGoal> makeSamples(int n)
+{
+    vector<IKLegPairGoal> samples;
+    samples.reserve(n);
+    int outOfReach = 0;
+    while (static_cast<int>(samples.size()) < n) {
+        const IKLegPairGoal g = randomGoal();
+        bool reachable = true;
+        for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+            reachable = reachable &&
+                analyticLegIK(chainFor(leg), footGoal(g, leg),
+                              footOrientation(g, leg), bodyGoal(g),
+                              bodyOrientation(g)).outcome == SUCCESS;
+        }
+        if (reachable) {
+            samples.push_back(g);
+        } else {
+            outOfReach++;
+        }
+    }
+    printf("sampled %d goals in reach of both legs, skipped %d out of "
+           "reach\n", n, outOfReach);
+    return samples;
+}
+
+/**
+ * Checks legIKPair against forwardKinematics and analyticLegIK. Returns the
+ * number of failures.
+ */
+static int checkAnalytic(const vector<IKLegPairGoal> &samples)
+{
+    int reached = 0, failures = 0;
+    float worstError = 0.0f, totalError = 0.0f, worstAngleDiff = 0.0f;
+
+    for (unsigned int k = 0; k < samples.size(); ++k) {
+        const IKLegPairGoal &g = samples[k];
+        const IKLegPairResult pair = legIKPair(g);
+
+        for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+            const IKLegResult single =
+                analyticLegIK(chainFor(leg), footGoal(g, leg),
+                              footOrientation(g, leg), bodyGoal(g),
+                              bodyOrientation(g));
+            for (unsigned int j = 0; j < LEG_JOINTS; ++j) {
+                const float diff = std::fabs(single.angles[j] -
+                                             pair.leg[leg].angles[j]);
+                if (diff > worstAngleDiff) {
+                    worstAngleDiff = diff;
+                }
+            }
+
+            if (pair.leg[leg].outcome != SUCCESS) {
+                continue;
+            }
+            reached++;
+            const float error =
+                norm_2(heelGoal_c(g, leg) -
+                       forwardKinematics(chainFor(leg),
+                                         pair.leg[leg].angles));
+            totalError += error;
+            if (error > worstError) {
+                worstError = error;
+            }
+            if (error > MAX_FK_ERROR) {
+                failures++;
+            }
+        }
+    }
+
+    printf("analytic: %d of %d legs in reach, heel error mean %.5fmm "
+           "worst %.5fmm, %d over %.3fmm\n",
+           reached, static_cast<int>(samples.size()) * NUM_IK_LEGS,
+           reached > 0 ? totalError / reached : 0.0f, worstError,
+           failures, MAX_FK_ERROR);
+    printf("analytic: legIKPair and analyticLegIK differ by at most %g rad\n",
+           worstAngleDiff);
+    if (worstAngleDiff != 0.0f) {
+        failures++;
+    }
+    return failures;
+}
+
+/**
+ * Heel-only goals through dls, once from zero, and once nudged by a couple
+ * of millimeters from the solution for the goal before it, as when the walk
+ * moves a foot from one frame to the next. Returns the number of failures.
+ */
+static int checkDLS(const vector<IKLegPairGoal> &samples)
+{
+    int failures = 0;
+    float worstCold = 0.0f, worstWarm = 0.0f;
+    const float zero[LEG_JOINTS] = {0.0f};
+
+    for (int k = 0; k < NUM_DLS_SAMPLES; ++k) {
+        for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+            const ufvector3 goal = footGoal(samples[k], leg);
+            const IKLegResult cold = dls(chainFor(leg), goal, zero);
+            const ufvector3 nextGoal = goal + nudge();
+            const IKLegResult warm = dls(chainFor(leg), nextGoal,
+                                         cold.angles);
+
+            const float coldError =
+                norm_2(goal - forwardKinematics(chainFor(leg), cold.angles));
+            const float warmError =
+                norm_2(nextGoal - forwardKinematics(chainFor(leg),
+                                                    warm.angles));
+            if (cold.outcome == SUCCESS) {
+                worstCold = std::max(worstCold, coldError);
+                failures += (coldError > ACCEPTABLE_ERROR);
+            }
+            if (warm.outcome == SUCCESS) {
+                worstWarm = std::max(worstWarm, warmError);
+                failures += (warmError > ACCEPTABLE_ERROR);
+            }
+        }
+    }
+    printf("dls: worst heel error %.5fmm cold, %.5fmm warm\n",
+           worstCold, worstWarm);
+    return failures;
+}
+
+static void benchmark(const vector<IKLegPairGoal> &samples)
+{
+    const int n = static_cast<int>(samples.size());
+    float sink = 0.0f;
+
+    long long start = micro_time();
+    for (int k = 0; k < n; ++k) {
+        const IKLegPairGoal &g = samples[k];
+        for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+            sink += analyticLegIK(chainFor(leg), footGoal(g, leg),
+                                  footOrientation(g, leg), bodyGoal(g),
+                                  bodyOrientation(g)).angles[0];
+        }
+    }
+    const long long single = micro_time() - start;
+
+    start = micro_time();
+    for (int k = 0; k < n; ++k) {
+        sink += legIKPair(samples[k]).leg[0].angles[0];
+    }
+    const long long pair = micro_time() - start;
+
+    // Start points for the warm runs, each solved from zero
+    const float zero[LEG_JOINTS] = {0.0f};
+    vector<IKLegResult> starts;
+    for (int k = 0; k < NUM_DLS_SAMPLES; ++k) {
+        for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+            starts.push_back(dls(chainFor(leg), footGoal(samples[k], leg),
+                                 zero));
+        }
+    }
+
+    start = micro_time();
+    for (int k = 0; k < NUM_DLS_SAMPLES; ++k) {
+        for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+            sink += dls(chainFor(leg), footGoal(samples[k], leg),
+                        zero).angles[0];
+        }
+    }
+    const long long cold = micro_time() - start;
+
+    start = micro_time();
+    for (int k = 0; k < NUM_DLS_SAMPLES; ++k) {
+        for (int leg = 0; leg < NUM_IK_LEGS; ++leg) {
+            sink += dls(chainFor(leg), footGoal(samples[k], leg) + nudge(),
+                        starts[k * NUM_IK_LEGS + leg].angles).angles[0];
+        }
+    }
+    const long long warm = micro_time() - start;
+
+    printf("\nper pair of legs:\n");
+    printf("  analyticLegIK x2  %8.2fus\n", static_cast<float>(single) / n);
+    printf("  legIKPair         %8.2fus\n", static_cast<float>(pair) / n);
+    printf("  dls cold x2       %8.2fus\n",
+           static_cast<float>(cold) / NUM_DLS_SAMPLES);
+    printf("  dls warm x2       %8.2fus\n",
+           static_cast<float>(warm) / NUM_DLS_SAMPLES);
+    if (sink == 12345.0f) {
+        printf("\n");
+    }
+}
+
+int main()
+{
+    srand(1);
+    const vector<IKLegPairGoal> samples = makeSamples(NUM_SAMPLES);
+
+    int failures = checkAnalytic(samples);
+    failures += checkDLS(samples);
+    benchmark(samples);
+
+    if (failures > 0) {
+        printf("\n%d FAILURES\n", failures);
+        return 1;
+    }
+    printf("\nall ok\n");
+    return 0;
+}
@@ -0,0 +1,332 @@
+/**
+ * queueBench.cpp - correctness and throughput of the messaging queues
+ *
+ * Pushes numbered messages through an SPSCQueue from one producer, and
+ * through an MPSCQueue and a MessageQueue from several, and checks that:
+ *  - every message comes out exactly once,
+ *  - each producer's messages come out in the order it sent them,
+ *  - a full queue refuses a push and an empty one has no front.
+ * Then compares the messages per second of each against a std::list behind
+ * a mutex, which is what MessageQueue used to be.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/time.h>
+
+#include "messaging.h"
+
+using namespace std;
+
+static const unsigned int QUEUE_SIZE = 256;
+static const int NUM_PRODUCERS = 4;
+static const unsigned int MESSAGES_PER_PRODUCER = 2000000;
+
+struct Message
+{
+    unsigned int producer;
+    unsigned int seq;
+};
+
+static long long microseconds()
+{
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+/**
+ * What the consumer has seen of each producer so far
+ */
+class Tally
+{
+public:
+    Tally(int producers)
+        : next(producers, 0), received(0), outOfOrder(0) { }
+
+    void take(const Message &m) {
+        if (m.producer >= next.size() || m.seq != next[m.producer])
+            ++outOfOrder;
+        else
+            ++next[m.producer];
+        ++received;
+    }
+
+    void report(const char *what, unsigned int expected,
+                long long elapsed) {
+        char message[128];
+        snprintf(message, sizeof(message), "%s keeps each producer's order",
+                 what);
+        check(outOfOrder == 0, message);
+        snprintf(message, sizeof(message), "%s delivers every message once",
+                 what);
+        check(received == expected, message);
+        printf("%-26s %8.2f M messages/s\n", what,
+               received / static_cast<double>(elapsed));
+    }
+
+    vector<unsigned int> next;
+    unsigned int received;
+    unsigned int outOfOrder;
+};
+
+// The old MessageQueue: a list behind a mutex
+struct LockedList
+{
+    LockedList() { pthread_mutex_init(&mutex, NULL); }
+    ~LockedList() { pthread_mutex_destroy(&mutex); }
+
+    void push(const Message &m) {
+        pthread_mutex_lock(&mutex);
+        data.push_back(m);
+        pthread_mutex_unlock(&mutex);
+    }
+    bool pop(Message &m) {
+        pthread_mutex_lock(&mutex);
+        const bool found = !data.empty();
+        if (found) {
+            m = data.front();
+            data.pop_front();
+        }
+        pthread_mutex_unlock(&mutex);
+        return found;
+    }
+
+    list<Message> data;
+    pthread_mutex_t mutex;
+};
+
+template <class Q>
+struct Producer
+{
+    Q *queue;
+    unsigned int id;
+};
+
+static void* spscProducer(void *arg)
+{
+    Producer<SPSCQueue<Message, QUEUE_SIZE> > *p =
+        reinterpret_cast<Producer<SPSCQueue<Message, QUEUE_SIZE> >*>(arg);
+    for (unsigned int i = 0; i < MESSAGES_PER_PRODUCER; ++i) {
+        Message *slot;
+        while ((slot = p->queue->producerSlot()) == NULL)
+            sched_yield();
+        slot->producer = p->id;
+        slot->seq = i;
+        p->queue->push();
+    }
+    return NULL;
+}
+
+static void* mpscProducer(void *arg)
+{
+    Producer<MPSCQueue<Message, QUEUE_SIZE> > *p =
+        reinterpret_cast<Producer<MPSCQueue<Message, QUEUE_SIZE> >*>(arg);
+    Message m;
+    m.producer = p->id;
+    for (m.seq = 0; m.seq < MESSAGES_PER_PRODUCER; ++m.seq) {
+        while (!p->queue->push(m))
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void* messageQueueProducer(void *arg)
+{
+    Producer<MessageQueue<Message, QUEUE_SIZE> > *p =
+        reinterpret_cast<Producer<MessageQueue<Message, QUEUE_SIZE> >*>(arg);
+    Message m;
+    m.producer = p->id;
+    for (m.seq = 0; m.seq < MESSAGES_PER_PRODUCER; ++m.seq) {
+        while (!p->queue->append(m))
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void* lockedProducer(void *arg)
+{
+    Producer<LockedList> *p = reinterpret_cast<Producer<LockedList>*>(arg);
+    Message m;
+    m.producer = p->id;
+    for (m.seq = 0; m.seq < MESSAGES_PER_PRODUCER; ++m.seq)
+        p->queue->push(m);
+    return NULL;
+}
+
+template <class Q>
+static void startProducers(Q &queue, int n, void* (*run)(void*),
+                           vector<Producer<Q> > &producers,
+                           vector<pthread_t> &threads)
+{
+    producers.resize(n);
+    threads.resize(n);
+    for (int i = 0; i < n; ++i) {
+        producers[i].queue = &queue;
+        producers[i].id = i;
+        pthread_create(&threads[i], NULL, run, &producers[i]);
+    }
+}
+
+static void joinProducers(vector<pthread_t> &threads)
+{
+    for (unsigned int i = 0; i < threads.size(); ++i)
+        pthread_join(threads[i], NULL);
+}
+
+static void checkLimits()
+{
+    SPSCQueue<Message, 4> spsc;
+    for (int i = 0; i < 4; ++i) {
+        check(spsc.producerSlot() != NULL, "SPSCQueue takes N messages");
+        spsc.push();
+    }
+    check(spsc.producerSlot() == NULL, "a full SPSCQueue refuses more");
+
+    MPSCQueue<Message, 4> mpsc;
+    Message m;
+    m.producer = 0;
+    check(mpsc.front() == NULL, "an empty MPSCQueue has no front");
+    for (m.seq = 0; m.seq < 4; ++m.seq)
+        check(mpsc.push(m), "MPSCQueue takes N messages");
+    check(!mpsc.push(m), "a full MPSCQueue refuses more");
+    mpsc.pop();
+    check(mpsc.push(m), "MPSCQueue takes one more after a pop");
+    for (unsigned int seq = 1; seq <= 4; ++seq) {
+        check(mpsc.front() != NULL && mpsc.front()->seq == seq,
+              "MPSCQueue comes round the ring in order");
+        mpsc.pop();
+    }
+    check(mpsc.front() == NULL, "a drained MPSCQueue is empty");
+}
+
+static void runSPSC()
+{
+    SPSCQueue<Message, QUEUE_SIZE> *queue =
+        new SPSCQueue<Message, QUEUE_SIZE>();
+    vector<Producer<SPSCQueue<Message, QUEUE_SIZE> > > producers;
+    vector<pthread_t> threads;
+    Tally tally(1);
+
+    const long long start = microseconds();
+    startProducers(*queue, 1, spscProducer, producers, threads);
+    while (tally.received < MESSAGES_PER_PRODUCER) {
+        const Message *m = queue->front();
+        if (m == NULL) {
+            sched_yield();
+            continue;
+        }
+        tally.take(*m);
+        queue->pop();
+    }
+    joinProducers(threads);
+    tally.report("SPSCQueue, 1 producer", MESSAGES_PER_PRODUCER,
+                 microseconds() - start);
+    delete queue;
+}
+
+static void runMPSC()
+{
+    MPSCQueue<Message, QUEUE_SIZE> *queue =
+        new MPSCQueue<Message, QUEUE_SIZE>();
+    vector<Producer<MPSCQueue<Message, QUEUE_SIZE> > > producers;
+    vector<pthread_t> threads;
+    Tally tally(NUM_PRODUCERS);
+    const unsigned int expected = NUM_PRODUCERS * MESSAGES_PER_PRODUCER;
+
+    const long long start = microseconds();
+    startProducers(*queue, NUM_PRODUCERS, mpscProducer, producers, threads);
+    while (tally.received < expected) {
+        const Message *m = queue->front();
+        if (m == NULL) {
+            sched_yield();
+            continue;
+        }
+        tally.take(*m);
+        queue->pop();
+    }
+    joinProducers(threads);
+    tally.report("MPSCQueue, 4 producers", expected, microseconds() - start);
+    check(queue->front() == NULL, "MPSCQueue is empty at the end");
+    delete queue;
+}
+
+static void runMessageQueue()
+{
+    MessageQueue<Message, QUEUE_SIZE> *queue =
+        new MessageQueue<Message, QUEUE_SIZE>();
+    vector<Producer<MessageQueue<Message, QUEUE_SIZE> > > producers;
+    vector<pthread_t> threads;
+    Tally tally(NUM_PRODUCERS);
+    const unsigned int expected = NUM_PRODUCERS * MESSAGES_PER_PRODUCER;
+
+    vector<Message> batch;
+    batch.reserve(QUEUE_SIZE);
+    const long long start = microseconds();
+    startProducers(*queue, NUM_PRODUCERS, messageQueueProducer,
+                   producers, threads);
+    while (tally.received < expected) {
+        batch.clear();
+        if (queue->retrieveAll(batch) == 0) {
+            sched_yield();
+            continue;
+        }
+        for (unsigned int i = 0; i < batch.size(); ++i)
+            tally.take(batch[i]);
+    }
+    joinProducers(threads);
+    tally.report("MessageQueue, 4 producers", expected,
+                 microseconds() - start);
+    delete queue;
+}
+
+static void runLocked()
+{
+    LockedList queue;
+    vector<Producer<LockedList> > producers;
+    vector<pthread_t> threads;
+    Tally tally(NUM_PRODUCERS);
+    const unsigned int expected = NUM_PRODUCERS * MESSAGES_PER_PRODUCER;
+
+    const long long start = microseconds();
+    startProducers(queue, NUM_PRODUCERS, lockedProducer, producers, threads);
+    Message m;
+    while (tally.received < expected) {
+        if (!queue.pop(m)) {
+            sched_yield();
+            continue;
+        }
+        tally.take(m);
+    }
+    joinProducers(threads);
+    tally.report("locked list, 4 producers", expected,
+                 microseconds() - start);
+}
+
+int main()
+{
+    checkLimits();
+
+    runSPSC();
+    runMPSC();
+    runMessageQueue();
+    runLocked();
+
+    if (failures)
+        return 1;
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,227 @@
+/**
+ * syncBench.cpp - behaviour and speed of the synchro Event and Semaphore
+ *
+ * Built twice by the Makefile, as syncbench on futexes and as
+ * syncbench_pthread on condition variables, so the two can be run side by
+ * side.  Checks that:
+ *  - a signal nobody waits for is kept, and two of them are only one,
+ *  - a semaphore counts its posts,
+ *  - no wake up is lost handing an event or a semaphore back and forth,
+ *    and a semaphore posted to from two threads is waited on that many
+ *    times (a lost wake up hangs, which the alarm turns into a failure).
+ * Then times an uncontended signal and poll, and the round trip of
+ * ping-ponging an Event, or a Semaphore, between two threads.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "synchro.h"
+
+using namespace std;
+using boost::shared_ptr;
+
+static const int NUM_ROUND_TRIPS = 100000;
+static const int NUM_POLLS = 10000000;
+static const int NUM_POSTS = 1000000;
+// Seconds before a run that has lost a wake up is called stuck
+static const int STUCK_S = 60;
+
+static long long microseconds()
+{
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+static void stuck(int)
+{
+    printf("FAILED: stuck for %d s, a wake up was lost\n", STUCK_S);
+    exit(1);
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        printf("FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+struct EventPair
+{
+    shared_ptr<Event> ping, pong;
+    int trips;
+};
+
+static void* eventPonger(void *arg)
+{
+    EventPair *pair = reinterpret_cast<EventPair*>(arg);
+    for (int i = 0; i < pair->trips; ++i) {
+        pair->ping->await();
+        pair->pong->signal();
+    }
+    return NULL;
+}
+
+struct SemaphorePair
+{
+    Semaphore ping, pong;
+    int trips;
+};
+
+static void* semaphorePonger(void *arg)
+{
+    SemaphorePair *pair = reinterpret_cast<SemaphorePair*>(arg);
+    for (int i = 0; i < pair->trips; ++i) {
+        pair->ping.wait();
+        pair->pong.post();
+    }
+    return NULL;
+}
+
+static void* poster(void *arg)
+{
+    Semaphore *sem = reinterpret_cast<Semaphore*>(arg);
+    for (int i = 0; i < NUM_POSTS; ++i)
+        sem->post();
+    return NULL;
+}
+
+static void printLatencies(const char *what, vector<long long> &trips,
+                           long long total)
+{
+    sort(trips.begin(), trips.end());
+    printf("%-24s %8.2f us/trip  median %4lld us  99%% %4lld us  max %6lld us\n",
+           what,
+           static_cast<double>(total) / trips.size(),
+           trips[trips.size() / 2],
+           trips[trips.size() * 99 / 100],
+           trips.back());
+}
+
+static void checkSemantics(Synchro &synchro)
+{
+    shared_ptr<Event> e = synchro.create("semantics");
+    check(!e->poll(), "a new event is not signalled");
+    e->signal();
+    e->signal();
+    check(e->poll(), "a signal is kept until polled");
+    check(!e->poll(), "two signals are taken as one");
+    e->signal();
+    e->await();
+    check(!e->poll(), "await takes the signal");
+
+    Semaphore sem(2);
+    sem.post();
+    check(sem.tryWait() && sem.tryWait() && sem.tryWait(),
+          "a semaphore counts its posts");
+    check(!sem.tryWait(), "a semaphore runs out");
+}
+
+static void checkPosters()
+{
+    Semaphore sem;
+    pthread_t a, b;
+    pthread_create(&a, NULL, poster, &sem);
+    pthread_create(&b, NULL, poster, &sem);
+    for (int i = 0; i < 2 * NUM_POSTS; ++i)
+        sem.wait();
+    pthread_join(a, NULL);
+    pthread_join(b, NULL);
+    check(!sem.tryWait(), "every post is waited on once");
+}
+
+static void timePolls(Synchro &synchro)
+{
+    shared_ptr<Event> e = synchro.create("polls");
+    int caught = 0;
+    const long long start = microseconds();
+    for (int i = 0; i < NUM_POLLS; ++i) {
+        e->signal();
+        caught += e->poll();
+    }
+    const long long total = microseconds() - start;
+    check(caught == NUM_POLLS, "every signal is polled");
+    printf("%-24s %8.1f ns/pair\n", "signal + poll",
+           total * 1000.0 / NUM_POLLS);
+}
+
+static void timeEvents(Synchro &synchro)
+{
+    EventPair pair;
+    pair.ping = synchro.create("ping");
+    pair.pong = synchro.create("pong");
+    pair.trips = NUM_ROUND_TRIPS;
+
+    pthread_t ponger;
+    pthread_create(&ponger, NULL, eventPonger, &pair);
+
+    vector<long long> trips(NUM_ROUND_TRIPS);
+    const long long start = microseconds();
+    for (int i = 0; i < NUM_ROUND_TRIPS; ++i) {
+        const long long sent = microseconds();
+        pair.ping->signal();
+        pair.pong->await();
+        trips[i] = microseconds() - sent;
+    }
+    const long long total = microseconds() - start;
+    pthread_join(ponger, NULL);
+
+    printLatencies("Event ping-pong", trips, total);
+}
+
+static void timeSemaphores()
+{
+    SemaphorePair pair;
+    pair.trips = NUM_ROUND_TRIPS;
+
+    pthread_t ponger;
+    pthread_create(&ponger, NULL, semaphorePonger, &pair);
+
+    vector<long long> trips(NUM_ROUND_TRIPS);
+    const long long start = microseconds();
+    for (int i = 0; i < NUM_ROUND_TRIPS; ++i) {
+        const long long sent = microseconds();
+        pair.ping.post();
+        pair.pong.wait();
+        trips[i] = microseconds() - sent;
+    }
+    const long long total = microseconds() - start;
+    pthread_join(ponger, NULL);
+
+    printLatencies("Semaphore ping-pong", trips, total);
+}
+
+int main()
+{
+#ifdef USE_FUTEX_SYNCHRO
+    printf("futex synchro, %ld cpus\n", sysconf(_SC_NPROCESSORS_ONLN));
+#else
+    printf("pthread synchro, %ld cpus\n", sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    signal(SIGALRM, stuck);
+    alarm(STUCK_S);
+
+    Synchro synchro;
+    checkSemantics(synchro);
+    checkPosters();
+
+    timePolls(synchro);
+    timeEvents(synchro);
+    timeSemaphores();
+
+    if (failures)
+        return 1;
+    printf("all checks passed\n");
+    return 0;
+}
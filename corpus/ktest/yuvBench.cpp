@@ -0,0 +1,211 @@
+/**
+ * yuvBench.cpp - correctness and speed of the RGB to YUV422 conversion
+ *
+ * Converts random and smooth images of a few sizes with every scale and
+ * filter, and checks that:
+ *  - the vector conversion matches the scalar one byte for byte,
+ *  - a single color comes out as exactly that color everywhere,
+ *  - luma doubled by nearest is what the old per pixel conversion in
+ *    WBImageTranscriber made.
+ * Then times a Webots frame, 160x120 doubled to 320x240, the old way and
+ * with each filter.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "YUVConverter.h"
+#include "Common.h"
+
+using namespace std;
+
+static const int WEBOTS_WIDTH = 160;
+static const int WEBOTS_HEIGHT = 120;
+static const int NUM_TIMING_RUNS = 2000;
+
+static vector<unsigned char> randomImage(int width, int height)
+{
+    vector<unsigned char> rgb(width * height * 3);
+    for (unsigned int i = 0; i < rgb.size(); ++i) {
+        rgb[i] = static_cast<unsigned char>(rand() & 0xff);
+    }
+    return rgb;
+}
+
+// Gradients, with a hard edge through the middle
+static vector<unsigned char> smoothImage(int width, int height)
+{
+    vector<unsigned char> rgb(width * height * 3);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned char *p = &rgb[(y * width + x) * 3];
+            p[0] = static_cast<unsigned char>(x * 255 / width);
+            p[1] = static_cast<unsigned char>(y * 255 / height);
+            p[2] = (x > width / 2 ? 200 : 30);
+        }
+    }
+    return rgb;
+}
+
+// What WBImageTranscriber::waitForImage used to do
+static void oldConvert(const unsigned char *wbimage, int width, int height,
+                       unsigned char *image)
+{
+    const int outWidth = width * 2;
+    for (int i = 0; i < height; i++) {
+        for (int j = 0; j < width; j++) {
+            unsigned char y, u, v;
+            const unsigned char *p = wbimage + (i * width + j) * 3;
+            YUVConverter::toYUV(p[0], p[1], p[2], y, u, v);
+            unsigned char *pair = image + (i * 2 * outWidth + j * 2) * 2;
+            for (int row = 0; row < 2; ++row) {
+                pair[row * outWidth * 2 + 0] = y;
+                pair[row * outWidth * 2 + 1] = u;
+                pair[row * outWidth * 2 + 2] = y;
+                pair[row * outWidth * 2 + 3] = v;
+            }
+        }
+    }
+}
+
+static const char * describe(int scale, YUVConverter::Filter filter)
+{
+    if (scale == 1) {
+        return "same size";
+    }
+    return filter == YUVConverter::NEAREST ? "doubled, nearest" :
+        "doubled, bilinear";
+}
+
+static int checkMatches(int width, int height)
+{
+    int failures = 0;
+    const vector<unsigned char> images[] = {
+        randomImage(width, height), smoothImage(width, height)
+    };
+    for (int scale = 1; scale <= 2; ++scale) {
+        for (int f = 0; f < 2; ++f) {
+            const YUVConverter::Filter filter =
+                static_cast<YUVConverter::Filter>(f);
+            if (scale == 1 && filter == YUVConverter::BILINEAR) {
+                continue;
+            }
+            YUVConverter c(width, height, scale, filter);
+            vector<unsigned char> a(c.getOutputBytes());
+            vector<unsigned char> b(c.getOutputBytes());
+            for (int i = 0; i < 2; ++i) {
+                c.convert(&images[i][0], &a[0]);
+                c.convertScalar(&images[i][0], &b[0]);
+                if (a != b) {
+                    printf("%dx%d %s: vector and scalar differ\n", width,
+                           height, describe(scale, filter));
+                    failures++;
+                }
+            }
+
+            // One color, which every filter has to leave alone
+            vector<unsigned char> plain(width * height * 3);
+            for (unsigned int i = 0; i < plain.size(); ++i) {
+                plain[i] = (i % 3 == 0 ? 250 : (i % 3 == 1 ? 90 : 10));
+            }
+            unsigned char y, u, v;
+            YUVConverter::toYUV(250, 90, 10, y, u, v);
+            c.convert(&plain[0], &a[0]);
+            int wrong = 0;
+            for (unsigned int i = 0; i < a.size(); i += 4) {
+                wrong += (a[i] != y || a[i + 1] != u || a[i + 2] != y ||
+                          a[i + 3] != v);
+            }
+            if (wrong > 0) {
+                printf("%dx%d %s: %d pairs of one color changed\n", width,
+                       height, describe(scale, filter), wrong);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+static int checkOldLuma()
+{
+    const vector<unsigned char> rgb = randomImage(WEBOTS_WIDTH,
+                                                  WEBOTS_HEIGHT);
+    YUVConverter c(WEBOTS_WIDTH, WEBOTS_HEIGHT, 2, YUVConverter::NEAREST);
+    vector<unsigned char> a(c.getOutputBytes()), old(c.getOutputBytes());
+    c.convert(&rgb[0], &a[0]);
+    oldConvert(&rgb[0], WEBOTS_WIDTH, WEBOTS_HEIGHT, &old[0]);
+    for (unsigned int i = 0; i < a.size(); i += 2) {
+        if (a[i] != old[i]) {
+            printf("luma differs from the old conversion at byte %d\n", i);
+            return 1;
+        }
+    }
+    printf("nearest luma matches the old conversion\n");
+    return 0;
+}
+
+static void benchmark()
+{
+    const vector<unsigned char> rgb = smoothImage(WEBOTS_WIDTH,
+                                                  WEBOTS_HEIGHT);
+    vector<unsigned char> out(WEBOTS_WIDTH * WEBOTS_HEIGHT * 4 * 2);
+    unsigned int sink = 0;
+
+    long long begin = micro_time();
+    for (int run = 0; run < NUM_TIMING_RUNS; ++run) {
+        oldConvert(&rgb[0], WEBOTS_WIDTH, WEBOTS_HEIGHT, &out[0]);
+        sink += out[run % out.size()];
+    }
+    const float old = static_cast<float>(micro_time() - begin) /
+        NUM_TIMING_RUNS;
+
+    printf("\n%dx%d to %dx%d, per frame:\n", WEBOTS_WIDTH, WEBOTS_HEIGHT,
+           WEBOTS_WIDTH * 2, WEBOTS_HEIGHT * 2);
+    printf("  old per pixel       %8.1fus\n", old);
+    for (int f = 0; f < 2; ++f) {
+        YUVConverter c(WEBOTS_WIDTH, WEBOTS_HEIGHT, 2,
+                       static_cast<YUVConverter::Filter>(f));
+        begin = micro_time();
+        for (int run = 0; run < NUM_TIMING_RUNS; ++run) {
+            c.convertScalar(&rgb[0], &out[0]);
+            sink += out[run % out.size()];
+        }
+        const float scalar = static_cast<float>(micro_time() - begin) /
+            NUM_TIMING_RUNS;
+        begin = micro_time();
+        for (int run = 0; run < NUM_TIMING_RUNS; ++run) {
+            c.convert(&rgb[0], &out[0]);
+            sink += out[run % out.size()];
+        }
+        const float vector = static_cast<float>(micro_time() - begin) /
+            NUM_TIMING_RUNS;
+        printf("  %-18s  %8.1fus scalar %8.1fus vector\n",
+               f == 0 ? "nearest" : "bilinear", scalar, vector);
+    }
+    if (sink == 12345) {
+        printf("\n");
+    }
+}
+
+int main()
+{
+#ifndef __SSE2__
+    printf("no SSE2, the vector conversion is the scalar one\n");
+#endif
+    int failures = 0;
+    // Whole vectors, a remainder, and less than one vector
+    failures += checkMatches(WEBOTS_WIDTH, WEBOTS_HEIGHT);
+    failures += checkMatches(70, 9);
+    failures += checkMatches(6, 3);
+    failures += checkOldLuma();
+
+    benchmark();
+
+    if (failures > 0) {
+        printf("\n%d FAILURES\n", failures);
+        return 1;
+    }
+    printf("\nall ok\n");
+    return 0;
+}
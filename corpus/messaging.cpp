@@ -39,32 +39,3 @@ T MessagePost<T>::retrieve()
     assert(release());
     return copy;
 }
-
-template <class T>
-void MessageQueue<T>::append(T &copy)
-{
-    assert(dolock());
-    data.push_back(new T(copy));
-    assert(release());
-}
-
-template <class T>
-T* MessageQueue<T>::retrieve()
-{
-    if (data.empty())
-        return NULL;
-
-    T* copy;
-    assert(dolock());
-    copy = data.pop_front();
-    assert(release());
-    return copy;
-}
-
-template <class T>
-std::list<T*> MessageQueue<T>::retrieveAll()
-{
-    std::list<T*> list;
-    list.swap(data);
-    return list;
-}
@@ -18,7 +18,10 @@
 // and the GNU Lesser Public License along with Man.  If not, see
 // <http://www.gnu.org/licenses/>.
 
-#include <list>
+#ifndef messaging_h_DEFINED
+#define messaging_h_DEFINED
+
+#include <vector>
 #include "synchro.h"
 
 
@@ -37,19 +40,240 @@ public:
     T    retrieve();
 };
 
-template <class T>
-class MessageQueue : public Lock
+/**
+ * A bounded queue between exactly one producer thread and one consumer
+ * thread, with no locks. N must be a power of two.
+ *
+ * The slots are allocated once and reused, so the producer fills a slot in
+ * place (producerSlot(), then push()) and the consumer reads it in place
+ * (front(), then pop()). Objects that own memory, like vectors, keep it
+ * between uses of their slot.
+ */
+template <class T, unsigned int N>
+class SPSCQueue
 {
+    // Fails to compile unless N is a power of two
+    typedef char size_is_power_of_two[(N > 0 && (N & (N - 1)) == 0) ? 1 : -1];
+
+public:
+    SPSCQueue() : head(0), tail(0) { }
+
 public:
-    std::list<T> data;
+    // Producer: the slot to fill for the next push(), or NULL if full
+    T* producerSlot() {
+        if (tail - head == N)
+            return NULL;
+        return &slots[tail & (N - 1)];
+    }
+    // Producer: publishes the slot from producerSlot()
+    void push() {
+        __sync_synchronize();
+        tail = tail + 1;
+    }
+
+    // Consumer: the oldest slot, or NULL if empty
+    T* front() {
+        if (head == tail)
+            return NULL;
+        __sync_synchronize();
+        return &slots[head & (N - 1)];
+    }
+    // Consumer: frees the slot from front() for the producer
+    void pop() {
+        __sync_synchronize();
+        head = head + 1;
+    }
+
+    unsigned int size() const { return tail - head; }
+
+private:
+    T slots[N];
+    // Counts of pops and pushes, each written by one side only
+    volatile unsigned int head;
+    volatile unsigned int tail;
+};
+
+/**
+ * A bounded queue from any number of producer threads to one consumer
+ * thread, with no locks. N must be a power of two.
+ *
+ * Producers claim the next slot by moving tail on with a compare and swap,
+ * copy into it and then mark it full, so nothing they do waits on the
+ * consumer or on each other; push() just fails if the queue is full. Each
+ * slot's seq says whose turn it is: the producer of pass p around the ring
+ * finds it at p * N + slot, and leaves it one higher for the consumer, who
+ * moves it on to the next pass. The consumer reads slots in place, like
+ * SPSCQueue, and stops at a slot that is claimed but not yet full.
+ */
+template <class T, unsigned int N>
+class MPSCQueue
+{
+    typedef char size_is_power_of_two[(N > 0 && (N & (N - 1)) == 0) ? 1 : -1];
 
 public:
-    MessageQueue() : data() { };
+    MPSCQueue() : head(0), tail(0) {
+        for (unsigned int i = 0; i < N; ++i)
+            cells[i].seq = i;
+    }
 
 public:
-    void append(T &copy);
-    T*   retrieve();
-    std::list<T*> retrieveAll();
+    // Any thread: copies into the queue, or returns false if it is full
+    bool push(const T &copy) {
+        unsigned int pos = tail;
+        for (;;) {
+            Cell &c = cells[pos & (N - 1)];
+            const int turn = static_cast<int>(c.seq - pos);
+            if (turn == 0) {
+                const unsigned int seen =
+                    __sync_val_compare_and_swap(&tail, pos, pos + 1);
+                if (seen == pos) {
+                    c.data = copy;
+                    __sync_synchronize();
+                    c.seq = pos + 1;
+                    return true;
+                }
+                pos = seen;
+            } else if (turn < 0) {
+                // The consumer has yet to take this slot from the last pass
+                return false;
+            } else {
+                // Another producer got here first
+                pos = tail;
+            }
+        }
+    }
+
+    // Consumer: the oldest slot, or NULL if empty
+    T* front() {
+        Cell &c = cells[head & (N - 1)];
+        if (c.seq != head + 1)
+            return NULL;
+        __sync_synchronize();
+        return &c.data;
+    }
+    // Consumer: frees the slot from front() for the producers
+    void pop() {
+        Cell &c = cells[head & (N - 1)];
+        __sync_synchronize();
+        c.seq = head + N;
+        head = head + 1;
+    }
+
+    // Slots claimed and not yet popped
+    unsigned int size() const { return tail - head; }
+
+private:
+    struct Cell {
+        T data;
+        volatile unsigned int seq;
+    };
+    Cell cells[N];
+    // Written by the consumer only
+    volatile unsigned int head;
+    // Moved on by the producers with a compare and swap
+    volatile unsigned int tail;
 };
 
+/**
+ * Copies of messages from any number of threads to one reader, on an
+ * MPSCQueue. Nothing is allocated after construction, and append() fails
+ * rather than waits when the reader has fallen N messages behind.
+ */
+template <class T, unsigned int N = 64>
+class MessageQueue
+{
+public:
+    MessageQueue() : queue() { }
+
+public:
+    bool append(const T &copy) { return queue.push(copy); }
+
+    // Reader: copies out the oldest message, if there is one
+    bool retrieve(T &copy) {
+        T *oldest = queue.front();
+        if (oldest == NULL)
+            return false;
+        copy = *oldest;
+        queue.pop();
+        return true;
+    }
+
+    // Reader: appends every waiting message to all, oldest first, and
+    // returns how many there were
+    unsigned int retrieveAll(std::vector<T> &all) {
+        unsigned int n = 0;
+        for (T *oldest = queue.front(); oldest != NULL;
+             oldest = queue.front()) {
+            all.push_back(*oldest);
+            queue.pop();
+            ++n;
+        }
+        return n;
+    }
+
+private:
+    MPSCQueue<T, N> queue;
+};
+
+/**
+ * Posts copies of a value from one writer thread to any number of readers
+ * without either side taking a lock or waiting on the other.
+ *
+ * The writer fills the ring slot after the latest one and then makes it the
+ * latest, so a reader copies a slot the writer has finished with. A reader
+ * only tries again if the writer comes all the way around the ring to the
+ * slot it is copying, which takes N - 1 more posts during one copy.
+ */
+template <class T, unsigned int N = 4>
+class RingPost
+{
+    typedef char size_is_power_of_two[(N > 1 && (N & (N - 1)) == 0) ? 1 : -1];
+
+public:
+    RingPost() : latest(0) {
+        for (unsigned int i = 0; i < N; ++i)
+            slots[i].seq = 0;
+    }
+
+public:
+    // Only ever called from one thread
+    void post(const T &copy) {
+        const unsigned int next = latest + 1;
+        Slot &s = slots[next & (N - 1)];
+        s.seq = s.seq + 1;      // odd while it is being written
+        __sync_synchronize();
+        s.data = copy;
+        __sync_synchronize();
+        s.seq = s.seq + 1;
+        __sync_synchronize();
+        latest = next;
+    }
+
+    // Copies the latest value into copy and returns how many values have
+    // been posted before it
+    unsigned int retrieve(T &copy) const {
+        for (;;) {
+            const unsigned int n = latest;
+            __sync_synchronize();
+            const Slot &s = slots[n & (N - 1)];
+            const unsigned int seq = s.seq;
+            __sync_synchronize();
+            if (seq & 1)
+                continue;
+            copy = s.data;
+            __sync_synchronize();
+            if (s.seq == seq)
+                return n;
+        }
+    }
+
+private:
+    struct Slot {
+        T data;
+        volatile unsigned int seq;
+    };
+    Slot slots[N];
+    volatile unsigned int latest;
+};
 
+#endif // messaging_h_DEFINED
@@ -25,6 +25,16 @@
 #include <boost/shared_ptr.hpp>
 #include "synchro.h"
 #include "corpusconfig.h"
+#ifdef USE_FUTEX_SYNCHRO
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  include <linux/futex.h>
+#  ifndef FUTEX_WAIT_PRIVATE
+     // Kernels before 2.6.22 only have the shared operations
+#    define FUTEX_WAIT_PRIVATE FUTEX_WAIT
+#    define FUTEX_WAKE_PRIVATE FUTEX_WAKE
+#  endif
+#endif
 using namespace std;
 using namespace boost;
 
@@ -34,6 +44,137 @@ using namespace boost;
 #  define DEBUG_THREAD_EXIT
 #endif
 
+#ifdef USE_FUTEX_SYNCHRO
+
+// How many times await() and wait() look again before they park.  A round
+// trip through the kernel costs a few microseconds, about what the thread
+// we wait on needs to answer, so on more than one core a short spin saves
+// most of the parking.  On one core spinning only holds the other thread
+// off the CPU, so there it does not spin at all.
+static const int SPIN_TRIES = 200;
+
+static int spinTries ()
+{
+    static const int tries = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SPIN_TRIES : 0;
+    return tries;
+}
+
+static inline void cpuRelax ()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__ ("pause" ::: "memory");
+#else
+    __asm__ __volatile__ ("" ::: "memory");
+#endif
+}
+
+// Sleeps while *word is still value; the kernel checks that atomically, so
+// a wake between our last look and sleeping is not lost.
+static inline void futexWait (volatile int *word, int value)
+{
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+static inline void futexWake (volatile int *word, int count)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+/*
+ * A waiter counts itself in waiters before it looks at the word the last
+ * time, and a signaller changes the word before it looks at waiters.  The
+ * __sync builtins are full barriers, so one of the two always sees the
+ * other: either the waiter sees the signal, or the signaller sees the
+ * waiter and wakes it.  Signalling nobody never makes a system call.
+ */
+
+Event::Event (string _name)
+  : name(_name), signalled(0), waiters(0)
+{
+}
+
+Event::Event (string _name, shared_ptr<pthread_mutex_t> _mutex)
+  : name(_name), mutex(_mutex), signalled(0), waiters(0)
+{
+}
+
+Event::~Event ()
+{
+}
+
+void Event::await ()
+{
+    const int tries = spinTries();
+    for (int i = 0; i < tries; ++i) {
+        if (signalled && __sync_bool_compare_and_swap(&signalled, 1, 0))
+            return;
+        cpuRelax();
+    }
+
+    __sync_fetch_and_add(&waiters, 1);
+    while (!__sync_bool_compare_and_swap(&signalled, 1, 0))
+        futexWait(&signalled, 0);
+    __sync_fetch_and_sub(&waiters, 1);
+}
+
+bool Event::poll ()
+{
+    return __sync_bool_compare_and_swap(&signalled, 1, 0);
+}
+
+void Event::signal ()
+{
+    __sync_lock_test_and_set(&signalled, 1);
+    __sync_synchronize();
+    if (waiters)
+        futexWake(&signalled, 1);
+}
+
+Semaphore::Semaphore (int initial)
+  : count(initial), waiters(0)
+{
+}
+
+Semaphore::~Semaphore ()
+{
+}
+
+bool Semaphore::tryWait ()
+{
+    int c = count;
+    while (c > 0) {
+        const int seen = __sync_val_compare_and_swap(&count, c, c - 1);
+        if (seen == c)
+            return true;
+        c = seen;
+    }
+    return false;
+}
+
+void Semaphore::wait ()
+{
+    const int tries = spinTries();
+    for (int i = 0; i < tries; ++i) {
+        if (tryWait())
+            return;
+        cpuRelax();
+    }
+
+    __sync_fetch_and_add(&waiters, 1);
+    while (!tryWait())
+        futexWait(&count, 0);
+    __sync_fetch_and_sub(&waiters, 1);
+}
+
+void Semaphore::post ()
+{
+    __sync_fetch_and_add(&count, 1);
+    if (waiters)
+        futexWake(&count, 1);
+}
+
+#else // !USE_FUTEX_SYNCHRO
+
 Event::Event (string _name)
   : name(_name), signalled(false)
 {
@@ -86,6 +227,54 @@ void Event::signal ()
     pthread_mutex_unlock(mutex.get());
 }
 
+Semaphore::Semaphore (int initial)
+  : count(initial)
+{
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+Semaphore::~Semaphore ()
+{
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&mutex);
+}
+
+bool Semaphore::tryWait ()
+{
+    pthread_mutex_lock(&mutex);
+
+    const bool result = count > 0;
+    if (result)
+        --count;
+
+    pthread_mutex_unlock(&mutex);
+    return result;
+}
+
+void Semaphore::wait ()
+{
+    pthread_mutex_lock(&mutex);
+
+    while (count == 0)
+        pthread_cond_wait(&cond, &mutex);
+    --count;
+
+    pthread_mutex_unlock(&mutex);
+}
+
+void Semaphore::post ()
+{
+    pthread_mutex_lock(&mutex);
+
+    ++count;
+    pthread_cond_signal(&cond);
+
+    pthread_mutex_unlock(&mutex);
+}
+
+#endif // USE_FUTEX_SYNCHRO
+
 Synchro::Synchro ()
     : events()
 {
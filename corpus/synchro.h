@@ -26,6 +26,8 @@
 #include <pthread.h>
 #include <boost/shared_ptr.hpp>
 
+#include "corpusconfig.h"
+
 
 #undef MUTEX_TYPE
 #ifdef NDEBUG
@@ -56,12 +58,23 @@ class Lock
     pthread_mutex_t mutex;
 };
 
+/**
+ * An auto-reset event: signal() sets it, and await() or poll() clear it.
+ * A signal with nobody waiting stays set until someone takes it.
+ *
+ * With USE_FUTEX_SYNCHRO the event is a word handled with atomic
+ * instructions, so signalling with nobody parked on it and taking a signal
+ * already there never enter the kernel.  await() spins briefly, on more
+ * than one core, before it parks on the futex.  Otherwise it is a flag
+ * under a mutex and condition variable.
+ */
 class Event
 {
   friend class Synchro;
 
   private:
     Event(std::string name);
+    // The mutex is only used without USE_FUTEX_SYNCHRO
     Event(std::string name, boost::shared_ptr<pthread_mutex_t> mutex);
   public:
     virtual ~Event();
@@ -76,8 +89,45 @@ class Event
 
   private:
     boost::shared_ptr<pthread_mutex_t> mutex;
+#ifdef USE_FUTEX_SYNCHRO
+    volatile int signalled;
+    // Threads parked, or about to park, on signalled
+    volatile int waiters;
+#else
     pthread_cond_t cond;
     bool signalled;
+#endif
+};
+
+/**
+ * A counting semaphore, for handing over a number of items rather than a
+ * single signal.  Built the same way as Event.
+ */
+class Semaphore
+{
+  public:
+    Semaphore(int initial = 0);
+    ~Semaphore();
+
+  public:
+    void post();
+    void wait();
+    // Takes one if there is one, without waiting
+    bool tryWait();
+
+  private:
+    // Not copyable
+    Semaphore(const Semaphore &other);
+    Semaphore& operator=(const Semaphore &other);
+
+  private:
+    volatile int count;
+#ifdef USE_FUTEX_SYNCHRO
+    volatile int waiters;
+#else
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+#endif
 };
 
 
@@ -25,6 +25,8 @@
 #define TOOL_PORT 4002
 
 #define UDP_BUF_SIZE 1024
+// Number of datagrams read per recvmmsg() call
+#define COMM_RECV_BATCH 8
 
 #if ROBOT(NAO)
 #  define TCP_BUF_SIZE 1048576 // 1MB for the Nao's
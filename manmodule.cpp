@@ -90,13 +90,17 @@ void ALCreateMan( ALPtr<ALBroker> broker){
         (new ALImageTranscriber(synchro, sensors, broker));
 
 #ifdef USE_DCM
+    // The enactor sends the lights' changes along with its own commands
+    shared_ptr<DCMCommandBuilder> dcmCommands(new DCMCommandBuilder());
     enactor = shared_ptr<EnactorT>(new EnactorT(sensors,
-                                                transcriber,broker));
+                                                transcriber,broker,
+                                                dcmCommands));
+    lights = shared_ptr<Lights>(new NaoLights(broker, dcmCommands));
 #else
     enactor = shared_ptr<EnactorT>(new EnactorT(sensors,synchro,
                                                 transcriber,broker));
-#endif
     lights = shared_ptr<Lights>(new NaoLights(broker));
+#endif
 
     //setLedsProxy(AL::ALPtr<AL::ALLedsProxy>(new AL::ALLedsProxy(broker)));
 
@@ -247,7 +251,7 @@ int main( int argc, char *argv[] )
             << " and port : " << brokerPort << std::endl;
 
   // Starting Broker
- ALPtr<ALBroker> pBroker = ALBroker::createBroker(brokerName, brokerIP, brokerPort, parentBrokerIP,  parentBrokerPort);
+ ALPtr<ALBroker> pBroker = ALBroker::createBroker(brokerName, brokerIP, brokerPort, parentBrokerIP,  parentBrokerPort);
  pBroker->setBrokerManagerInstance(ALBrokerManager::getInstance());
 
 
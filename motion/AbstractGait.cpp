@@ -41,22 +41,17 @@ void AbstractGait::setGaitFromGait(const AbstractGait &other){
                       other.arm);
 }
 
-template<const unsigned int length>
-void AbstractGait::addSubComponent(float target[length],
-                     const float array1[length],
-                     const float array2[length]){
-    for(unsigned int i =0; i < length; i++){
-        target[i] = array1[i] + array2[i];
-    }
-}
-
-template<const unsigned int length>
-void AbstractGait::multiplySubComponent(float target[length],
-                                        const float source[length],
-                                        const float scalar){
-    for(unsigned int i =0; i < length; i++){
-        target[i] =source[i]*scalar;
-    }
+bool AbstractGait::equals(const AbstractGait &other) const{
+    return
+        memcmp(stance,other.stance,WP::LEN_STANCE_CONFIG*sizeof(float)) == 0 &&
+        memcmp(step,other.step,WP::LEN_STEP_CONFIG*sizeof(float)) == 0 &&
+        memcmp(zmp,other.zmp,WP::LEN_ZMP_CONFIG*sizeof(float)) == 0 &&
+        memcmp(hack,other.hack,WP::LEN_HACK_CONFIG*sizeof(float)) == 0 &&
+        memcmp(sensor,other.sensor,WP::LEN_SENSOR_CONFIG*sizeof(float)) == 0 &&
+        memcmp(stiffness,other.stiffness,
+               WP::LEN_STIFF_CONFIG*sizeof(float)) == 0 &&
+        memcmp(odo,other.odo,WP::LEN_ODO_CONFIG*sizeof(float)) == 0 &&
+        memcmp(arm,other.arm,WP::LEN_ARM_CONFIG*sizeof(float)) == 0;
 }
 
 
@@ -107,24 +102,6 @@ void AbstractGait::combineSubComponents(float target[length],
                                     const float source1[length],
                                     const float source2[length],
                                     const float percentSwitched){
-    float temp1[length];
-    float temp2[length];
-
-
-    const float source1Contribution = 1.0f - percentSwitched;
-    const float source2Contribution = percentSwitched;
-
-    // cout << " *** New recombination ** sC1,sC2 ="<<source1Contribution
-    //      <<","<<source2Contribution<<endl;
-    // cout << "Source1 is:"<<endl<<"   [";
-    // for(unsigned int  i = 0; i <  length; i++){
-    //     cout << source1[i]<<",";
-    // }cout<<"]"<<endl;
-    // cout << "Source2 is:"<<endl<<"   [";
-    // for(unsigned int  i = 0; i <  length; i++){
-    //     cout << source2[i]<<",";
-    // }cout<<"]"<<endl;
-
     if(percentSwitched == 0.0f){
         memcpy(target,source1,sizeof(float)*length);
         return;
@@ -133,13 +110,14 @@ void AbstractGait::combineSubComponents(float target[length],
         memcpy(target,source2,sizeof(float)*length);
         return;
     }
-    multiplySubComponent<length>(temp1,source1, source1Contribution);
-    multiplySubComponent<length>(temp2,source2, source2Contribution);
-    addSubComponent<length>(target, temp1, temp2);
-    //     cout << "Result is:"<<endl<<"   [";
-    // for(unsigned int  i = 0; i <  length; i++){
-    //     cout << target[i]<<",";
-    // }cout<<"]"<<endl<<endl;
+
+    //One pass, without the temporary arrays this used to scale them into
+    const float source1Contribution = 1.0f - percentSwitched;
+    const float source2Contribution = percentSwitched;
+    for(unsigned int i = 0; i < length; i++){
+        target[i] = source1[i]*source1Contribution +
+            source2[i]*source2Contribution;
+    }
 }
 
 using namespace WP;
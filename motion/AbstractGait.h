@@ -9,6 +9,8 @@ public:
     AbstractGait();
     virtual ~AbstractGait();
     std::string toString() const ;
+    // Whether every parameter is exactly the same as other's
+    bool equals(const AbstractGait &other) const;
 
 protected:
     void setGaitFromGait(const AbstractGait &other);
@@ -22,15 +24,6 @@ protected:
                    const float _arm_config[WP::LEN_ARM_CONFIG]);
 
 
-    template<const unsigned int length>
-    static void addSubComponent(float target[length],
-                         const float array1[length],
-                         const float array2[length]);
-    template<const unsigned int length>
-    static void multiplySubComponent(float target[length],
-                              const float source[length],
-                              const float scalar);
-
     static void interpolateGaits(AbstractGait &targetGait,
                                  const AbstractGait &startGait,
                                  const AbstractGait &endGait,
@@ -40,30 +40,38 @@ ChopShop::ChopShop (shared_ptr<Sensors> s)
 /*************************************************************************/
 shared_ptr<ChoppedCommand>
 ChopShop::chopCommand(const JointCommand *command) {
-	shared_ptr<ChoppedCommand> chopped;
-	int numChops = 1;
-	if (command->getDuration() > MOTION_FRAME_LENGTH_S) {
-		numChops = static_cast<int>(command->getDuration() / MOTION_FRAME_LENGTH_S);
-	}
+	shared_ptr<ChoppedCommand> chopped = chopFrom(command, getCurrentJoints());
+
+	// Deleting command!
+	delete command;
+	return chopped;
+}
 
-	vector<float> currentJoints = getCurrentJoints();
+shared_ptr<ChoppedCommand>
+ChopShop::chopFrom(const JointCommand *command,
+				   const vector<float> &startJoints) {
+	const int numChops = getNumChops(command);
 
 	if (command->getInterpolation() == INTERPOLATION_LINEAR) {
-		chopped = chopLinear(command, currentJoints, numChops);
+		return chopLinear(command, startJoints, numChops);
 	}
 
  	else if (command->getInterpolation() == INTERPOLATION_SMOOTH) {
- 		chopped =  chopSmooth(command, currentJoints, numChops);
+ 		return chopSmooth(command, startJoints, numChops);
  	}
 
 	else {
 		cout << "ILLEGAL INTERPOLATION VALUE. CHOPPING SMOOTHLY" << endl;
-		chopped = chopSmooth(command, currentJoints, numChops) ;
+		return chopSmooth(command, startJoints, numChops);
 	}
+}
 
-	// Deleting command!
-	delete command;
-	return chopped;
+int ChopShop::getNumChops(const JointCommand *command) {
+	int numChops = 1;
+	if (command->getDuration() > MOTION_FRAME_LENGTH_S) {
+		numChops = static_cast<int>(command->getDuration() / MOTION_FRAME_LENGTH_S);
+	}
+	return numChops;
 }
 
 //Smooth interpolation motion
@@ -40,15 +40,24 @@ public:
 
     boost::shared_ptr<ChoppedCommand> chopCommand(const JointCommand *command);
 
+	// Chops command starting from startJoints instead of the current
+	// joints. Does NOT delete the command.
+	static boost::shared_ptr<ChoppedCommand>
+	chopFrom(const JointCommand *command,
+			 const std::vector<float> &startJoints);
+
+	// How many motion frames the command is chopped into
+	static int getNumChops(const JointCommand *command);
+
 private:
     boost::shared_ptr<Sensors> sensors;
 	float FRAME_LENGTH_S;
 
-    boost::shared_ptr<ChoppedCommand> chopLinear(const JointCommand *command,
+    static boost::shared_ptr<ChoppedCommand> chopLinear(const JointCommand *command,
 												 std::vector<float> currentJoints,
 												 int numChops);
 
-    boost::shared_ptr<ChoppedCommand> chopSmooth(const JointCommand *command,
+    static boost::shared_ptr<ChoppedCommand> chopSmooth(const JointCommand *command,
 												 std::vector<float> currentJoints,
 												 int numChops);
 
@@ -0,0 +1,300 @@
+
+// This file is part of Man, a robotic perception, locomotion, and
+// team strategy application created by the Northern Bites RoboCup
+// team of Bowdoin College in Brunswick, Maine, for the Aldebaran
+// Nao robot.
+//
+// Man is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Man is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and the GNU Lesser Public License along with Man.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <cstring>
+#include <boost/shared_ptr.hpp>
+
+#include "JointTrajectory.h"
+#include "ChopShop.h"
+#include "NBMath.h"
+
+using namespace std;
+using namespace Kinematics;
+using boost::shared_ptr;
+
+// File layout, all in the robot's byte order:
+//   magic, version, NUM_JOINTS, signature, frames, segments, source values
+//   the source values
+//   start angles and first moving segment, per joint
+//   per segment: first frame, frames, stiffnesses
+//   per frame: segment, progress, angles
+static const unsigned int TRAJECTORY_MAGIC = 0x4e424a54; // "NBJT"
+static const unsigned int TRAJECTORY_VERSION = 2;
+
+JointTrajectory::JointTrajectory()
+{
+    clear();
+}
+
+void JointTrajectory::clear()
+{
+    sig = 0;
+    source.clear();
+    numFrames = 0;
+    segments.clear();
+    frames.clear();
+    frameSegments.clear();
+    frameProgress.clear();
+    for (unsigned int j = 0; j < NUM_JOINTS; ++j) {
+        start[j] = 0.0f;
+        firstSegment[j] = -1;
+    }
+}
+
+void JointTrajectory::compile(const vector<const BodyJointCommand*> &seq,
+                              const vector<float> &startJoints)
+{
+    clear();
+    sourceValues(seq, source);
+    sig = signature(seq);
+    for (unsigned int j = 0; j < NUM_JOINTS; ++j) {
+        start[j] = startJoints[j];
+    }
+
+    for (vector<const BodyJointCommand*>::const_iterator i = seq.begin();
+         i != seq.end(); ++i) {
+        compileSegment(*i);
+    }
+}
+
+/**
+ * Runs the command through the same chopped command the ScriptedProvider
+ * would, from the last row of the table (or the start), and keeps every
+ * frame it produces.
+ */
+void JointTrajectory::compileSegment(const BodyJointCommand *command)
+{
+    const float *last = (numFrames > 0 ?
+                         &frames[(numFrames - 1) * NUM_JOINTS] : start);
+    const vector<float> segmentStart(last, last + NUM_JOINTS);
+    shared_ptr<ChoppedCommand> chopped = ChopShop::chopFrom(command,
+                                                            segmentStart);
+    const int numChops = ChopShop::getNumChops(command);
+    const int segment = static_cast<int>(segments.size());
+
+    Segment s;
+    s.firstFrame = numFrames;
+    s.numFrames = numChops;
+    for (unsigned int chain = 0; chain < NUM_CHAINS; ++chain) {
+        const vector<float> stiffness =
+            chopped->getStiffness(static_cast<ChainID>(chain));
+        for (unsigned int j = 0; j < chain_lengths[chain]; ++j) {
+            s.stiffness[chain_first_joint[chain] + j] = stiffness[j];
+        }
+
+        const vector<float> *joints =
+            command->getJoints(static_cast<ChainID>(chain));
+        if (joints == 0 || joints->empty()) {
+            continue;
+        }
+        for (unsigned int j = chain_first_joint[chain];
+             j <= chain_last_joint[chain]; ++j) {
+            if (firstSegment[j] == -1) {
+                firstSegment[j] = segment;
+            }
+        }
+    }
+    segments.push_back(s);
+
+    frames.resize((numFrames + numChops) * NUM_JOINTS);
+    for (int chop = 1; chop <= numChops; ++chop) {
+        float *row = &frames[numFrames * NUM_JOINTS];
+        for (unsigned int chain = 0; chain < NUM_CHAINS; ++chain) {
+            const vector<float> joints = chopped->getNextJoints(chain);
+            for (unsigned int j = 0; j < chain_lengths[chain]; ++j) {
+                row[chain_first_joint[chain] + j] = joints[j];
+            }
+        }
+
+        // The same fractions the chopped commands move through
+        const float f = static_cast<float>(chop) /
+            static_cast<float>(numChops);
+        float progress = f;
+        if (command->getInterpolation() != INTERPOLATION_LINEAR) {
+            const float t = f * M_PI_FLOAT * 2.0f;
+            progress = (t - sin(t)) / (2 * M_PI_FLOAT);
+        }
+        frameSegments.push_back(segment);
+        frameProgress.push_back(progress);
+        numFrames++;
+    }
+}
+
+void JointTrajectory::getFrame(int frame, const float *actualStart,
+                               float *joints) const
+{
+    const float *row = &frames[frame * NUM_JOINTS];
+    const int segment = frameSegments[frame];
+    const float remaining = 1.0f - frameProgress[frame];
+
+    for (unsigned int j = 0; j < NUM_JOINTS; ++j) {
+        const float offset = actualStart[j] - start[j];
+        if (firstSegment[j] == -1 || segment < firstSegment[j]) {
+            // Not moved yet, so still where it actually started
+            joints[j] = row[j] + offset;
+        } else if (segment == firstSegment[j]) {
+            joints[j] = row[j] + offset * remaining;
+        } else {
+            joints[j] = row[j];
+        }
+    }
+}
+
+const float * JointTrajectory::getStiffnesses(int frame) const
+{
+    return segments[frameSegments[frame]].stiffness;
+}
+
+/**
+ * FNV-1a over everything in the commands that goes into the table
+ */
+unsigned int JointTrajectory::signature(
+    const vector<const BodyJointCommand*> &seq)
+{
+    vector<float> values;
+    sourceValues(seq, values);
+
+    unsigned int hash = 2166136261u;
+    const unsigned char *bytes =
+        reinterpret_cast<const unsigned char*>(values.empty() ? 0 : &values[0]);
+    for (unsigned int b = 0; b < values.size() * sizeof(float); ++b) {
+        hash = (hash ^ bytes[b]) * 16777619u;
+    }
+    return hash;
+}
+
+bool JointTrajectory::compiledFrom(
+    const vector<const BodyJointCommand*> &seq) const
+{
+    vector<float> values;
+    sourceValues(seq, values);
+    return values == source;
+}
+
+void JointTrajectory::sourceValues(const vector<const BodyJointCommand*> &seq,
+                                   vector<float> &values)
+{
+    values.clear();
+    for (vector<const BodyJointCommand*>::const_iterator i = seq.begin();
+         i != seq.end(); ++i) {
+        const BodyJointCommand *command = *i;
+        values.push_back(command->getDuration());
+        values.push_back(static_cast<float>(command->getInterpolation()));
+        for (unsigned int chain = LARM_CHAIN; chain < NUM_CHAINS; ++chain) {
+            const vector<float> *joints =
+                command->getJoints(static_cast<ChainID>(chain));
+            if (joints == 0) {
+                values.push_back(-1.0f);
+                continue;
+            }
+            values.push_back(static_cast<float>(joints->size()));
+            values.insert(values.end(), joints->begin(), joints->end());
+        }
+        const vector<float> *stiffness = command->getStiffness();
+        values.push_back(static_cast<float>(stiffness->size()));
+        values.insert(values.end(), stiffness->begin(), stiffness->end());
+    }
+}
+
+template <typename T>
+static bool writeValues(FILE *f, const T *values, unsigned int n)
+{
+    return n == 0 || fwrite(values, sizeof(T), n, f) == n;
+}
+
+template <typename T>
+static bool readValues(FILE *f, T *values, unsigned int n)
+{
+    return n == 0 || fread(values, sizeof(T), n, f) == n;
+}
+
+bool JointTrajectory::write(FILE *f) const
+{
+    const unsigned int header[] = {
+        TRAJECTORY_MAGIC, TRAJECTORY_VERSION, NUM_JOINTS, sig,
+        static_cast<unsigned int>(numFrames),
+        static_cast<unsigned int>(segments.size()),
+        static_cast<unsigned int>(source.size())
+    };
+    bool ok = writeValues(f, header, 7) &&
+        (source.empty() || writeValues(f, &source[0], source.size())) &&
+        writeValues(f, start, NUM_JOINTS) &&
+        writeValues(f, firstSegment, NUM_JOINTS);
+
+    for (unsigned int i = 0; ok && i < segments.size(); ++i) {
+        ok = writeValues(f, &segments[i].firstFrame, 1) &&
+            writeValues(f, &segments[i].numFrames, 1) &&
+            writeValues(f, segments[i].stiffness, NUM_JOINTS);
+    }
+    if (numFrames > 0) {
+        ok = ok && writeValues(f, &frameSegments[0], numFrames) &&
+            writeValues(f, &frameProgress[0], numFrames) &&
+            writeValues(f, &frames[0], numFrames * NUM_JOINTS);
+    }
+    return ok;
+}
+
+bool JointTrajectory::read(FILE *f)
+{
+    clear();
+
+    unsigned int header[7];
+    if (!readValues(f, header, 7) ||
+        header[0] != TRAJECTORY_MAGIC ||
+        header[1] != TRAJECTORY_VERSION ||
+        header[2] != NUM_JOINTS) {
+        return false;
+    }
+    const int n = static_cast<int>(header[4]);
+    const unsigned int numSegments = header[5];
+
+    source.resize(header[6]);
+    bool ok = (source.empty() || readValues(f, &source[0], source.size())) &&
+        readValues(f, start, NUM_JOINTS) &&
+        readValues(f, firstSegment, NUM_JOINTS);
+
+    segments.resize(numSegments);
+    for (unsigned int i = 0; ok && i < numSegments; ++i) {
+        ok = readValues(f, &segments[i].firstFrame, 1) &&
+            readValues(f, &segments[i].numFrames, 1) &&
+            readValues(f, segments[i].stiffness, NUM_JOINTS);
+    }
+    if (ok && n > 0) {
+        frameSegments.resize(n);
+        frameProgress.resize(n);
+        frames.resize(n * NUM_JOINTS);
+        ok = readValues(f, &frameSegments[0], n) &&
+            readValues(f, &frameProgress[0], n) &&
+            readValues(f, &frames[0], n * NUM_JOINTS);
+    }
+    for (int i = 0; ok && i < n; ++i) {
+        ok = (frameSegments[i] >= 0 &&
+              frameSegments[i] < static_cast<int>(numSegments));
+    }
+
+    if (!ok) {
+        clear();
+        return false;
+    }
+    sig = header[3];
+    numFrames = n;
+    return true;
+}
@@ -0,0 +1,114 @@
+
+// This file is part of Man, a robotic perception, locomotion, and
+// team strategy application created by the Northern Bites RoboCup
+// team of Bowdoin College in Brunswick, Maine, for the Aldebaran
+// Nao robot.
+//
+// Man is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Man is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and the GNU Lesser Public License along with Man.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/**
+ * A sequence of BodyJointCommands compiled into a dense table of joint
+ * angles, one row per motion frame.
+ *
+ * The rows are what the chopped commands would have produced frame by frame
+ * (they are built by running them), so playing a trajectory back is just
+ * reading the next row: no trig and no allocation per frame. Each command
+ * becomes a segment of the table, which keeps the command's stiffnesses.
+ *
+ * A trajectory is compiled from one start pose but can be played from any
+ * other. Every joint is offset by how far the actual start is from the
+ * compiled one, and the offset is faded out over the first segment that
+ * commands the joint, following that segment's interpolation. This gives
+ * the same rows as compiling again from the actual start, so a compiled
+ * SweetMove can be reused however the robot is standing when it starts.
+ *
+ * Trajectories can be written to and read from files, so they can be
+ * compiled ahead of time and loaded at startup.
+ */
+
+#ifndef _JointTrajectory_h_DEFINED
+#define _JointTrajectory_h_DEFINED
+
+#include <cstdio>
+#include <vector>
+
+#include "BodyJointCommand.h"
+#include "Kinematics.h"
+
+class JointTrajectory {
+public:
+    JointTrajectory();
+
+    // Compiles seq, starting from startJoints (NUM_JOINTS angles). The
+    // commands are not deleted.
+    void compile(const std::vector<const BodyJointCommand*> &seq,
+                 const std::vector<float> &startJoints);
+
+    // Identifies a sequence by the contents of its commands, so a trajectory
+    // compiled once can be found again the next time the same sequence is
+    // sent. It is only a hash: check compiledFrom() before reusing a
+    // trajectory found by its signature.
+    static unsigned int signature(
+        const std::vector<const BodyJointCommand*> &seq);
+    unsigned int getSignature() const { return sig; }
+    // Whether this was compiled from commands with exactly seq's contents
+    bool compiledFrom(const std::vector<const BodyJointCommand*> &seq) const;
+
+    int getNumFrames() const { return numFrames; }
+    int getNumSegments() const { return static_cast<int>(segments.size()); }
+
+    // Fills joints (NUM_JOINTS angles) with the given frame as it plays from
+    // start rather than from the pose the trajectory was compiled from.
+    void getFrame(int frame, const float *start, float *joints) const;
+    // The NUM_JOINTS stiffnesses in effect during a frame
+    const float * getStiffnesses(int frame) const;
+
+    // Returns false, leaving the trajectory empty on a failed read, if the
+    // file could not be written or does not hold a trajectory.
+    bool write(FILE *f) const;
+    bool read(FILE *f);
+
+private:
+    void clear();
+    void compileSegment(const BodyJointCommand *command);
+    // Everything in seq's commands that the trajectory depends on
+    static void sourceValues(const std::vector<const BodyJointCommand*> &seq,
+                             std::vector<float> &values);
+
+private:
+    struct Segment {
+        int firstFrame;
+        int numFrames;
+        float stiffness[Kinematics::NUM_JOINTS];
+    };
+
+    unsigned int sig;
+    // The sourceValues() it was compiled from
+    std::vector<float> source;
+    int numFrames;
+    float start[Kinematics::NUM_JOINTS];
+    std::vector<Segment> segments;
+    // numFrames rows of NUM_JOINTS angles
+    std::vector<float> frames;
+    // The segment each frame belongs to, and how far through its segment's
+    // interpolation the frame is, from just above 0 to 1
+    std::vector<int> frameSegments;
+    std::vector<float> frameProgress;
+    // The first segment that moves each joint, or -1 if none does and the
+    // joint is held where it started
+    int firstSegment[Kinematics::NUM_JOINTS];
+};
+
+#endif
@@ -36,6 +36,11 @@ void MetaGait::tick_gait(){
 }
 
 void MetaGait::setNewGaitTarget(Gait &nextTarget){
+    //The behaviors send the gait they want again and again. If we are
+    //already headed for it, starting the transition over would only slow
+    //it down and interpolate every frame for nothing.
+    if(!newGaitSent && nextTarget.equals(nextGait))
+        return;
 #ifdef DEBUG_META_GAIT
         cout << "MetaGait got a new target "<<endl;
 #endif
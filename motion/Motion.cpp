@@ -58,6 +58,7 @@ void Motion::run(){
 
     //Setup the callback  in the enactor so it knows to call the switchboard
     enactor->setSwitchboard(&switchboard);
+    switchboard.setLockStep(enactor->lockStep());
 
     switchboard.run();
     Thread::trigger->off();
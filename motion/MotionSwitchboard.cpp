@@ -1,5 +1,7 @@
 
 #include <vector>
+#include <algorithm>
+#include <unistd.h>
 using namespace std;
 
 #include <boost/shared_ptr.hpp>
@@ -10,6 +12,10 @@ using namespace boost;
 using namespace Kinematics;
 using namespace NBMath;
 //#define DEBUG_SWITCHBOARD
+// Print the switchboard timing statistics every ten seconds
+//#define DEBUG_SWITCHBOARD_TIMING
+static const int TIMING_PRINT_FRAMES =
+    static_cast<int>(10.0f * MOTION_FRAME_RATE);
 
 const float MotionSwitchboard::sitDownAngles[NUM_BODY_JOINTS] =
 {1.57f,0.0f,-1.13f,-1.0f,
@@ -40,15 +46,29 @@ MotionSwitchboard::MotionSwitchboard(shared_ptr<Sensors> s,
 	  running(false),
       newJoints(false),
       readyToSend(false),
-      noWalkTransitionCommand(true)
+      timer(static_cast<long long>(MOTION_FRAME_LENGTH_uS)),
+      lockStep(false),
+      rtPriority(0),
+      rtCpu(-1),
+      rtLockMemory(false),
+      frameSignalled(false),
+      lastFrameSignal(0),
+      framesSignalled(0),
+      framesDone(0),
+      noWalkTransitionCommand(true),
+      numHeldControls(0)
 {
+#ifdef USE_MOTION_REALTIME
+    setRealTime(SWITCHBOARD_RT_PRIORITY, -1, true);
+#endif
 
     //Allow safe access to the next joints
     pthread_mutex_init(&next_joints_mutex, NULL);
-    pthread_mutex_init(&next_provider_mutex, NULL);
     pthread_mutex_init(&calc_new_joints_mutex, NULL);
     pthread_mutex_init(&stiffness_mutex, NULL);
+    pthread_mutex_init(&held_controls_mutex, NULL);
     pthread_cond_init(&calc_new_joints_cond,NULL);
+    pthread_cond_init(&frame_done_cond,NULL);
 
 #ifdef DEBUG_JOINTS_OUTPUT
     initDebugLogs();
@@ -69,10 +89,18 @@ MotionSwitchboard::MotionSwitchboard(shared_ptr<Sensors> s,
 
 MotionSwitchboard::~MotionSwitchboard() {
     pthread_mutex_destroy(&next_joints_mutex);
-    pthread_mutex_destroy(&next_provider_mutex);
     pthread_mutex_destroy(&calc_new_joints_mutex);
     pthread_mutex_destroy(&stiffness_mutex);
+    pthread_mutex_destroy(&held_controls_mutex);
     pthread_cond_destroy(&calc_new_joints_cond);
+    pthread_cond_destroy(&frame_done_cond);
+
+    // Commands sent after the last frame are still ours to delete
+    for (QueuedCommand *c = commands.front(); c != NULL;
+         c = commands.front()) {
+        discard(*c);
+        commands.pop();
+    }
 
 #ifdef DEBUG_JOINTS_OUTPUT
     closeDebugLogs();
@@ -93,11 +121,12 @@ void MotionSwitchboard::start() {
 
 
 void MotionSwitchboard::stop() {
-    running = false;
     cout << "Switchboard signaled to stop" <<endl;
     //signal to end waiting in the run method,
     pthread_mutex_lock(&calc_new_joints_mutex);
+    running = false;
     pthread_cond_signal(&calc_new_joints_cond);
+    pthread_cond_broadcast(&frame_done_cond);
     pthread_mutex_unlock(&calc_new_joints_mutex);
 }
 
@@ -106,12 +135,16 @@ void MotionSwitchboard::stop() {
  * The switchboard run method is continuously looping. At each iteration
  * it grabs the appropriate joints from the designated provider, and
  * then copies them into place so an enactor can send them to the low level.
- * This threaed then 'hangs' until the enactor signals it has read the current
- * values. (This signaling is actually done in the getNextJoints method in
- * this class)
  *
- * Potential problems: If the processing for the next joints
- * takes too long, the enactor will send old joints.
+ * With USE_MOTION_TIMER the loop runs off its own monotonic timer, which
+ * is kept TIMER_OFFSET_uS behind the enactor's sensor updates. The joints
+ * for the next DCM cycle are then ready a whole frame before the enactor
+ * sends them, whether or not the enactor thread itself is running late.
+ * Otherwise, or if the enactor steps the switchboard (setLockStep()), the
+ * thread 'hangs' until the enactor signals it has posted new sensor values.
+ *
+ * Either way, each frame's wakeup latency and the slack left before the
+ * enactor needs the joints are recorded in timingStats.
  */
 void MotionSwitchboard::run() {
     static int fcount = 0;
@@ -120,11 +153,31 @@ void MotionSwitchboard::run() {
     //angles into sensors->motionBodyAngles:
     sensors->setMotionBodyAngles(sensors->getBodyAngles());
 
-    pthread_mutex_lock(&calc_new_joints_mutex);
-    pthread_cond_wait(&calc_new_joints_cond, &calc_new_joints_mutex);
-    pthread_mutex_unlock(&calc_new_joints_mutex);
+    if (rtPriority > 0 || rtCpu >= 0 || rtLockMemory) {
+        setRealTimeScheduling(rtPriority, rtCpu, rtLockMemory);
+    }
+
+    waitForNextFrame();
+
+#ifdef USE_MOTION_TIMER
+    const bool useTimer = !lockStep && timer.start();
+    if (useTimer) {
+        timer.align(lastFrameSignal + TIMER_OFFSET_uS);
+        timer.wait();
+    }
+#else
+    const bool useTimer = false;
+#endif
+    const long long period = static_cast<long long>(MOTION_FRAME_LENGTH_uS);
+    int skipped = 0;
 
     while(running) {
+        pthread_mutex_lock(&calc_new_joints_mutex);
+        const long long due = useTimer ? timer.lastTick() : lastFrameSignal;
+        const unsigned long frame = framesSignalled;
+        pthread_mutex_unlock(&calc_new_joints_mutex);
+        const long long woke = MotionTimer::monotonicMicros();
+
 		PROF_ENTER(profiler, P_SWITCHBOARD);
         realityCheckJoints();
 
@@ -134,6 +187,16 @@ void MotionSwitchboard::run() {
         bool active  = postProcess();
 		PROF_EXIT(profiler, P_SWITCHBOARD);
 
+        // The enactor sends these joints at the start of its next cycle
+        const long long deadline =
+            due + period - (useTimer ? TIMER_OFFSET_uS : 0);
+        const long long done = MotionTimer::monotonicMicros();
+        pthread_mutex_lock(&calc_new_joints_mutex);
+        timingStats.record(woke - due, deadline - done, skipped);
+        framesDone = frame;
+        pthread_cond_broadcast(&frame_done_cond);
+        pthread_mutex_unlock(&calc_new_joints_mutex);
+
         if(active)
         {
             readyToSend = true;
@@ -142,22 +205,72 @@ void MotionSwitchboard::run() {
 #endif
         }
 
-        pthread_mutex_lock(&calc_new_joints_mutex);
-        pthread_cond_wait(&calc_new_joints_cond, &calc_new_joints_mutex);
-        pthread_mutex_unlock(&calc_new_joints_mutex);
+#ifdef DEBUG_SWITCHBOARD_TIMING
+        if (fcount % TIMING_PRINT_FRAMES == 0) {
+            getTimingStats().print(cout);
+        }
+#endif
+
+        if (useTimer) {
+            skipped = max(timer.wait() - 1, 0);
+            keepInPhase();
+        } else {
+            waitForNextFrame();
+        }
         fcount++;
     }
+    timer.stop();
+    getTimingStats().print(cout);
     cout << "Switchboard run has exited" <<endl;
 }
 
+/**
+ * Block until the enactor signals new sensor values or we are stopped.
+ */
+void MotionSwitchboard::waitForNextFrame()
+{
+    pthread_mutex_lock(&calc_new_joints_mutex);
+    while (running && !frameSignalled) {
+        pthread_cond_wait(&calc_new_joints_cond, &calc_new_joints_mutex);
+    }
+    frameSignalled = false;
+    pthread_mutex_unlock(&calc_new_joints_mutex);
+}
+
+/**
+ * The timer and the DCM run off different clocks, so the timer slowly
+ * slides through the enactor's cycle. Pull it back to TIMER_OFFSET_uS after
+ * the latest sensor update when it has drifted too far. If the enactor has
+ * gone quiet there is nothing to follow and the timer runs free.
+ */
+void MotionSwitchboard::keepInPhase()
+{
+    pthread_mutex_lock(&calc_new_joints_mutex);
+    const long long signal = lastFrameSignal;
+    pthread_mutex_unlock(&calc_new_joints_mutex);
+
+    const long long tick = timer.lastTick();
+    if (tick - signal > ENACTOR_TIMEOUT_uS) {
+        return;
+    }
+
+    const long long period = timer.getPeriod();
+    long long phase = (tick - signal) % period;
+    if (phase < 0) {
+        phase += period;
+    }
+    const long long error = phase - TIMER_OFFSET_uS;
+    if (error > MAX_PHASE_ERROR_uS || error < -MAX_PHASE_ERROR_uS) {
+        timer.align(signal + TIMER_OFFSET_uS);
+    }
+}
+
 void MotionSwitchboard::preProcess()
 {
-    pthread_mutex_lock(&next_provider_mutex);
+    applyCommands();
 
     preProcessHead();
     preProcessBody();
-
-    pthread_mutex_unlock(&next_provider_mutex);
 }
 
 void MotionSwitchboard::processJoints()
@@ -224,8 +337,6 @@ void MotionSwitchboard::processStiffness(){
 
 
 int MotionSwitchboard::postProcess(){
-    pthread_mutex_lock(&next_provider_mutex);
-
     newJoints = true;
 
     //Make sure that if the current provider just became inactive,
@@ -249,8 +360,6 @@ int MotionSwitchboard::postProcess(){
     //       The overhead of the mutex shouldn't be that high though.
     sensors->setSupportFoot(curProvider->getSupportFoot());
 
-    pthread_mutex_unlock(&next_provider_mutex);
-
     //return if one of the enactors
     return curProvider->isActive() ||  curHeadProvider->isActive();
 }
@@ -555,11 +664,41 @@ const vector<float>  MotionSwitchboard::getNextStiffness() const{
 
 void MotionSwitchboard::signalNextFrame(){
     pthread_mutex_lock(&calc_new_joints_mutex);
+    frameSignalled = true;
+    lastFrameSignal = MotionTimer::monotonicMicros();
+    ++framesSignalled;
     pthread_cond_signal(&calc_new_joints_cond);
     pthread_mutex_unlock(&calc_new_joints_mutex);
 
 }
 
+/**
+ * Waits for the joints computed from the sensors posted with the last
+ * signalNextFrame(). Returns straight away once the switchboard is
+ * stopped, or if it was never started.
+ */
+void MotionSwitchboard::awaitFrameDone(){
+    pthread_mutex_lock(&calc_new_joints_mutex);
+    const unsigned long frame = framesSignalled;
+    while (running && framesDone < frame) {
+        pthread_cond_wait(&frame_done_cond, &calc_new_joints_mutex);
+    }
+    pthread_mutex_unlock(&calc_new_joints_mutex);
+}
+
+void MotionSwitchboard::setRealTime(int priority, int cpu, bool lockMemory){
+    rtPriority = priority;
+    rtCpu = cpu;
+    rtLockMemory = lockMemory;
+}
+
+const MotionTimingStats MotionSwitchboard::getTimingStats() const{
+    pthread_mutex_lock(&calc_new_joints_mutex);
+    const MotionTimingStats stats(timingStats);
+    pthread_mutex_unlock(&calc_new_joints_mutex);
+    return stats;
+}
+
 
 /**
  * Checks to ensure that the current MotionBodyAngles are close enough to
@@ -715,80 +854,226 @@ void MotionSwitchboard::updateDebugLogs(){
 }
 #endif
 
-void MotionSwitchboard::sendMotionCommand(const boost::shared_ptr<Gait> command){
-    //Don't request to switch providers when we get a gait command
-    //nextProvider = &walkProvider;
+/**
+ * Queues a command for the switchboard thread. This never waits on the
+ * switchboard; the queue only fills up if the switchboard has stopped
+ * taking commands, and then after a short wait the command is dropped.
+ * Freezes, unfreezes, stops and resets are never dropped: see hold().
+ */
+void MotionSwitchboard::post(const QueuedCommand &command){
+    if (command.isControl()) {
+        pthread_mutex_lock(&held_controls_mutex);
+        // Once one is held the rest follow it, so they still reach the
+        // providers in the order they were sent
+        if (numHeldControls > 0 || !commands.push(command)) {
+            hold(command);
+        }
+        pthread_mutex_unlock(&held_controls_mutex);
+        return;
+    }
 
-    walkProvider.setCommand(command);
+    for (int waited = 0; !commands.push(command);
+         waited += COMMAND_QUEUE_POLL_uS) {
+        if (waited >= COMMAND_QUEUE_WAIT_uS) {
+            cout << "MotionSwitchboard: command queue full, "
+                 << "dropping a command" << endl;
+            discard(command);
+            return;
+        }
+        usleep(COMMAND_QUEUE_POLL_uS);
+    }
 }
-void MotionSwitchboard::sendMotionCommand(const WalkCommand *command){
-    pthread_mutex_lock(&next_provider_mutex);
-    nextProvider = &walkProvider;
-    walkProvider.setCommand(command);
-    pthread_mutex_unlock(&next_provider_mutex);
 
+/**
+ * Keeps a control command that found the queue full until the end of the
+ * next frame's applyCommands(). Only the last of each kind matters, and a
+ * freeze and an unfreeze undo each other, so an earlier one of the same
+ * kind is taken out and this one goes on the end. That bounds what is held
+ * to one of each. Called with held_controls_mutex locked.
+ */
+void MotionSwitchboard::hold(const QueuedCommand &command){
+    cout << "MotionSwitchboard: command queue full, "
+         << "holding a control command for the next frame" << endl;
+
+    const bool freezing = command.kind == QueuedCommand::FREEZE ||
+        command.kind == QueuedCommand::UNFREEZE;
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < numHeldControls; ++i) {
+        const QueuedCommand::Kind kind = heldControls[i].kind;
+        const bool same = kind == command.kind ||
+            (freezing && (kind == QueuedCommand::FREEZE ||
+                          kind == QueuedCommand::UNFREEZE));
+        if (!same) {
+            heldControls[kept++] = heldControls[i];
+        }
+    }
+    for (unsigned int i = kept; i < numHeldControls; ++i) {
+        heldControls[i] = QueuedCommand();
+    }
+    heldControls[kept] = command;
+    numHeldControls = kept + 1;
 }
-void MotionSwitchboard::sendMotionCommand(const BodyJointCommand *command){
-    pthread_mutex_lock(&next_provider_mutex);
-	noWalkTransitionCommand = true;
-    nextProvider = &scriptedProvider;
-    scriptedProvider.setCommand(command);
-    pthread_mutex_unlock(&next_provider_mutex);
 
+/**
+ * Deletes a command that will never be applied, if it is one the provider
+ * would have deleted. Head set and coord commands stay with the sender.
+ */
+void MotionSwitchboard::discard(const QueuedCommand &command){
+    switch (command.kind) {
+    case QueuedCommand::BODY_JOINT:
+    case QueuedCommand::HEAD_JOINT:
+    case QueuedCommand::WALK:
+        delete command.command;
+        break;
+    default:
+        break;
+    }
 }
-void MotionSwitchboard::sendMotionCommand(const SetHeadCommand * command){
-    pthread_mutex_lock(&next_provider_mutex);
-    nextHeadProvider = &headProvider;
-    headProvider.setCommand(command);
-    pthread_mutex_unlock(&next_provider_mutex);
 
+/**
+ * Hands the commands sent since the last frame to the providers, oldest
+ * first, then any control commands that were held back because the queue
+ * was full. Those come after whatever is queued, so a stop or a freeze is
+ * never undone by a command it was sent after. Called only from the
+ * switchboard thread, at the start of a frame.
+ */
+void MotionSwitchboard::applyCommands(){
+    for (QueuedCommand *c = commands.front(); c != NULL;
+         c = commands.front()) {
+        apply(*c);
+        commands.pop();
+    }
+
+    pthread_mutex_lock(&held_controls_mutex);
+    for (unsigned int i = 0; i < numHeldControls; ++i) {
+        apply(heldControls[i]);
+    }
+    numHeldControls = 0;
+    pthread_mutex_unlock(&held_controls_mutex);
 }
-void MotionSwitchboard::sendMotionCommand(const CoordHeadCommand * command){
-    pthread_mutex_lock(&next_provider_mutex);
-    nextHeadProvider = &headProvider;
-    headProvider.setCommand(command);
-    pthread_mutex_unlock(&next_provider_mutex);
 
+void MotionSwitchboard::apply(QueuedCommand &c){
+    switch (c.kind) {
+    case QueuedCommand::BODY_JOINT:
+        noWalkTransitionCommand = true;
+        nextProvider = &scriptedProvider;
+        scriptedProvider.setCommand(
+            static_cast<const BodyJointCommand*>(c.command));
+        break;
+    case QueuedCommand::HEAD_JOINT:
+        nextHeadProvider = &headProvider;
+        headProvider.setCommand(
+            static_cast<const HeadJointCommand*>(c.command));
+        break;
+    case QueuedCommand::WALK:
+        nextProvider = &walkProvider;
+        walkProvider.setCommand(
+            static_cast<const WalkCommand*>(c.command));
+        break;
+    case QueuedCommand::GAIT:
+        //Don't request to switch providers when we get a gait command
+        walkProvider.setCommand(c.gait);
+        break;
+    case QueuedCommand::SET_HEAD:
+        nextHeadProvider = &headProvider;
+        headProvider.setCommand(
+            static_cast<const SetHeadCommand*>(c.command));
+        break;
+    case QueuedCommand::COORD_HEAD:
+        nextHeadProvider = &headProvider;
+        headProvider.setCommand(
+            static_cast<const CoordHeadCommand*>(c.command));
+        break;
+    case QueuedCommand::FREEZE: {
+        const shared_ptr<FreezeCommand> freeze =
+            static_pointer_cast<FreezeCommand>(c.shared);
+        nextProvider = &nullBodyProvider;
+        nextHeadProvider = &nullHeadProvider;
+        nullHeadProvider.setCommand(freeze);
+        nullBodyProvider.setCommand(freeze);
+#ifdef DEBUG_SWITCHBOARD
+        cout << "Switched to " << *curProvider << endl;
+#endif
+        break;
+    }
+    case QueuedCommand::UNFREEZE: {
+        const shared_ptr<UnfreezeCommand> unfreeze =
+            static_pointer_cast<UnfreezeCommand>(c.shared);
+        if(curHeadProvider == &nullHeadProvider){
+            nullHeadProvider.setCommand(unfreeze);
+        }
+        if(curProvider == &nullBodyProvider){
+            nullBodyProvider.setCommand(unfreeze);
+        }
+        break;
+    }
+    case QueuedCommand::STEP:
+        nextProvider = &walkProvider;
+        walkProvider.setCommand(static_pointer_cast<StepCommand>(c.shared));
+        break;
+    case QueuedCommand::STOP_BODY:
+        curProvider->requestStop();
+        break;
+    case QueuedCommand::STOP_HEAD:
+        headProvider.requestStop();
+        break;
+    case QueuedCommand::RESET_WALK:
+        walkProvider.hardReset();
+        break;
+    case QueuedCommand::RESET_SCRIPTED:
+        scriptedProvider.hardReset();
+        break;
+    }
+
+    // Let go of shared commands now, not when the slot comes round again
+    c.shared.reset();
+    c.gait.reset();
 }
-void MotionSwitchboard::sendMotionCommand(const HeadJointCommand *command){
-    pthread_mutex_lock(&next_provider_mutex);
-    nextHeadProvider = &headProvider;
-    headProvider.setCommand(command);
-    pthread_mutex_unlock(&next_provider_mutex);
 
+void MotionSwitchboard::sendMotionCommand(const boost::shared_ptr<Gait> command){
+    post(QueuedCommand(command));
+}
+void MotionSwitchboard::sendMotionCommand(const WalkCommand *command){
+    post(QueuedCommand(QueuedCommand::WALK, command));
+}
+void MotionSwitchboard::sendMotionCommand(const BodyJointCommand *command){
+    post(QueuedCommand(QueuedCommand::BODY_JOINT, command));
+}
+void MotionSwitchboard::sendMotionCommand(const SetHeadCommand * command){
+    post(QueuedCommand(QueuedCommand::SET_HEAD, command));
+}
+void MotionSwitchboard::sendMotionCommand(const CoordHeadCommand * command){
+    post(QueuedCommand(QueuedCommand::COORD_HEAD, command));
+}
+void MotionSwitchboard::sendMotionCommand(const HeadJointCommand *command){
+    post(QueuedCommand(QueuedCommand::HEAD_JOINT, command));
 }
 void
 MotionSwitchboard::sendMotionCommand(const shared_ptr<FreezeCommand> command){
-    pthread_mutex_lock(&next_provider_mutex);
-    nextProvider = &nullBodyProvider;
-    nextHeadProvider = &nullHeadProvider;
-
-    nullHeadProvider.setCommand(command);
-    nullBodyProvider.setCommand(command);
-    pthread_mutex_unlock(&next_provider_mutex);
-
-#ifdef DEBUG_SWITCHBOARD
-    cout << "Switched to " << *curProvider << endl;
-#endif
-
+    post(QueuedCommand(QueuedCommand::FREEZE,
+                       static_pointer_cast<MotionCommand>(command)));
 }
 void
 MotionSwitchboard::sendMotionCommand(const shared_ptr<UnfreezeCommand> command){
-    pthread_mutex_lock(&next_provider_mutex);
-    if(curHeadProvider == &nullHeadProvider){
-        nullHeadProvider.setCommand(command);
-    }
-    if(curProvider == &nullBodyProvider){
-        nullBodyProvider.setCommand(command);
-    }
-    pthread_mutex_unlock(&next_provider_mutex);
+    post(QueuedCommand(QueuedCommand::UNFREEZE,
+                       static_pointer_cast<MotionCommand>(command)));
 }
 
 void
 MotionSwitchboard::sendMotionCommand(const shared_ptr<StepCommand> command){
-    pthread_mutex_lock(&next_provider_mutex);
-    nextProvider = &walkProvider;
-    walkProvider.setCommand(command);
-    pthread_mutex_unlock(&next_provider_mutex);
+    post(QueuedCommand(QueuedCommand::STEP,
+                       static_pointer_cast<MotionCommand>(command)));
 }
 
+void MotionSwitchboard::stopHeadMoves(){
+    post(QueuedCommand(QueuedCommand::STOP_HEAD, NULL));
+}
+void MotionSwitchboard::stopBodyMoves(){
+    post(QueuedCommand(QueuedCommand::STOP_BODY, NULL));
+}
+void MotionSwitchboard::resetWalkProvider(){
+    post(QueuedCommand(QueuedCommand::RESET_WALK, NULL));
+}
+void MotionSwitchboard::resetScriptedProvider(){
+    post(QueuedCommand(QueuedCommand::RESET_SCRIPTED, NULL));
+}
@@ -46,8 +46,10 @@
 #include "NullHeadProvider.h"
 #include "NullBodyProvider.h"
 #include "Sensors.h"
+#include "messaging.h"
 #include "MotionConstants.h"
 #include "Profiler.h"
+#include "MotionTimer.h"
 
 #include "BodyJointCommand.h"
 #include "HeadJointCommand.h"
@@ -71,9 +73,20 @@ public:
     void stop();
     void run();
 
+    // Scheduling to give the switchboard thread when run() starts; see
+    // setRealTimeScheduling(). Must be called before start().
+    void setRealTime(int priority, int cpu, bool lockMemory);
+    const MotionTimingStats getTimingStats() const;
+
 	const std::vector <float> getNextJoints() const;
 	const std::vector<float> getNextStiffness() const;
     void signalNextFrame();
+    // Blocks until run() has finished the frame signalled last, for
+    // enactors that step the switchboard instead of keeping to a clock
+    void awaitFrameDone();
+    // Makes run() follow signalNextFrame() even with USE_MOTION_TIMER, for
+    // those same enactors. Must be called before run().
+    void setLockStep(bool step) { lockStep = step; }
 	void sendMotionCommand(const BodyJointCommand* command);
 	void sendMotionCommand(const HeadJointCommand* command);
 	void sendMotionCommand(const WalkCommand* command);
@@ -85,23 +98,69 @@ public:
 	void sendMotionCommand(const boost::shared_ptr<StepCommand> command);
 
 public:
-    void stopHeadMoves(){headProvider.requestStop();}
-	void stopBodyMoves(){
-		curProvider->requestStop();
-	}
+    void stopHeadMoves();
+    void stopBodyMoves();
 
     bool isWalkActive(){return walkProvider.isActive();}
     bool isHeadActive(){return headProvider.isActive();}
     bool isBodyActive(){return curProvider->isActive();}
 
-    void resetWalkProvider(){ walkProvider.hardReset(); }
-    void resetScriptedProvider(){ scriptedProvider.hardReset(); }
+    void resetWalkProvider();
+    void resetScriptedProvider();
 
     MotionModel getOdometryUpdate(){
         return walkProvider.getOdometryUpdate();
     }
 
 private:
+    /**
+     * A command, stop or reset waiting in the queue for the switchboard
+     * thread. Commands passed by pointer are owned by the provider they go
+     * to once they are applied.
+     */
+    struct QueuedCommand {
+        enum Kind {
+            BODY_JOINT,
+            HEAD_JOINT,
+            WALK,
+            GAIT,
+            SET_HEAD,
+            COORD_HEAD,
+            FREEZE,
+            UNFREEZE,
+            STEP,
+            STOP_BODY,
+            STOP_HEAD,
+            RESET_WALK,
+            RESET_SCRIPTED
+        };
+
+        QueuedCommand() : kind(STOP_BODY), command(NULL) { }
+        QueuedCommand(Kind k, const MotionCommand *c)
+            : kind(k), command(c) { }
+        QueuedCommand(Kind k, const boost::shared_ptr<MotionCommand> &c)
+            : kind(k), command(NULL), shared(c) { }
+        QueuedCommand(const boost::shared_ptr<Gait> &g)
+            : kind(GAIT), command(NULL), gait(g) { }
+
+        // Freezes, stops and resets, which post() never drops
+        bool isControl() const {
+            return kind == FREEZE || kind == UNFREEZE ||
+                kind == STOP_BODY || kind == STOP_HEAD ||
+                kind == RESET_WALK || kind == RESET_SCRIPTED;
+        }
+
+        Kind kind;
+        const MotionCommand *command;
+        boost::shared_ptr<MotionCommand> shared;
+        boost::shared_ptr<Gait> gait;
+    };
+
+    void post(const QueuedCommand &command);
+    void hold(const QueuedCommand &command);
+    static void discard(const QueuedCommand &command);
+    void applyCommands();
+    void apply(QueuedCommand &command);
     void preProcess();
     void processJoints();
     void processStiffness();
@@ -115,6 +174,8 @@ private:
     void swapBodyProvider();
     void swapHeadProvider();
     int realityCheckJoints();
+    void waitForNextFrame();
+    void keepInPhase();
 
 #ifdef DEBUG_JOINTS_OUTPUT
     void initDebugLogs();
@@ -149,15 +210,57 @@ private:
 
     static const float sitDownAngles[Kinematics::NUM_BODY_JOINTS];
 
+    // How long after the enactor posts sensors the timer wakes us, so the
+    // providers always see the latest sensor values
+    static const int TIMER_OFFSET_uS = 500;
+    // Realign the timer when its phase drifts this far from the enactor's
+    static const int MAX_PHASE_ERROR_uS = 1000;
+    // Free run when the enactor has been quiet for this long
+    static const int ENACTOR_TIMEOUT_uS = 100000;
+    static const int SWITCHBOARD_RT_PRIORITY = 60;
+
+    MotionTimer timer;
+    bool lockStep;
+    MotionTimingStats timingStats;
+    int rtPriority;
+    int rtCpu;
+    bool rtLockMemory;
+
     pthread_t       switchboard_thread;
+    // Set by signalNextFrame() and cleared once run() has seen it, so a
+    // signal that comes while we are busy is not lost, and a spurious wake
+    // up does not start a frame
+    bool frameSignalled;
+    long long lastFrameSignal;
+    // Frames signalled so far, and how many of them run() has finished
+    unsigned long framesSignalled;
+    unsigned long framesDone;
     pthread_cond_t  calc_new_joints_cond;
+    pthread_cond_t  frame_done_cond;
     mutable pthread_mutex_t calc_new_joints_mutex;
-    mutable pthread_mutex_t next_provider_mutex;
     mutable pthread_mutex_t next_joints_mutex;
     mutable pthread_mutex_t stiffness_mutex;
 
     bool noWalkTransitionCommand;
 
+    // Enough for the longest sweet move, sent all at once
+    static const unsigned int COMMAND_QUEUE_SIZE = 128;
+    // How long post() waits for room before it drops a command
+    static const int COMMAND_QUEUE_WAIT_uS = 100000;
+    static const int COMMAND_QUEUE_POLL_uS = 1000;
+
+    // Everything sent to the switchboard goes through here, so the thread
+    // sending commands never waits on a frame and the switchboard thread is
+    // the only one to change the providers or which one is next
+    MPSCQueue<QueuedCommand, COMMAND_QUEUE_SIZE> commands;
+
+    // Control commands that found the queue full, at most one of each kind
+    // (freeze and unfreeze count as one), applied after the queue drains
+    static const unsigned int NUM_HELD_CONTROLS = 5;
+    QueuedCommand heldControls[NUM_HELD_CONTROLS];
+    unsigned int numHeldControls;
+    pthread_mutex_t held_controls_mutex;
+
 #ifdef DEBUG_JOINTS_OUTPUT
     FILE* joints_log;
     FILE* stiffness_log;
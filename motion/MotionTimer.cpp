@@ -0,0 +1,256 @@
+
+// This file is part of Man, a robotic perception, locomotion, and
+// team strategy application created by the Northern Bites RoboCup
+// team of Bowdoin College in Brunswick, Maine, for the Aldebaran
+// Nao robot.
+//
+// Man is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Man is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and the GNU Lesser Public License along with Man.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#  include <stdint.h>
+#  include <sys/timerfd.h>
+#endif
+using namespace std;
+
+#include "MotionTimer.h"
+#include "Common.h"
+
+MotionTimer::MotionTimer(long long _periodMicros)
+    : periodMicros(_periodMicros), timer_fd(-1), tick(0), nextTick(0)
+{
+}
+
+MotionTimer::~MotionTimer()
+{
+    stop();
+}
+
+bool MotionTimer::start()
+{
+#ifdef __linux__
+    if (timer_fd == -1) {
+        timer_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+        if (timer_fd == -1) {
+            cout << "MotionTimer: timerfd_create failed: "
+                 << strerror(errno) << endl;
+            return false;
+        }
+    }
+#else
+    timer_fd = 0;
+#endif
+    tick = monotonicMicros();
+    arm(tick + periodMicros);
+    return true;
+}
+
+void MotionTimer::stop()
+{
+#ifdef __linux__
+    if (timer_fd != -1) {
+        close(timer_fd);
+    }
+#endif
+    timer_fd = -1;
+}
+
+void MotionTimer::align(long long _tick)
+{
+    // Of the ticks on the new schedule, take the one nearest to the tick
+    // that was already due next, so that moving the schedule neither adds
+    // a frame nor drops one
+    long long offset = (nextTick - _tick) % periodMicros;
+    if (offset < 0) {
+        offset += periodMicros;
+    }
+    long long first = nextTick - offset;
+    if (offset > periodMicros / 2) {
+        first += periodMicros;
+    }
+
+    const long long now = monotonicMicros();
+    if (first <= now) {
+        first += ((now - first) / periodMicros + 1) * periodMicros;
+    }
+    arm(first);
+}
+
+void MotionTimer::arm(long long firstTick)
+{
+    nextTick = firstTick;
+#ifdef __linux__
+    // Absolute time, so the schedule does not drift by however long it
+    // takes us to get here
+    struct itimerspec spec;
+    spec.it_value.tv_sec = firstTick / MICROS_PER_SECOND;
+    spec.it_value.tv_nsec = (firstTick % MICROS_PER_SECOND) * 1000;
+    spec.it_interval.tv_sec = periodMicros / MICROS_PER_SECOND;
+    spec.it_interval.tv_nsec = (periodMicros % MICROS_PER_SECOND) * 1000;
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+#endif
+}
+
+int MotionTimer::wait()
+{
+    if (timer_fd == -1) {
+        return 0;
+    }
+
+    long long expirations = 0;
+#ifdef __linux__
+    uint64_t count;
+    while (read(timer_fd, &count, sizeof(count)) != sizeof(count)) {
+        if (errno != EINTR) {
+            return 0;
+        }
+    }
+    expirations = static_cast<long long>(count);
+#else
+    // Without timerfd, sleep until the next tick is due
+    long long now = monotonicMicros();
+    if (now < nextTick) {
+        usleep(static_cast<useconds_t>(nextTick - now));
+        now = monotonicMicros();
+    }
+    expirations = (now - nextTick) / periodMicros + 1;
+#endif
+
+    tick = nextTick + (expirations - 1) * periodMicros;
+    nextTick = tick + periodMicros;
+    return static_cast<int>(expirations);
+}
+
+long long MotionTimer::monotonicMicros()
+{
+#ifdef __linux__
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * MICROS_PER_SECOND + now.tv_nsec / 1000;
+#else
+    return micro_time();
+#endif
+}
+
+
+MotionTimingStats::MotionTimingStats()
+{
+    reset();
+}
+
+void MotionTimingStats::reset()
+{
+    frames = 0;
+    missed = 0;
+    worstLatency = 0;
+    worstSlack = 0;
+    totalLatency = 0;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        slackHistogram[i] = 0;
+    }
+}
+
+void MotionTimingStats::record(long long latency, long long slack,
+                               int skipped)
+{
+    if (frames == 0 || slack < worstSlack) {
+        worstSlack = slack;
+    }
+    if (latency > worstLatency) {
+        worstLatency = latency;
+    }
+    totalLatency += latency;
+    frames++;
+    missed += skipped;
+
+    if (slack < 0) {
+        missed++;
+    } else {
+        const long long bucket = slack / BUCKET_MICROS;
+        slackHistogram[bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1]++;
+    }
+}
+
+void MotionTimingStats::print(ostream &out) const
+{
+    out << "Motion timing over " << frames << " frames: "
+        << missed << " missed, wakeup latency mean "
+        << (frames > 0 ? totalLatency / frames : 0) << "us worst "
+        << worstLatency << "us, worst slack " << worstSlack << "us" << endl;
+    if (frames == 0) {
+        return;
+    }
+
+    out << "  slack (us)     frames" << endl;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        if (slackHistogram[i] == 0) {
+            continue;
+        }
+        out << "  " << setw(5) << i * BUCKET_MICROS;
+        if (i < NUM_BUCKETS - 1) {
+            out << "-" << setw(5) << (i + 1) * BUCKET_MICROS;
+        } else {
+            out << "+     ";
+        }
+        out << " " << setw(8) << slackHistogram[i] << endl;
+    }
+}
+
+
+bool setRealTimeScheduling(int priority, int cpu, bool lockMemory)
+{
+    bool ok = true;
+
+    if (priority > 0) {
+        struct sched_param param;
+        param.sched_priority = priority;
+        const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO,
+                                              &param);
+        if (err != 0) {
+            cout << "Could not set SCHED_FIFO priority " << priority << ": "
+                 << strerror(err) << endl;
+            ok = false;
+        }
+    }
+
+#ifdef __linux__
+    if (cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        const int err = pthread_setaffinity_np(pthread_self(),
+                                               sizeof(cpus), &cpus);
+        if (err != 0) {
+            cout << "Could not pin thread to cpu " << cpu << ": "
+                 << strerror(err) << endl;
+            ok = false;
+        }
+    }
+#endif
+
+    if (lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        cout << "Could not lock memory: " << strerror(errno) << endl;
+        ok = false;
+    }
+
+    return ok;
+}
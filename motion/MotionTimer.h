@@ -0,0 +1,118 @@
+
+// This file is part of Man, a robotic perception, locomotion, and
+// team strategy application created by the Northern Bites RoboCup
+// team of Bowdoin College in Brunswick, Maine, for the Aldebaran
+// Nao robot.
+//
+// Man is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Man is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and the GNU Lesser Public License along with Man.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/**
+ * Timing support for the motion loop.
+ *
+ * MotionTimer wakes a thread once per motion frame off the monotonic clock,
+ * so the switchboard keeps its own schedule instead of depending on when the
+ * enactor gets around to signalling it. MotionTimingStats records, for each
+ * frame, how late the thread woke up and how much time was left before the
+ * enactor needed the joints, so we can see how close we run to the edge.
+ */
+
+#ifndef _MotionTimer_h_DEFINED
+#define _MotionTimer_h_DEFINED
+
+#include <iostream>
+
+class MotionTimer {
+public:
+    MotionTimer(long long _periodMicros);
+    ~MotionTimer();
+
+    // Ticks every period starting one period from now. Returns false if the
+    // timer could not be created.
+    bool start();
+    void stop();
+
+    // Moves the schedule onto the times tick + n * period. The next tick is
+    // the one of those nearest to when the next tick was due before, unless
+    // that has already passed.
+    void align(long long tick);
+
+    // Blocks until the next tick. Returns the number of ticks that have
+    // passed since the last wait, so anything over one means we fell behind,
+    // or 0 if the timer is not running.
+    int wait();
+
+    // The time the most recent tick was due, which is when it should have
+    // woken us up.
+    long long lastTick() const { return tick; }
+    long long getPeriod() const { return periodMicros; }
+
+    // Microseconds on the monotonic clock, which unlike micro_time() does
+    // not jump when the system time is set.
+    static long long monotonicMicros();
+
+private:
+    void arm(long long firstTick);
+
+private:
+    const long long periodMicros;
+    int timer_fd;
+    long long tick;
+    long long nextTick;
+};
+
+class MotionTimingStats {
+public:
+    MotionTimingStats();
+
+    void reset();
+
+    // Records one frame.
+    // @param latency how long after the frame was due the thread woke up
+    // @param slack   how long before the joints were needed they were ready;
+    //                negative if they were late
+    // @param skipped number of whole frames missed before this one
+    void record(long long latency, long long slack, int skipped);
+
+    int getFrames() const { return frames; }
+    int getMissed() const { return missed; }
+    long long getWorstLatency() const { return worstLatency; }
+    long long getWorstSlack() const { return worstSlack; }
+
+    void print(std::ostream &out) const;
+
+    static const int BUCKET_MICROS = 500;
+    static const int NUM_BUCKETS = 20;
+
+private:
+    int frames;
+    // Frames whose joints were late or that were skipped entirely
+    int missed;
+    long long worstLatency;
+    long long worstSlack;
+    long long totalLatency;
+    // slackHistogram[i] counts frames with slack in
+    // [i * BUCKET_MICROS, (i + 1) * BUCKET_MICROS); the last bucket also
+    // takes everything above
+    int slackHistogram[NUM_BUCKETS];
+};
+
+// Gives the calling thread SCHED_FIFO at the given priority (if it is above
+// zero), pins it to cpu (if it is not negative) and, if lockMemory is set,
+// locks the process's pages into memory so a page fault can not stall the
+// motion loop. Each step that fails is reported and skipped, since the robot
+// still walks without them; returns true only if everything asked for worked.
+bool setRealTimeScheduling(int priority, int cpu, bool lockMemory);
+
+#endif
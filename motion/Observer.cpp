@@ -19,9 +19,6 @@
 // <http://www.gnu.org/licenses/>.
 
 #include "Observer.h"
-using std::list;
-
-using namespace NBMath;
 
 // generated by octave
 const float Observer::weights[NUM_AVAIL_PREVIEW_FRAMES] =
@@ -63,37 +60,15 @@ const float Observer::L_values[3] =
   -0.338547f,
   -0.274121f};
 
-const float Observer::c_values[3] =
-{ 0.0f, 0.0f, 1.0f };
-
 const float Observer::Gi = -59.557f;
 
 Observer::Observer()
-    : WalkController(), stateVector(ufvector3(3)),
-      A(ufmatrix3(3,3)), b(ufvector3(3)), c(ufrowVector3(1,3)),
-      L(ufvector3(3)),trackingError(0.0f)
+    : WalkController(), trackingError(0.0f), trajectory(), previews(),
+      trajectoryPlan(0), trajectoryStart(0), nextFrame(0),
+      hasTrajectory(false)
 {
-    // instantiate the ublas matrices with their respective values
-    // TODO: there might be a better way to do this.
-    for (int i=0; i < 3; i++)
-        stateVector(i) = 0.0f;
-
-    for (int i=0; i < 3; i++)
-        A(0, i) = A_values[i];
-    for (int i=0; i < 3; i++)
-        A(1, i) = A_values[3+i];
-    for (int i=0; i < 3; i++)
-        A(2, i) = A_values[6+i];
-
     for (int i=0; i < 3; i++)
-        b(i) = b_values[i];
-
-    for (int i=0; i < 3; i++)
-        c(0,i) = c_values[i];
-
-    for (int i=0; i < 3; i++)
-        L(i) = L_values[i];
-
+        stateVector[i] = 0.0f;
 #ifdef DEBUG_CONTROLLER_GAINS
     FILE * gains_log;
     gains_log = fopen("/tmp/gains_log.xls","w");
@@ -113,28 +88,100 @@ Observer::Observer()
  * Tick calculates the next state vector for the robot, given the zmp_ref
  *
  */
-const float Observer::tick(const list<float> *zmp_ref,
-                           const float cur_zmp_ref,
+const float Observer::tick(const ZmpQueue &zmp_ref,
                            const float sensor_zmp) {
-    float preview_control = 0.0f;
-    unsigned int counter = 0;
-
-    for (list<float>::const_iterator i = zmp_ref->begin();
-         counter < NUM_PREVIEW_FRAMES; ++counter, ++i) {
-        preview_control += weights[counter]* (*i);
+    const float cur_zmp_ref = zmp_ref.front();
+    if (sensor_zmp != cur_zmp_ref) {
+        // The sensors have taken us off the plan, so anything we ran ahead
+        // over no longer holds
+        hasTrajectory = false;
+        const float *preview = zmp_ref.data() + 1;
+        float preview_control = 0.0f;
+        for (unsigned int counter = 0; counter < NUM_PREVIEW_FRAMES;
+             ++counter) {
+            preview_control += weights[counter]* preview[counter];
+        }
+        step(preview_control, cur_zmp_ref, sensor_zmp);
+        return getPosition();
     }
 
-    trackingError += prod(c,stateVector)(0) - cur_zmp_ref;
+    if (!hasRunAhead(zmp_ref))
+        runAhead(zmp_ref);
+    const float *frame = &trajectory[4 * nextFrame];
+    ++nextFrame;
+    stateVector[0] = frame[0];
+    stateVector[1] = frame[1];
+    stateVector[2] = frame[2];
+    trackingError = frame[3];
+    return getPosition();
+}
 
+/**
+ * One frame of the observer: x' = A x - L (sensor - c x) + b u, where c x
+ * is just the ZMP, x[2]
+ */
+void Observer::step(const float preview_control, const float cur_zmp_ref,
+                    const float sensor_zmp) {
+    const float zmp = stateVector[2];
+    trackingError += zmp - cur_zmp_ref;
     const float control = -Gi * trackingError - preview_control;
-    const float psensor = sensor_zmp;
+    const float sensor_error = sensor_zmp - zmp;
 
-    ufvector3 temp(prod(A, stateVector)
-                   - L*(psensor - prod(c,stateVector)(0)) * 1.0f
-                   + b*control);
-    stateVector.assign(temp);
+    float next[3];
+    for (int i=0; i < 3; i++)
+        next[i] = A_values[3*i] * stateVector[0] +
+            A_values[3*i+1] * stateVector[1] +
+            A_values[3*i+2] * stateVector[2] -
+            L_values[i] * sensor_error +
+            b_values[i] * control;
+    for (int i=0; i < 3; i++)
+        stateVector[i] = next[i];
+}
 
-    return getPosition();
+/**
+ * Runs the observer on from where it is over every frame zmp_ref has a
+ * whole preview for, taking the sensed ZMP to be the reference, and keeps
+ * each frame's state for the ticks to come. The preview control of all of
+ * them, which is most of the work, is summed a gain at a time across every
+ * frame at once.
+ */
+void Observer::runAhead(const ZmpQueue &zmp_ref) {
+    const unsigned int frames = zmp_ref.size() - NUM_PREVIEW_FRAMES;
+    const float *refs = zmp_ref.data();
+
+    previews.assign(frames, 0.0f);
+    float *preview_control = &previews[0];
+    for (unsigned int counter = 0; counter < NUM_PREVIEW_FRAMES; ++counter) {
+        const float weight = weights[counter];
+        const float *preview = refs + 1 + counter;
+        for (unsigned int i = 0; i < frames; ++i)
+            preview_control[i] += weight * preview[i];
+    }
+
+    trajectory.resize(4 * frames);
+    for (unsigned int i = 0; i < frames; ++i) {
+        step(preview_control[i], refs[i], refs[i]);
+        float *frame = &trajectory[4 * i];
+        frame[0] = stateVector[0];
+        frame[1] = stateVector[1];
+        frame[2] = stateVector[2];
+        frame[3] = trackingError;
+    }
+
+    trajectoryPlan = zmp_ref.planId();
+    trajectoryStart = zmp_ref.position();
+    nextFrame = 0;
+    hasTrajectory = true;
+}
+
+/**
+ * Whether the next frame we ran ahead to is zmp_ref's front, in the same plan
+ */
+bool Observer::hasRunAhead(const ZmpQueue &zmp_ref) const {
+    return hasTrajectory &&
+        zmp_ref.planId() == trajectoryPlan &&
+        zmp_ref.position() == trajectoryStart + nextFrame &&
+        4 * nextFrame < trajectory.size();
 }
 
 /**
@@ -142,8 +189,9 @@ const float Observer::tick(const list<float> *zmp_ref,
  * We also assume we are starting off without any tracking error.
  */
 void Observer::initState(float x, float v, float p){
-    stateVector(0) = x;
-    stateVector(1) = v;
-    stateVector(2) = p;
+    stateVector[0] = x;
+    stateVector[1] = v;
+    stateVector[2] = p;
     trackingError = 0.0f;
+    hasTrajectory = false;
 }
@@ -28,6 +28,12 @@
  * are pre-calculated in Octave (see observer.m and setupobserver.m). The
  * theory is described in Czarnetzki and Kajita and Katayama.
  *
+ * While the sensed ZMP is just the reference, as it is with the sensor
+ * feedback weighted out, the state depends on nothing but the plan. The
+ * observer then runs ahead over every frame the plan has a whole preview
+ * for in one go, and each tick takes its frame from that, until the frames
+ * run out or the plan is cleared.
+ *
  * @author George Slavov
  * @author Johannes Strom
  * @date March 2009
@@ -37,12 +43,8 @@
 #ifndef _Observer_h_DEFINED
 #define _Observer_h_DEFINED
 
-#include <boost/numeric/ublas/matrix.hpp>
-#include <boost/numeric/ublas/vector.hpp>
-
-#include <list>
+#include <vector>
 
-#include "NBMatrixMath.h"
 #include "WalkController.h"
 #include "motionconfig.h"
 
@@ -54,15 +56,22 @@ class Observer : public WalkController {
 public:
     Observer();
     virtual ~Observer(){};
-    virtual const float tick(const std::list<float> *zmp_ref,
-                             const float cur_zmp_ref,
+    virtual const float tick(const ZmpQueue &zmp_ref,
                              const float sensor_zmp);
-    virtual const float getPosition() const { return stateVector(0); }
-    virtual const float getZMP() const {return stateVector(2);}
+    virtual const float getPosition() const { return stateVector[0]; }
+    virtual const float getZMP() const {return stateVector[2];}
 
     virtual void initState(float x, float v, float p);
+
 private:
-    NBMath::ufvector3 stateVector;
+    void step(const float preview_control, const float cur_zmp_ref,
+              const float sensor_zmp);
+    void runAhead(const ZmpQueue &zmp_ref);
+    bool hasRunAhead(const ZmpQueue &zmp_ref) const;
+
+private:
+    // CoM position, velocity and the ZMP
+    float stateVector[3];
 
 public: //Constants
     static const unsigned int NUM_PREVIEW_FRAMES = 70;
@@ -71,16 +80,21 @@ private:
     static const float weights[NUM_AVAIL_PREVIEW_FRAMES];
     static const float A_values[9];
     static const float b_values[3];
-    static const float c_values[3];
     static const float L_values[3];
     static const float Gi;
 
-    NBMath::ufmatrix3 A;
-    NBMath::ufvector3 b;
-    NBMath::ufrowVector3 c;
-    NBMath::ufvector3 L;
-
     float trackingError;
+
+    // What runAhead() worked out: for each frame from the plan position
+    // trajectoryStart on, the state vector and tracking error after it
+    std::vector<float> trajectory;
+    // Scratch for the preview control of each of those frames
+    std::vector<float> previews;
+    unsigned int trajectoryPlan;
+    unsigned int trajectoryStart;
+    // The frame of trajectory the next tick takes
+    unsigned int nextFrame;
+    bool hasTrajectory;
 };
 
 #endif
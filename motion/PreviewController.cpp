@@ -19,7 +19,6 @@
 // <http://www.gnu.org/licenses/>.
 
 #include "PreviewController.h"
-using std::list;
 
 using namespace NBMath;
 
@@ -80,14 +79,13 @@ PreviewController::PreviewController()
  * Tick calculates the next state vector for the robot, given the zmp_ref
  *
  */
-const float PreviewController::tick(const list<float> *zmp_ref,
-                                    const float cur_zmp_ref,
+const float PreviewController::tick(const ZmpQueue &zmp_ref,
                                     const float sensor_zmp) {
     float control = 0.0f; // This is 'u' in mathematical notation
-    unsigned int counter = 0;
-    for (list<float>::const_iterator i = zmp_ref->begin();
-         counter < NUM_PREVIEW_FRAMES; counter++, i++) {
-        control += weights[counter]* (*i);
+    // The preview starts with the frame after this one
+    const float *preview = zmp_ref.data() + 1;
+    for (unsigned int counter = 0; counter < NUM_PREVIEW_FRAMES; counter++) {
+        control += weights[counter]* preview[counter];
     }
     stateVector.assign(prod(A_c, stateVector) + b*control);
     return getPosition();
@@ -39,8 +39,6 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
-#include <list>
-
 #include "NBMatrixMath.h"
 #include "WalkController.h"
 #include "motionconfig.h"
@@ -53,8 +51,7 @@ class PreviewController : public WalkController {
 public:
     PreviewController();
     virtual ~PreviewController(){};
-    virtual const float tick(const std::list<float> *zmp_ref,
-                             const float cur_zmp_ref,
+    virtual const float tick(const ZmpQueue &zmp_ref,
                              const float sensor_zmp);
     virtual const float getPosition() const { return stateVector(0); }
     virtual const float getZMP() const {return stateVector(2);}
@@ -18,26 +18,41 @@
 // and the GNU Lesser Public License along with Man.  If not, see
 // <http://www.gnu.org/licenses/>.
 
+#include <cstdio>
 #include <boost/shared_ptr.hpp>
 #include "ScriptedProvider.h"
+#include "motionconfig.h"
 
 using namespace std;
 using namespace Kinematics;
 using boost::shared_ptr;
 
+#if defined USE_TRAJECTORY_CACHE && ! defined WEBOTS_BACKEND
+// Written by motion/offline/compileMoves and copied over by upload.sh
+static const char * TRAJECTORY_CACHE = "/home/nao/naoqi/etc/moves.traj";
+#endif
+
 ScriptedProvider::ScriptedProvider(shared_ptr<Sensors> s,
 								   shared_ptr<Profiler> p)
 	: MotionProvider(SCRIPTED_PROVIDER, p),
 	  sensors(s),
-	  chopper(sensors),
-	  // INITIALIZE WITH NULL/FINISHED CHOPPED COMMAND
-	currCommand(new ChoppedCommand()),
-    bodyCommandQueue()
-
+	  currTrajectory(),
+	  currFrame(0),
+	  trajectories(),
+	  bodyCommandQueue(),
+	  nextSequence(),
+	  chainJoints(NUM_CHAINS),
+	  chainStiffnesses(NUM_CHAINS)
 {
     // Create mutexes
     // (?) Need one mutex per queue (?)
     pthread_mutex_init (&scripted_mutex, NULL);
+
+#if defined USE_TRAJECTORY_CACHE && ! defined WEBOTS_BACKEND
+	// So the SweetMoves are not compiled on the motion thread
+	cout << "ScriptedProvider: loaded " << loadTrajectories(TRAJECTORY_CACHE)
+		 << " trajectories" << endl;
+#endif
 }
 
 ScriptedProvider::~ScriptedProvider() {
@@ -48,11 +63,6 @@ ScriptedProvider::~ScriptedProvider() {
     // be empty once we're not active.
 }
 
-// We're going to finish the whole command queue
-// and then stop doing anything.
-// So this method does nothing. At all.
-// We'll just naturally finish what we're doing and
-// hold steady at the last position.
 void ScriptedProvider::requestStopFirstInstance() { }
 
 void ScriptedProvider::hardReset(){
@@ -62,13 +72,12 @@ void ScriptedProvider::hardReset(){
         delete cmd;
         bodyCommandQueue.pop();
     }
-    currCommand = shared_ptr<ChoppedCommand>(new ChoppedCommand());
+    currTrajectory.reset();
+    currFrame = 0;
     setActive();
     pthread_mutex_unlock(&scripted_mutex);
 }
 
-//Checks if this chain is currently providing angles so that external
-//classes can check the status of this one
 void ScriptedProvider::setActive(){
     if(isDone())
         inactive();
@@ -76,17 +85,14 @@ void ScriptedProvider::setActive(){
         active();
 }
 
-// Are we done moving totally?
 bool ScriptedProvider::isDone() {
     return currCommandEmpty() && commandQueueEmpty();
 }
 
-// Are we finished with our current motion command?
 bool ScriptedProvider::currCommandEmpty() {
-	return currCommand->isDone();
+	return !currTrajectory || currFrame >= currTrajectory->getNumFrames();
 }
 
-// Do we have any BodyCommands left to run through?
 bool ScriptedProvider::commandQueueEmpty(){
     return bodyCommandQueue.empty();
 }
@@ -97,24 +103,20 @@ void ScriptedProvider::calculateNextJointsAndStiffnesses() {
 	if (currCommandEmpty())
 		setNextBodyCommand();
 
-
-	// Go through the chains and enqueue the next
-	// joints from the ChoppedCommand.
-	shared_ptr<vector <vector <float> > > currentChains(getCurrentChains());
-
-	for (unsigned int id=0; id< Kinematics::NUM_CHAINS; ++id ) {
-		Kinematics::ChainID cid = static_cast<Kinematics::ChainID>(id);
-		if ( currCommand->isDone() ){
-			setNextChainJoints( cid,
-								currentChains->at(cid) );
-		}else{
-			setNextChainJoints( cid,
-								currCommand->getNextJoints(cid) );
-		}
-		// Curr command will allways provide the current stiffnesses
-		// even if it is finished providing new joint angles.
-		setNextChainStiffnesses( cid,
-								 currCommand->getStiffness(cid) );
+	if (currCommandEmpty()) {
+		// Nothing left to play, so hold the joints where they are. The
+		// last trajectory always provides the stiffnesses, even after it
+		// has finished.
+		const vector<float> currentJoints = sensors->getBodyAngles();
+		setChainsFromFrame(&currentJoints[0],
+						   currTrajectory ?
+						   currTrajectory->getStiffnesses(
+							   currTrajectory->getNumFrames() - 1) : 0);
+	} else {
+		currTrajectory->getFrame(currFrame, trajectoryStart, frameJoints);
+		setChainsFromFrame(frameJoints,
+						   currTrajectory->getStiffnesses(currFrame));
+		currFrame++;
 	}
 
     setActive();
@@ -122,6 +124,26 @@ void ScriptedProvider::calculateNextJointsAndStiffnesses() {
 	PROF_EXIT(profiler,P_SCRIPTED);
 }
 
+void ScriptedProvider::setChainsFromFrame(const float *joints,
+										  const float *stiffnesses) {
+	for (unsigned int id = 0; id < NUM_CHAINS; ++id) {
+		const ChainID cid = static_cast<ChainID>(id);
+		const unsigned int first = chain_first_joint[id];
+		const unsigned int end = chain_last_joint[id] + 1;
+
+		// assign() keeps the vectors' storage, so after the first frame
+		// this does not allocate
+		chainJoints[id].assign(joints + first, joints + end);
+		setNextChainJoints(cid, chainJoints[id]);
+
+		if (stiffnesses != 0) {
+			chainStiffnesses[id].assign(stiffnesses + first,
+										stiffnesses + end);
+			setNextChainStiffnesses(cid, chainStiffnesses[id]);
+		}
+	}
+}
+
 /*
  * Adds new command to queue of commands.
  * when the chainQueues are all empty,
@@ -145,47 +167,104 @@ void ScriptedProvider::enqueueSequence(std::vector<const BodyJointCommand*> &seq
 		setCommand(*i);
 }
 
+/*
+ * Takes every command that is queued up and plays them as one trajectory.
+ * The commands of a SweetMove are all sent at once, so this usually gets
+ * the whole move, which is the same every time it is sent: after the first
+ * time it is compiled it just gets played again from wherever the robot is.
+ */
 void ScriptedProvider::setNextBodyCommand() {
 
 	// If there are no more commands, don't try to enqueue one
-	if ( !bodyCommandQueue.empty() ) {
+	if ( bodyCommandQueue.empty() ) {
+		return;
+	}
 
-		const BodyJointCommand *nextCommand = bodyCommandQueue.front();
+	while ( !bodyCommandQueue.empty() ) {
+		nextSequence.push_back(bodyCommandQueue.front());
 		bodyCommandQueue.pop();
+	}
+
+	PROF_ENTER(profiler, P_CHOPPED);
+	const vector<float> startJoints = sensors->getMotionBodyAngles();
+	currTrajectory = getTrajectory(startJoints);
+	currFrame = 0;
+	for (unsigned int j = 0; j < NUM_JOINTS; ++j) {
+		trajectoryStart[j] = startJoints[j];
+	}
+	PROF_EXIT(profiler, P_CHOPPED);
 
-		// Replace the current command and delete the
-		// next command object
-		PROF_ENTER(profiler, P_CHOPPED);
-		currCommand = chopper.chopCommand(nextCommand);
-		PROF_EXIT(profiler, P_CHOPPED);
+	// The commands are all in the trajectory now
+	for (vector<const BodyJointCommand*>::iterator i = nextSequence.begin();
+		 i != nextSequence.end(); ++i) {
+		delete *i;
 	}
+	nextSequence.clear();
 }
 
-// Get the chain's current positions. Gives a shared pointer to
-// a vector containing a vector for each chain. Makes accessing
-// each chain very simple.
-shared_ptr<vector<vector<float> > > ScriptedProvider::getCurrentChains() {
-    shared_ptr<vector<vector<float> > >currentChains(
-		new vector<vector<float> >(Kinematics::NUM_CHAINS) );
+shared_ptr<const JointTrajectory>
+ScriptedProvider::getTrajectory(const vector<float> &startJoints) {
+	const unsigned int sig = JointTrajectory::signature(nextSequence);
 
-    vector<float> currentJoints = sensors->getBodyAngles();
+	map<unsigned int, shared_ptr<const JointTrajectory> >::const_iterator
+		found = trajectories.find(sig);
+	// The signature is only a hash, so make sure it is the same move
+	if (found != trajectories.end() &&
+		found->second->compiledFrom(nextSequence)) {
+		return found->second;
+	}
 
-    unsigned int lastChainJoint,joint,chain;
-	lastChainJoint= 0;
-	joint = 0;
-	chain = 0;
+	shared_ptr<JointTrajectory> compiled(new JointTrajectory());
+	compiled->compile(nextSequence, startJoints);
+	if (found != trajectories.end() ||
+		trajectories.size() < MAX_TRAJECTORIES) {
+		trajectories[sig] = compiled;
+	}
+	return compiled;
+}
 
-	vector<vector<float> >::iterator i = currentChains->begin();
+int ScriptedProvider::loadTrajectories(const char *path) {
+	FILE *f = fopen(path, "rb");
+	if (f == NULL) {
+		cout << "ScriptedProvider: could not open " << path << endl;
+		return 0;
+	}
 
-	while (i != currentChains->end() ) {
-        lastChainJoint += chain_lengths[chain];
+	int loaded = 0;
+	pthread_mutex_lock(&scripted_mutex);
+	while (trajectories.size() < MAX_TRAJECTORIES) {
+		shared_ptr<JointTrajectory> t(new JointTrajectory());
+		if (!t->read(f)) {
+			break;
+		}
+		trajectories[t->getSignature()] = t;
+		loaded++;
+	}
+	pthread_mutex_unlock(&scripted_mutex);
 
-        for ( ; joint < lastChainJoint ; joint++) {
-            i->push_back(currentJoints.at(joint));
-        }
+	fclose(f);
+	return loaded;
+}
 
-		++i;
-		++chain;
-    }
-    return currentChains;
+int ScriptedProvider::saveTrajectories(const char *path) {
+	FILE *f = fopen(path, "wb");
+	if (f == NULL) {
+		cout << "ScriptedProvider: could not open " << path << endl;
+		return 0;
+	}
+
+	int saved = 0;
+	pthread_mutex_lock(&scripted_mutex);
+	for (map<unsigned int, shared_ptr<const JointTrajectory> >::const_iterator
+			 i = trajectories.begin(); i != trajectories.end(); ++i) {
+		if (!i->second->write(f)) {
+			cout << "ScriptedProvider: could not write " << path << endl;
+			break;
+		}
+		saved++;
+	}
+	pthread_mutex_unlock(&scripted_mutex);
+
+	fclose(f);
+	return saved;
 }
@@ -23,13 +23,13 @@
 
 #include <vector>
 #include <queue>
+#include <map>
 #include <boost/shared_ptr.hpp>
 
 #include "MotionProvider.h"
 #include "BodyJointCommand.h"
 #include "Sensors.h"
-#include "ChopShop.h"
-#include "ChoppedCommand.h"
+#include "JointTrajectory.h"
 #include "Kinematics.h"
 
 #include "Profiler.h"
@@ -49,22 +49,43 @@ public:
 	void enqueueSequence(std::vector<const BodyJointCommand*> &seq);
 	void setCommand(const BodyJointCommand * command);
 
+	// Compiled trajectories are kept, so a sequence that has been played
+	// once (or that was loaded here at startup) plays from its table the
+	// next time. Both return the number of trajectories read or written.
+	int loadTrajectories(const char * path);
+	int saveTrajectories(const char * path);
+
+	static const unsigned int MAX_TRAJECTORIES = 64;
+
 private:
     boost::shared_ptr<Sensors> sensors;
-	ChopShop chopper;
-	std::vector<std::vector<float> > nextJoints;
 
-	// The current chopped command which is being enacted
-	boost::shared_ptr<ChoppedCommand> currCommand;
+	// The trajectory being played, the next frame of it and the joints it
+	// started from
+	boost::shared_ptr<const JointTrajectory> currTrajectory;
+	int currFrame;
+	float trajectoryStart[Kinematics::NUM_JOINTS];
+
+	// Compiled trajectories by signature
+	std::map<unsigned int,
+			 boost::shared_ptr<const JointTrajectory> > trajectories;
 
 	// Queue to hold the next body commands
 	std::queue<const BodyJointCommand*> bodyCommandQueue;
+	std::vector<const BodyJointCommand*> nextSequence;
+
+	// Reused every frame so playing a trajectory does not allocate
+	float frameJoints[Kinematics::NUM_JOINTS];
+	std::vector<std::vector<float> > chainJoints;
+	std::vector<std::vector<float> > chainStiffnesses;
 
 	pthread_mutex_t scripted_mutex;
 
-	boost::shared_ptr<std::vector <std::vector <float> > > getCurrentChains();
+	void setChainsFromFrame(const float *joints, const float *stiffnesses);
 
 	void setNextBodyCommand();
+	boost::shared_ptr<const JointTrajectory> getTrajectory(
+		const std::vector<float> &startJoints);
     void setActive();
 	bool isDone();
 	bool currCommandEmpty();
@@ -7,17 +7,31 @@ using namespace std;
 
 //#define DEBUG_STEP
 
+Step::Step()
+  : walkVector(ZERO_WALKVECTOR), transformsMade(false), refs(0), pool(NULL)
+{
+}
+
 Step::Step(const Step& other)
+  : refs(0), pool(NULL)
 {
     copyAttributesFromOther(other);
 }
 
+Step& Step::operator=(const Step &other)
+{
+    if (this != &other)
+        copyAttributesFromOther(other);
+    return *this;
+}
+
 Step::Step(const WalkVector &target,
            const AbstractGait & gait, const Foot _foot,
 	   const WalkVector &last,
 	   const StepType _type)
   : walkVector(target), sOffsetY(gait.stance[WP::LEG_SEPARATION_Y]*0.5f),
-    foot(_foot),type(_type),zmpd(false)
+    foot(_foot),type(_type),zmpd(false),transformsMade(false),
+    refs(0),pool(NULL)
 {
   copyGaitAttributes(gait.step,gait.zmp,gait.stance);
 
@@ -44,11 +58,18 @@ Step::Step(const WalkVector &target,
 // Copy constructor to allow changing reference frames:
 Step::Step(const float new_x, const float new_y, const float new_theta,
            const Step & other)
+  : refs(0), pool(NULL)
 {
     copyAttributesFromOther(other);
+    moveTo(new_x, new_y, new_theta);
+}
+
+void Step::moveTo(const float new_x, const float new_y,
+                  const float new_theta){
     x = new_x;
     y = new_y;
     theta = new_theta;
+    transformsMade = false;
 }
 
 void Step::updateFrameLengths(const float duration,
@@ -75,6 +96,9 @@ void Step::copyAttributesFromOther(const Step &other){
     foot = other.foot;
     type = other.type;
     zmpd = other.zmpd;
+    transformsMade = other.transformsMade;
+    if (transformsMade)
+        transforms = other.transforms;
     copyGaitAttributes(other.stepConfig,other.zmpConfig,other.stanceConfig);
 }
 
@@ -265,3 +289,56 @@ void Step::setStepLiftMagnitude(){
 
   stepConfig[WP::FOOT_LIFT_ANGLE] *= percent_of_forward_max;
 }
+
+
+void intrusive_ptr_add_ref(Step *step){
+    ++step->refs;
+}
+
+void intrusive_ptr_release(Step *step){
+    if (--step->refs > 0)
+        return;
+    if (step->pool)
+        step->pool->giveBack(step);
+    else
+        delete step;
+}
+
+StepPool::StepPool()
+    : numFreeSteps(CAPACITY), overflowed(0)
+{
+    for (unsigned int i = 0; i < CAPACITY; ++i) {
+        steps[i].pool = this;
+        freeSteps[i] = &steps[i];
+    }
+}
+
+StepPtr StepPool::make(const WalkVector &target,
+                       const AbstractGait &gait,
+                       const Foot foot,
+                       const WalkVector &last,
+                       const StepType type){
+    Step *step = take();
+    *step = Step(target, gait, foot, last, type);
+    return StepPtr(step);
+}
+
+StepPtr StepPool::make(const float x, const float y, const float theta,
+                       const Step &other){
+    Step *step = take();
+    *step = other;
+    step->moveTo(x, y, theta);
+    return StepPtr(step);
+}
+
+Step* StepPool::take(){
+    if (numFreeSteps == 0) {
+        ++overflowed;
+        return new Step();
+    }
+    return freeSteps[--numFreeSteps];
+}
+
+void StepPool::giveBack(Step *step){
+    freeSteps[numFreeSteps++] = step;
+}
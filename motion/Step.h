@@ -1,10 +1,11 @@
 #ifndef Step_h_DEFINED
 #define Step_h_DEFINED
 
-#include <boost/shared_ptr.hpp>
+#include <boost/intrusive_ptr.hpp>
 #include <boost/tuple/tuple.hpp>
 #include <iostream>
 #include "Gait.h"
+#include "NBMatrixMath.h"
 
 
 typedef boost::tuple<const float,const float, const float>  distVector;
@@ -29,6 +30,27 @@ struct WalkVector {
 
 static const WalkVector ZERO_WALKVECTOR = {0.0f,0.0f,0.0f};
 
+/**
+ * The transforms between the foot frames either side of a step; see
+ * StepGenerator::get_fprime_f and the rest.
+ */
+struct StepTransforms {
+    NBMath::ufmatrix3 f_fprime;
+    NBMath::ufmatrix3 fprime_f;
+    NBMath::ufmatrix3 sprime_s;
+    NBMath::ufmatrix3 s_sprime;
+};
+
+class Step;
+class StepPool;
+
+// Steps are counted references into a StepPool (or to the heap, for the
+// few made outside one). They are only ever handled on the motion thread,
+// so the count is not atomic.
+typedef boost::intrusive_ptr<Step> StepPtr;
+void intrusive_ptr_add_ref(Step *step);
+void intrusive_ptr_release(Step *step);
+
 /**
  * Container to hold information about steps.
  * Steps hold some arrays which contain the gait information from when they
@@ -48,6 +70,9 @@ public:
     Step(const float new_x, const float new_y, const float new_theta,
          const Step& other);
 
+    // Copies everything but the reference count and pool
+    Step& operator=(const Step &other);
+
     void updateFrameLengths(const float duration,
                             const float dblSuppF);
 
@@ -75,11 +100,25 @@ public:
     float stepConfig[WP::LEN_STEP_CONFIG];
     float zmpConfig[WP::LEN_ZMP_CONFIG];
     float stanceConfig[WP::LEN_STANCE_CONFIG];
+
+    // Made by StepGenerator the first time it needs one of them, so each
+    // is worked out once per step. x, y, theta and foot are not changed
+    // after that, except through moveTo().
+    mutable StepTransforms transforms;
+    mutable bool transformsMade;
 private:
+    friend class StepPool;
+    friend void intrusive_ptr_add_ref(Step *step);
+    friend void intrusive_ptr_release(Step *step);
+
+    // Only for StepPool's slots
+    Step();
+
     void copyGaitAttributes(const float _step_config[],
                             const float _zmp_config[],
 			    const float _stance_config[]);
     void copyAttributesFromOther(const Step &other);
+    void moveTo(const float new_x, const float new_y, const float new_theta);
     void setStepSize(const WalkVector &target,
 		     const WalkVector &last);
     
@@ -89,10 +128,59 @@ private:
     const WalkVector accelClipVelocities(const WalkVector & source,
                                          const WalkVector & last);
     const WalkVector lateralClipVelocities(const WalkVector & source);
+
+private:
+    unsigned int refs;
+    StepPool *pool;
+};
+
+/**
+ * A fixed number of Steps, handed out as StepPtrs and taken back when the
+ * last one to a Step goes, so that making a step does not allocate. The
+ * rest of the walk engine still does. If more are wanted at once than it
+ * holds, as when takeSteps() queues a long walk, the rest come from the
+ * heap.
+ *
+ * The pool must outlive every StepPtr it has handed out.
+ */
+class StepPool {
+public:
+    StepPool();
+
+    StepPtr make(const WalkVector &target,
+                 const AbstractGait &gait,
+                 const Foot foot,
+                 const WalkVector &last = ZERO_WALKVECTOR,
+                 const StepType type = REGULAR_STEP);
+    // A copy of other, moved to (x, y, theta)
+    StepPtr make(const float x, const float y, const float theta,
+                 const Step &other);
+
+    unsigned int numFree() const { return numFreeSteps; }
+    // How many Steps had to come from the heap
+    unsigned int numOverflowed() const { return overflowed; }
+
+    static const unsigned int CAPACITY = 32;
+
+private:
+    friend void intrusive_ptr_release(Step *step);
+
+    // Not copyable
+    StepPool(const StepPool &other);
+    StepPool& operator=(const StepPool &other);
+
+    Step* take();
+    void giveBack(Step *step);
+
+private:
+    Step steps[CAPACITY];
+    Step *freeSteps[CAPACITY];
+    unsigned int numFreeSteps;
+    unsigned int overflowed;
 };
 
-static const boost::shared_ptr<Step> EMPTY_STEP =
-  boost::shared_ptr<Step>(new Step(ZERO_WALKVECTOR,
-                                     DEFAULT_GAIT,
-                                     LEFT_FOOT));
+static const StepPtr EMPTY_STEP =
+  StepPtr(new Step(ZERO_WALKVECTOR,
+                   DEFAULT_GAIT,
+                   LEFT_FOOT));
 #endif
@@ -19,6 +19,7 @@
 // <http://www.gnu.org/licenses/>.
 
 #include <iostream>
+#include <algorithm>
 using namespace std;
 
 #include <boost/shared_ptr.hpp>
@@ -36,6 +37,20 @@ using namespace NBMath;
 
 //#define DEBUG_STEPGENERATOR
 
+/**
+ * The homogeneous transform that rotates by an angle, given as its cosine
+ * and sine, then translates by (tx, ty). Written out, rather than built as
+ * products of rotation3D and translation3D, each of which makes a matrix.
+ */
+static const ufmatrix3 rigid3D(const float c, const float s,
+                               const float tx, const float ty){
+    ufmatrix3 m(3,3);
+    m(0,0) = c;    m(0,1) = -s;   m(0,2) = tx;
+    m(1,0) = s;    m(1,1) = c;    m(1,2) = ty;
+    m(2,0) = 0.0f; m(2,1) = 0.0f; m(2,2) = 1.0f;
+    return m;
+}
+
 StepGenerator::StepGenerator(shared_ptr<Sensors> s, const MetaGait * _gait)
   : x(0.0f), y(0.0f), theta(0.0f),
     done(true),
@@ -43,7 +58,7 @@ StepGenerator::StepGenerator(shared_ptr<Sensors> s, const MetaGait * _gait)
     com_i(CoordFrame3D::vector3D(0.0f,0.0f)),
     com_f(CoordFrame3D::vector3D(0.0f,0.0f)),
     est_zmp_i(CoordFrame3D::vector3D(0.0f,0.0f)),
-    zmp_ref_x(list<float>()),zmp_ref_y(list<float>()), futureSteps(),
+    zmp_ref_x(),zmp_ref_y(), futureSteps(),
     currentZMPDSteps(),
     si_Transform(CoordFrame3D::identity3D()),
     last_zmp_end_s(CoordFrame3D::vector3D(0.0f,0.0f)),
@@ -108,12 +123,12 @@ void StepGenerator::resetHard(){
  *    When the Future ZMP values we want run out, we pop the next future step
  *    add generated ZMP from it, and put it into the ZMPDsteps List
  *
- *  * Ensures that there are NUM_PREVIEW_FRAMES + 1 frames in the zmp lists.
- *    the oldest value will be popped off before the list is sent to the
- *    controller.
+ *  * Ensures that there are NUM_PREVIEW_FRAMES + 1 frames in the zmp lists:
+ *    the current one, which will be popped off once the controller has
+ *    ticked, and the ones the controller previews.
  *
  */
-zmp_xy_tuple StepGenerator::generate_zmp_ref() {
+void StepGenerator::generate_zmp_ref() {
     //Generate enough ZMPs so a) the controller can run
     //and                     b) there are enough steps
     while (zmp_ref_y.size() <= Observer::NUM_PREVIEW_FRAMES ||
@@ -123,7 +138,7 @@ zmp_xy_tuple StepGenerator::generate_zmp_ref() {
             generateStep(x, y, theta); // replenish with the current walk vector
         }
         else {
-            shared_ptr<Step> nextStep = futureSteps.front();
+            StepPtr nextStep = futureSteps.front();
             futureSteps.pop_front();
 
             fillZMP(nextStep);
@@ -132,7 +147,6 @@ zmp_xy_tuple StepGenerator::generate_zmp_ref() {
 
         }
     }
-    return zmp_xy_tuple(&zmp_ref_x, &zmp_ref_y);
 }
 
 /**
@@ -224,14 +238,11 @@ void StepGenerator::tick_controller(){
     //JS June 2009
     //findSensorZMP();
 
-    zmp_xy_tuple zmp_ref = generate_zmp_ref();
+    generate_zmp_ref();
 
     //The observer needs to know the current reference zmp
     const float cur_zmp_ref_x =  zmp_ref_x.front();
     const float cur_zmp_ref_y = zmp_ref_y.front();
-    //clear the oldest (i.e. current) value from the preview list
-    zmp_ref_x.pop_front();
-    zmp_ref_y.pop_front();
 
     //Scale the sensor feedback according to the gait parameters
     est_zmp_i(0) = scaleSensors(zmp_filter.get_zmp_x(), cur_zmp_ref_x);
@@ -239,16 +250,16 @@ void StepGenerator::tick_controller(){
 
     //Tick the controller (input: ZMPref, sensors -- out: CoM x, y)
 
-    const float com_x = controller_x->tick(zmp_ref.get<0>(),cur_zmp_ref_x,
-                                           est_zmp_i(0));
+    const float com_x = controller_x->tick(zmp_ref_x, est_zmp_i(0));
     /*
     // TODO! for now we are disabling the observer for the x direction
     // by reporting a sensor zmp equal to the planned/expected value
-    const float com_x = controller_x->tick(zmp_ref.get<0>(),cur_zmp_ref_x,
-                                           cur_zmp_ref_x); // NOTE!
+    const float com_x = controller_x->tick(zmp_ref_x, cur_zmp_ref_x); // NOTE!
     */
-    const float com_y = controller_y->tick(zmp_ref.get<1>(),cur_zmp_ref_y,
-                                           est_zmp_i(1));
+    const float com_y = controller_y->tick(zmp_ref_y, est_zmp_i(1));
+    //clear the oldest (i.e. current) value from the preview list
+    zmp_ref_x.pop_front();
+    zmp_ref_y.pop_front();
     com_i = CoordFrame3D::vector3D(com_x,com_y);
 
 }
@@ -295,21 +306,17 @@ WalkLegsTuple StepGenerator::tick_legs(){
 
     //Using the location of the com in the f coord frame, we can calculate
     //a transformation matrix to go from f to c
-    fc_Transform = prod(CoordFrame3D::rotation3D(CoordFrame3D::Z_AXIS,
-                                                 body_rot_angle_fc),
-                        CoordFrame3D::translation3D(-com_f(0),-com_f(1)));
+    const float c = cos(body_rot_angle_fc);
+    const float s = sin(body_rot_angle_fc);
+    fc_Transform = rigid3D(c, s,
+                           -c*com_f(0) + s*com_f(1),
+                           -s*com_f(0) - c*com_f(1));
 
     //Now we need to determine which leg to send the coorect footholds/Steps to
-    shared_ptr<Step> leftStep_f,rightStep_f;
     //First, the support leg.
-    if (supportStep_f->foot == LEFT_FOOT){
-        leftStep_f = supportStep_f;
-        rightStep_f = swingingStep_f;
-    }
-    else{
-        rightStep_f = supportStep_f;
-        leftStep_f = swingingStep_f;
-    }
+    const bool leftSupport = supportStep_f->foot == LEFT_FOOT;
+    const StepPtr &leftStep_f = leftSupport ? supportStep_f : swingingStep_f;
+    const StepPtr &rightStep_f = leftSupport ? swingingStep_f : supportStep_f;
 
     //Since we'd like to ignore the state information of the WalkinLeg as much
     //as possible, we send in the source of the swinging leg to both, regardless
@@ -353,16 +360,16 @@ void StepGenerator::swapSupportLegs(){
         //there are at least three elements in the list, pop the obsolete one
         //(currently use last step to determine when to stop, hackish-ish)
         //and the first step is the support one now, the second the swing
-        lastStep_s = *currentZMPDSteps.begin();
+        lastStep_s = currentZMPDSteps.front();
         currentZMPDSteps.pop_front();
-        swingingStep_s  = *(++currentZMPDSteps.begin());
-        supportStep_s   =  *currentZMPDSteps.begin();
+        swingingStep_s  = currentZMPDSteps[1];
+        supportStep_s   = currentZMPDSteps[0];
 
         supportFoot = (supportStep_s->foot == LEFT_FOOT ?
                        LEFT_SUPPORT : RIGHT_SUPPORT);
 
         //update the translation matrix between i and f coord. frames
-        ufmatrix3 stepTransform = get_fprime_f(supportStep_s);
+        const ufmatrix3 &stepTransform = get_fprime_f(*supportStep_s);
         if_Transform = prod(stepTransform,if_Transform);
         updateDebugMatrix();
 
@@ -382,8 +389,8 @@ void StepGenerator::swapSupportLegs(){
         //We get the translation matrix that takes points in next f-type
         //coordinate frame, namely the one that will be centered at the swinging
         //foot's destination, and puts them into the current f coord. frame
-        const ufmatrix3 swing_reverse_trans =
-            get_f_fprime(swingingStep_s);
+        const ufmatrix3 &swing_reverse_trans =
+            get_f_fprime(*swingingStep_s);
         //This gives us the position of the swinging foot's destination
         //in the current f frame
         const ufvector3 swing_pos_f = prod(swing_reverse_trans,
@@ -401,14 +408,14 @@ void StepGenerator::swapSupportLegs(){
         //in the F coordinate frames, we express Steps representing
         // the three footholds from above
         supportStep_f =
-            shared_ptr<Step>(new Step(supp_pos_f(0),supp_pos_f(1),
-                                      0.0f,*supportStep_s));
+            stepPool.make(supp_pos_f(0),supp_pos_f(1),
+                          0.0f,*supportStep_s);
         swingingStep_f =
-            shared_ptr<Step>(new Step(swing_pos_f(0),swing_pos_f(1),
-                                      swing_dest_angle,*swingingStep_s));
+            stepPool.make(swing_pos_f(0),swing_pos_f(1),
+                          swing_dest_angle,*swingingStep_s);
         swingingStepSource_f  =
-            shared_ptr<Step>(new Step(swing_src_f(0),swing_src_f(1),
-                                      swing_src_angle,*lastStep_s));
+            stepPool.make(swing_src_f(0),swing_src_f(1),
+                          swing_src_angle,*lastStep_s);
 
 }
 
@@ -421,7 +428,7 @@ void StepGenerator::swapSupportLegs(){
  *    - Regular, where there is another step coming after
  *    - End, where the ZMP should move directly under the robot (origin of S)
  */
-void StepGenerator::fillZMP(const shared_ptr<Step> newSupportStep ){
+void StepGenerator::fillZMP(const StepPtr &newSupportStep ){
 
     switch(newSupportStep->type){
     case REGULAR_STEP:
@@ -440,7 +447,7 @@ void StepGenerator::fillZMP(const shared_ptr<Step> newSupportStep ){
  * Generates the ZMP reference pattern for a normal step
  */
 void
-StepGenerator::fillZMPRegular(const shared_ptr<Step> newSupportStep ){
+StepGenerator::fillZMPRegular(const StepPtr &newSupportStep ){
     //update the lastZMPD Step
     const float sign = (newSupportStep->foot == LEFT_FOOT ? 1.0f : -1.0f);
     const float last_sign = -sign;
@@ -516,57 +523,74 @@ StepGenerator::fillZMPRegular(const shared_ptr<Step> newSupportStep ){
     //  3) a static portion at start_i
     //The time is split between these phases according to
     //the constant gait->dblSupInactivePercentage
-
-    //First, split up the frames:
-    const int halfNumDSChops = //DS - DoubleStaticChops
-       static_cast<int>(static_cast<float>(newSupportStep->doubleSupportFrames)*
-                        newSupportStep->zmpConfig[WP::DBL_SUP_STATIC_P]/2.0f);
-    const int numDMChops = //DM - DoubleMovingChops
-        newSupportStep->doubleSupportFrames - halfNumDSChops*2;
+    const ZMPTemplate &shape = getZMPTemplate(*newSupportStep);
 
     //Phase 1) - stay at start_i
-    for(int i = 0; i< halfNumDSChops; i++){
+    for(int i = 0; i< shape.halfNumStaticFrames; i++){
         zmp_ref_x.push_back(start_i(0));
         zmp_ref_y.push_back(start_i(1));
     }
 
-    //phase 2) - move from start_i to
-    for(int i = 0; i< numDMChops; i++){
-        ufvector3 new_i = start_i +
-            (static_cast<float>(i)/
-			 static_cast<float>(numDMChops) ) *
-			(mid_i-start_i);
-
-        zmp_ref_x.push_back(new_i(0));
-        zmp_ref_y.push_back(new_i(1));
+    //phase 2) - move from start_i to mid_i
+    const float start_mid_x = mid_i(0) - start_i(0);
+    const float start_mid_y = mid_i(1) - start_i(1);
+    for(unsigned int i = 0; i< shape.toMid.size(); i++){
+        zmp_ref_x.push_back(start_i(0) + shape.toMid[i]*start_mid_x);
+        zmp_ref_y.push_back(start_i(1) + shape.toMid[i]*start_mid_y);
     }
 
     //phase 3) - stay at mid_i
-    for(int i = 0; i< halfNumDSChops; i++){
+    for(int i = 0; i< shape.halfNumStaticFrames; i++){
         zmp_ref_x.push_back(mid_i(0));
         zmp_ref_y.push_back(mid_i(1));
     }
 
-
     //single support -  we want to stay over the new step
-    const int numSChops = newSupportStep->singleSupportFrames;
-    for(int i = 0; i< numSChops; i++){
-//    const int numSChops = gait->stepDurationFrames;
-//    for(int i = 0; i< gait->stepDurationFrames; i++){
-
-        ufvector3 new_i = mid_i +
-            (static_cast<float>(i) /
-			 static_cast<float>(numSChops) ) *
-			(end_i-mid_i);
-
-        zmp_ref_x.push_back(new_i(0));
-        zmp_ref_y.push_back(new_i(1));
+    const float mid_end_x = end_i(0) - mid_i(0);
+    const float mid_end_y = end_i(1) - mid_i(1);
+    for(unsigned int i = 0; i< shape.toEnd.size(); i++){
+        zmp_ref_x.push_back(mid_i(0) + shape.toEnd[i]*mid_end_x);
+        zmp_ref_y.push_back(mid_i(1) + shape.toEnd[i]*mid_end_y);
     }
 
     //update our reference frame for the next time this method is called
-    si_Transform = prod(si_Transform,get_s_sprime(newSupportStep));
+    si_Transform = prod(si_Transform,get_s_sprime(*newSupportStep));
     //store the end of the zmp in the next s frame:
-    last_zmp_end_s = prod(get_sprime_s(newSupportStep),end_s);
+    last_zmp_end_s = prod(get_sprime_s(*newSupportStep),end_s);
+}
+
+/**
+ * Returns the ZMP pattern for a regular step with step's timing, making it
+ * again only if that timing differs from the last step's
+ */
+const ZMPTemplate& StepGenerator::getZMPTemplate(const Step &step){
+    const float staticPercent = step.zmpConfig[WP::DBL_SUP_STATIC_P];
+    if(zmpTemplate.doubleSupportFrames == step.doubleSupportFrames &&
+       zmpTemplate.singleSupportFrames == step.singleSupportFrames &&
+       zmpTemplate.staticPercent == staticPercent)
+        return zmpTemplate;
+
+    zmpTemplate.doubleSupportFrames = step.doubleSupportFrames;
+    zmpTemplate.singleSupportFrames = step.singleSupportFrames;
+    zmpTemplate.staticPercent = staticPercent;
+
+    //First, split up the frames:
+    zmpTemplate.halfNumStaticFrames = //DS - DoubleStaticChops
+       static_cast<int>(static_cast<float>(step.doubleSupportFrames)*
+                        staticPercent/2.0f);
+    const int numDMChops = //DM - DoubleMovingChops
+        step.doubleSupportFrames - zmpTemplate.halfNumStaticFrames*2;
+    const int numSChops = step.singleSupportFrames;
+
+    zmpTemplate.toMid.resize(std::max(numDMChops, 0));
+    for(int i = 0; i< numDMChops; i++)
+        zmpTemplate.toMid[i] = (static_cast<float>(i)/
+                                static_cast<float>(numDMChops));
+    zmpTemplate.toEnd.resize(std::max(numSChops, 0));
+    for(int i = 0; i< numSChops; i++)
+        zmpTemplate.toEnd[i] = (static_cast<float>(i)/
+                                static_cast<float>(numSChops));
+    return zmpTemplate;
 }
 
 /**
@@ -574,7 +598,7 @@ StepGenerator::fillZMPRegular(const shared_ptr<Step> newSupportStep ){
  * such that it will be the last step before stopping
  */
 void
-StepGenerator::fillZMPEnd(const shared_ptr<Step> newSupportStep ){
+StepGenerator::fillZMPEnd(const StepPtr &newSupportStep ){
     const ufvector3 end_s =
         CoordFrame3D::vector3D(gait->stance[WP::BODY_OFF_X],
                                0.0f);
@@ -589,7 +613,7 @@ StepGenerator::fillZMPEnd(const shared_ptr<Step> newSupportStep ){
     //An End step should never move the si_Transform!
     //si_Transform = prod(si_Transform,get_s_sprime(newSupportStep));
     //store the end of the zmp in the next s frame:
-    last_zmp_end_s = prod(get_sprime_s(newSupportStep),end_s);
+    last_zmp_end_s = prod(get_sprime_s(*newSupportStep),end_s);
 }
 
 /**
@@ -760,14 +784,14 @@ void StepGenerator::resetSteps(const bool startLeft){
 
     //Support step is END Type, but the first swing step, generated
     //in generateStep, is REGULAR type.
-    shared_ptr<Step> firstSupportStep =
-      shared_ptr<Step>(new Step(ZERO_WALKVECTOR,
-                                  *gait,
-                                  firstSupportFoot,ZERO_WALKVECTOR,END_STEP)); 
-    shared_ptr<Step> dummyStep =
-        shared_ptr<Step>(new Step(ZERO_WALKVECTOR,
-                                  *gait,
-                                  dummyFoot));
+    StepPtr firstSupportStep =
+        stepPool.make(ZERO_WALKVECTOR,
+                      *gait,
+                      firstSupportFoot,ZERO_WALKVECTOR,END_STEP);
+    StepPtr dummyStep =
+        stepPool.make(ZERO_WALKVECTOR,
+                      *gait,
+                      dummyFoot);
     //need to indicate what the current support foot is:
     currentZMPDSteps.push_back(dummyStep);//right gets popped right away
     fillZMP(firstSupportStep);
@@ -851,12 +875,12 @@ void StepGenerator::generateStep( float _x,
 
     const WalkVector new_walk = {_x,_y,_theta};
 
-    shared_ptr<Step> step(new Step(new_walk,
-                                   *gait,
-                                   (nextStepIsLeft ?
-                                    LEFT_FOOT : RIGHT_FOOT),
-				   lastQueuedStep->walkVector,
-                                   type));
+    StepPtr step = stepPool.make(new_walk,
+                                 *gait,
+                                 (nextStepIsLeft ?
+                                  LEFT_FOOT : RIGHT_FOOT),
+                                 lastQueuedStep->walkVector,
+                                 type);
 
 #ifdef DEBUG_STEPGENERATOR
     cout << "Generated a new step: "<<*step<<endl;
@@ -882,12 +906,13 @@ StepGenerator::getDefaultStance(const Gait& wp){
                                -wp.stance[WP::LEG_SEPARATION_Y]*0.5f,
                                -wp.stance[WP::BODY_HEIGHT]);
 
-    const vector<float> lleg = WalkingLeg::getAnglesFromGoal(LLEG_CHAIN,
-                                                             lleg_goal,
-                                                             wp.stance);
-    const vector<float> rleg = WalkingLeg::getAnglesFromGoal(RLEG_CHAIN,
-                                                             rleg_goal,
-                                                             wp.stance);
+    const IKLegPairResult legs = WalkingLeg::getAnglesFromGoals(lleg_goal,
+                                                                rleg_goal,
+                                                                wp.stance);
+    const float *lleg_angles = legs.leg[IK_LEFT_LEG].angles;
+    const float *rleg_angles = legs.leg[IK_RIGHT_LEG].angles;
+    const vector<float> lleg(lleg_angles, &lleg_angles[LEG_JOINTS]);
+    const vector<float> rleg(rleg_angles, &rleg_angles[LEG_JOINTS]);
 
     const vector<float> larm(LARM_WALK_ANGLES,&LARM_WALK_ANGLES[ARM_JOINTS]);
     const vector<float> rarm(RARM_WALK_ANGLES,&RARM_WALK_ANGLES[ARM_JOINTS]);
@@ -902,24 +927,51 @@ StepGenerator::getDefaultStance(const Gait& wp){
     return allJoints;
 }
 
+/**
+ * Makes all four of a step's transforms the first time one is asked for,
+ * from one sine and cosine of its theta, and keeps them on the step.
+ *
+ * Each is the product of a rotation by the step's theta and translations by
+ * the step and by HIP_OFFSET_Y, written out in one matrix.
+ */
+const StepTransforms& StepGenerator::getTransforms(const Step &step){
+    if (step.transformsMade)
+        return step.transforms;
+
+    const float leg_sign = (step.foot == LEFT_FOOT ? 1.0f : -1.0f);
+    const float c = cos(step.theta);
+    const float s = sin(step.theta);
+    StepTransforms &t = step.transforms;
+
+    //translation(x, y + leg_sign*HIP_OFFSET_Y) * rotation(theta)
+    t.f_fprime = rigid3D(c, s, step.x, step.y + leg_sign*HIP_OFFSET_Y);
+
+    //rotation(-theta) * translation(-x, -y - leg_sign*HIP_OFFSET_Y)
+    const float fx = -step.x;
+    const float fy = -step.y - leg_sign*HIP_OFFSET_Y;
+    t.fprime_f = rigid3D(c, -s, c*fx + s*fy, -s*fx + c*fy);
+
+    //translation(0, leg_sign*HIP_OFFSET_Y) * rotation(-theta) *
+    //translation(-x, -y)
+    t.sprime_s = rigid3D(c, -s,
+                         -c*step.x - s*step.y,
+                         s*step.x - c*step.y + leg_sign*HIP_OFFSET_Y);
+
+    //translation(x, y) * rotation(theta) *
+    //translation(0, -leg_sign*HIP_OFFSET_Y)
+    const float sy = -leg_sign*HIP_OFFSET_Y;
+    t.s_sprime = rigid3D(c, s, step.x - s*sy, step.y + c*sy);
+
+    step.transformsMade = true;
+    return t;
+}
+
 /**
  * Method returns the transformation matrix that goes between the previous
  * foot ('f') coordinate frame and the next f coordinate frame rooted at 'step'
  */
-const ufmatrix3 StepGenerator::get_fprime_f(const shared_ptr<Step> step){
-    const float leg_sign = (step->foot == LEFT_FOOT ? 1.0f : -1.0f);
-
-    const float x = step->x;
-    const float y = step->y;
-    const float theta = step->theta;
-
-    ufmatrix3 trans_fprime_s =
-        CoordFrame3D::translation3D(0,-leg_sign*HIP_OFFSET_Y);
-
-    ufmatrix3 trans_s_f =
-        prod(CoordFrame3D::rotation3D(CoordFrame3D::Z_AXIS,-theta),
-             CoordFrame3D::translation3D(-x,-y));
-    return prod(trans_s_f,trans_fprime_s);
+const ufmatrix3& StepGenerator::get_fprime_f(const Step &step){
+    return getTransforms(step).fprime_f;
 }
 
 /**
@@ -928,40 +980,16 @@ const ufmatrix3 StepGenerator::get_fprime_f(const shared_ptr<Step> step){
  * frame rooted at the last step.  Really just the inverse of the matrix
  * returned by the 'get_fprime_f'
  */
-const ufmatrix3 StepGenerator::get_f_fprime(const shared_ptr<Step> step){
-    const float leg_sign = (step->foot == LEFT_FOOT ? 1.0f : -1.0f);
-
-    const float x = step->x;
-    const float y = step->y;
-    const float theta = step->theta;
-
-    ufmatrix3 trans_fprime_s =
-        CoordFrame3D::translation3D(0,leg_sign*HIP_OFFSET_Y);
-
-    ufmatrix3 trans_s_f =
-        prod(CoordFrame3D::translation3D(x,y),
-             CoordFrame3D::rotation3D(CoordFrame3D::Z_AXIS,theta));
-    return prod(trans_fprime_s,trans_s_f);
+const ufmatrix3& StepGenerator::get_f_fprime(const Step &step){
+    return getTransforms(step).f_fprime;
 }
 
 /**
  * Translates points in the sprime frame into the s frame, where
  * the difference between sprime and s is based on 'step'
  */
-const ufmatrix3 StepGenerator::get_sprime_s(const shared_ptr<Step> step){
-    const float leg_sign = (step->foot == LEFT_FOOT ? 1.0f : -1.0f);
-
-    const float x = step->x;
-    const float y = step->y;
-    const float theta = step->theta;
-
-    const ufmatrix3 trans_f_s =
-        CoordFrame3D::translation3D(0,leg_sign*HIP_OFFSET_Y);
-
-    const ufmatrix3 trans_sprime_f =
-        prod(CoordFrame3D::rotation3D(CoordFrame3D::Z_AXIS,-theta),
-             CoordFrame3D::translation3D(-x,-y));
-    return prod(trans_f_s,trans_sprime_f);
+const ufmatrix3& StepGenerator::get_sprime_s(const Step &step){
+    return getTransforms(step).sprime_s;
 }
 
 /**
@@ -969,20 +997,8 @@ const ufmatrix3 StepGenerator::get_sprime_s(const shared_ptr<Step> step){
  * in the next s frame back to the previous one, based on the intervening
  * Step (s' being the last s frame).
  */
-const ufmatrix3 StepGenerator::get_s_sprime(const shared_ptr<Step> step){
-    const float leg_sign = (step->foot == LEFT_FOOT ? 1.0f : -1.0f);
-
-    const float x = step->x;
-    const float y = step->y;
-    const float theta = step->theta;
-
-    const ufmatrix3 trans_f_s =
-        CoordFrame3D::translation3D(0,-leg_sign*HIP_OFFSET_Y);
-
-    const ufmatrix3 trans_sprime_f =
-        prod(CoordFrame3D::translation3D(x,y),
-             CoordFrame3D::rotation3D(CoordFrame3D::Z_AXIS,theta));
-    return prod(trans_sprime_f,trans_f_s);
+const ufmatrix3& StepGenerator::get_s_sprime(const Step &step){
+    return getTransforms(step).s_sprime;
 }
 
 /**
@@ -74,7 +74,8 @@
 
 #include <cstdio>
 #include <math.h>
-#include <list>
+#include <deque>
+#include <vector>
 
 #include <boost/tuple/tuple.hpp>
 #include <boost/shared_ptr.hpp>
@@ -82,6 +83,7 @@
 
 #include "Structs.h"
 #include "WalkController.h"
+#include "ZmpQueue.h"
 #include "WalkingConstants.h"
 #include "WalkingLeg.h"
 #include "WalkingArm.h"
@@ -98,13 +100,32 @@
 #  define DEBUG_SENSOR_ZMP
 #endif
 
-typedef boost::tuple<const std::list<float>*,
-                     const std::list<float>*> zmp_xy_tuple;
 typedef boost::tuple<LegJointStiffTuple,
                       LegJointStiffTuple> WalkLegsTuple;
 typedef boost::tuple<ArmJointStiffTuple,
                      ArmJointStiffTuple> WalkArmsTuple;
 
+/**
+ * The shape of the ZMP reference over a regular step: how many frames it
+ * stays put at each end of double support, how far along from the start to
+ * the middle point it is for each frame in between, and from the middle to
+ * the end for each frame of single support. It only depends on the step's
+ * timing, so it is only made again when the gait changes that.
+ */
+struct ZMPTemplate {
+    ZMPTemplate()
+        : doubleSupportFrames(0), singleSupportFrames(0),
+          staticPercent(-1.0f), halfNumStaticFrames(0) { }
+
+    unsigned int doubleSupportFrames;
+    unsigned int singleSupportFrames;
+    float staticPercent;
+
+    int halfNumStaticFrames;
+    std::vector<float> toMid;
+    std::vector<float> toEnd;
+};
+
 static unsigned int MIN_NUM_ENQUEUED_STEPS = 3; //At any given time, we need at least 3
                                      //steps stored in future, current lists
 
@@ -135,7 +156,7 @@ public:
     }
 
 private: // Helper methods
-    zmp_xy_tuple generate_zmp_ref();
+    void generate_zmp_ref();
     void generate_steps();
 
     void findSensorZMP();
@@ -145,16 +166,18 @@ private: // Helper methods
 
     void generateStep(float _x,float _y,
                       float _theta);
-    void fillZMP(const boost::shared_ptr<Step> newStep );
-    void fillZMPRegular(const boost::shared_ptr<Step> newStep );
-    void fillZMPEnd(const boost::shared_ptr<Step> newStep );
+    void fillZMP(const StepPtr &newStep );
+    void fillZMPRegular(const StepPtr &newStep );
+    void fillZMPEnd(const StepPtr &newStep );
+    const ZMPTemplate& getZMPTemplate(const Step &step);
 
     void resetSteps(const bool startLeft);
 
-    static const NBMath::ufmatrix3 get_f_fprime(const boost::shared_ptr<Step> step);
-    static const NBMath::ufmatrix3 get_fprime_f(const boost::shared_ptr<Step> step);
-    static const NBMath::ufmatrix3 get_sprime_s(const boost::shared_ptr<Step> step);
-    static const NBMath::ufmatrix3 get_s_sprime(const boost::shared_ptr<Step> step);
+    static const StepTransforms& getTransforms(const Step &step);
+    static const NBMath::ufmatrix3& get_f_fprime(const Step &step);
+    static const NBMath::ufmatrix3& get_fprime_f(const Step &step);
+    static const NBMath::ufmatrix3& get_sprime_s(const Step &step);
+    static const NBMath::ufmatrix3& get_s_sprime(const Step &step);
 
     const bool decideStartLeft(const float lateralVelocity,
                                const float radialVelocity);
@@ -182,13 +205,16 @@ private:
     NBMath::ufvector3 com_i,last_com_c,com_f,est_zmp_i;
     //boost::numeric::ublas::vector<float> com_f;
     // need to store future zmp_ref values (points in xy)
-    std::list<float> zmp_ref_x, zmp_ref_y;
-    std::list<boost::shared_ptr<Step> > futureSteps; //stores steps not yet zmpd
+    ZmpQueue zmp_ref_x, zmp_ref_y;
+    ZMPTemplate zmpTemplate;
+    //Every step below comes from here, so it must come first
+    StepPool stepPool;
+    std::deque<StepPtr> futureSteps; //stores steps not yet zmpd
     //Stores currently relevant steps that are zmpd but not yet completed.
     //A step is consider completed (obsolete/irrelevant) as soon as the foot
     //enters into double support (perisistant)
-    std::list<boost::shared_ptr<Step> > currentZMPDSteps;
-    boost::shared_ptr<Step> lastQueuedStep;
+    std::deque<StepPtr> currentZMPDSteps;
+    StepPtr lastQueuedStep;
 
     //Reference Frames for ZMPing steps
     //These are updated when we ZMP a step - they are the 'future', if you will
@@ -196,12 +222,12 @@ private:
     NBMath::ufvector3 last_zmp_end_s;
 
     //Steps for the Walking Leg
-    boost::shared_ptr<Step> lastStep_s;
-    boost::shared_ptr<Step> supportStep_s;
-    boost::shared_ptr<Step> swingingStep_s;
-    boost::shared_ptr<Step> supportStep_f;
-    boost::shared_ptr<Step> swingingStep_f;
-    boost::shared_ptr<Step> swingingStepSource_f;
+    StepPtr lastStep_s;
+    StepPtr supportStep_s;
+    StepPtr swingingStep_s;
+    StepPtr supportStep_f;
+    StepPtr swingingStep_f;
+    StepPtr swingingStepSource_f;
 
     //Reference frames for the Walking Leg
     //These are updated in real time, as we are processing steps
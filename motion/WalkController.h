@@ -25,16 +25,16 @@
 #ifndef _WalkController_h_DEFINED
 #define _WalkController_h_DEFINED
 
-#include <list>
-
 #include "Sensors.h"
+#include "ZmpQueue.h"
 
 class WalkController {
 public:
     //WalkController(Sensors *s) : sensors(s) { }
     virtual ~WalkController(){};
-    virtual const float tick(const std::list<float> *zmp_ref,
-                             const float cur_zmp_ref,
+    // zmp_ref's front is the reference for this tick, and it holds at
+    // least the controller's preview frames after it
+    virtual const float tick(const ZmpQueue &zmp_ref,
                              const float sensor_zmp) = 0;
     virtual const float getPosition() const = 0;
     virtual const float getZMP() const = 0;
@@ -19,7 +19,7 @@ WalkingArm::~WalkingArm(){}
 
 
 
-ArmJointStiffTuple WalkingArm::tick(shared_ptr<Step> supportStep){
+ArmJointStiffTuple WalkingArm::tick(const StepPtr &supportStep){
     singleSupportFrames = supportStep->singleSupportFrames;
     doubleSupportFrames = supportStep->doubleSupportFrames;
 
@@ -46,7 +46,7 @@ ArmJointStiffTuple WalkingArm::tick(shared_ptr<Step> supportStep){
  * Currently, the arms only move in the forward direction by modulating the
  * shoulderPitch
  */
-const float WalkingArm::getShoulderPitchAddition(shared_ptr<Step> supportStep){
+const float WalkingArm::getShoulderPitchAddition(const StepPtr &supportStep){
     float direction = 1.0f; //forward = negative
     float percentComplete = 0.0f;
     switch(state){
@@ -18,7 +18,7 @@ public:
     WalkingArm(const MetaGait * _gait,Kinematics::ChainID id);
     ~WalkingArm();
 
-    ArmJointStiffTuple tick(boost::shared_ptr<Step> );
+    ArmJointStiffTuple tick(const StepPtr &supportStep);
 
     void startLeft();
     void startRight();
@@ -29,7 +29,7 @@ private:
     SupportMode nextState();
     void setState(SupportMode newState);
 
-    const float getShoulderPitchAddition(boost::shared_ptr<Step> supportStep);
+    const float getShoulderPitchAddition(const StepPtr &supportStep);
 
 private:
     SupportMode state;
@@ -77,18 +77,18 @@ WalkingLeg::~WalkingLeg(){
 #endif
 }
 
-void WalkingLeg::setSteps(boost::shared_ptr<Step> _swing_src,
-                          boost::shared_ptr<Step> _swing_dest,
-                          boost::shared_ptr<Step> _support_step){
+void WalkingLeg::setSteps(const StepPtr &_swing_src,
+                          const StepPtr &_swing_dest,
+                          const StepPtr &_support_step){
     swing_src = _swing_src;
     swing_dest = _swing_dest;
     support_step = _support_step;
     assignStateTimes(support_step);
 }
 
-LegJointStiffTuple WalkingLeg::tick(boost::shared_ptr<Step> step,
-                                boost::shared_ptr<Step> _swing_src,
-                                boost::shared_ptr<Step> _swing_dest,
+LegJointStiffTuple WalkingLeg::tick(const StepPtr &step,
+                                const StepPtr &_swing_src,
+                                const StepPtr &_swing_dest,
                                 ufmatrix3 fc_Transform){
 #ifdef DEBUG_WALKINGLEG
     cout << "WalkingLeg::tick() "<<leg_name <<" leg, state is "<<state<<endl;
@@ -398,7 +398,7 @@ WalkingLeg::getHipHack(const float footAngleZ){
         hack_chain = getOtherLegChainID();
     }else{
         // This step is double support, returning 0 hip hack
-        return 0.0f;
+        return boost::make_tuple(0.0f, 0.0f);
     }
     const float support_sign = (state !=SWINGING? 1.0f : -1.0f);
     const float absFootAngle = std::abs(footAngleZ);
@@ -499,35 +499,27 @@ void WalkingLeg::computeOdoUpdate(){
 }
 
 /**
- *  STATIC!! method to get angles from a goal, and the components of walking params
+ *  STATIC!! method to get the angles for both legs from their goals, and the
+ *  components of walking params. Both legs are solved in one IK call.
  */
-vector<float>
-WalkingLeg::getAnglesFromGoal(const ChainID chainID,
-                              const ufvector3 & goal,
-                              const float stance[WP::LEN_STANCE_CONFIG]){
-
-        const float sign = (chainID == LLEG_CHAIN ? 1.0f : -1.0f);
-
-        const ufvector3 body_orientation =
-            CoordFrame3D::vector3D(0.0f,
-                                   stance[WP::BODY_ROT_Y],
-                                   0.0f);
-
-        const ufvector3 foot_orientation =
-            CoordFrame3D::vector3D(0.0f,
-                                   0.0f,
-                                   sign*stance[WP::LEG_ROT_Z]*0.5);
-        const ufvector3 body_goal =
-            CoordFrame3D::vector3D(0.0f,0.0f,0.0f);
-
-
-        IKLegResult result = Kinematics::legIK(chainID,
-                                               goal,
-                                               foot_orientation,
-                                               body_goal,
-                                               body_orientation);
-        return  vector<float>(result.angles,&result.angles[LEG_JOINTS]);
+const Kinematics::IKLegPairResult
+WalkingLeg::getAnglesFromGoals(const ufvector3 & lleg_goal,
+                               const ufvector3 & rleg_goal,
+                               const float stance[WP::LEN_STANCE_CONFIG]){
+        IKLegPairGoal goal;
+        for (int i = 0; i < 3; ++i) {
+            goal.footGoal[i][IK_LEFT_LEG] = lleg_goal(i);
+            goal.footGoal[i][IK_RIGHT_LEG] = rleg_goal(i);
+            goal.footOrientation[i][IK_LEFT_LEG] = 0.0f;
+            goal.footOrientation[i][IK_RIGHT_LEG] = 0.0f;
+            goal.bodyGoal[i] = 0.0f;
+            goal.bodyOrientation[i] = 0.0f;
+        }
+        goal.bodyOrientation[1] = stance[WP::BODY_ROT_Y];
+        goal.footOrientation[2][IK_LEFT_LEG] = stance[WP::LEG_ROT_Z]*0.5f;
+        goal.footOrientation[2][IK_RIGHT_LEG] = -stance[WP::LEG_ROT_Z]*0.5f;
 
+        return Kinematics::legIKPair(goal);
 }
 
 
@@ -605,7 +597,7 @@ void WalkingLeg::setState(SupportMode newState){
         lastRotation = -lastRotation;
 }
 
-void WalkingLeg::assignStateTimes(boost::shared_ptr<Step> step){
+void WalkingLeg::assignStateTimes(const StepPtr &step){
     doubleSupportFrames = step->doubleSupportFrames;
     singleSupportFrames = step->singleSupportFrames;
     cycleFrames = step->stepDurationFrames;
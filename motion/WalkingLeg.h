@@ -88,14 +88,14 @@ public:
                    Kinematics::ChainID id);
     ~WalkingLeg();
 
-    LegJointStiffTuple tick(boost::shared_ptr<Step> step,
-                             boost::shared_ptr<Step> swing_src,
-                             boost::shared_ptr<Step> _suppoting,
+    LegJointStiffTuple tick(const StepPtr &step,
+                             const StepPtr &swing_src,
+                             const StepPtr &_suppoting,
                              NBMath::ufmatrix3 fc_Transform);
 
-    void setSteps(boost::shared_ptr<Step> _swing_src,
-                  boost::shared_ptr<Step> _swing_dest,
-                  boost::shared_ptr<Step> _suppoting);
+    void setSteps(const StepPtr &_swing_src,
+                  const StepPtr &_swing_dest,
+                  const StepPtr &_suppoting);
 
     //Hopefully these never need to get called (architecturally).
     //Instead, use methods like startLeft, right etc
@@ -123,10 +123,10 @@ public:
     std::vector<float> getOdoUpdate();
     void computeOdoUpdate();
 
-    static std::vector<float>
-    getAnglesFromGoal(const Kinematics::ChainID chainID,
-                      const NBMath::ufvector3 & goal,
-                      const float stance[WP::LEN_STANCE_CONFIG]);
+    static const Kinematics::IKLegPairResult
+    getAnglesFromGoals(const NBMath::ufvector3 & lleg_goal,
+                       const NBMath::ufvector3 & rleg_goal,
+                       const float stance[WP::LEN_STANCE_CONFIG]);
 
 private:
     //Execution methods, get called depending on which state the leg is in
@@ -142,7 +142,7 @@ private:
     SupportMode nextState();
     bool shouldSwitchStates();
     bool firstFrame(){return frameCounter == 0;}
-    void assignStateTimes(boost::shared_ptr<Step> step);
+    void assignStateTimes(const StepPtr &step);
     const boost::tuple<const float, const float> getSensorFeedback();
     void debugProcessing();
 //hack
@@ -173,7 +173,7 @@ private:
     unsigned int cycleFrames;
 
     //destination attributes
-    boost::shared_ptr<Step> cur_dest, swing_src, swing_dest,support_step;
+    StepPtr cur_dest, swing_src, swing_dest,support_step;
 
     //Leg Attributes
     Kinematics::ChainID chainID; //keep track of which leg this is
@@ -0,0 +1,63 @@
+#ifndef ZmpQueue_h_DEFINED
+#define ZmpQueue_h_DEFINED
+
+#include <vector>
+
+/**
+ * The ZMP reference in one direction, a frame at a time: the front is the
+ * frame being walked now, and what follows it is what the controller
+ * previews. Frames are only ever added at the back and taken off the
+ * front, and they are kept in one block, so a controller can read a whole
+ * preview window, or many of them at once, straight from data().
+ *
+ * The plan is only ever thrown away by clear(), so a controller that runs
+ * ahead over the frames it has can keep what it worked out for as long as
+ * planId() stays the same.
+ */
+class ZmpQueue
+{
+public:
+    ZmpQueue() : head(0), popped(0), plan(0) { }
+
+    void push_back(float ref) { refs.push_back(ref); }
+
+    void pop_front() {
+        ++head;
+        ++popped;
+        // Move what is left back to the start once most of the block has
+        // been walked, so it never grows past a few steps' worth
+        if (head >= MIN_COMPACT && head * 2 >= refs.size()) {
+            refs.erase(refs.begin(), refs.begin() + head);
+            head = 0;
+        }
+    }
+
+    void clear() {
+        refs.clear();
+        head = 0;
+        popped = 0;
+        ++plan;
+    }
+
+    float front() const { return refs[head]; }
+    float operator[](unsigned int i) const { return refs[head + i]; }
+    // size() frames, front first
+    const float* data() const { return &refs[head]; }
+    unsigned int size() const { return refs.size() - head; }
+    bool empty() const { return size() == 0; }
+
+    // How many frames have been taken off the front since the plan began
+    unsigned int position() const { return popped; }
+    // Changes every time the plan is cleared
+    unsigned int planId() const { return plan; }
+
+private:
+    static const unsigned int MIN_COMPACT = 256;
+
+    std::vector<float> refs;
+    unsigned int head;
+    unsigned int popped;
+    unsigned int plan;
+};
+
+#endif // ZmpQueue_h_DEFINED
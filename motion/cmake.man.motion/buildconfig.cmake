@@ -46,3 +46,21 @@ OPTION(
   "Turn on/off commands being sent from motion to the actuators"
   ON
 )
+
+OPTION(
+  USE_MOTION_TIMER
+  "Run the switchboard off its own monotonic timer, a frame ahead of the enactor (Linux only)"
+  ON
+)
+
+OPTION(
+  USE_MOTION_REALTIME
+  "Give the switchboard thread SCHED_FIFO priority and lock motion's memory"
+  OFF
+)
+
+OPTION(
+  USE_TRAJECTORY_CACHE
+  "Load the SweetMoves compiled by motion/offline/compileMoves from etc/moves.traj at startup"
+  ON
+)
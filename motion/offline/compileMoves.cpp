@@ -0,0 +1,219 @@
+/**
+ * compileMoves.cpp - compile every SweetMove ahead of time
+ *
+ * Imports SweetMoves.py, turns each move into BodyJointCommands the way
+ * PyBodyJointCommand does when the behaviors send it, and plays the
+ * commands through a ScriptedProvider, which compiles them into the
+ * JointTrajectory it will look them up by. The provider's trajectories are
+ * then saved to one file, which the ScriptedProvider on the robot loads when
+ * it is built, so no SweetMove is compiled on the motion thread.
+ *
+ * The file is read back into a fresh provider to check that every move
+ * loads.
+ */
+#include <Python.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "ScriptedProvider.h"
+#include "Sensors.h"
+#include "Profiler.h"
+#include "Common.h"
+
+using namespace std;
+using namespace Kinematics;
+using boost::shared_ptr;
+
+// Lengths of a whole body and a single chain position in SweetMoves.py
+static const int SWEET_MOVE_LENGTH = 7;
+static const int CHAIN_MOVE_LENGTH = 5;
+
+// Appends n floats from item i of seq, converted as PyBodyJointCommand does
+static bool floats(PyObject *seq, int i, unsigned int n, float scale,
+                   vector<float> *out)
+{
+    PyObject *values = PySequence_GetItem(seq, i);
+    if (values == NULL) {
+        return false;
+    }
+    bool ok = PySequence_Check(values) &&
+        PySequence_Size(values) >= static_cast<Py_ssize_t>(n);
+    for (unsigned int j = 0; ok && j < n; ++j) {
+        PyObject *v = PySequence_GetItem(values, j);
+        const float f = v ? static_cast<float>(PyFloat_AsDouble(v)) : 0.0f;
+        Py_XDECREF(v);
+        ok = !PyErr_Occurred();
+        out->push_back(f * scale);
+    }
+    Py_DECREF(values);
+    return ok;
+}
+
+static bool number(PyObject *seq, int i, double *out)
+{
+    PyObject *v = PySequence_GetItem(seq, i);
+    *out = v ? PyFloat_AsDouble(v) : 0.0;
+    Py_XDECREF(v);
+    return v != NULL && !PyErr_Occurred();
+}
+
+static const BodyJointCommand * toCommand(PyObject *position)
+{
+    const Py_ssize_t length = PySequence_Size(position);
+    double time, interpolation, chain;
+
+    if (length == SWEET_MOVE_LENGTH) {
+        vector<float> *larm = new vector<float>;
+        vector<float> *lleg = new vector<float>;
+        vector<float> *rleg = new vector<float>;
+        vector<float> *rarm = new vector<float>;
+        vector<float> *stiffness = new vector<float>;
+        if (floats(position, 0, ARM_JOINTS, TO_RAD, larm) &&
+            floats(position, 1, LEG_JOINTS, TO_RAD, lleg) &&
+            floats(position, 2, LEG_JOINTS, TO_RAD, rleg) &&
+            floats(position, 3, ARM_JOINTS, TO_RAD, rarm) &&
+            number(position, 4, &time) &&
+            number(position, 5, &interpolation) &&
+            floats(position, 6, NUM_JOINTS, 1.0f, stiffness)) {
+            return new BodyJointCommand(
+                static_cast<float>(time), larm, lleg, rleg, rarm, stiffness,
+                static_cast<InterpolationType>(static_cast<int>(
+                                                   interpolation)));
+        }
+        delete larm;
+        delete lleg;
+        delete rleg;
+        delete rarm;
+        delete stiffness;
+    } else if (length == CHAIN_MOVE_LENGTH &&
+               number(position, 0, &chain) &&
+               chain >= 0 && chain < NUM_CHAINS) {
+        const ChainID id = static_cast<ChainID>(static_cast<int>(chain));
+        vector<float> *joints = new vector<float>;
+        vector<float> *stiffness = new vector<float>;
+        if (floats(position, 1, chain_lengths[id], TO_RAD, joints) &&
+            number(position, 2, &time) &&
+            number(position, 3, &interpolation) &&
+            floats(position, 4, NUM_BODY_JOINTS, 1.0f, stiffness)) {
+            return new BodyJointCommand(
+                static_cast<float>(time), id, joints, stiffness,
+                static_cast<InterpolationType>(static_cast<int>(
+                                                   interpolation)));
+        }
+        delete joints;
+        delete stiffness;
+    }
+    PyErr_Clear();
+    return NULL;
+}
+
+// Whether obj looks like a move: a tuple of positions of either length
+static bool isMove(PyObject *obj)
+{
+    if (!PyTuple_Check(obj) || PyTuple_Size(obj) == 0) {
+        return false;
+    }
+    for (Py_ssize_t i = 0; i < PyTuple_Size(obj); ++i) {
+        PyObject *position = PyTuple_GET_ITEM(obj, i);
+        if (!PyTuple_Check(position) ||
+            (PyTuple_Size(position) != SWEET_MOVE_LENGTH &&
+             PyTuple_Size(position) != CHAIN_MOVE_LENGTH)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *motionDir = argc > 1 ? argv[1] : "..";
+    const char *outName = argc > 2 ? argv[2] : "moves.traj";
+    if (argc > 3) {
+        fprintf(stderr, "usage: %s [motion-dir] [out-file]\n", argv[0]);
+        return 1;
+    }
+
+    Py_Initialize();
+    PyObject *path = PySys_GetObject(const_cast<char*>("path"));
+    PyObject *dir = PyString_FromString(motionDir);
+    PyList_Insert(path, 0, dir);
+    Py_DECREF(dir);
+
+    PyObject *moves = PyImport_ImportModule("SweetMoves");
+    if (moves == NULL) {
+        PyErr_Print();
+        fprintf(stderr, "could not import SweetMoves from %s\n", motionDir);
+        return 1;
+    }
+
+    shared_ptr<Sensors> sensors(new Sensors());
+    shared_ptr<Profiler> profiler(new Profiler(&micro_time));
+    ScriptedProvider provider(sensors, profiler);
+
+    PyObject *names = PyObject_Dir(moves);
+    int compiled = 0, skipped = 0;
+    for (Py_ssize_t n = 0; n < PyList_Size(names); ++n) {
+        PyObject *name = PyList_GET_ITEM(names, n);
+        PyObject *move = PyObject_GetAttr(moves, name);
+        if (move == NULL || !isMove(move)) {
+            Py_XDECREF(move);
+            PyErr_Clear();
+            continue;
+        }
+
+        vector<const BodyJointCommand*> seq;
+        bool ok = true;
+        for (Py_ssize_t i = 0; ok && i < PyTuple_Size(move); ++i) {
+            const BodyJointCommand *command =
+                toCommand(PyTuple_GET_ITEM(move, i));
+            ok = command != NULL;
+            if (ok) {
+                seq.push_back(command);
+            }
+        }
+        Py_DECREF(move);
+
+        if (!ok) {
+            // The behaviors could not send it either
+            printf("%-28s skipped, a position does not convert\n",
+                   PyString_AsString(name));
+            for (unsigned int i = 0; i < seq.size(); ++i) {
+                delete seq[i];
+            }
+            skipped++;
+            continue;
+        }
+
+        // Sent all at once, as the behaviors do, and taken as one sequence
+        // on the next frame. The provider deletes the commands.
+        const unsigned int numCommands = seq.size();
+        provider.enqueueSequence(seq);
+        provider.calculateNextJointsAndStiffnesses();
+        provider.hardReset();
+        printf("%-28s %2u commands\n", PyString_AsString(name), numCommands);
+        compiled++;
+    }
+    Py_DECREF(names);
+    Py_DECREF(moves);
+    Py_Finalize();
+
+    const int saved = provider.saveTrajectories(outName);
+    // Moves that are the same share a trajectory
+    printf("compiled %d moves, skipped %d, saved %d trajectories to %s\n",
+           compiled, skipped, saved, outName);
+    if (saved == static_cast<int>(ScriptedProvider::MAX_TRAJECTORIES)) {
+        printf("the provider keeps at most %u trajectories, the rest are "
+               "compiled on the robot\n", ScriptedProvider::MAX_TRAJECTORIES);
+    }
+
+    ScriptedProvider check(sensors, profiler);
+    const int loaded = check.loadTrajectories(outName);
+    if (loaded != saved) {
+        printf("FAILED: only %d of them load\n", loaded);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * gaitSweep.cpp - run the ZMP observer over a sweep of step timings
+ *
+ * For every combination of step duration, double support fraction and
+ * step length, lays out the ZMP reference of a straight walk the way
+ * StepGenerator does for a regular step (the ZMP stays on the support foot
+ * through single support and moves over to the next foot through double
+ * support), queues the whole plan at once and ticks an Observer in x and y
+ * through it.  Since the plan is known and the sensors are weighted out,
+ * the observer runs ahead over the whole walk in one pass.
+ *
+ * Prints, for each gait, the worst distance between the observer's ZMP and
+ * the reference in x and y and the largest sideways sway of the CoM, then
+ * how much faster than the robot's 100 frames a second the sweep ran.
+ */
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Observer.h"
+#include "ZmpQueue.h"
+#include "Kinematics.h"
+#include "Common.h"
+
+using namespace std;
+
+static const float DURATIONS[] = {0.3f, 0.4f, 0.5f, 0.6f};
+static const float DBL_SUPP_FRACTIONS[] = {0.1f, 0.2f, 0.3f, 0.4f};
+static const float STEP_LENGTHS[] = {0.0f, 40.0f, 80.0f};
+static const int NUM_DURATIONS = sizeof(DURATIONS) / sizeof(float);
+static const int NUM_DBL_SUPP = sizeof(DBL_SUPP_FRACTIONS) / sizeof(float);
+static const int NUM_LENGTHS = sizeof(STEP_LENGTHS) / sizeof(float);
+
+static const int NUM_STEPS = 20;
+// Frames stood still before the first step and after the last
+static const int NUM_STILL_FRAMES = 100;
+// Times the whole sweep is run for the timing
+static const int NUM_SWEEPS = 50;
+
+struct Result
+{
+    float maxErrorX, maxErrorY, maxSway;
+};
+
+static void addFrames(ZmpQueue &x, ZmpQueue &y, float toX, float toY,
+                      int frames)
+{
+    for (int i = 0; i < frames; ++i) {
+        x.push_back(toX);
+        y.push_back(toY);
+    }
+}
+
+// Moves linearly from (fromX, fromY), which is already queued, to (toX, toY)
+static void addShift(ZmpQueue &x, ZmpQueue &y, float fromX, float fromY,
+                     float toX, float toY, int frames)
+{
+    for (int i = 1; i <= frames; ++i) {
+        const float t = static_cast<float>(i) / frames;
+        x.push_back(fromX + t * (toX - fromX));
+        y.push_back(fromY + t * (toY - fromY));
+    }
+}
+
+static void planWalk(ZmpQueue &x, ZmpQueue &y, float duration,
+                     float dblSupp, float length)
+{
+    const int stepFrames =
+        static_cast<int>(duration / MOTION_FRAME_LENGTH_S + 0.5f);
+    const int dblSuppFrames = static_cast<int>(stepFrames * dblSupp + 0.5f);
+
+    x.clear();
+    y.clear();
+    addFrames(x, y, 0.0f, 0.0f, NUM_STILL_FRAMES);
+    float lastX = 0.0f, lastY = 0.0f;
+    for (int i = 0; i < NUM_STEPS; ++i) {
+        const float footX = i * length;
+        const float footY = (i % 2 ? -1.0f : 1.0f) * Kinematics::HIP_OFFSET_Y;
+        addShift(x, y, lastX, lastY, footX, footY, dblSuppFrames);
+        addFrames(x, y, footX, footY, stepFrames - dblSuppFrames);
+        lastX = footX;
+        lastY = footY;
+    }
+    const float endX = (NUM_STEPS - 1) * length;
+    addShift(x, y, lastX, lastY, endX, 0.0f, NUM_STILL_FRAMES);
+    addFrames(x, y, endX, 0.0f,
+              NUM_STILL_FRAMES + Observer::NUM_PREVIEW_FRAMES);
+}
+
+// Returns the number of frames walked
+static int walk(Observer &obsX, Observer &obsY, ZmpQueue &x, ZmpQueue &y,
+                Result &result)
+{
+    obsX.initState(0.0f, 0.0f, 0.0f);
+    obsY.initState(0.0f, 0.0f, 0.0f);
+    result.maxErrorX = result.maxErrorY = result.maxSway = 0.0f;
+
+    int frames = 0;
+    while (x.size() > Observer::NUM_PREVIEW_FRAMES) {
+        obsX.tick(x, x.front());
+        const float comY = obsY.tick(y, y.front());
+        // Where the observer has the ZMP next frame, against the plan
+        const float errorX = fabsf(obsX.getZMP() - x[1]);
+        const float errorY = fabsf(obsY.getZMP() - y[1]);
+        if (errorX > result.maxErrorX)
+            result.maxErrorX = errorX;
+        if (errorY > result.maxErrorY)
+            result.maxErrorY = errorY;
+        if (fabsf(comY) > result.maxSway)
+            result.maxSway = fabsf(comY);
+        x.pop_front();
+        y.pop_front();
+        ++frames;
+    }
+    return frames;
+}
+
+int main()
+{
+    Observer obsX, obsY;
+    ZmpQueue x, y;
+    vector<Result> results(NUM_DURATIONS * NUM_DBL_SUPP * NUM_LENGTHS);
+
+    long long frames = 0;
+    const long long start = micro_time();
+    for (int sweep = 0; sweep < NUM_SWEEPS; ++sweep) {
+        int gait = 0;
+        for (int d = 0; d < NUM_DURATIONS; ++d) {
+            for (int s = 0; s < NUM_DBL_SUPP; ++s) {
+                for (int l = 0; l < NUM_LENGTHS; ++l, ++gait) {
+                    planWalk(x, y, DURATIONS[d], DBL_SUPP_FRACTIONS[s],
+                             STEP_LENGTHS[l]);
+                    frames += walk(obsX, obsY, x, y, results[gait]);
+                }
+            }
+        }
+    }
+    const long long elapsed = micro_time() - start;
+
+    printf("duration  dbl supp  length   ZMP error x   ZMP error y   CoM sway\n");
+    int gait = 0;
+    for (int d = 0; d < NUM_DURATIONS; ++d) {
+        for (int s = 0; s < NUM_DBL_SUPP; ++s) {
+            for (int l = 0; l < NUM_LENGTHS; ++l, ++gait) {
+                const Result &r = results[gait];
+                printf("%6.2f s  %6.0f %%  %4.0f mm  %8.2f mm   %8.2f mm"
+                       "   %5.1f mm\n",
+                       DURATIONS[d], 100.0f * DBL_SUPP_FRACTIONS[s],
+                       STEP_LENGTHS[l], r.maxErrorX, r.maxErrorY,
+                       r.maxSway);
+            }
+        }
+    }
+
+    const double walked = frames * MOTION_FRAME_LENGTH_S * 1000000.0;
+    printf("%lld frames in %.3f s: %.1f ns/frame, %.0f times real time\n",
+           frames, elapsed / 1000000.0,
+           elapsed * 1000.0 / frames, walked / elapsed);
+    return 0;
+}
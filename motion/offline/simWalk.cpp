@@ -0,0 +1,130 @@
+/**
+ * simWalk.cpp - walk the switchboard around a SimWorld, lock-stepped
+ *
+ * Runs the switchboard against a SimEnactor and a SimTranscriber on a
+ * SimWorld, a motion frame at a time as sim_soccer_player steps it, but
+ * with no vision or behaviors. The robot walks forwards, sideways to the
+ * left and turning left, each from the same place facing the yellow goal,
+ * and the camera image is rendered every other motion frame as the player
+ * would for vision.
+ *
+ * Prints how far each walk moved the robot and which way it turned, then
+ * how much faster than the robot's 100 frames a second the whole run went
+ * and how long a frame took to render.
+ */
+#include <pthread.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "MotionSwitchboard.h"
+#include "SimWorld.h"
+#include "SimEnactor.h"
+#include "SimTranscriber.h"
+#include "Sensors.h"
+#include "Profiler.h"
+#include "FieldConstants.h"
+#include "VisionDef.h"
+#include "Common.h"
+
+using namespace std;
+using namespace boost;
+
+// Frames each walk runs for, and frames to stop in before the next
+static const int WALK_FRAMES = 1000;
+static const int STOP_FRAMES = 200;
+// As sim_soccer_player, which runs vision every other motion frame
+static const int MOTION_FRAMES_PER_IMAGE = 2;
+
+struct Walk
+{
+    const char *name;
+    float x, y, theta;
+};
+
+static const Walk walks[] = {
+    {"forward", 100.0f, 0.0f, 0.0f},
+    {"left", 0.0f, 50.0f, 0.0f},
+    {"turning left", 0.0f, 0.0f, 0.3f},
+};
+static const int NUM_WALKS = sizeof(walks) / sizeof(walks[0]);
+
+static void * switchboardThread(void * arg)
+{
+    reinterpret_cast<MotionSwitchboard*>(arg)->run();
+    return NULL;
+}
+
+// Returns the time spent rendering, in us
+static long long step(SimEnactor &enactor, SimWorld &world,
+                      vector<unsigned char> &image, int frames)
+{
+    long long rendering = 0;
+    for (int i = 0; i < frames; ++i) {
+        enactor.postSensors();
+        enactor.sendCommands();
+        if (i % MOTION_FRAMES_PER_IMAGE == 0) {
+            const long long start = micro_time();
+            world.render(&image[0]);
+            rendering += micro_time() - start;
+        }
+    }
+    return rendering;
+}
+
+int main()
+{
+    shared_ptr<Sensors> sensors(new Sensors());
+    shared_ptr<Profiler> profiler(new Profiler(&micro_time));
+    shared_ptr<SimWorld> world(new SimWorld());
+    shared_ptr<SimTranscriber> transcriber(new SimTranscriber(sensors,
+                                                              world));
+    SimEnactor enactor(sensors, transcriber, world);
+    MotionSwitchboard switchboard(sensors, profiler);
+    vector<unsigned char> image(IMAGE_BYTE_SIZE);
+
+    enactor.setSwitchboard(&switchboard);
+    switchboard.setLockStep(enactor.lockStep());
+    switchboard.start();
+    pthread_t switchboard_thread;
+    pthread_create(&switchboard_thread, NULL, switchboardThread,
+                   &switchboard);
+
+    // The switchboard starts out frozen, until the behaviors unfreeze it
+    switchboard.sendMotionCommand(
+        shared_ptr<UnfreezeCommand>(new UnfreezeCommand()));
+
+    long long rendering = 0;
+    int frames = 0;
+    const long long start = micro_time();
+    for (int w = 0; w < NUM_WALKS; ++w) {
+        world->setPose(CENTER_FIELD_X, CENTER_FIELD_Y, 0.0f);
+        switchboard.sendMotionCommand(
+            new WalkCommand(walks[w].x, walks[w].y, walks[w].theta));
+        rendering += step(enactor, *world, image, WALK_FRAMES);
+
+        switchboard.sendMotionCommand(new WalkCommand(0.0f, 0.0f, 0.0f));
+        rendering += step(enactor, *world, image, STOP_FRAMES);
+        frames += WALK_FRAMES + STOP_FRAMES;
+
+        printf("%-13s moved %6.1f cm forward, %6.1f cm left, "
+               "turned %6.1f degrees\n", walks[w].name,
+               world->getX() - CENTER_FIELD_X,
+               world->getY() - CENTER_FIELD_Y,
+               world->getHeading() * TO_DEG);
+    }
+    const long long elapsed = micro_time() - start;
+
+    switchboard.stop();
+    pthread_join(switchboard_thread, NULL);
+    enactor.setSwitchboard(NULL);
+
+    const double walked = frames * MOTION_FRAME_LENGTH_S * 1000000.0;
+    const int images = frames / MOTION_FRAMES_PER_IMAGE;
+    printf("%d frames in %.3f s: %.1f times real time, "
+           "%.2f ms to render a frame\n",
+           frames, elapsed / 1000000.0, walked / elapsed,
+           rendering / 1000.0 / images);
+    return 0;
+}
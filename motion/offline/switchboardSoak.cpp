@@ -0,0 +1,247 @@
+/**
+ * switchboardSoak.cpp - run the motion switchboard against a fake enactor
+ *
+ * A stand-in for NaoEnactor runs on its own motion frame timer. Every cycle
+ * it takes the switchboard's next joints, feeds them straight back as the
+ * sensed angles and signals the next frame, as the DCM callbacks do on the
+ * robot. Meanwhile the main thread keeps the providers busy, alternating
+ * walks in different directions with scripted body and head moves.
+ *
+ * With -f another thread floods the switchboard with head commands, as
+ * fast as it will take them, to check that sending commands never holds
+ * up a frame.
+ *
+ * At the end the switchboard's timing statistics are printed (worst wakeup
+ * latency, worst slack before the enactor's deadline and the slack
+ * histogram), followed by the fake enactor's own wakeup latency.
+ */
+#include <pthread.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+#include <boost/shared_ptr.hpp>
+
+#include "MotionSwitchboard.h"
+#include "MotionTimer.h"
+#include "Sensors.h"
+#include "Profiler.h"
+#include "CoordHeadCommand.h"
+#include "Common.h"
+using namespace std;
+using namespace boost;
+using namespace Kinematics;
+
+// How long each command runs before the next one is sent
+static const int SECONDS_PER_COMMAND = 4;
+
+struct FakeEnactor
+{
+    shared_ptr<Sensors> sensors;
+    MotionSwitchboard * switchboard;
+    volatile bool running;
+    MotionTimingStats stats;
+};
+
+struct Flooder
+{
+    MotionSwitchboard * switchboard;
+    volatile bool running;
+    long long sent;
+};
+
+void * switchboardThread(void * arg);
+void * enactorThread(void * arg);
+void * floodThread(void * arg);
+void sendNextCommand(MotionSwitchboard * switchboard, int step);
+
+int main(int argc, char** argv)
+{
+    int seconds = 60;
+    int priority = 0;
+    int cpu = -1;
+    bool lockMemory = false;
+    bool flood = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:p:c:mf")) != -1) {
+        switch (opt) {
+        case 's':
+            seconds = atoi(optarg);
+            break;
+        case 'p':
+            priority = atoi(optarg);
+            break;
+        case 'c':
+            cpu = atoi(optarg);
+            break;
+        case 'm':
+            lockMemory = true;
+            break;
+        case 'f':
+            flood = true;
+            break;
+        default:
+            seconds = 0;
+            break;
+        }
+    }
+    if (seconds < 1) {
+        cerr << "usage: " << argv[0] << " [-s seconds] [-p fifo-priority]"
+             << " [-c cpu] [-m] [-f]" << endl
+             << "  -m locks memory; -p and -m usually need root" << endl;
+        return 1;
+    }
+
+    shared_ptr<Sensors> sensors(new Sensors());
+    shared_ptr<Profiler> profiler(new Profiler(&micro_time));
+    MotionSwitchboard switchboard(sensors, profiler);
+    switchboard.setRealTime(priority, cpu, lockMemory);
+
+    FakeEnactor enactor;
+    enactor.sensors = sensors;
+    enactor.switchboard = &switchboard;
+    enactor.running = true;
+
+    switchboard.start();
+    pthread_t switchboard_thread, enactor_thread;
+    pthread_create(&switchboard_thread, NULL, switchboardThread, &switchboard);
+    pthread_create(&enactor_thread, NULL, enactorThread, &enactor);
+
+    Flooder flooder;
+    flooder.switchboard = &switchboard;
+    flooder.running = true;
+    flooder.sent = 0;
+    pthread_t flood_thread;
+    if (flood) {
+        pthread_create(&flood_thread, NULL, floodThread, &flooder);
+    }
+
+    sendNextCommand(&switchboard, 0);
+    for (int t = 1; t < seconds; ++t) {
+        sleep(1);
+        if (t % SECONDS_PER_COMMAND == 0) {
+            sendNextCommand(&switchboard, t / SECONDS_PER_COMMAND);
+        }
+    }
+
+    if (flood) {
+        flooder.running = false;
+        pthread_join(flood_thread, NULL);
+    }
+    // ScriptedProvider's destructor spins until its move is done, so drop
+    // any move still playing and give the switchboard a few frames to do it
+    switchboard.resetScriptedProvider();
+    usleep(10 * static_cast<int>(MOTION_FRAME_LENGTH_uS));
+    switchboard.stop();
+    pthread_join(switchboard_thread, NULL);
+    enactor.running = false;
+    pthread_join(enactor_thread, NULL);
+
+    cout << endl << "Switchboard:" << endl;
+    switchboard.getTimingStats().print(cout);
+    cout << endl << "Fake enactor:" << endl;
+    enactor.stats.print(cout);
+
+    const MotionTimingStats stats = switchboard.getTimingStats();
+    cout << endl << "worst case latency " << stats.getWorstLatency()
+         << "us, worst slack " << stats.getWorstSlack() << "us, "
+         << stats.getMissed() << " of " << stats.getFrames()
+         << " deadlines missed" << endl;
+    if (flood) {
+        cout << flooder.sent << " head commands flooded in, "
+             << flooder.sent / seconds << " per second" << endl;
+    }
+    return 0;
+}
+
+void * switchboardThread(void * arg)
+{
+    reinterpret_cast<MotionSwitchboard*>(arg)->run();
+    return NULL;
+}
+
+/**
+ * Does what NaoEnactor's DCM callbacks do each cycle: send the next joints
+ * (here, straight back into the sensors as if the motors reached them
+ * instantly) and then post sensors and signal the switchboard.
+ */
+void * enactorThread(void * arg)
+{
+    FakeEnactor * e = reinterpret_cast<FakeEnactor*>(arg);
+    MotionTimer timer(static_cast<long long>(MOTION_FRAME_LENGTH_uS));
+    if (!timer.start()) {
+        return NULL;
+    }
+
+    while (e->running) {
+        const int ticks = timer.wait();
+        const long long woke = MotionTimer::monotonicMicros();
+
+        const vector<float> joints = e->switchboard->getNextJoints();
+        e->sensors->setBodyAngles(joints);
+        e->sensors->setMotionBodyAngles(joints);
+        e->switchboard->signalNextFrame();
+
+        const long long done = MotionTimer::monotonicMicros();
+        e->stats.record(woke - timer.lastTick(),
+                        timer.lastTick() + timer.getPeriod() - done,
+                        ticks > 1 ? ticks - 1 : 0);
+    }
+    return NULL;
+}
+
+/**
+ * Sends the same head command over and over. The switchboard does not
+ * delete head coord commands, so one does for the whole run; it outlives
+ * this thread because the switchboard may still have it queued.
+ */
+static const CoordHeadCommand floodCommand(0.2f, 0.1f);
+
+void * floodThread(void * arg)
+{
+    Flooder * f = reinterpret_cast<Flooder*>(arg);
+    while (f->running) {
+        f->switchboard->sendMotionCommand(&floodCommand);
+        ++f->sent;
+    }
+    return NULL;
+}
+
+/**
+ * Cycle through walking forwards, sideways and turning, with a scripted body
+ * move and a head move in between, so every provider gets exercised.
+ */
+void sendNextCommand(MotionSwitchboard * switchboard, int step)
+{
+    switch (step % 5) {
+    case 0:
+        switchboard->sendMotionCommand(new WalkCommand(100.0f, 0.0f, 0.0f));
+        break;
+    case 1:
+        switchboard->sendMotionCommand(new WalkCommand(0.0f, 50.0f, 0.0f));
+        break;
+    case 2:
+        switchboard->sendMotionCommand(new WalkCommand(50.0f, 0.0f, 0.5f));
+        break;
+    case 3: {
+        switchboard->sendMotionCommand(new WalkCommand(0.0f, 0.0f, 0.0f));
+        // Joint commands take ownership of the vectors they are given
+        vector<float> * head = new vector<float>(HEAD_JOINTS, 0.5f);
+        vector<float> * stiffness = new vector<float>(NUM_JOINTS, 0.85f);
+        switchboard->sendMotionCommand(
+            new HeadJointCommand(2.0f, head, stiffness,
+                                 INTERPOLATION_SMOOTH));
+        break;
+    }
+    default: {
+        vector<float> * body = new vector<float>(NUM_BODY_JOINTS, 0.0f);
+        vector<float> * stiffness = new vector<float>(NUM_JOINTS, 0.85f);
+        switchboard->sendMotionCommand(
+            new BodyJointCommand(3.0f, body, stiffness,
+                                 INTERPOLATION_SMOOTH));
+        break;
+    }
+    }
+}
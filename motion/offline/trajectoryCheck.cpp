@@ -0,0 +1,253 @@
+/**
+ * trajectoryCheck.cpp - check compiled joint trajectories
+ *
+ * Plays a stand-up-like sequence of BodyJointCommands the way the
+ * ScriptedProvider used to, chopping one command at a time from wherever the
+ * last one ended, and checks that:
+ *  - a JointTrajectory compiled from the same start has exactly those rows,
+ *  - one compiled from a different start, played from this start, is within
+ *    rounding of them,
+ *  - a trajectory is only taken as compiled from the commands it was,
+ *  - a trajectory written to a file and read back is unchanged.
+ * Then it times a frame of each.
+ */
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "JointTrajectory.h"
+#include "ChopShop.h"
+#include "Common.h"
+
+using namespace std;
+using namespace Kinematics;
+using boost::shared_ptr;
+
+// Angles played back from a different start may differ by rounding
+static const float MAX_RETARGET_ERROR = 1e-5f;
+static const int NUM_TIMING_RUNS = 200;
+
+static vector<float> * degrees(int n, const float *values)
+{
+    vector<float> *v = new vector<float>;
+    for (int i = 0; i < n; ++i) {
+        v->push_back(values[i] * TO_RAD);
+    }
+    return v;
+}
+
+static BodyJointCommand * keyframe(const float larm[], const float lleg[],
+                                   const float rleg[], const float rarm[],
+                                   float time, InterpolationType type)
+{
+    return new BodyJointCommand(time, degrees(ARM_JOINTS, larm),
+                                degrees(LEG_JOINTS, lleg),
+                                degrees(LEG_JOINTS, rleg),
+                                degrees(ARM_JOINTS, rarm),
+                                new vector<float>(NUM_JOINTS, 0.85f), type);
+}
+
+// Sitting, arms forward, up onto the legs and a wave of the left arm alone
+static vector<const BodyJointCommand*> makeSequence()
+{
+    const float sitArm[] = {90.0f, 0.0f, -65.0f, -57.0f};
+    const float sitLeg[] = {0.0f, 0.0f, -55.0f, 125.7f, -75.7f, 0.0f};
+    const float rSitArm[] = {90.0f, 0.0f, 65.0f, 57.0f};
+    const float standArm[] = {60.0f, 35.0f, 0.0f, 0.0f};
+    const float standLeg[] = {0.0f, 0.0f, -21.6f, 52.13f, -30.3f, 0.0f};
+    const float rStandArm[] = {60.0f, -35.0f, 0.0f, 0.0f};
+    const float waveArm[] = {-90.0f, 20.0f, 0.0f, -10.0f};
+
+    vector<const BodyJointCommand*> seq;
+    seq.push_back(keyframe(sitArm, sitLeg, sitLeg, rSitArm, 1.5f,
+                           INTERPOLATION_SMOOTH));
+    seq.push_back(keyframe(standArm, standLeg, standLeg, rStandArm, 2.0f,
+                           INTERPOLATION_LINEAR));
+    seq.push_back(new BodyJointCommand(0.8f, LARM_CHAIN,
+                                       degrees(ARM_JOINTS, waveArm),
+                                       new vector<float>(NUM_JOINTS, 0.6f),
+                                       INTERPOLATION_SMOOTH));
+    seq.push_back(keyframe(standArm, standLeg, standLeg, rStandArm, 0.5f,
+                           INTERPOLATION_SMOOTH));
+    return seq;
+}
+
+static vector<float> makeStart(float scale)
+{
+    vector<float> start(NUM_JOINTS);
+    for (unsigned int j = 0; j < NUM_JOINTS; ++j) {
+        start[j] = scale * sin(static_cast<float>(j));
+    }
+    return start;
+}
+
+// What the ScriptedProvider used to send, frame by frame
+static vector<vector<float> > chopSequence(
+    const vector<const BodyJointCommand*> &seq, const vector<float> &start)
+{
+    vector<vector<float> > rows;
+    vector<float> current = start;
+    for (unsigned int c = 0; c < seq.size(); ++c) {
+        shared_ptr<ChoppedCommand> chopped = ChopShop::chopFrom(seq[c],
+                                                                current);
+        const int numChops = ChopShop::getNumChops(seq[c]);
+        for (int chop = 0; chop < numChops; ++chop) {
+            vector<float> row;
+            for (unsigned int chain = 0; chain < NUM_CHAINS; ++chain) {
+                const vector<float> joints = chopped->getNextJoints(chain);
+                row.insert(row.end(), joints.begin(), joints.end());
+            }
+            rows.push_back(row);
+            current = row;
+        }
+    }
+    return rows;
+}
+
+// Largest difference between the trajectory played from start and rows
+static float compare(const JointTrajectory &t, const vector<float> &start,
+                     const vector<vector<float> > &rows)
+{
+    if (t.getNumFrames() != static_cast<int>(rows.size())) {
+        printf("  %d frames, expected %d\n", t.getNumFrames(),
+               static_cast<int>(rows.size()));
+        return 1.0f;
+    }
+    float worst = 0.0f;
+    float joints[NUM_JOINTS];
+    for (int f = 0; f < t.getNumFrames(); ++f) {
+        t.getFrame(f, &start[0], joints);
+        for (unsigned int j = 0; j < NUM_JOINTS; ++j) {
+            worst = max(worst, std::fabs(joints[j] - rows[f][j]));
+        }
+    }
+    return worst;
+}
+
+static int checkRoundTrip(const vector<const BodyJointCommand*> &seq,
+                          const JointTrajectory &t)
+{
+    FILE *f = tmpfile();
+    if (f == NULL || !t.write(f)) {
+        printf("round trip: could not write\n");
+        return 1;
+    }
+    rewind(f);
+    JointTrajectory read;
+    const bool ok = read.read(f);
+    fclose(f);
+
+    const vector<float> start = makeStart(0.1f);
+    float a[NUM_JOINTS], b[NUM_JOINTS];
+    int differences = 0;
+    for (int frame = 0; ok && frame < t.getNumFrames(); ++frame) {
+        t.getFrame(frame, &start[0], a);
+        read.getFrame(frame, &start[0], b);
+        for (unsigned int j = 0; j < NUM_JOINTS; ++j) {
+            differences += (a[j] != b[j] ||
+                            t.getStiffnesses(frame)[j] !=
+                            read.getStiffnesses(frame)[j]);
+        }
+    }
+    if (!ok || read.getSignature() != t.getSignature() ||
+        !read.compiledFrom(seq) ||
+        read.getNumFrames() != t.getNumFrames() || differences > 0) {
+        printf("round trip: read back differs\n");
+        return 1;
+    }
+    printf("round trip: %d frames read back unchanged\n", t.getNumFrames());
+    return 0;
+}
+
+static void benchmark(const vector<const BodyJointCommand*> &seq,
+                      const JointTrajectory &t)
+{
+    const vector<float> start = makeStart(0.1f);
+    const int frames = t.getNumFrames();
+    float sink = 0.0f;
+
+    long long begin = micro_time();
+    for (int run = 0; run < NUM_TIMING_RUNS; ++run) {
+        sink += chopSequence(seq, start).back()[0];
+    }
+    const long long chopped = micro_time() - begin;
+
+    float joints[NUM_JOINTS];
+    begin = micro_time();
+    for (int run = 0; run < NUM_TIMING_RUNS; ++run) {
+        for (int f = 0; f < frames; ++f) {
+            t.getFrame(f, &start[0], joints);
+            sink += joints[f % NUM_JOINTS];
+        }
+    }
+    const long long table = micro_time() - begin;
+
+    begin = micro_time();
+    for (int run = 0; run < NUM_TIMING_RUNS; ++run) {
+        JointTrajectory compiled;
+        compiled.compile(seq, start);
+        sink += compiled.getNumFrames();
+    }
+    const long long compile = micro_time() - begin;
+
+    const float perFrame = static_cast<float>(NUM_TIMING_RUNS * frames);
+    printf("\nper frame:\n");
+    printf("  chopped commands  %8.3fus\n", chopped / perFrame);
+    printf("  trajectory table  %8.3fus\n", table / perFrame);
+    printf("compiling the sequence once: %.1fus\n",
+           static_cast<float>(compile) / NUM_TIMING_RUNS);
+    if (sink == 12345.0f) {
+        printf("\n");
+    }
+}
+
+int main()
+{
+    const vector<const BodyJointCommand*> seq = makeSequence();
+    const vector<float> start = makeStart(0.1f);
+    const vector<float> otherStart = makeStart(-0.3f);
+    const vector<vector<float> > rows = chopSequence(seq, start);
+    int failures = 0;
+
+    JointTrajectory t;
+    t.compile(seq, start);
+    const float exact = compare(t, start, rows);
+    printf("compiled: %d frames in %d segments, differ from the chopped "
+           "commands by at most %g\n", t.getNumFrames(),
+           t.getNumSegments(), exact);
+    failures += (exact != 0.0f);
+
+    JointTrajectory other;
+    other.compile(seq, otherStart);
+    const float retarget = compare(other, start, rows);
+    printf("retargeted: differ by at most %g\n", retarget);
+    failures += (retarget > MAX_RETARGET_ERROR);
+
+    if (JointTrajectory::signature(seq) != t.getSignature() ||
+        other.getSignature() != t.getSignature()) {
+        printf("signature depends on the start\n");
+        failures++;
+    }
+
+    const vector<const BodyJointCommand*> shorter(seq.begin(), seq.end() - 1);
+    if (!t.compiledFrom(seq) || !other.compiledFrom(seq) ||
+        t.compiledFrom(shorter)) {
+        printf("compiledFrom does not match the commands\n");
+        failures++;
+    }
+
+    failures += checkRoundTrip(seq, t);
+    benchmark(seq, t);
+
+    for (unsigned int c = 0; c < seq.size(); ++c) {
+        delete seq[c];
+    }
+
+    if (failures > 0) {
+        printf("\n%d FAILURES\n", failures);
+        return 1;
+    }
+    printf("\nall ok\n");
+    return 0;
+}
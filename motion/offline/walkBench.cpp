@@ -0,0 +1,136 @@
+/**
+ * walkBench.cpp - time the walk engine per motion frame
+ *
+ * Runs a WalkProvider the way the switchboard does, one
+ * calculateNextJointsAndStiffnesses() a frame, while walking at a constant
+ * speed: straight ahead, turning, and straight ahead with the behaviors
+ * sending the same gait again every so often.  Prints the best of a few
+ * runs' mean time per frame, the heap allocations per frame, and a sum of
+ * every joint it sent, which should not change when the engine is only
+ * made faster.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "WalkProvider.h"
+#include "WalkCommand.h"
+#include "Sensors.h"
+#include "Profiler.h"
+#include "Common.h"
+
+using namespace std;
+using namespace Kinematics;
+using boost::shared_ptr;
+
+// Frames to get going before the timing starts, and frames timed
+static const int NUM_START_FRAMES = 500;
+static const int NUM_FRAMES = 20000;
+// How often the behaviors send the gait again
+static const int FRAMES_PER_GAIT = 50;
+// Runs of each walk, of which the fastest is reported
+static const int NUM_RUNS = 5;
+
+static long long allocations = 0;
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+    ++allocations;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+    return operator new(size);
+}
+
+// Not inlined, or gcc sees memory from new going to free() and warns
+__attribute__((noinline)) void operator delete(void *p) throw()
+{
+    free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    operator delete(p);
+}
+
+struct Walk
+{
+    const char *name;
+    float x, y, theta;
+    bool resendGait;
+};
+
+static const Walk walks[] = {
+    {"forward", 100.0f, 0.0f, 0.0f, false},
+    {"turning", 50.0f, 0.0f, 0.3f, false},
+    {"gait resent", 100.0f, 0.0f, 0.0f, true},
+};
+static const int NUM_WALKS = sizeof(walks) / sizeof(walks[0]);
+
+static double sumJoints(WalkProvider &walk)
+{
+    double sum = 0.0;
+    for (unsigned int chain = LARM_CHAIN; chain < NUM_CHAINS; ++chain) {
+        const vector<float> joints =
+            walk.getChainJoints(static_cast<ChainID>(chain));
+        for (unsigned int i = 0; i < joints.size(); ++i)
+            sum += joints[i];
+    }
+    return sum;
+}
+
+// Returns the mean time per frame, in us
+static double run(const Walk &w, long long &allocated, double &sum)
+{
+    shared_ptr<Sensors> sensors(new Sensors());
+    shared_ptr<Profiler> profiler(new Profiler(&micro_time));
+    WalkProvider walk(sensors, profiler);
+    const shared_ptr<Gait> gait(new Gait(DEFAULT_GAIT));
+
+    walk.setCommand(gait);
+    walk.setCommand(new WalkCommand(w.x, w.y, w.theta));
+    for (int i = 0; i < NUM_START_FRAMES; ++i)
+        walk.calculateNextJointsAndStiffnesses();
+
+    sum = 0.0;
+    allocated = 0;
+    long long total = 0;
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        if (w.resendGait && i % FRAMES_PER_GAIT == 0)
+            walk.setCommand(gait);
+        const long long allocatedBefore = allocations;
+        const long long frameStart = micro_time();
+        walk.calculateNextJointsAndStiffnesses();
+        total += micro_time() - frameStart;
+        allocated += allocations - allocatedBefore;
+        sum += sumJoints(walk);
+    }
+    return static_cast<double>(total) / NUM_FRAMES;
+}
+
+static void runBest(const Walk &w)
+{
+    double best = 0.0, sum = 0.0;
+    long long allocated = 0;
+    for (int i = 0; i < NUM_RUNS; ++i) {
+        const double mean = run(w, allocated, sum);
+        if (i == 0 || mean < best)
+            best = mean;
+    }
+    printf("%-12s %6.2f us/frame  %6.2f allocations/frame  joint sum %.4f\n",
+           w.name, best, static_cast<double>(allocated) / NUM_FRAMES, sum);
+}
+
+int main()
+{
+    for (int i = 0; i < NUM_WALKS; ++i)
+        runBest(walks[i]);
+    return 0;
+}
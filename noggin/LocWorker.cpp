@@ -0,0 +1,220 @@
+#include <sched.h>
+
+#include "LocWorker.h"
+#include "NBMath.h"
+
+using namespace std;
+using namespace boost;
+
+LocWorker::LocWorker(shared_ptr<Synchro> _synchro,
+                     shared_ptr<LocSystem> _loc)
+    : Thread(_synchro, "LocWorker"), loc(_loc),
+      packetReady(_synchro->create("LocWorker::packetReady")),
+      requestDone(_synchro->create("LocWorker::requestDone")),
+      packets(), estimates(), pendingOdometry(), droppedFrames(0),
+      requestsSent(0), requestsApplied(0),
+      observationsLock(), lastObservations()
+{
+    publish(-1);
+}
+
+LocWorker::~LocWorker()
+{
+}
+
+void LocWorker::run()
+{
+    running = true;
+    trigger->on();
+
+    while (running) {
+        const LocPacket *p;
+        while ((p = packets.front()) != NULL) {
+            apply(*p);
+            const long frame = p->frame;
+            const bool isRequest = p->request != LOC_UPDATE;
+            packets.pop();
+            if (isRequest)
+                requestsApplied++;
+            publish(frame);
+            if (isRequest)
+                requestDone->signal();
+        }
+        packetReady->await();
+    }
+
+    trigger->off();
+}
+
+void LocWorker::stop()
+{
+    Thread::stop();
+    packetReady->signal();
+}
+
+void LocWorker::apply(const LocPacket &p)
+{
+    switch (p.request) {
+    case LOC_UPDATE:
+        loc->updateLocalization(p.odometry, p.observations);
+        observationsLock.dolock();
+        lastObservations = loc->getLastObservations();
+        observationsLock.release();
+        break;
+    case LOC_RESET:
+        loc->reset();
+        break;
+    case LOC_BLUE_GOALIE_RESET:
+        loc->blueGoalieReset();
+        break;
+    case LOC_RED_GOALIE_RESET:
+        loc->redGoalieReset();
+        break;
+    case LOC_SET_X:
+        loc->setXEst(p.value);
+        break;
+    case LOC_SET_Y:
+        loc->setYEst(p.value);
+        break;
+    case LOC_SET_H:
+        loc->setHEst(p.value);
+        break;
+    case LOC_SET_X_UNCERT:
+        loc->setXUncert(p.value);
+        break;
+    case LOC_SET_Y_UNCERT:
+        loc->setYUncert(p.value);
+        break;
+    case LOC_SET_H_UNCERT:
+        loc->setHUncert(p.value);
+        break;
+    }
+}
+
+void LocWorker::publish(long frame)
+{
+    LocEstimate e;
+    e.frame = (frame == -1 ? latest().frame : frame);
+    e.estimate = loc->getCurrentEstimate();
+    e.uncertainty = loc->getCurrentUncertainty();
+    e.lastOdo = loc->getLastOdo();
+    e.requests = requestsApplied;
+    estimates.post(e);
+}
+
+const LocWorker::LocEstimate LocWorker::latest() const
+{
+    LocEstimate e;
+    estimates.retrieve(e);
+    return e;
+}
+
+void LocWorker::updateLocalization(long frame, const MotionModel &u_t,
+                                   const vector<Observation> &z_t)
+{
+    LocPacket *p = packets.producerSlot();
+    if (p == NULL) {
+        // The worker is behind; keep the odometry for the next frame
+        pendingOdometry.deltaF += u_t.deltaF;
+        pendingOdometry.deltaL += u_t.deltaL;
+        pendingOdometry.deltaR += u_t.deltaR;
+        droppedFrames++;
+        return;
+    }
+
+    p->request = LOC_UPDATE;
+    p->frame = frame;
+    p->odometry = MotionModel(pendingOdometry.deltaF + u_t.deltaF,
+                              pendingOdometry.deltaL + u_t.deltaL,
+                              pendingOdometry.deltaR + u_t.deltaR);
+    p->observations.assign(z_t.begin(), z_t.end());
+    packets.push();
+    packetReady->signal();
+    pendingOdometry = MotionModel();
+}
+
+void LocWorker::updateLocalization(MotionModel u_t, vector<Observation> z_t)
+{
+    updateLocalization(-1, u_t, z_t);
+}
+
+/**
+ * Resets and setters must not be lost, so if the queue is full they wait
+ * for the worker to make room, which it does within an update. Then they
+ * wait for the worker to apply them, so the getters see the change as soon
+ * as this returns.
+ */
+void LocWorker::request(LocRequest r, float value)
+{
+    LocPacket *p;
+    while ((p = packets.producerSlot()) == NULL && running) {
+        sched_yield();
+    }
+    if (p == NULL) {
+        return;
+    }
+    p->request = r;
+    p->frame = -1;
+    p->value = value;
+    packets.push();
+    requestsSent++;
+    packetReady->signal();
+
+    while (running && latest().requests != requestsSent) {
+        requestDone->await();
+    }
+}
+
+void LocWorker::reset() { request(LOC_RESET); }
+void LocWorker::blueGoalieReset() { request(LOC_BLUE_GOALIE_RESET); }
+void LocWorker::redGoalieReset() { request(LOC_RED_GOALIE_RESET); }
+
+void LocWorker::setXEst(float xEst) { request(LOC_SET_X, xEst); }
+void LocWorker::setYEst(float yEst) { request(LOC_SET_Y, yEst); }
+void LocWorker::setHEst(float hEst) { request(LOC_SET_H, hEst); }
+void LocWorker::setXUncert(float uncertX) { request(LOC_SET_X_UNCERT, uncertX); }
+void LocWorker::setYUncert(float uncertY) { request(LOC_SET_Y_UNCERT, uncertY); }
+void LocWorker::setHUncert(float uncertH) { request(LOC_SET_H_UNCERT, uncertH); }
+
+const PoseEst LocWorker::getCurrentEstimate() const
+{
+    return latest().estimate;
+}
+
+const PoseEst LocWorker::getCurrentUncertainty() const
+{
+    return latest().uncertainty;
+}
+
+const float LocWorker::getXEst() const { return latest().estimate.x; }
+const float LocWorker::getYEst() const { return latest().estimate.y; }
+const float LocWorker::getHEst() const { return latest().estimate.h; }
+const float LocWorker::getHEstDeg() const
+{
+    return latest().estimate.h * TO_DEG;
+}
+const float LocWorker::getXUncert() const { return latest().uncertainty.x; }
+const float LocWorker::getYUncert() const { return latest().uncertainty.y; }
+const float LocWorker::getHUncert() const { return latest().uncertainty.h; }
+const float LocWorker::getHUncertDeg() const
+{
+    return latest().uncertainty.h * TO_DEG;
+}
+
+const MotionModel LocWorker::getLastOdo() const
+{
+    return latest().lastOdo;
+}
+
+const vector<Observation> LocWorker::getLastObservations() const
+{
+    observationsLock.dolock();
+    const vector<Observation> copy = lastObservations;
+    observationsLock.release();
+    return copy;
+}
+
+long LocWorker::getEstimateFrame() const
+{
+    return latest().frame;
+}
@@ -0,0 +1,139 @@
+/**
+ * LocWorker.h - Runs a localization system on its own thread
+ *
+ * Noggin hands each frame's odometry and observations to the worker through
+ * a single producer, single consumer queue and goes straight on to the
+ * behaviors, so the filter no longer runs inside the vision frame. After
+ * every update the worker posts the estimate, stamped with the vision frame
+ * its observations came from, and the getters read the latest one posted
+ * without locking. Resets and setters go through the queue too, in order
+ * with the updates, so only the worker ever touches the filter, but unlike
+ * updates they wait until the worker has applied them and posted the new
+ * estimate. Python that resets or sets loc and reads it straight back, as
+ * odotune does, sees its own change; the price is that the caller may wait
+ * out the update the worker is in the middle of.
+ *
+ * The estimates can be behind vision by the frame or so the worker is
+ * still working on. If it falls further behind than the queue holds, the
+ * observations of the frames that do not fit are dropped and their
+ * odometry is added to the next frame that does.
+ */
+
+#ifndef LocWorker_h_DEFINED
+#define LocWorker_h_DEFINED
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "synchro.h"
+#include "messaging.h"
+#include "LocSystem.h"
+
+class LocWorker : public Thread, public LocSystem
+{
+public:
+    LocWorker(boost::shared_ptr<Synchro> _synchro,
+              boost::shared_ptr<LocSystem> _loc);
+    virtual ~LocWorker();
+
+    void run();
+    void stop();
+
+    // Queues an update with the observations from the given vision frame
+    void updateLocalization(long frame, const MotionModel &u_t,
+                            const std::vector<Observation> &z_t);
+
+    // LocSystem. Updates queued this way are stamped with frame -1.
+    void updateLocalization(MotionModel u_t, std::vector<Observation> z_t);
+    void reset();
+    void blueGoalieReset();
+    void redGoalieReset();
+
+    const PoseEst getCurrentEstimate() const;
+    const PoseEst getCurrentUncertainty() const;
+    const float getXEst() const;
+    const float getYEst() const;
+    const float getHEst() const;
+    const float getHEstDeg() const;
+    const float getXUncert() const;
+    const float getYUncert() const;
+    const float getHUncert() const;
+    const float getHUncertDeg() const;
+    const MotionModel getLastOdo() const;
+    const std::vector<Observation> getLastObservations() const;
+
+    void setXEst(float xEst);
+    void setYEst(float yEst);
+    void setHEst(float hEst);
+    void setXUncert(float uncertX);
+    void setYUncert(float uncertY);
+    void setHUncert(float uncertH);
+
+    // The vision frame the latest estimate came from, or -1 if none has
+    // been posted yet
+    long getEstimateFrame() const;
+    // Frames whose observations were dropped because the queue was full
+    unsigned int getDroppedFrames() const { return droppedFrames; }
+
+private:
+    enum LocRequest {
+        LOC_UPDATE,
+        LOC_RESET,
+        LOC_BLUE_GOALIE_RESET,
+        LOC_RED_GOALIE_RESET,
+        LOC_SET_X,
+        LOC_SET_Y,
+        LOC_SET_H,
+        LOC_SET_X_UNCERT,
+        LOC_SET_Y_UNCERT,
+        LOC_SET_H_UNCERT
+    };
+
+    struct LocPacket {
+        LocRequest request;
+        long frame;
+        MotionModel odometry;
+        std::vector<Observation> observations;
+        float value;
+    };
+
+    struct LocEstimate {
+        LocEstimate()
+            : frame(-1), estimate(0.0f, 0.0f, 0.0f),
+              uncertainty(0.0f, 0.0f, 0.0f), lastOdo(), requests(0) { }
+        long frame;
+        PoseEst estimate;
+        PoseEst uncertainty;
+        MotionModel lastOdo;
+        // Resets and setters applied before this estimate
+        unsigned int requests;
+    };
+
+    void request(LocRequest r, float value = 0.0f);
+    void apply(const LocPacket &p);
+    void publish(long frame);
+    const LocEstimate latest() const;
+
+private:
+    static const unsigned int QUEUE_SIZE = 8;
+
+    boost::shared_ptr<LocSystem> loc;
+    boost::shared_ptr<Event> packetReady;
+    // Signalled by the worker after it posts a reset or setter
+    boost::shared_ptr<Event> requestDone;
+    SPSCQueue<LocPacket, QUEUE_SIZE> packets;
+    RingPost<LocEstimate> estimates;
+
+    // Odometry from frames that did not fit in the queue
+    MotionModel pendingOdometry;
+    unsigned int droppedFrames;
+    // Resets and setters sent, and applied by the worker
+    unsigned int requestsSent;
+    unsigned int requestsApplied;
+
+    // The worker's copy of the last observations, for the TOOL
+    mutable Lock observationsLock;
+    std::vector<Observation> lastObservations;
+};
+
+#endif // LocWorker_h_DEFINED
@@ -8,8 +8,7 @@
 
 #include "MCL.h"
 #include "NBMath.h"
-#include <time.h> // for srand(time(NULL))
-#include <cstdlib> // for MAX_RAND
+#include <time.h> // for time(NULL)
 using namespace std;
 #define MAX_CHANGE_X 5.0f
 #define MAX_CHANGE_Y 5.0f
@@ -17,28 +16,21 @@ using namespace std;
 #define MAX_CHANGE_F 5.0f
 #define MAX_CHANGE_L 5.0f
 #define MAX_CHANGE_R M_PI_FLOAT / 16.0f
-#define UNIFORM_1_NEG_1 (2.0f*(static_cast<float>(rand()) / (static_cast<float>(RAND_MAX)+1)) - 1.0f)
 
 /**
  * Initializes the sampel sets so that the first update works appropriately
  */
-MCL::MCL(int _M) : useBest(false), lastOdo(0,0,0), frameCounter(0), M(_M)
+MCL::MCL(int _M) : useBest(false), lastOdo(0,0,0),
+                   rng(static_cast<unsigned int>(time(NULL))),
+                   frameCounter(0), M(_M)
 {
-    // Initialize particles to be randomly spread about the field...
-    srand(time(NULL));
-    for (int m = 0; m < M; ++m) {
-        //Particle p_m;
-        // X bounded by width of the field
-        // Y bounded by height of the field
-        // H between +-pi
-        PoseEst x_m(static_cast<float>(rand() % static_cast<int>(FIELD_WIDTH)),
-                    static_cast<float>(rand() % static_cast<int>(FIELD_HEIGHT)),
-                    UNIFORM_1_NEG_1 * (M_PI_FLOAT / 2.0f));
-        Particle p_m(x_m, 1.0f);
-        X_t.push_back(p_m);
-    }
+    initParticles();
+}
 
-    updateEstimates();
+MCL::MCL(int _M, unsigned int seed) : useBest(false), lastOdo(0,0,0),
+                                      rng(seed), frameCounter(0), M(_M)
+{
+    initParticles();
 }
 
 MCL::~MCL()
@@ -51,15 +43,22 @@ MCL::~MCL()
 void MCL::reset()
 {
     frameCounter = 0;
+    initParticles();
+}
 
+/**
+ * Spread the particles randomly about the field
+ */
+void MCL::initParticles()
+{
     for (int m = 0; m < M; ++m) {
         //Particle p_m;
         // X bounded by width of the field
         // Y bounded by height of the field
         // H between +-pi
-        PoseEst x_m(static_cast<float>(rand() % static_cast<int>(FIELD_WIDTH)),
-                    static_cast<float>(rand() % static_cast<int>(FIELD_HEIGHT)),
-                    UNIFORM_1_NEG_1 * (M_PI_FLOAT / 2.0f));
+        PoseEst x_m(static_cast<float>(rng.uniformInt(static_cast<int>(FIELD_WIDTH))),
+                    static_cast<float>(rng.uniformInt(static_cast<int>(FIELD_HEIGHT))),
+                    rng.uniformNeg1To1() * (M_PI_FLOAT / 2.0f));
         Particle p_m(x_m, 1.0f);
         X_t.push_back(p_m);
     }
@@ -79,6 +78,7 @@ void MCL::reset()
 void MCL::updateLocalization(MotionModel u_t, vector<Observation> z_t)
 {
     frameCounter++;
+    lastObservations = z_t;
     // Set the current particles to be of time minus one.
     vector<Particle> X_t_1 = X_t;
     // Clar the current set
@@ -194,9 +194,23 @@ float MCL::updateMeasurementModel(vector<Observation> z_t, PoseEst x_t)
  * @param totalWeights the totalWeights of the particle set X_bar_t
  */
 void MCL::resample(std::vector<Particle> * X_bar_t, float totalWeights) {
+    // No particle explains the observations, so there is nothing to resample
+    // by; keep the set as it is with even weights
+    if (!(totalWeights > 0.0f)) {
+        for (int m = 0; m < M; ++m) {
+            (*X_bar_t)[m].weight = 1.0f / static_cast<float>(M);
+        }
+        noResample(X_bar_t);
+        return;
+    }
+
+    int best = 0;
     for (int m = 0; m < M; ++m) {
         // Normalize the particle weights
         (*X_bar_t)[m].weight /= totalWeights;
+        if ((*X_bar_t)[m].weight > (*X_bar_t)[best].weight) {
+            best = m;
+        }
 
         int count = int(round(float(M) * (*X_bar_t)[m].weight));
         for (int i = 0; i < count; ++i) {
@@ -205,13 +219,20 @@ void MCL::resample(std::vector<Particle> * X_bar_t, float totalWeights) {
             //X_t.push_back(X_bar_t[m]);
         }
     }
+
+    // Rounding the counts rarely gives exactly M particles, and the next
+    // update walks M of them, so trim the extras or fill in from the best
+    if (X_t.size() > static_cast<unsigned int>(M)) {
+        X_t.erase(X_t.begin() + M, X_t.end());
+    }
+    while (X_t.size() < static_cast<unsigned int>(M)) {
+        X_t.push_back(randomWalkParticle((*X_bar_t)[best]));
+    }
 }
 
 void MCL::lowVarianceResample(std::vector<Particle> * X_bar_t,
                               float totalWeights) {
-    float r = ((static_cast<float>(rand()) /
-				static_cast<float>(RAND_MAX)) *
-			   (1.0f/static_cast<float>(M) ));
+    float r = rng.uniform() * (1.0f/static_cast<float>(M));
     float c = (*X_bar_t)[0].weight / totalWeights;
     int i = 0;
     for (int m = 0; m < M; ++m) {
@@ -446,20 +467,12 @@ Particle MCL::randomWalkParticle(Particle p)
 
 float MCL::sampleNormalDistribution(float sd)
 {
-    float samp = 0;
-    for(int i = 0; i < 12; i++) {
-        samp += (2*(static_cast<float>(rand()) /
-					static_cast<float>(RAND_MAX)) * sd) - sd;
-    }
-    return 0.5f*samp;
+    return rng.sampleNormal(sd);
 }
 
 float MCL::sampleTriangularDistribution(float sd)
 {
-    return std::sqrt(6.0f)*0.5f * ((2.0f*sd*(static_cast<float>(rand()) /
-								   static_cast<float>(RAND_MAX))) - sd +
-                            (2.0f*sd*(static_cast<float>(rand()) /
-								   static_cast<float>(RAND_MAX))) - sd);
+    return rng.sampleTriangular(sd);
 }
 
 // Particle
@@ -19,6 +19,7 @@
 #include "NBMath.h"
 #include "NogginStructs.h"
 #include "LocSystem.h"
+#include "RandomStream.h"
 
 // Particle
 class Particle
@@ -46,6 +47,9 @@ class MCL : public LocSystem
 public:
     // Constructors & Destructors
     MCL(int M=100);
+    // Draw all samples from a stream seeded with seed, so that runs with
+    // the same seed and inputs are identical
+    MCL(int M, unsigned int seed);
     virtual ~MCL();
 
     // Core Functions
@@ -108,6 +112,13 @@ public:
 
     const MotionModel getLastOdo() const { return lastOdo; }
 
+    /**
+     * @return The observations of the last update
+     */
+    const std::vector<Observation> getLastObservations() const {
+        return lastObservations;
+    }
+
     /**
      * @return The current set of particles in the filter
      */
@@ -145,6 +156,7 @@ public:
     void setHUncert(float uncertH) { curUncert.h = uncertH;}
 
     void setUseBest(bool _new) { useBest = _new; }
+    void setSeed(unsigned int seed) { rng.seed(seed); }
 
 private:
     // Class variables
@@ -154,6 +166,8 @@ private:
     std::vector<Particle> X_t; // Current set of particles
     bool useBest;
     MotionModel lastOdo;
+    std::vector<Observation> lastObservations;
+    RandomStream rng;
 
     // Core Functions
     PoseEst updateMotionModel(PoseEst x_t, MotionModel u_t);
@@ -163,6 +177,7 @@ private:
                              float totalWeights);
     void noResample(std::vector<Particle> * X_bar_t);
     void updateEstimates();
+    void initParticles();
 
     // Helpers
     float determinePointWeight(Observation z, PoseEst x_t,
@@ -38,17 +38,23 @@ fstream outputFile;
 
 const char * BRAIN_MODULE = "man.noggin.Brain";
 const int TEAMMATE_FRAMES_OFF_THRESH = 5;
-Noggin::Noggin (shared_ptr<Profiler> p, shared_ptr<Vision> v,
+// Frame time (s) used to predict the ball until frames have been timed,
+// the one the ball filter assumes; times outside of the limits are not used
+const float DEFAULT_BALL_PREDICTION_DT = 1.0f / 30.0f;
+const float MIN_BALL_PREDICTION_DT = 1.0f / 60.0f;
+const float MAX_BALL_PREDICTION_DT = 0.25f;
+Noggin::Noggin (shared_ptr<Synchro> _synchro,
+                shared_ptr<Profiler> p, shared_ptr<Vision> v,
                 shared_ptr<Comm> c, shared_ptr<RoboGuardian> rbg,
                 shared_ptr<Sensors> _sensors, MotionInterface * _minterface)
-    : profiler(p), comm(c),gc(c->getGC()),
+    : synchro(_synchro), profiler(p), comm(c),gc(c->getGC()),
       sensors(_sensors),
       chestButton(rbg->getButton(CHEST_BUTTON)),
       leftFootButton(rbg->getButton(LEFT_FOOT_BUTTON)),
       rightFootButton(rbg->getButton(RIGHT_FOOT_BUTTON)),
       error_state(false), brain_module(NULL), brain_instance(NULL),
       motion_interface(_minterface),registeredGCReset(false), ballFramesOff(0),
-      do_reload(0)
+      lastLocFrameTime(0), do_reload(0)
 {
 #   ifdef DEBUG_NOGGIN_INITIALIZATION
     printf("Noggin::initializing\n");
@@ -74,6 +80,7 @@ Noggin::Noggin (shared_ptr<Profiler> p, shared_ptr<Vision> v,
 
 Noggin::~Noggin ()
 {
+    stopLocalization();
     Py_XDECREF(brain_instance);
     Py_XDECREF(brain_module);
 #   ifdef LOG_LOC
@@ -128,7 +135,23 @@ void Noggin::initializeLocalization()
 #   endif
 
     // Initialize the localization modules
+    stopLocalization();
+#   ifdef USE_LOC_WORKER
+    shared_ptr<LocEKF> ekf(new LocEKF());
+    locWorker = shared_ptr<LocWorker>(new LocWorker(synchro, ekf));
+    if (locWorker->start() == 0) {
+        locWorker->getTrigger()->await_on();
+        loc = locWorker;
+    } else {
+        // Nothing would apply the queued updates, so run the filter inline
+        cerr << "Localization worker failed to start, "
+             << "running localization on the vision thread" << endl;
+        locWorker.reset();
+        loc = ekf;
+    }
+#   else
     loc = shared_ptr<LocEKF>(new LocEKF());
+#   endif
     ballEKF = shared_ptr<BallEKF>(new BallEKF());
 
     // Setup the python localization wrappers
@@ -144,6 +167,15 @@ void Noggin::initializeLocalization()
 #   endif
 }
 
+void Noggin::stopLocalization()
+{
+    if (locWorker) {
+        locWorker->stop();
+        locWorker->getTrigger()->await_off();
+        locWorker.reset();
+    }
+}
+
 bool Noggin::import_modules ()
 {
     // Load Brain module
@@ -394,11 +426,45 @@ void Noggin::updateLocalization()
 	// 	}
     // }
 
-    // Process the information
+    // Process the information. The worker only queues it, and the ball
+    // filter below works from the latest estimate it has finished.
     PROF_ENTER(profiler, P_MCL);
-    loc->updateLocalization(odometery, observations);
+    if (locWorker)
+        locWorker->updateLocalization(vision->getFrameNumber(), odometery,
+                                      observations);
+    else
+        loc->updateLocalization(odometery, observations);
     PROF_EXIT(profiler, P_MCL);
 
+    // One estimate for all of the ball tracking
+    const PoseEst pose = loc->getCurrentEstimate();
+
+    // Crosses are only used close up, so vision needn't look for them when
+    // none can be that close
+    const float crossRange = MAX_CROSS_DISTANCE +
+        2.0f * max(loc->getXUncert(), loc->getYUncert());
+    bool crossInRange = false;
+    for (int i = 0; i < ConcreteCross::NUM_FIELD_CROSSES; ++i) {
+        const ConcreteCross *c = ConcreteCross::concreteCrossList[i];
+        if (hypot(c->getFieldX() - pose.x, c->getFieldY() - pose.y) <
+            crossRange) {
+            crossInRange = true;
+        }
+    }
+    vision->setCrossesWanted(crossInRange);
+
+    // How long frames are taking, to move the ball on by one
+    const long long now = micro_time();
+    float frameTime = DEFAULT_BALL_PREDICTION_DT;
+    if (lastLocFrameTime > 0) {
+        const float dt = static_cast<float>(now - lastLocFrameTime) /
+            static_cast<float>(MICROS_PER_SECOND);
+        if (dt >= MIN_BALL_PREDICTION_DT && dt <= MAX_BALL_PREDICTION_DT) {
+            frameTime = dt;
+        }
+    }
+    lastLocFrameTime = now;
+
     // Ball Tracking
     if (vision->ball->getDistance() > 0.0) {
         ballFramesOff = 0;
@@ -424,11 +490,9 @@ void Noggin::updateLocalization()
         if (!(n.ballX == 0.0 && n.ballY == 0.0) &&
             !(gc->gameState() == STATE_INITIAL ||
               gc->gameState() == STATE_FINISHED)) {
-            m.distance = hypot(loc->getXEst() - n.ballX,
-                               loc->getYEst() - n.ballY);
-            m.bearing = subPIAngle(atan2(n.ballY - loc->getYEst(),
-                                         n.ballX - loc->getXEst()) -
-                                   loc->getHEst());
+            m.distance = hypot(pose.x - n.ballX, pose.y - n.ballY);
+            m.bearing = subPIAngle(atan2(n.ballY - pose.y,
+                                         n.ballX - pose.x) - pose.h);
             m.distanceSD = vision->ball->ballDistanceToSD(m.distance);
             m.bearingSD =  vision->ball->ballBearingToSD(m.bearing);
 #           ifdef DEBUG_TEAMMATE_BALL_OBSERVATIONS
@@ -442,7 +506,22 @@ void Noggin::updateLocalization()
 #       endif
     }
 
-    ballEKF->updateModel(m, loc->getCurrentEstimate());
+    ballEKF->updateModel(m, pose);
+
+    // While we are seeing the ball, tell vision where to look for it next
+    if (ballFramesOff == 0) {
+        const float dt = frameTime;
+        const float relX = ballEKF->getXEst() +
+            ballEKF->getXVelocityEst() * dt - pose.x;
+        const float relY = ballEKF->getYEst() +
+            ballEKF->getYVelocityEst() * dt - pose.y;
+        const float uncert = max(ballEKF->getXUncert(),
+                                 ballEKF->getYUncert()) +
+            hypot(ballEKF->getXVelocityEst(), ballEKF->getYVelocityEst()) * dt;
+        vision->setBallPrediction(hypot(relX, relY),
+                                  subPIAngle(atan2(relY, relX) - pose.h),
+                                  uncert);
+    }
 #   ifdef LOG_LOCALIZATION
     if (loggingLoc) {
         // Print out odometry and ball readings
@@ -10,6 +10,7 @@
 #include "PyVision.h"
 #include "MCL.h"
 #include "LocEKF.h"
+#include "LocWorker.h"
 #include "BallEKF.h"
 #include "Comm.h"
 #include "GameController.h"
@@ -27,7 +28,8 @@
 class Noggin
 {
 public:
-    Noggin(boost::shared_ptr<Profiler> p, boost::shared_ptr<Vision> v,
+    Noggin(boost::shared_ptr<Synchro> _synchro,
+           boost::shared_ptr<Profiler> p, boost::shared_ptr<Vision> v,
            boost::shared_ptr<Comm> c, boost::shared_ptr<RoboGuardian> rbg,
            boost::shared_ptr<Sensors> _sensors,
            MotionInterface * _minterface);
@@ -58,10 +60,13 @@ private:
     void initializeLocalization();
     // Run the localization update; performed at every run step
     void updateLocalization();
+    // Stop the localization worker, if there is one
+    void stopLocalization();
     //Process button  clicks that pertain to GameController manipulation
     void processGCButtonClicks();
 
 private:
+    boost::shared_ptr<Synchro> synchro;
     boost::shared_ptr<Profiler> profiler;
     boost::shared_ptr<Vision> vision;
     boost::shared_ptr<Comm> comm;
@@ -83,6 +88,8 @@ private:
     bool registeredGCReset;
     // Teammate ball stuff
     int ballFramesOff;
+    // When the last loc update ran (us), for the ball prediction
+    long long lastLocFrameTime;
     // Reload specifiers
     int do_reload;
     std::vector<std::string> module_list;
@@ -91,6 +98,9 @@ private:
 public:
     boost::shared_ptr<LocSystem> loc;
     boost::shared_ptr<BallEKF> ballEKF;
+    // Runs loc on its own thread when USE_LOC_WORKER is set, in which case
+    // it is also what loc points to
+    boost::shared_ptr<LocWorker> locWorker;
 
 #ifdef LOG_LOCALIZATION
     void startLocLog();
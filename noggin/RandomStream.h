@@ -0,0 +1,129 @@
+/**
+ * RandomStream.h
+ *
+ * A seedable source of random numbers with its own state, so that each
+ * filter or offline job draws from an independent, reproducible sequence
+ * instead of the process wide (and lock protected) rand().
+ *
+ * The generator is xoshiro128+, which is plenty for sampling noise and costs
+ * a handful of adds, xors and shifts per draw. Gaussian samples are made with
+ * Box-Muller a batch at a time and handed out from a small buffer.
+ */
+
+#ifndef RandomStream_h_DEFINED
+#define RandomStream_h_DEFINED
+
+#include <cmath>
+#include <stdint.h>
+
+class RandomStream
+{
+public:
+    RandomStream(uint32_t _seed = 1) { seed(_seed); }
+
+    /**
+     * Reset the stream. Streams seeded with the same value produce the same
+     * sequence; nearby seeds give unrelated sequences.
+     */
+    void seed(uint32_t _seed) {
+        for (int i = 0; i < 4; ++i) {
+            s[i] = mix(_seed + static_cast<uint32_t>(i + 1) * 0x9e3779b9u);
+        }
+        // The all zero state is the one state xoshiro can not leave
+        if ((s[0] | s[1] | s[2] | s[3]) == 0) {
+            s[0] = 1;
+        }
+        normalIndex = NORMAL_BATCH;
+    }
+
+    uint32_t next() {
+        const uint32_t result = s[0] + s[3];
+        const uint32_t t = s[1] << 9;
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = (s[3] << 11) | (s[3] >> 21);
+
+        return result;
+    }
+
+    /**
+     * @return A uniform sample in [0, 1)
+     */
+    float uniform() {
+        // The low bits of xoshiro128+ are weak, so use the top 24
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /**
+     * @return A uniform sample in [-1, 1)
+     */
+    float uniformNeg1To1() { return 2.0f * uniform() - 1.0f; }
+
+    /**
+     * @return A uniform integer in [0, n)
+     */
+    int uniformInt(int n) { return static_cast<int>(uniform() * n); }
+
+    /**
+     * @return A zero mean normal sample with standard deviation sd
+     */
+    float sampleNormal(float sd) {
+        if (normalIndex == NORMAL_BATCH) {
+            fillNormalBatch();
+        }
+        return sd * normals[normalIndex++];
+    }
+
+    /**
+     * Fill out with n zero mean normal samples with standard deviation sd
+     */
+    void sampleNormal(float * out, int n, float sd) {
+        for (int i = 0; i < n; ++i) {
+            out[i] = sampleNormal(sd);
+        }
+    }
+
+    float sampleTriangular(float sd) {
+        return std::sqrt(6.0f) * 0.5f * ((2.0f * sd * uniform()) - sd +
+                                         (2.0f * sd * uniform()) - sd);
+    }
+
+private:
+    enum { NORMAL_BATCH = 64 };
+
+    // Finalizer from MurmurHash3, spreads a seed over all 32 bits
+    static uint32_t mix(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x85ebca6bu;
+        x ^= x >> 13;
+        x *= 0xc2b2ae35u;
+        x ^= x >> 16;
+        return x;
+    }
+
+    void fillNormalBatch() {
+        float u[NORMAL_BATCH];
+        for (int i = 0; i < NORMAL_BATCH; ++i) {
+            u[i] = uniform();
+        }
+        // Each pair of uniforms becomes a pair of independent normals. The
+        // first of a pair is moved to (0, 1] so that the log is finite.
+        for (int i = 0; i < NORMAL_BATCH; i += 2) {
+            const float r = std::sqrt(-2.0f * std::log(1.0f - u[i]));
+            const float theta = 6.2831853f * u[i + 1];
+            normals[i] = r * std::cos(theta);
+            normals[i + 1] = r * std::sin(theta);
+        }
+        normalIndex = 0;
+    }
+
+    uint32_t s[4];
+    float normals[NORMAL_BATCH];
+    int normalIndex;
+};
+
+#endif // RandomStream_h_DEFINED
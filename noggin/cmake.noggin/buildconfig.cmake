@@ -37,5 +37,10 @@ OPTION(
     "Make noggin halt brain run() calls until a reload after an error"
     ON
     )
+OPTION(
+    USE_LOC_WORKER
+    "Run localization on its own thread instead of in the vision frame"
+    ON
+    )
 
 
@@ -0,0 +1,362 @@
+/**
+ * batchLoc.cpp - run a grid of faked localization experiments on all cores
+ *
+ * Every combination of nav file, filter, noise level and seed is one job.
+ * Jobs are independent: each builds its own filters and draws its noise from
+ * its own RandomStream seeded from the job's seed, so a row of the output is
+ * reproducible no matter how many threads ran or in what order jobs finished.
+ *
+ * Output is a single CSV with one row per job:
+ *   log,filter,particles,noise,seed,frames,pos_rms,heading_rms,ball_rms,micros
+ *
+ * With -c each job also writes its per frame core table (see
+ * printCoreLogLine) next to its nav file, named the way accuracyVsNoise.R
+ * reads them: <name>.ekf.noise.<noise> for the EKF, run with the first seed,
+ * and <name>.mcl.noise.<noise>.<k> for MCL run with the k-th seed.
+ */
+#include <pthread.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "fakerIO.h"
+#include "fakerIterators.h"
+#include "NBMath.h"
+#include "Common.h"
+using namespace std;
+using namespace boost;
+using namespace NBMath;
+
+// Filter id used for the EKF in a job; any other value is an MCL particle count
+static const int EKF_FILTER = 0;
+
+// Keep the particle filter's stream apart from the observation noise stream
+static const unsigned int MCL_SEED_OFFSET = 0x9e3779b9u;
+
+struct LocJob
+{
+    int path;
+    int particles;
+    float noise;
+    unsigned int seed;
+    // Where the seed is in the seed list
+    int run;
+};
+
+struct LocResult
+{
+    int frames;
+    float posRMS;
+    float headingRMS;
+    float ballRMS;
+    long long micros;
+};
+
+static vector<NavPath> paths;
+static vector<string> pathNames;
+static vector<LocJob> jobs;
+
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t out_mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int nextJob = 0;
+static FILE * outFile = NULL;
+static bool writeCore = false;
+
+LocResult runJob(const LocJob &job);
+void * worker(void * arg);
+string coreFileName(const LocJob &job);
+void parseList(const char * arg, vector<float> * values);
+int numCores();
+
+int main(int argc, char** argv)
+{
+    int numThreads = numCores();
+    const char * outName = "batchLoc.csv";
+    vector<float> seeds, noises, particles;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:o:s:n:p:c")) != -1) {
+        switch (opt) {
+        case 'j':
+            numThreads = atoi(optarg);
+            break;
+        case 'o':
+            outName = optarg;
+            break;
+        case 's':
+            parseList(optarg, &seeds);
+            break;
+        case 'n':
+            parseList(optarg, &noises);
+            break;
+        case 'p':
+            parseList(optarg, &particles);
+            break;
+        case 'c':
+            writeCore = true;
+            break;
+        default:
+            optind = argc + 1;
+            break;
+        }
+    }
+
+    if (optind >= argc || numThreads < 1) {
+        cerr << "usage: " << argv[0] << " [-j threads] [-o out.csv]"
+             << " [-s seeds] [-n noise-levels] [-p particle-counts] [-c]"
+             << " nav-file..." << endl
+             << "  lists are comma separated; a particle count of 0 runs"
+             << " the EKF" << endl
+             << "  -c also writes each job's per frame core table" << endl;
+        return 1;
+    }
+
+    // Defaults match the sweep done by faker
+    if (seeds.empty()) {
+        for (int i = 1; i <= 10; ++i) {
+            seeds.push_back(static_cast<float>(i));
+        }
+    }
+    if (noises.empty()) {
+        for (float n = 0.0f; n < 0.61f; n += 0.05f) {
+            noises.push_back(n);
+        }
+    }
+    if (particles.empty()) {
+        particles.push_back(static_cast<float>(EKF_FILTER));
+    }
+
+    // Core tables are named by filter, noise and run only
+    int numMCL = 0;
+    for (unsigned int f = 0; f < particles.size(); ++f) {
+        if (static_cast<int>(particles[f]) != EKF_FILTER) {
+            ++numMCL;
+        }
+    }
+    if (writeCore && numMCL > 1) {
+        cerr << "-c takes at most one MCL particle count" << endl;
+        return 1;
+    }
+
+    for (int i = optind; i < argc; ++i) {
+        fstream navFile(argv[i], ios::in);
+        if (!navFile.is_open()) {
+            cerr << "Failed to open input file " << argv[i] << endl;
+            return 1;
+        }
+        NavPath letsGo;
+        readNavInputFile(&navFile, &letsGo);
+        navFile.close();
+        paths.push_back(letsGo);
+        pathNames.push_back(argv[i]);
+    }
+
+    // Build the job grid
+    for (unsigned int p = 0; p < paths.size(); ++p) {
+        for (unsigned int f = 0; f < particles.size(); ++f) {
+            for (unsigned int n = 0; n < noises.size(); ++n) {
+                for (unsigned int s = 0; s < seeds.size(); ++s) {
+                    LocJob job;
+                    job.path = p;
+                    job.particles = static_cast<int>(particles[f]);
+                    job.noise = noises[n];
+                    job.seed = static_cast<unsigned int>(seeds[s]);
+                    job.run = s;
+                    jobs.push_back(job);
+                }
+            }
+        }
+    }
+
+    outFile = fopen(outName, "w");
+    if (outFile == NULL) {
+        cerr << "Failed to open output file " << outName << endl;
+        return 1;
+    }
+    fprintf(outFile, "log,filter,particles,noise,seed,frames,"
+            "pos_rms,heading_rms,ball_rms,micros\n");
+
+    cout << "Running " << jobs.size() << " jobs on " << numThreads
+         << " threads" << endl;
+    long long totalTime = -micro_time();
+
+    vector<pthread_t> threads(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        if (pthread_create(&threads[i], NULL, worker, NULL) != 0) {
+            cerr << "Failed to start worker thread" << endl;
+            return 1;
+        }
+    }
+    for (int i = 0; i < numThreads; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    totalTime += micro_time();
+    fclose(outFile);
+    cout << "Finished in " << totalTime * 0.001 << " ms, results in "
+         << outName << endl;
+    return 0;
+}
+
+/**
+ * Pull jobs off the shared grid until there are none left, writing each
+ * result as soon as it is done.
+ */
+void * worker(void * arg)
+{
+    while (true) {
+        pthread_mutex_lock(&job_mutex);
+        const unsigned int i = nextJob++;
+        pthread_mutex_unlock(&job_mutex);
+
+        if (i >= jobs.size()) {
+            break;
+        }
+
+        const LocJob &job = jobs[i];
+        const LocResult r = runJob(job);
+
+        pthread_mutex_lock(&out_mutex);
+        fprintf(outFile, "%s,%s,%d,%g,%u,%d,%g,%g,%g,%lld\n",
+                pathNames[job.path].c_str(),
+                job.particles == EKF_FILTER ? "ekf" : "mcl",
+                job.particles, job.noise, job.seed, r.frames,
+                r.posRMS, r.headingRMS, r.ballRMS, r.micros);
+        fflush(outFile);
+        pthread_mutex_unlock(&out_mutex);
+    }
+    return NULL;
+}
+
+/**
+ * Run a single faked path through one filter, as iterateFakerPath does, and
+ * accumulate error statistics, writing the core table too if asked for.
+ */
+LocResult runJob(const LocJob &job)
+{
+    const NavPath &letsGo = paths[job.path];
+    RandomStream rng(job.seed);
+
+    shared_ptr<LocSystem> loc;
+    if (job.particles == EKF_FILTER) {
+        loc = shared_ptr<LocSystem>(new LocEKF());
+    } else {
+        loc = shared_ptr<LocSystem>(new MCL(job.particles,
+                                            job.seed ^ MCL_SEED_OFFSET));
+    }
+    shared_ptr<BallEKF> ballEKF = shared_ptr<BallEKF>(new BallEKF());
+    VisualBall visBall;
+
+    PoseEst currentPose;
+    BallPose currentBall;
+    currentPose.x = letsGo.startPos.x;
+    currentPose.y = letsGo.startPos.y;
+    currentPose.h = letsGo.startPos.h;
+    currentBall = letsGo.ballStart;
+
+    // The EKF's own run does not depend on the seed, so R reads one table
+    fstream coreFile;
+    if (writeCore && (job.particles != EKF_FILTER || job.run == 0)) {
+        coreFile.open(coreFileName(job).c_str(), fstream::out);
+        if (!coreFile.is_open()) {
+            cerr << "Failed to open core file " << coreFileName(job) << endl;
+        } else {
+            const MotionModel noMove(0.0f, 0.0f, 0.0f);
+            printCoreLogLine(&coreFile, loc, vector<Observation>(), noMove,
+                             &currentPose, &currentBall, ballEKF);
+        }
+    }
+
+    LocResult r;
+    r.frames = 0;
+    double posErr = 0.0, headingErr = 0.0, ballErr = 0.0;
+
+    r.micros = -micro_time();
+    for (unsigned int i = 0; i < letsGo.myMoves.size(); ++i) {
+        for (int j = 0; j < letsGo.myMoves[i].time; ++j, ++r.frames) {
+            currentPose += letsGo.myMoves[i].move;
+            currentBall += letsGo.myMoves[i].ballVel;
+
+            vector<Observation> Z_t =
+                determineObservedLandmarks(currentPose, 0.0, job.noise, rng);
+            visBall.setDistanceEst(determineBallEstimate(&currentPose,
+                                                         &currentBall,
+                                                         0.0, rng));
+            RangeBearingMeasurement m(&visBall);
+
+            loc->updateLocalization(letsGo.myMoves[i].move, Z_t);
+            if (usePerfectLocForBall) {
+                ballEKF->updateModel(m, currentPose);
+            } else {
+                ballEKF->updateModel(m, loc->getCurrentEstimate());
+            }
+
+            const float dx = loc->getXEst() - currentPose.x;
+            const float dy = loc->getYEst() - currentPose.y;
+            const float dh = subPIAngle(loc->getHEst() - currentPose.h);
+            const float bx = ballEKF->getXEst() - currentBall.x;
+            const float by = ballEKF->getYEst() - currentBall.y;
+            posErr += dx * dx + dy * dy;
+            headingErr += dh * dh;
+            ballErr += bx * bx + by * by;
+
+            if (coreFile.is_open()) {
+                printCoreLogLine(&coreFile, loc, Z_t,
+                                 letsGo.myMoves[i].move, &currentPose,
+                                 &currentBall, ballEKF);
+            }
+        }
+    }
+    r.micros += micro_time();
+    if (coreFile.is_open()) {
+        coreFile.close();
+    }
+
+    const double n = r.frames > 0 ? r.frames : 1;
+    r.posRMS = static_cast<float>(sqrt(posErr / n));
+    r.headingRMS = static_cast<float>(sqrt(headingErr / n));
+    r.ballRMS = static_cast<float>(sqrt(ballErr / n));
+    return r;
+}
+
+/**
+ * The nav file's name without its extension, then the filter, noise and run
+ */
+string coreFileName(const LocJob &job)
+{
+    string name = pathNames[job.path];
+    const string::size_type dot = name.rfind('.');
+    if (dot != string::npos && name.find('/', dot) == string::npos) {
+        name.erase(dot);
+    }
+
+    char suffix[64];
+    if (job.particles == EKF_FILTER) {
+        snprintf(suffix, sizeof(suffix), ".ekf.noise.%g", job.noise);
+    } else {
+        snprintf(suffix, sizeof(suffix), ".mcl.noise.%g.%d",
+                 job.noise, job.run);
+    }
+    return name + suffix;
+}
+
+/**
+ * Parse a comma separated list of numbers, appending them to values
+ */
+void parseList(const char * arg, vector<float> * values)
+{
+    char * end;
+    while (*arg != '\0') {
+        values->push_back(static_cast<float>(strtod(arg, &end)));
+        if (end == arg) {
+            break;
+        }
+        arg = (*end == ',') ? end + 1 : end;
+    }
+}
+
+int numCores()
+{
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? static_cast<int>(n) : 1;
+}
@@ -3,6 +3,8 @@ using namespace std;
 using namespace boost;
 using namespace NBMath;
 
+RandomStream fakerStream;
+
 /**
  * Method to iterate through a robot path and write the localization info.
  *
@@ -244,19 +246,21 @@ void iterateMCLObsPath(fstream * locFile, fstream * coreFile,
  * @return A vector containing all of the observable landmarks at myPose
  */
 vector<Observation> determineObservedLandmarks(PoseEst myPos, float neckYaw,
-                                               float noiseLevel)
+                                               float noiseLevel,
+                                               RandomStream &rng)
 {
     vector<Observation> Z_t;
 
-	checkObjects(Z_t, myPos, noiseLevel);
-	checkCrosses(Z_t, myPos, noiseLevel);
-	checkCorners(Z_t, myPos, noiseLevel);
+	checkObjects(Z_t, myPos, noiseLevel, rng);
+	checkCrosses(Z_t, myPos, noiseLevel, rng);
+	checkCorners(Z_t, myPos, noiseLevel, rng);
 	checkLines(Z_t, myPos);
 
     return Z_t;
 }
 
-void checkObjects(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
+void checkObjects(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel,
+                  RandomStream &rng)
 {
     // Measurements between robot position and seen object
     float deltaX, deltaY;
@@ -276,7 +280,7 @@ void checkObjects(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
 
             // Get measurement variance and add noise to reading
             if (!use_perfect_dists) {
-                visDist += sampleNormalDistribution(visDist * noiseLevel);
+                visDist += sampleNormalDistribution(visDist * noiseLevel, rng);
             }
 
             // Build the (visual) field object
@@ -287,7 +291,7 @@ void checkObjects(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
 
             // set ambiguous data
             // Randomly set them to abstract
-            if (false && (rand() / (float(RAND_MAX)+1)) < 0.12) {
+            if (false && rng.uniform() < 0.12) {
                 fo.setIDCertainty(NOT_SURE);
                 if(foID == BLUE_GOAL_LEFT_POST ||
                    foID == BLUE_GOAL_RIGHT_POST) {
@@ -304,7 +308,8 @@ void checkObjects(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
     }
 }
 
-void checkCrosses(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
+void checkCrosses(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel,
+                  RandomStream &rng)
 {
     for(int i = 0; i < ConcreteCross::NUM_FIELD_CROSSES; ++i) {
 		const ConcreteCross* toView = ConcreteCross::concreteCrossList[i];
@@ -319,7 +324,7 @@ void checkCrosses(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
 
             // Get measurement variance and add noise to reading
             if(!use_perfect_dists) {
-                visDist += sampleNormalDistribution(visDist*noiseLevel);
+                visDist += sampleNormalDistribution(visDist*noiseLevel, rng);
             }
 
             const crossID id = toView->getID();
@@ -335,14 +340,15 @@ void checkCrosses(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
     }
 }
 
-void checkCorners(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
+void checkCorners(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel,
+                  RandomStream &rng)
 {
     // required measurements for the added observation
     float visDist, visBearing;
 
     // Check concrete corners
-    for(int i = 0; i < ConcreteCorner::NUM_CORNERS; ++i) {
-       const ConcreteCorner* toView = ConcreteCorner::concreteCornerList[i];
+    for(unsigned int i = 0; i < ConcreteCorner::concreteCorners().size(); ++i) {
+       const ConcreteCorner* toView = ConcreteCorner::concreteCorners()[i];
         float deltaX = toView->getFieldX() - myPos.x;
         float deltaY = toView->getFieldY() - myPos.y;
         visDist = hypot(deltaX, deltaY);
@@ -354,7 +360,7 @@ void checkCorners(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
 
             // Get measurement variance and add noise to reading
             if(!use_perfect_dists) {
-                visDist += sampleNormalDistribution(visDist*noiseLevel);
+                visDist += sampleNormalDistribution(visDist*noiseLevel, rng);
             }
 
             // Ignore the center circle for right now
@@ -362,57 +368,57 @@ void checkCorners(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
                 continue;
             }
             const cornerID id = toView->getID();
-            list <const ConcreteCorner*> toUse;
+            vector <const ConcreteCorner*> toUse;
             // Randomly set ambiguous data
-            if ((rand() / (float(RAND_MAX)+1)) < 0.50) {
+            if (rng.uniform() < 0.50) {
                 shape s = ConcreteCorner::inferCornerType(id);
                 toUse = ConcreteCorner::getPossibleCorners(s);
             } else {
                 const ConcreteCorner * corn;
                 switch(id) {
                 case BLUE_CORNER_TOP_L:
-                    corn = &ConcreteCorner::blue_corner_top_l;
+                    corn = &ConcreteCorner::blue_corner_top_l();
                     break;
                 case BLUE_CORNER_BOTTOM_L:
-                    corn = &ConcreteCorner::blue_corner_bottom_l;
+                    corn = &ConcreteCorner::blue_corner_bottom_l();
                     break;
                 case BLUE_GOAL_LEFT_T:
-                    corn = &ConcreteCorner::blue_goal_left_t;
+                    corn = &ConcreteCorner::blue_goal_left_t();
                     break;
                 case BLUE_GOAL_RIGHT_T:
-                    corn = &ConcreteCorner::blue_goal_right_t;
+                    corn = &ConcreteCorner::blue_goal_right_t();
                     break;
                 case BLUE_GOAL_LEFT_L:
-                    corn = &ConcreteCorner::blue_goal_left_l;
+                    corn = &ConcreteCorner::blue_goal_left_l();
                     break;
                 case BLUE_GOAL_RIGHT_L:
-                    corn = &ConcreteCorner::blue_goal_right_l;
+                    corn = &ConcreteCorner::blue_goal_right_l();
                     break;
                 case CENTER_TOP_T:
-                    corn = &ConcreteCorner::center_top_t;
+                    corn = &ConcreteCorner::center_top_t();
                     break;
                 case CENTER_BOTTOM_T:
-                    corn = &ConcreteCorner::center_bottom_t;
+                    corn = &ConcreteCorner::center_bottom_t();
                     break;
                 case YELLOW_CORNER_TOP_L:
-                    corn = &ConcreteCorner::yellow_corner_top_l;
+                    corn = &ConcreteCorner::yellow_corner_top_l();
                     break;
                 case YELLOW_CORNER_BOTTOM_L:
-                    corn = &ConcreteCorner::yellow_corner_bottom_l;
+                    corn = &ConcreteCorner::yellow_corner_bottom_l();
                     break;
                 case YELLOW_GOAL_LEFT_T:
-                    corn = &ConcreteCorner::yellow_goal_left_t;
+                    corn = &ConcreteCorner::yellow_goal_left_t();
                     break;
                 case YELLOW_GOAL_RIGHT_T:
-                    corn = &ConcreteCorner::yellow_goal_right_t;
+                    corn = &ConcreteCorner::yellow_goal_right_t();
                     break;
                 case YELLOW_GOAL_LEFT_L:
-                    corn = &ConcreteCorner::yellow_goal_left_l;
+                    corn = &ConcreteCorner::yellow_goal_left_l();
                     break;
                 case YELLOW_GOAL_RIGHT_L:
                     // Intentional fall through
                 default:
-                    corn = &ConcreteCorner::yellow_goal_right_l;
+                    corn = &ConcreteCorner::yellow_goal_right_l();
                     break;
                 }
                 // Append to the list
@@ -421,13 +427,15 @@ void checkCorners(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
 
             // Build the visual corner
             VisualCorner vc(20, 20, visDist,visBearing,
-                            VisualLine(), VisualLine(), 10.0f, 10.0f);
+                            shared_ptr<VisualLine>(new VisualLine()),
+                            shared_ptr<VisualLine>(new VisualLine()),
+                            10.0f, 10.0f);
             vc.setPossibleCorners(toUse);
 
             // Set ID
-            if (toUse == ConcreteCorner::lCorners) {
+            if (toUse == ConcreteCorner::lCorners()) {
                 vc.setID(L_INNER_CORNER);
-            } else if (toUse == ConcreteCorner::tCorners) {
+            } else if (toUse == ConcreteCorner::tCorners()) {
                 vc.setID(T_CORNER);
             } else {
                 vc.setID(id);
@@ -439,18 +447,39 @@ void checkCorners(vector<Observation> &Z_t, PoseEst myPos, float noiseLevel)
     }
 }
 
+/**
+ * The closest point on the line to the robot, relative to the robot, as
+ * LocEKF works it out.
+ */
+static pair<float, float> findClosestLinePointCartesian(LineLandmark l,
+                                                        float x_r, float y_r,
+                                                        float h_r)
+{
+    const float x_l = l.dx;
+    const float y_l = l.dy;
+
+    const float x_b = l.x1;
+    const float y_b = l.y1;
+
+    // Find closest point on the line to the robot (global frame)
+    const float x_p = ((x_r - x_b)*x_l + (y_r - y_b)*y_l)*x_l + x_b;
+    const float y_p = ((x_r - x_b)*x_l + (y_r - y_b)*y_l)*y_l + y_b;
+
+    return pair<float, float>(x_p - x_r, y_p - y_r);
+}
+
 void checkLines(vector<Observation> &Z_t, PoseEst myPos)
 {
 
     // Check concrete lines
-	for (int i = 0; i < ConcreteLine::NUM_LINES; ++i) {
-		const ConcreteLine *toView = ConcreteLine::concreteLineList[i];
+	for (unsigned int i = 0; i < ConcreteLine::concreteLines().size(); ++i) {
+		const ConcreteLine *toView = ConcreteLine::concreteLines()[i];
 		LineLandmark ll(toView->getFieldX1(),
 						toView->getFieldY1(),
 						toView->getFieldX2(),
 						toView->getFieldY2());
 		std::pair<float,float> lineDelta =
-			Utility::findClosestLinePointCartesian(ll, myPos.x, myPos.y, myPos.h);
+			findClosestLinePointCartesian(ll, myPos.x, myPos.y, myPos.h);
 
 		const float distance = hypot(lineDelta.first, lineDelta.second);
 		const float bearing = subPIAngle(safe_atan2(lineDelta.second, lineDelta.first) - myPos.h);
@@ -461,34 +490,34 @@ void checkLines(vector<Observation> &Z_t, PoseEst myPos)
 		const ConcreteLine * line;
 		switch(id) {
 		case BLUE_GOAL_ENDLINE:
-			line = &ConcreteLine::blue_goal_endline;
+			line = &ConcreteLine::blue_goal_endline();
 			break;
 		case YELLOW_GOAL_ENDLINE:
-			line = &ConcreteLine::yellow_goal_endline;
+			line = &ConcreteLine::yellow_goal_endline();
 			break;
 		case TOP_SIDELINE:
-			line = &ConcreteLine::top_sideline;
+			line = &ConcreteLine::top_sideline();
 			break;
 		case BOTTOM_SIDELINE:
-			line = &ConcreteLine::bottom_sideline;
+			line = &ConcreteLine::bottom_sideline();
 			break;
-		case CENTER_FIELD_LINE:
-			line = &ConcreteLine::center_field_line;
+		case MIDLINE:
+			line = &ConcreteLine::midline();
 			break;
 		case BLUE_GOALBOX_TOP_LINE:
-			line = &ConcreteLine::blue_goalbox_top_line;
+			line = &ConcreteLine::blue_goalbox_top_line();
 			break;
 		case BLUE_GOALBOX_LEFT_LINE:
-			line = &ConcreteLine::blue_goalbox_left_line;
+			line = &ConcreteLine::blue_goalbox_left_line();
 			break;
 		case BLUE_GOALBOX_RIGHT_LINE:
-			line = &ConcreteLine::blue_goalbox_right_line;
+			line = &ConcreteLine::blue_goalbox_right_line();
 			break;
 		case YELLOW_GOALBOX_TOP_LINE:
-			line = &ConcreteLine::yellow_goalbox_top_line;
+			line = &ConcreteLine::yellow_goalbox_top_line();
 			break;
 		case YELLOW_GOALBOX_LEFT_LINE:
-			line = &ConcreteLine::yellow_goalbox_left_line;
+			line = &ConcreteLine::yellow_goalbox_left_line();
 			break;
 		case YELLOW_GOALBOX_RIGHT_LINE:
 		case UNKNOWN_LINE:
@@ -499,7 +528,7 @@ void checkLines(vector<Observation> &Z_t, PoseEst myPos)
 		case GOALBOX_SIDE_LINE:
 		case GOALBOX_TOP_LINE:
 		default:
-			line = &ConcreteLine::yellow_goalbox_right_line;
+			line = &ConcreteLine::yellow_goalbox_right_line();
 			break;
 		}
 		toUse.assign(1, line);
@@ -519,7 +548,7 @@ void checkLines(vector<Observation> &Z_t, PoseEst myPos)
  * @return The current distance and bearing of the ball with noise
  */
 estimate determineBallEstimate(PoseEst * currentPose, BallPose * currentBall,
-                               float neckYaw)
+                               float neckYaw, RandomStream &rng)
 {
     estimate e;
     e.bearing = subPIAngle(atan2(currentBall->y - currentPose->y,
@@ -528,11 +557,11 @@ estimate determineBallEstimate(PoseEst * currentPose, BallPose * currentBall,
 
     // Calculate distance if object is within view
     if ( e.bearing > -FOV_OFFSET && e.bearing < FOV_OFFSET &&
-         (rand() / (float(RAND_MAX)+1)) < 0.85) {
+         rng.uniform() < 0.85) {
         e.dist = hypot(currentPose->x - currentBall->x,
                        currentPose->y - currentBall->y);
         if (!use_perfect_dists) {
-            e.dist += sampleNormalDistribution(e.dist*0.05);
+            e.dist += sampleNormalDistribution(e.dist*0.05, rng);
         }
 
     } else {
@@ -542,17 +571,12 @@ estimate determineBallEstimate(PoseEst * currentPose, BallPose * currentBall,
     return e;
 }
 
-float sampleNormalDistribution(float sd)
+float sampleNormalDistribution(float sd, RandomStream &rng)
 {
-    float samp = 0;
-    for(int i = 0; i < 12; i++) {
-        samp += (2*(rand() / float(RAND_MAX)) * sd) - sd;
-    }
-    return 0.5*samp;
+    return rng.sampleNormal(sd);
 }
 
-float sampleTriangularDistribution(float sd)
+float sampleTriangularDistribution(float sd, RandomStream &rng)
 {
-    return sqrt(6.0)*0.5 * ((2*sd*(rand() / float(RAND_MAX))) - sd +
-                            (2*sd*(rand() / float(RAND_MAX))) - sd);
+    return rng.sampleTriangular(sd);
 }
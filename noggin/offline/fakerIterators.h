@@ -16,6 +16,7 @@
 #include "Observation.h"
 #include "NavStructs.h"
 #include "fakerIO.h"
+#include "RandomStream.h"
 
 // Observation parameter
 // Ranges at which objects are viewable
@@ -33,6 +34,10 @@ static const bool use_perfect_dists = false;
 // Get half of the nao FOV converted to radians
 static float FOV_OFFSET = NAO_FOV_X_DEG * M_PI / 360.0f + M_PI / 4.0f;
 
+// Noise source used when the caller does not supply its own. Concurrent
+// runs (see batchLoc) must each pass their own stream.
+extern RandomStream fakerStream;
+
 void iterateNavPath(std::fstream * obsFile, NavPath * letsGo);
 void iterateObsPath(std::fstream * locFile, std::fstream * coreFile,
                     boost::shared_ptr<LocSystem> loc,
@@ -56,19 +61,22 @@ void iterateMCLObsPath(std::fstream * locFile, std::fstream * coreFile,
 void iterateFakerPath(std::fstream * mclFile, std::fstream * ekfFile,
                       NavPath * letsGo, float noiseLevel = 0.05);
 void checkObjects(std::vector<Observation> &Z_t, PoseEst myPos,
-				  float noiseLevel);
+				  float noiseLevel, RandomStream &rng = fakerStream);
 void checkCorners(std::vector<Observation> &Z_t, PoseEst myPos,
-				  float noiseLevel);
+				  float noiseLevel, RandomStream &rng = fakerStream);
 void checkCrosses(std::vector<Observation> &Z_t, PoseEst myPos,
-				  float noiseLevel);
+				  float noiseLevel, RandomStream &rng = fakerStream);
 void checkLines(std::vector<Observation> &Z_t, PoseEst myPos);
 std::vector<Observation> determineObservedLandmarks(PoseEst myPos,
                                                     float neckYaw,
-                                                    float noiseLevel = 0.05);
+                                                    float noiseLevel = 0.05,
+                                                    RandomStream &rng =
+                                                    fakerStream);
 estimate determineBallEstimate(PoseEst * currentPose, BallPose * currentBall,
-                               float neckYaw);
-float sampleNormalDistribution(float sd);
-float sampleTriangularDistribution(float sd);
+                               float neckYaw,
+                               RandomStream &rng = fakerStream);
+float sampleNormalDistribution(float sd, RandomStream &rng = fakerStream);
+float sampleTriangularDistribution(float sd, RandomStream &rng = fakerStream);
 
 #endif // obsToLoc_h_DEFINED
 
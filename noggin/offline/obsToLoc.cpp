@@ -1,9 +1,9 @@
 /* obsToNac.cpp */
+#include <unistd.h>
 #include "fakerIO.h"
 #include "fakerIterators.h"
 #include "NBMath.h"
 #include "Common.h"
-#define UNIFORM_1_NEG_1 (2*(rand() / (float(RAND_MAX)+1)) - 1)
 using namespace std;
 using namespace boost;
 using namespace NBMath;
@@ -15,6 +15,9 @@ static vector<vector<Observation> > sightings;
 static vector<float> ballDists;
 static vector<float> ballBearings;
 
+// Seeds each MCL run in turn, so a whole run is the same for a given seed
+static RandomStream mclSeeds;
+
 void runMCL(char * base, string name, int numParticles, bool useBest);
 
 int main(int argc, char** argv)
@@ -23,16 +26,31 @@ int main(int argc, char** argv)
     // IO Variables
     fstream obsFile;
 
+    unsigned int seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:")) != -1) {
+        switch (opt) {
+        case 's':
+            seed = static_cast<unsigned int>(atoi(optarg));
+            break;
+        default:
+            optind = argc + 1;
+            break;
+        }
+    }
+
     /* Test for the correct number of CLI arguments */
-    if(argc != 2) {
-        cerr << "usage: " << argv[0] << " input-file" << endl;
+    if (optind != argc - 1) {
+        cerr << "usage: " << argv[0] << " [-s seed] input-file" << endl;
         return 1;
     }
+    mclSeeds.seed(seed);
+    char * inputName = argv[optind];
     try {
-        obsFile.open(argv[1], ios::in);
+        obsFile.open(inputName, ios::in);
 
-    } catch (const exception& e) {
-        cout << "Failed to open input file" << argv[1] << endl;
+    } catch (const std::exception& e) {
+        cout << "Failed to open input file" << inputName << endl;
         return 1;
     }
 
@@ -46,8 +64,8 @@ int main(int argc, char** argv)
     // EKF files
     fstream ekfFile;
     fstream ekfCoreFile;
-    string ekfFileName(argv[1]);
-    string ekfCoreFileName(argv[1]);
+    string ekfFileName(inputName);
+    string ekfCoreFileName(inputName);
     ekfFileName.replace(ekfFileName.end()-3, ekfFileName.end(), "ekf");
     ekfFile.open(ekfFileName.c_str(), ios::out);
     ekfCoreFileName.replace(ekfCoreFileName.end()-3,
@@ -72,8 +90,8 @@ int main(int argc, char** argv)
     // EKF no ambiguous files
     fstream ekfNoAmbigFile;
     fstream ekfNoAmbigCoreFile;
-    string ekfNoAmbigFileName(argv[1]);
-    string ekfNoAmbigCoreFileName(argv[1]);
+    string ekfNoAmbigFileName(inputName);
+    string ekfNoAmbigCoreFileName(inputName);
 
     ekfNoAmbigFileName.replace(ekfNoAmbigFileName.end()-3,
                                ekfNoAmbigFileName.end(),
@@ -104,9 +122,9 @@ int main(int argc, char** argv)
         for (int i = 1; i <= 10; ++i) {
             stringstream st;
             st << sampleSizes[x] << "-" << i;
-            runMCL(argv[1], st.str(), sampleSizes[x], false);
+            runMCL(inputName, st.str(), sampleSizes[x], false);
             st << ".best";
-            runMCL(argv[1], st.str(), sampleSizes[x], true);
+            runMCL(inputName, st.str(), sampleSizes[x], true);
         }
     }
     return 0;
@@ -128,7 +146,8 @@ void runMCL(char * base, string name, int numParticles, bool useBest)
     mclCoreFileName += name;
     mclCoreFile.open(mclCoreFileName.c_str(), ios::out);
 
-    shared_ptr<MCL> mcl = shared_ptr<MCL>(new MCL(numParticles));
+    shared_ptr<MCL> mcl = shared_ptr<MCL>(new MCL(numParticles,
+                                                mclSeeds.next()));
     mcl->setUseBest(useBest);
 
     // Iterate through the path
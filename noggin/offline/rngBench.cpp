@@ -0,0 +1,105 @@
+/**
+ * rngBench.cpp - compare RandomStream against the old rand() based sampling
+ *
+ * Times normal samples drawn the way MCL and the fakers used to (twelve
+ * calls to rand() per sample) against RandomStream, with every thread
+ * hammering its generator at once as in batchLoc.
+ */
+#include <pthread.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "RandomStream.h"
+#include "Common.h"
+using namespace std;
+
+static const int SAMPLES_PER_THREAD = 4000000;
+
+// The previous sampler, kept here only for comparison
+static float randNormal(float sd)
+{
+    float samp = 0;
+    for(int i = 0; i < 12; i++) {
+        samp += (2*(rand() / float(RAND_MAX)) * sd) - sd;
+    }
+    return 0.5f*samp;
+}
+
+struct BenchArg
+{
+    int mode;
+    unsigned int seed;
+    float sum;
+};
+
+enum { BENCH_RAND, BENCH_STREAM, BENCH_STREAM_BATCH };
+static const char * modeNames[] = { "rand()", "RandomStream",
+                                    "RandomStream batch" };
+
+void * benchThread(void * arg)
+{
+    BenchArg * b = reinterpret_cast<BenchArg*>(arg);
+    float sum = 0.0f;
+
+    if (b->mode == BENCH_RAND) {
+        for (int i = 0; i < SAMPLES_PER_THREAD; ++i) {
+            sum += randNormal(1.0f);
+        }
+    } else if (b->mode == BENCH_STREAM) {
+        RandomStream rng(b->seed);
+        for (int i = 0; i < SAMPLES_PER_THREAD; ++i) {
+            sum += rng.sampleNormal(1.0f);
+        }
+    } else {
+        RandomStream rng(b->seed);
+        float buf[256];
+        for (int i = 0; i < SAMPLES_PER_THREAD; i += 256) {
+            rng.sampleNormal(buf, 256, 1.0f);
+            for (int j = 0; j < 256; ++j) {
+                sum += buf[j];
+            }
+        }
+    }
+    // Keep the result live so the loop is not optimized away
+    b->sum = sum;
+    return NULL;
+}
+
+int main(int argc, char** argv)
+{
+    int numThreads = 1;
+    if (argc > 1) {
+        numThreads = atoi(argv[1]);
+    }
+    if (numThreads < 1) {
+        cerr << "usage: " << argv[0] << " [threads]" << endl;
+        return 1;
+    }
+
+    printf("%d thread(s), %d normal samples each\n",
+           numThreads, SAMPLES_PER_THREAD);
+
+    for (int mode = BENCH_RAND; mode <= BENCH_STREAM_BATCH; ++mode) {
+        vector<pthread_t> threads(numThreads);
+        vector<BenchArg> args(numThreads);
+
+        long long time = -micro_time();
+        for (int i = 0; i < numThreads; ++i) {
+            args[i].mode = mode;
+            args[i].seed = i + 1;
+            pthread_create(&threads[i], NULL, benchThread, &args[i]);
+        }
+        for (int i = 0; i < numThreads; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        time += micro_time();
+
+        const double samples =
+            static_cast<double>(SAMPLES_PER_THREAD) * numThreads;
+        const double ns = static_cast<double>(time) * 1000.0;
+        printf("%-20s %8.2f ns/sample %8.4f samples/ns\n",
+               modeNames[mode], ns / samples, samples / ns);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * File:         sim_soccer_player.cpp
+ * Description:  Runs Man headless against a SimWorld, lock-stepped and as
+ *               fast as the machine allows, then reports how fast that
+ *               was and where the robot ended up.
+ *
+ * Usage:        sim_soccer_player [frames [x y heading]]
+ *
+ *               frames is the number of vision frames to run (default
+ *               1000); x, y in cm and heading in degrees place the robot
+ *               on the field to start with.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <sys/time.h>
+using namespace std;
+
+#include "Man.h"
+#include "SimWorld.h"
+#include "SimEnactor.h"
+#include "SimImageTranscriber.h"
+#include "SimTranscriber.h"
+#include "WBLights.h"
+#include "NBMath.h"
+
+using boost::shared_ptr;
+
+typedef Man SimMan;
+
+// Each vision frame covers two motion frames, as in the Webots player
+static const int MOTION_FRAMES_PER_IMAGE = 2;
+
+static shared_ptr<SimMan> man;
+static shared_ptr<Sensors> sensors;
+static shared_ptr<Synchro> synchro;
+static shared_ptr<SimWorld> world;
+static shared_ptr<SimTranscriber> transcriber;
+static shared_ptr<SimImageTranscriber> imageTranscriber;
+static shared_ptr<SimEnactor> enactor;
+static shared_ptr<Lights> lights;
+
+
+void SimCreateMan(){
+
+    synchro = shared_ptr<Synchro>(new Synchro());
+    sensors = shared_ptr<Sensors>(new Sensors);
+    transcriber = shared_ptr<SimTranscriber>(new SimTranscriber(sensors,
+                                                                world));
+    imageTranscriber =
+        shared_ptr<SimImageTranscriber>
+        (new SimImageTranscriber(sensors, world));
+
+    enactor = shared_ptr<SimEnactor>(new SimEnactor(sensors,
+                                                    transcriber,
+                                                    world));
+    // Nothing to light up, same as in Webots
+    lights  = shared_ptr<Lights>(new WBLights());
+
+    man = boost::shared_ptr<SimMan> (new SimMan(sensors,
+                                                transcriber,
+                                                imageTranscriber,
+                                                enactor,
+                                                synchro,
+                                                lights));
+    man->startSubThreads();
+}
+
+void SimDestroyMan(){
+    man->stopSubThreads();
+}
+
+static double seconds(){
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+
+int main(int argc, char *argv[]) {
+
+    const int frames = argc > 1 ? atoi(argv[1]) : 1000;
+
+    world = shared_ptr<SimWorld>(new SimWorld());
+    if (argc > 4) {
+        world->setPose(static_cast<float>(atof(argv[2])),
+                       static_cast<float>(atof(argv[3])),
+                       static_cast<float>(atof(argv[4])) * TO_RAD);
+    }
+
+    SimCreateMan();
+
+    const double start = seconds();
+    for (int frame = 0; frame < frames; ++frame) {
+        //step motion
+        for (int i = 0; i < MOTION_FRAMES_PER_IMAGE; ++i) {
+            enactor->postSensors();
+            enactor->sendCommands();
+        }
+
+        //step vision
+        transcriber->postVisionSensors();
+        imageTranscriber->waitForImage();
+    }
+    const double elapsed = seconds() - start;
+
+    SimDestroyMan();
+
+    const double simulated =
+        frames * MOTION_FRAMES_PER_IMAGE * MOTION_FRAME_LENGTH_S;
+    cout << frames << " frames in " << elapsed << " s, "
+         << frames / elapsed << " frames/s, "
+         << simulated / elapsed << "x real time" << endl
+         << "robot at (" << world->getX() << ", " << world->getY()
+         << ") heading " << world->getHeading() * TO_DEG << endl;
+    return 0;
+}
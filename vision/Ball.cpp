@@ -155,77 +155,91 @@ int Ball::balls(int horizon, VisualBall *thisBall)
         }
     }
 
+	// The screens below work on the blob table: cheap tests on the bounds
+	// run over every blob at once, and only the blobs that survive them
+	// have their color counted.
+	blobs->buildTable();
+	const BlobTable& t = blobs->table();
+	unsigned char* keep = blobs->keep();
+	const int n = blobs->number();
+
 	// when we have red uniforms, sometimes we get tons of orange blobs
 	// and sometimes they are inside of each other
-	if (blobs->number() > MIN_BLOB_SIZE) {
-		int big = 0, bigArea = blobs->get(0).getArea();
-		for (int i = 1; i < blobs->number(); i++) {
-			if (blobs->get(i).getArea() > bigArea) {
+	if (n > MIN_BLOB_SIZE) {
+		int big = 0, bigArea = t.area[0];
+		for (int i = 1; i < n; i++) {
+			if (t.area[i] > bigArea) {
 				big = i;
-				bigArea = blobs->get(i).getArea();
+				bigArea = t.area[i];
 			}
 		}
-		for (int i = 0; i < blobs->number(); i++) {
-			if (i != big && blobs->get(i).getRightTopX() > blobs->get(big).getLeftTopX() &&
-				blobs->get(i).getLeftTopX() < blobs->get(big).getRightTopX() &&
-				blobs->get(i).getLeftBottomY() > blobs->get(big).getLeftTopY() &&
-				blobs->get(i).getLeftTopY() < blobs->get(big).getLeftBottomY()) {
-				if (BALLDEBUG) {
+		const int bigLeft = t.left[big], bigRight = t.right[big];
+		const int bigTop = t.top[big], bigBottom = t.bottom[big];
+		for (int i = 0; i < n; i++) {
+			keep[i] = !((t.right[i] > bigLeft) & (t.left[i] < bigRight) &
+						(t.bottom[i] > bigTop) & (t.top[i] < bigBottom));
+		}
+		keep[big] = 1;
+		if (BALLDEBUG) {
+			for (int i = 0; i < n; i++) {
+				if (!keep[i]) {
 					cout << "Screening an inner ball" << endl;
 					drawBlob(blobs->get(i), WHITE);
 				}
-				blobs->init(i);
 			}
 		}
+		blobs->dropUnkept();
 	}
 
     // pre-screen blobs that don't meet our criteria
     //cout << "horizon " << horizon << " " << slope << endl;
-    for (int i = 0; i < blobs->number(); i++) {
-        int ar = blobs->get(i).getArea();
-        float perc = rightColor(blobs->get(i), ORANGE);
-        int diam = max(blobs->get(i).width(), blobs->get(i).height());
+	// first on position and size alone
+	for (int i = 0; i < n; i++) {
+		const int diam = max(t.width[i], t.height[i]);
+		const bool belowHorizon = t.bottom[i] + diam >= horizonAt(t.left[i]);
+		if (BALLDEBUG && keep[i]) {
+			if (!belowHorizon) {
+				cout << "Screened one for horizon problems " << endl;
+			} else if (t.area[i] <= MIN_AREA) {
+				drawBlob(blobs->get(i), BLACK);
+				printBlob(blobs->get(i));
+				cout << "Screened one for being too small - its area is "
+					 << t.area[i] << endl;
+			}
+		}
+		keep[i] &= belowHorizon & (t.area[i] > MIN_AREA);
+	}
+	// then on color for whatever is left
+	for (int i = 0; i < n; i++) {
+		if (!keep[i]) {
+			continue;
+		}
+		const Blob& candidate = blobs->get(i);
+		const int ar = t.area[i];
 		float minpercent = MINORANGEPERCENT;
 		// For now we are going to allow very small balls to be a bit less orange
 		// obviously this is dangerous, so we'll have to keep an eye on it.
 		if (ar < MIN_AREA * 3) {
 			minpercent = MINORANGEPERCENTSMALL;
 		}
-		if (blobs->get(i).getArea() > 0) {
-			if (blobs->get(i).getLeftBottomY() + diam <
-				horizonAt(blobs->get(i).getLeftTopX())) {
-				blobs->init(i);
-				if (BALLDEBUG) {
-					cout << "Screened one for horizon problems " << endl;
-					drawBlob(blobs->get(i), WHITE);
-				}
-			} else if (ar > MIN_AREA && perc > minpercent) {
-				// don't do anything
-				if (BALLDEBUG) {
-					cout << "Candidate ball " << endl;
-					printBlob(blobs->get(i));
-				}
-			} else if (ar > MAX_AREA && rightHalfColor(blobs->get(i)) > minpercent)
-			{
-				if (BALLDEBUG) {
-					cout << "Candidate ball " << endl;
-					printBlob(blobs->get(i));
-				}
-			} else {
-				if (BALLDEBUG) {
-					drawBlob(blobs->get(i), BLACK);
-					printBlob(blobs->get(i));
-					if (perc < minpercent) {
-						cout << "Screened one for not being orange enough, its percentage is "
-							 << perc << endl;
-					} else {
-						cout << "Screened one for being too small - its area is " << ar << endl;
-					}
-				}
-				blobs->init(i);
+		float perc = rightColor(candidate, ORANGE);
+		if (perc > minpercent ||
+			(ar > MAX_AREA && rightHalfColor(candidate) > minpercent)) {
+			if (BALLDEBUG) {
+				cout << "Candidate ball " << endl;
+				printBlob(candidate);
 			}
+		} else {
+			if (BALLDEBUG) {
+				drawBlob(candidate, BLACK);
+				printBlob(candidate);
+				cout << "Screened one for not being orange enough, its percentage is "
+					 << perc << endl;
+			}
+			keep[i] = 0;
 		}
-    }
+	}
+	blobs->dropUnkept();
 
 	bool done = false;
 	int w, h;   // width and height of potential ball
@@ -644,8 +658,22 @@ int Ball::horizonAt(int x) {
  * @param tempobj      the current ball candidate
  * @return             the best percentage we found
  */
+#ifdef USE_COLOR_INTEGRALS
+/* Count the pixels of any shade of orange in a rectangle.
+ * @return     the number of ORANGE, ORANGERED and ORANGEYELLOW pixels with
+ *             left <= x < right and top <= y < bottom
+ */
+int Ball::countOranges(int left, int top, int right, int bottom)
+{
+    ColorCounts &counts = thresh->colorCounts;
+    return counts.count(ORANGE, left, top, right, bottom) +
+        counts.count(ORANGERED, left, top, right, bottom) +
+        counts.count(ORANGEYELLOW, left, top, right, bottom);
+}
+#endif
+
 // only called on really big orange blobs
-float Ball::rightHalfColor(Blob tempobj)
+float Ball::rightHalfColor(const Blob& tempobj)
 {
     const float COLOR_THRESH = 0.15f;
 	const float POOR_VALUE = 0.10f;
@@ -655,8 +683,14 @@ float Ball::rightHalfColor(Blob tempobj)
     int spanY = tempobj.height() - 1;
     int spanX = tempobj.width() - 1;
     int good = 0, good1 = 0, good2 = 0;
-    int pix;
     if (rightColor(tempobj, ORANGE) < COLOR_THRESH) return POOR_VALUE;
+#ifdef USE_COLOR_INTEGRALS
+    // bottom half, left half and right half
+    good = countOranges(x, y + spanY / 2, x + spanX, y + spanY);
+    good1 = countOranges(x, y, x + spanX / 2, y + spanY);
+    good2 = countOranges(x + spanX / 2, y, x + spanX, y + spanY);
+#else
+    int pix;
     for (int i = spanY / 2; i < spanY; i++) {
         for (int j = 0; j < spanX; j++) {
             pix = thresh->thresholded[y + i][x + j];
@@ -687,6 +721,7 @@ float Ball::rightHalfColor(Blob tempobj)
             }
         }
     }
+#endif
     if (BALLDEBUG) {
         cout << "Checking half color " << good << " " << good1 << " " <<
 			good2 << " " << (spanX * spanY / 2) << endl;
@@ -703,7 +738,7 @@ float Ball::rightHalfColor(Blob tempobj)
  * @return            the percentage (unless a special situation occurred)
  */
 
-float Ball::rightColor(Blob tempobj, int col)
+float Ball::rightColor(const Blob& tempobj, int col)
 {
     const int MIN_BLOB_SIZE = 1000;
 	const float RED_PERCENT = 0.10f;
@@ -722,6 +757,14 @@ float Ball::rightColor(Blob tempobj, int col)
     int oygood = 0;
     int red = 0;
 	int pink = 0;
+#ifdef USE_COLOR_INTEGRALS
+    ColorCounts &counts = thresh->colorCounts;
+    ogood = counts.countRect(ORANGE, x, y, spanX, spanY);
+    oygood = counts.countRect(ORANGEYELLOW, x, y, spanX, spanY);
+    orgood = counts.countRect(ORANGERED, x, y, spanX, spanY);
+    red = counts.countRect(RED, x, y, spanX, spanY);
+    good = ogood + oygood + orgood;
+#else
     for (int i = 0; i < spanY; i++) {
         for (int j = 0; j < spanX; j++) {
 			if (y + i > -1 && x + j > -1 && (y + i) < IMAGE_HEIGHT &&
@@ -742,6 +785,7 @@ float Ball::rightColor(Blob tempobj, int col)
 			}
         }
     }
+#endif
     // here's a big hack - if we have a ton of orange, let's say it is enough
 	// unless the percentage is really low
     if (BALLDEBUG) {
@@ -784,7 +828,7 @@ float Ball::rightColor(Blob tempobj, int col)
  * @param b    the potential ball
  * @return     did we find some green?
  */
-bool Ball::greenCheck(Blob b)
+bool Ball::greenCheck(const Blob& b)
 {
     const int ERROR_TOLERANCE = 5;
 	const int EXTRA_LINES = 10;
@@ -797,6 +841,17 @@ bool Ball::greenCheck(Blob b)
     int w = b.width();
     int y = 0;
     int x = b.getLeftBottomX();
+#ifdef USE_COLOR_INTEGRALS
+    // A scan down from the blob finds two greens before ERROR_TOLERANCE
+    // other pixels exactly when there are two in its first
+    // ERROR_TOLERANCE + 1 pixels.
+    y = b.getLeftBottomY();
+    for (int i = 0; i < w; i+= 2) {
+        if (thresh->colorCounts.countRect(GREEN, x + i, y, 1,
+                                          ERROR_TOLERANCE + 1) > 1)
+            return true;
+    }
+#else
 	stop scan;
     for (int i = 0; i < w; i+= 2) {
         y = b.getLeftBottomY();
@@ -804,6 +859,7 @@ bool Ball::greenCheck(Blob b)
         if (scan.good > 1)
             return true;
     }
+#endif
     // try one more in case its a white line
     int bad = 0;
     for (int i = 0; i < EXTRA_LINES && bad < MAX_BAD_PIXELS; i++) {
@@ -821,7 +877,7 @@ bool Ball::greenCheck(Blob b)
  * @param b    the potential ball
  * @return     did we find some green?
  */
-bool Ball::greenSide(Blob b)
+bool Ball::greenSide(const Blob& b)
 {
     const int ERROR_TOLERANCE = 5;
 	const int X_EXTRA = 8;
@@ -944,7 +1000,7 @@ int Ball::scanOut(int start_x, int start_y, float slopel, int dir){
  * @return       a constant result - BAD_VALUE, or 0 for round
  */
 
-int  Ball::roundness(Blob b)
+int  Ball::roundness(const Blob& b)
 {
     const int IMAGE_EDGE = 3;
 	const int BIG_ENOUGH = 4;
@@ -1082,7 +1138,7 @@ int  Ball::roundness(Blob b)
  * @return    where the green is
  */
 
-int Ball::ballNearGreen(Blob b)
+int Ball::ballNearGreen(const Blob& b)
 {
     const int EXTRA_LINES = 6;
 
@@ -1138,7 +1194,7 @@ int Ball::ballNearGreen(Blob b)
  * @return     true if the surround looks bad, false if its ok
  */
 
-bool Ball::badSurround(Blob b) {
+bool Ball::badSurround(const Blob& b) {
     // basically check around the blob and see if it is ok - ideally we'd have
     // some green, worrisome would be lots of RED
     static const int SURROUND = 12;
@@ -1150,9 +1206,28 @@ bool Ball::badSurround(Blob b) {
     int w = b.width();
     int h = b.height();
 	int surround = min(SURROUND, w/2);
-    int greens = 0, orange = 0, red = 0, borange = 0, pix, realred = 0,
+    int greens = 0, orange = 0, red = 0, borange = 0, realred = 0,
 		yellows = 0;
 
+#ifdef USE_COLOR_INTEGRALS
+    ColorCounts &counts = thresh->colorCounts;
+	// first collect information on the ball itself
+    borange = counts.count(ORANGE, x - 1, y - 1, x + w + 1, y + h + 1);
+
+	// now collect information on the area surrounding the ball
+    x = max(0, x - surround);
+    y = max(0, y - surround);
+    w = w + surround * 2;
+    h = h + surround * 2;
+    orange = counts.countRect(ORANGE, x, y, w, h) +
+        counts.countRect(ORANGEYELLOW, x, y, w, h);
+    realred = counts.countRect(RED, x, y, w, h);
+    red = counts.countRect(ORANGERED, x, y, w, h);
+    greens = counts.countRect(GREEN, x, y, w, h);
+    // only yellow above the ball counts
+    yellows = counts.countRect(YELLOW, x, y, w, min(h, surround));
+#else
+    int pix;
 	// first collect information on the ball itself
     for (int i = -1; i < w+1; i++) {
         for (int j = -1; j < h+1; j++) {
@@ -1185,6 +1260,7 @@ bool Ball::badSurround(Blob b) {
 				yellows++;
         }
     }
+#endif
     if (BALLDEBUG) {
         cout << "Surround information " << red << " " << realred << " "
 			 << orange << " " << borange << " " << greens << " "
@@ -1250,7 +1326,7 @@ bool Ball::badSurround(Blob b) {
  * @param b    the ball
  * @return     whether or not it borders a boundary
  */
-bool Ball::atBoundary(Blob b) {
+bool Ball::atBoundary(const Blob& b) {
     return b.getLeftTopX() == 0 || b.getRightTopX() >= IMAGE_WIDTH -1 ||
 		b.getLeftTopY() == 0
         || b.getLeftBottomY() >= IMAGE_HEIGHT - 1;
@@ -1301,7 +1377,7 @@ void Ball::setBallInfo(int w, int h, VisualBall *thisBall) {
  * @param minpercent  how good it needs to be
  * @return            was it good enough?
  */
-bool Ball::rightBlobColor(Blob tempobj, float minpercent) {
+bool Ball::rightBlobColor(const Blob& tempobj, float minpercent) {
     int x = tempobj.getLeftTopX();
     int y = tempobj.getLeftTopY();
     int spanX = tempobj.width();
@@ -1309,6 +1385,12 @@ bool Ball::rightBlobColor(Blob tempobj, float minpercent) {
     if (spanX < 2 || spanY < 2) return false;
     int ny, nx, starty, startx;
     int good = 0, total = 0;
+#ifdef USE_COLOR_INTEGRALS
+    if (ColorCounts::hasTable(color)) {
+        good = thresh->colorCounts.countRect(color, x, y, spanX, spanY);
+        total = ColorCounts::clippedArea(x, y, x + spanX, y + spanY);
+    } else
+#endif
     for (int i = 0; i < spanY; i++) {
         starty = y + i;
         startx = x;
@@ -1351,7 +1433,7 @@ void Ball::addPoint(float x, float y){
  * @param b    the blob we worked on.
  * @return     true when the processing worked, false otherwise
  */
-bool Ball::blobOk(Blob b) {
+bool Ball::blobOk(const Blob& b) {
     if (b.getLeftTopX() > BAD_VALUE && b.getLeftBottomX() > BAD_VALUE &&
 		b.width() > 2)
         return true;
@@ -1362,7 +1444,7 @@ bool Ball::blobOk(Blob b) {
 /* Print debugging information for a blob.
  * @param b    the blob
  */
-void Ball::printBlob(Blob b) {
+void Ball::printBlob(const Blob& b) {
 #if defined OFFLINE
     cout << "Outputting blob" << endl;
     cout << b.getLeftTopX() << " " << b.getLeftTopY() << " " << b.getRightTopX()
@@ -1379,7 +1461,7 @@ void Ball::printBlob(Blob b) {
  * @param o    what the occlusions are if any
  * @param bg   where around the ball there is green
  */
-void Ball::printBall(Blob b, int c, float p, int o) {
+void Ball::printBall(const Blob& b, int c, float p, int o) {
 #ifdef OFFLINE
     if (BALLDEBUG) {
         cout << "Ball info: " << b.getLeftTopX() << " " << b.getLeftTopY()
@@ -1441,7 +1523,7 @@ void Ball::drawRect(int x, int y, int w, int h, int c) {
  * @param b    the blob
  * @param c    the color to paint
  */
-void Ball::drawBlob(Blob b, int c) {
+void Ball::drawBlob(const Blob& b, int c) {
 #ifdef OFFLINE
     thresh->drawLine(b.getLeftTopX(), b.getLeftTopY(),
                      b.getRightTopX(), b.getRightTopY(),
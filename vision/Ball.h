@@ -54,6 +54,7 @@ public:
     void setColor(int c);
     void allocateColorRuns();
 	void newRun(int x, int y, int h);
+	int getNumberOfRuns() { return numberOfRuns; }
 
     // Making object
     void init(float s);
@@ -68,30 +69,33 @@ public:
     void createBall(int c);
 
     // ball stuff
-    float rightColor(Blob obj, int c);
-    float rightHalfColor(Blob obj);
-    bool greenCheck(Blob b);
-    bool greenSide(Blob b);
+    float rightColor(const Blob& obj, int c);
+    float rightHalfColor(const Blob& obj);
+#ifdef USE_COLOR_INTEGRALS
+    int countOranges(int left, int top, int right, int bottom);
+#endif
+    bool greenCheck(const Blob& b);
+    bool greenSide(const Blob& b);
     int scanOut(int start_x, int start_y, float slope,int dir);
-    int ballNearGreen(Blob b);
-    int roundness(Blob b);
-    bool badSurround(Blob b);
-    bool atBoundary(Blob b);
+    int ballNearGreen(const Blob& b);
+    int roundness(const Blob& b);
+    bool badSurround(const Blob& b);
+    bool atBoundary(const Blob& b);
 	void setBallInfo(int w, int h, VisualBall *thisBall);
     int balls(int c, VisualBall *thisBall);
 
     // sanity checks
-    bool rightBlobColor(Blob obj, float per);
+    bool rightBlobColor(const Blob& obj, float per);
     void addPoint(float x, float y);
-	bool blobOk(Blob b);
+	bool blobOk(const Blob& b);
 
     // debugging methods
-    void printBall(Blob b, int c, float p, int o);
+    void printBall(const Blob& b, int c, float p, int o);
     void drawPoint(int x, int y, int c);
     void drawRect(int x, int y, int w, int h, int c);
-    void drawBlob(Blob b, int c);
+    void drawBlob(const Blob& b, int c);
     void drawLine(int x, int y, int x1, int y1, int c);
-    void printBlob(Blob b);
+    void printBlob(const Blob& b);
     void paintRun(int x,int y, int h, int c);
     void drawRun(const run& run, int c);
 
@@ -48,19 +48,19 @@ void Blob::init() {
 	setPixels(0);
 }
 
-int Blob::getArea() {
+int Blob::getArea() const {
     return width() * height();
 }
 
-int Blob::width() {
+int Blob::width() const {
     return rightTop.x - leftTop.x + 1;
 }
 
-int Blob::height() {
+int Blob::height() const {
     return leftBottom.y - leftTop.y + 1;
 }
 
-void Blob::merge(Blob other) {
+void Blob::merge(const Blob& other) {
     int value = min(leftTop.x, other.leftTop.x);
     leftTop.x = value;
     leftBottom.x = value;
@@ -77,7 +77,7 @@ void Blob::merge(Blob other) {
 
 /* Print debugging information for a blob.
  */
-void Blob::printBlob() {
+void Blob::printBlob() const {
 #if defined OFFLINE
     cout << "Outputting blob" << endl;
     cout << leftTop.x << " " << leftTop.y << " " << rightTop.x << " "
@@ -34,31 +34,31 @@ public:
 	void setPixels(int p) {pixels = p;}
 
 	// GETTERS
-	point<int> getLeftTop() {return leftTop;}
-	int getLeftTopX() {return leftTop.x;}
-	int getLeftTopY() {return leftTop.y;}
-	point<int> getRightTop() {return rightTop;}
-	int getRightTopX() {return rightTop.x;}
-	int getRightTopY() {return rightTop.y;}
-	point<int> getLeftBottom() {return leftBottom;}
-	int getLeftBottomX() {return leftBottom.x;}
-	int getLeftBottomY() {return leftBottom.y;}
-	point<int> getRightBottom() {return rightBottom;}
-	int getRightBottomX() {return rightBottom.x;}
-	int getRightBottomY() {return rightBottom.y;}
-	int getLeft() {return min(leftTop.x, leftBottom.x);}
-	int getRight() {return max(rightTop.x, rightBottom.x);}
-	int getTop() {return min(leftTop.y, rightTop.y);}
-	int getBottom() {return max(leftBottom.y, rightBottom.y);}
-	int width();
-	int height();
-	int getArea();
-	int getPixels() {return pixels;}
+	point<int> getLeftTop() const {return leftTop;}
+	int getLeftTopX() const {return leftTop.x;}
+	int getLeftTopY() const {return leftTop.y;}
+	point<int> getRightTop() const {return rightTop;}
+	int getRightTopX() const {return rightTop.x;}
+	int getRightTopY() const {return rightTop.y;}
+	point<int> getLeftBottom() const {return leftBottom;}
+	int getLeftBottomX() const {return leftBottom.x;}
+	int getLeftBottomY() const {return leftBottom.y;}
+	point<int> getRightBottom() const {return rightBottom;}
+	int getRightBottomX() const {return rightBottom.x;}
+	int getRightBottomY() const {return rightBottom.y;}
+	int getLeft() const {return min(leftTop.x, leftBottom.x);}
+	int getRight() const {return max(rightTop.x, rightBottom.x);}
+	int getTop() const {return min(leftTop.y, rightTop.y);}
+	int getBottom() const {return max(leftBottom.y, rightBottom.y);}
+	int width() const;
+	int height() const;
+	int getArea() const;
+	int getPixels() const {return pixels;}
 
     // blobbing
 	void init();
-	void merge(Blob other);
-	void printBlob();
+	void merge(const Blob& other);
+	void printBlob() const;
 
 private:
     // bounding coordinates of the blob
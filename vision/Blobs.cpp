@@ -33,9 +33,25 @@ Blobs::Blobs(int howMany) {
 	for (int i = 0; i < howMany; i++) {
 		blobs[i] = Blob();
 	}
+	// one allocation for all of the table columns
+	boundsStore = (int*)malloc(sizeof(int) * howMany * 7);
+	bounds.left = boundsStore;
+	bounds.right = bounds.left + howMany;
+	bounds.top = bounds.right + howMany;
+	bounds.bottom = bounds.top + howMany;
+	bounds.width = bounds.bottom + howMany;
+	bounds.height = bounds.width + howMany;
+	bounds.area = bounds.height + howMany;
+	bounds.keep = (unsigned char*)malloc(howMany);
 	init();
 }
 
+Blobs::~Blobs() {
+	free(boundsStore);
+	free(bounds.keep);
+	free(blobs);
+}
+
 
 void Blobs::init() {
 	for (int i = 0; i < total; i++) {
@@ -230,4 +246,43 @@ void Blobs::mergeBlobs(int first, int second)
 	zeroTheBlob(second);
 }
 
+/* Copy the bounds of the current blobs into the table and mark them all as
+   kept.  Blobs are boxes here the way blobIt() builds them, so the left top
+   and left bottom corners are enough; width, height and area are what the
+   Blob methods of the same names return.
+*/
+void Blobs::buildTable()
+{
+	for (int i = 0; i < numBlobs; i++) {
+		const Blob& b = blobs[i];
+		bounds.left[i] = b.getLeftTopX();
+		bounds.right[i] = b.getRightTopX();
+		bounds.top[i] = b.getLeftTopY();
+		bounds.bottom[i] = b.getLeftBottomY();
+	}
+	for (int i = 0; i < numBlobs; i++) {
+		bounds.width[i] = bounds.right[i] - bounds.left[i] + 1;
+		bounds.height[i] = bounds.bottom[i] - bounds.top[i] + 1;
+		bounds.area[i] = bounds.width[i] * bounds.height[i];
+		bounds.keep[i] = 1;
+	}
+}
 
+/* Zero every blob the screens did not keep, and make its row of the table
+   match, so that later screens see the same thing the Blob would tell them.
+*/
+void Blobs::dropUnkept()
+{
+	for (int i = 0; i < numBlobs; i++) {
+		if (!bounds.keep[i]) {
+			blobs[i].init();
+			bounds.left[i] = 0;
+			bounds.right[i] = 0;
+			bounds.top[i] = 0;
+			bounds.bottom[i] = 0;
+			bounds.width[i] = 1;
+			bounds.height[i] = 1;
+			bounds.area[i] = 1;
+		}
+	}
+}
@@ -10,10 +10,22 @@ using namespace std;
 
 static const int BADONE = -10000;
 
+/* The bounds of all of the blobs of one color laid out column by column, so
+ * that a screen can test every blob with a tight loop over plain arrays
+ * rather than calling through each Blob in turn.  keep is the screens'
+ * verdict: they clear it for blobs that fail, and Blobs::dropUnkept()
+ * zeroes those blobs afterwards.
+ */
+struct BlobTable {
+	int *left, *right, *top, *bottom;
+	int *width, *height, *area;
+	unsigned char *keep;
+};
+
 class Blobs {
 public:
     Blobs(int howMany);
-    virtual ~Blobs() {}
+    virtual ~Blobs();
 
 	void init();
 	void init(int which) {blobs[which].init();}
@@ -26,10 +38,15 @@ public:
 	Blob* getWidest();
 	void zeroTheBlob(int which);
 	void mergeBlobs(int first, int second);
+	void buildTable();
+	void dropUnkept();
 
 // getters
 	int number() {return numBlobs;}
-	Blob get(int which) {return blobs[which];}
+	const Blob& get(int which) const {return blobs[which];}
+	// valid from buildTable() until the blobs next change
+	const BlobTable& table() const {return bounds;}
+	unsigned char* keep() {return bounds.keep;}
 
 private:
 	int total;
@@ -42,5 +59,7 @@ private:
     int numBlobs;
     //blob checker, obj, pole, leftBox, rightBox;
     Blob* blobs;
+    BlobTable bounds;
+    int* boundsStore;
 };
 #endif
@@ -0,0 +1,67 @@
+#include "ClassPyramid.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ClassPyramid::ClassPyramid(const unsigned char (*_image)[IMAGE_WIDTH])
+    : image(_image)
+{
+}
+
+void ClassPyramid::build()
+{
+    for (int y = 0; y < IMAGE_HEIGHT / 2; ++y) {
+        const unsigned char *top = image[2 * y];
+        const unsigned char *bottom = image[2 * y + 1];
+        unsigned int *cell = half[y];
+        for (int x = 0; x < IMAGE_WIDTH / 2; ++x) {
+            cell[x] = bit(top[2 * x]) | bit(top[2 * x + 1]) |
+                bit(bottom[2 * x]) | bit(bottom[2 * x + 1]);
+        }
+    }
+
+    for (int y = 0; y < IMAGE_HEIGHT / 4; ++y) {
+        const unsigned int *top = half[2 * y];
+        const unsigned int *bottom = half[2 * y + 1];
+        unsigned int *cell = quarter[y];
+        for (int x = 0; x < IMAGE_WIDTH / 4; ++x) {
+            cell[x] = top[2 * x] | top[2 * x + 1] |
+                bottom[2 * x] | bottom[2 * x + 1];
+        }
+    }
+}
+
+bool ClassPyramid::columnHas(int level, int x, int top, int bottom,
+                             unsigned int mask) const
+{
+    top = max(top, 0);
+    bottom = min(bottom, IMAGE_HEIGHT - 1);
+    if (x < 0 || x >= IMAGE_WIDTH || top > bottom) {
+        return false;
+    }
+
+    top >>= level;
+    bottom >>= level;
+    x >>= level;
+    if (level == QUARTER) {
+        for (int y = top; y <= bottom; ++y) {
+            if (quarter[y][x] & mask) {
+                return true;
+            }
+        }
+    } else if (level == HALF) {
+        for (int y = top; y <= bottom; ++y) {
+            if (half[y][x] & mask) {
+                return true;
+            }
+        }
+    } else {
+        for (int y = top; y <= bottom; ++y) {
+            if (bit(image[y][x]) & mask) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,52 @@
+#ifndef ClassPyramid_h_DEFINED
+#define ClassPyramid_h_DEFINED
+
+#include "VisionDef.h"
+
+/**
+ * Coarse copies of the thresholded image.  Each cell of a level holds the
+ * set of colors seen in the 2x2 block of cells below it, as a bitmask, so a
+ * quarter resolution cell says which colors appear anywhere in a 4x4 block
+ * of pixels.
+ *
+ * The scanners use it to decide where not to look: if no cell covering a
+ * stretch of a column has the colors a scan cares about, the full
+ * resolution scan of that stretch can't find anything and is skipped.
+ * Wherever a color does show up the scan runs as before, so edges are
+ * still found at full resolution.
+ */
+class ClassPyramid
+{
+public:
+    enum {
+        HALF = 1,
+        QUARTER = 2
+    };
+
+    ClassPyramid(const unsigned char (*_image)[IMAGE_WIDTH]);
+    virtual ~ClassPyramid() {}
+
+    /**
+     * Rebuild both levels from the thresholded image.  Has to be called
+     * every frame once thresholding is done.
+     */
+    void build();
+
+    static unsigned int bit(int c) { return 1u << (c & 31); }
+
+    /**
+     * @return whether any pixel of column x from row top to row bottom
+     * (inclusive, full resolution coordinates) might have one of the
+     * colors in mask, judging from the given level.  Never false when such
+     * a pixel exists.
+     */
+    bool columnHas(int level, int x, int top, int bottom,
+                   unsigned int mask) const;
+
+private:
+    const unsigned char (*image)[IMAGE_WIDTH];
+    unsigned int half[IMAGE_HEIGHT / 2][IMAGE_WIDTH / 2];
+    unsigned int quarter[IMAGE_HEIGHT / 4][IMAGE_WIDTH / 4];
+};
+
+#endif // ClassPyramid_h_DEFINED
@@ -0,0 +1,95 @@
+#include "ColorCounts.h"
+
+#include <algorithm>
+
+using namespace std;
+
+const int ColorCounts::tableColors[NUM_TABLES] = {
+    WHITE, GREEN, BLUE, YELLOW, ORANGE, ORANGERED, ORANGEYELLOW, RED
+};
+
+// Inverse of tableColors, -1 for colors without a table
+const int ColorCounts::tableIndex[NUM_TABLE_COLORS] = {
+    -1, // GREY
+    0,  // WHITE
+    1,  // GREEN
+    2,  // BLUE
+    3,  // YELLOW
+    4,  // ORANGE
+    -1, // YELLOWWHITE
+    -1, // BLUEGREEN
+    5,  // ORANGERED
+    6,  // ORANGEYELLOW
+    7   // RED
+};
+
+ColorCounts::ColorCounts(const unsigned char (*_image)[IMAGE_WIDTH])
+    : image(_image)
+{
+    // The top row and left column of every table are always zero
+    for (int i = 0; i < NUM_TABLES; ++i) {
+        for (int x = 0; x < TABLE_WIDTH; ++x) {
+            table[i][x] = 0;
+        }
+        for (int y = 0; y <= IMAGE_HEIGHT; ++y) {
+            table[i][y * TABLE_WIDTH] = 0;
+        }
+    }
+    invalidate();
+}
+
+void ColorCounts::invalidate()
+{
+    for (int i = 0; i < NUM_TABLES; ++i) {
+        valid[i] = false;
+    }
+}
+
+int ColorCounts::count(int c, int left, int top, int right, int bottom)
+{
+    left = max(left, 0);
+    top = max(top, 0);
+    right = min(right, IMAGE_WIDTH);
+    bottom = min(bottom, IMAGE_HEIGHT);
+    if (left >= right || top >= bottom) {
+        return 0;
+    }
+
+    const int index = tableIndex[c];
+    if (!valid[index]) {
+        buildTable(index, tableColors[index]);
+    }
+
+    const int *t = table[index];
+    return t[bottom * TABLE_WIDTH + right] - t[top * TABLE_WIDTH + right]
+        - t[bottom * TABLE_WIDTH + left] + t[top * TABLE_WIDTH + left];
+}
+
+int ColorCounts::clippedArea(int left, int top, int right, int bottom)
+{
+    left = max(left, 0);
+    top = max(top, 0);
+    right = min(right, IMAGE_WIDTH);
+    bottom = min(bottom, IMAGE_HEIGHT);
+    if (left >= right || top >= bottom) {
+        return 0;
+    }
+    return (right - left) * (bottom - top);
+}
+
+void ColorCounts::buildTable(int index, int c)
+{
+    int *above = table[index] + 1;
+    int *row = above + TABLE_WIDTH;
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        const unsigned char *pix = image[y];
+        int rowSum = 0;
+        for (int x = 0; x < IMAGE_WIDTH; ++x) {
+            rowSum += (pix[x] == c);
+            row[x] = above[x] + rowSum;
+        }
+        above = row;
+        row += TABLE_WIDTH;
+    }
+    valid[index] = true;
+}
@@ -0,0 +1,74 @@
+#ifndef ColorCounts_h_DEFINED
+#define ColorCounts_h_DEFINED
+
+#include "VisionDef.h"
+
+/**
+ * Summed area tables over the thresholded image for the colors the object
+ * recognizers count most (the oranges, red, green, white and the goal
+ * colors).  With them the number of pixels of a color inside any rectangle
+ * is four lookups instead of a walk over the rectangle.
+ *
+ * Tables are built lazily: invalidate() is called once the thresholded image
+ * is final for the frame, and the first count of a color afterwards builds
+ * that color's table.  Frames without ball candidates never pay for orange.
+ */
+class ColorCounts
+{
+public:
+    ColorCounts(const unsigned char (*_image)[IMAGE_WIDTH]);
+    virtual ~ColorCounts() {}
+
+    void invalidate();
+
+    /**
+     * @return whether c is one of the colors with a table
+     */
+    static bool hasTable(int c) {
+        return c >= 0 && c < NUM_TABLE_COLORS && tableIndex[c] >= 0;
+    }
+
+    /**
+     * Count the pixels of color c with left <= x < right and top <= y <
+     * bottom.  The rectangle is clipped to the image.  c must have a table.
+     */
+    int count(int c, int left, int top, int right, int bottom);
+
+    /**
+     * Count pixels of color c in the rectangle of the given size whose top
+     * left corner is (x, y)
+     */
+    int countRect(int c, int x, int y, int width, int height) {
+        return count(c, x, y, x + width, y + height);
+    }
+
+    /**
+     * Count pixels of color c in row y from left to right inclusive
+     */
+    int countRow(int c, int y, int left, int right) {
+        return count(c, left, y, right + 1, y + 1);
+    }
+
+    /**
+     * Number of pixels of the rectangle that are inside the image
+     */
+    static int clippedArea(int left, int top, int right, int bottom);
+
+private:
+    void buildTable(int index, int c);
+
+    // Colors are small integers; anything at or past this has no table
+    static const int NUM_TABLE_COLORS = RED + 1;
+    static const int NUM_TABLES = 8;
+    static const int TABLE_WIDTH = IMAGE_WIDTH + 1;
+    static const int tableColors[NUM_TABLES];
+    static const int tableIndex[NUM_TABLE_COLORS];
+
+    const unsigned char (*image)[IMAGE_WIDTH];
+    bool valid[NUM_TABLES];
+    // table[i][y * TABLE_WIDTH + x] is the count of tableColors[i] in the
+    // rectangle [0, x) x [0, y)
+    int table[NUM_TABLES][(IMAGE_HEIGHT + 1) * TABLE_WIDTH];
+};
+
+#endif // ColorCounts_h_DEFINED
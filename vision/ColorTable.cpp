@@ -0,0 +1,185 @@
+
+// This file is part of Man, a robotic perception, locomotion, and
+// team strategy application created by the Northern Bites RoboCup
+// team of Bowdoin College in Brunswick, Maine, for the Aldebaran
+// Nao robot.
+//
+// Man is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Man is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// and the GNU Lesser Public License along with Man.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ColorTable.h"
+#ifndef NO_ZLIB
+#include "Zlib.h"
+#endif
+
+using namespace std;
+
+ColorTable::ColorTable(unsigned char *_uvy, bool _mapped)
+    : uvy(_uvy), mapped(_mapped), index(0), blocks(0), numBlocks(0)
+{
+}
+
+ColorTable::~ColorTable()
+{
+    releaseTable();
+    delete [] index;
+    delete [] blocks;
+}
+
+void ColorTable::releaseTable()
+{
+    if (uvy == 0) {
+        return;
+    }
+    if (mapped) {
+        munmap(uvy, BYTES);
+    } else {
+        free(uvy);
+    }
+    uvy = 0;
+}
+
+/**
+ * Maps the table file into memory.  The mapping is private and read only,
+ * and asks for the pages up front so the first frame doesn't fault them in.
+ */
+ColorTable* ColorTable::load(const string &filename)
+{
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < BYTES) {
+        close(fd);
+        return 0;
+    }
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void *table = mmap(0, BYTES, PROT_READ, flags, fd, 0);
+    close(fd);
+    if (table == MAP_FAILED) {
+        return 0;
+    }
+    return new ColorTable(static_cast<unsigned char*>(table), true);
+}
+
+ColorTable* ColorTable::loadCompressed(const string &filename)
+{
+#ifndef NO_ZLIB
+    FILE *fp = fopen(filename.c_str(), "r");
+    if (fp == NULL) {
+        return 0;
+    }
+    int length = 0;
+    unsigned char *data = Zlib::readCompressedFile(fp, length);
+    fclose(fp);
+
+    if (data == NULL) {
+        return 0;
+    }
+    if (length < BYTES) {
+        free(data);
+        return 0;
+    }
+    // Zlib hands back a malloc()ed buffer the table can keep
+    return new ColorTable(data, false);
+#else
+    return 0;
+#endif /* NO_ZLIB */
+}
+
+ColorTable* ColorTable::fromBuffer(const unsigned char *uvy)
+{
+    unsigned char *table = static_cast<unsigned char*>(malloc(BYTES));
+    if (table == NULL) {
+        return 0;
+    }
+    memcpy(table, uvy, BYTES);
+    return new ColorTable(table, false);
+}
+
+ColorTable* ColorTable::blank()
+{
+    unsigned char *table = static_cast<unsigned char*>(calloc(BYTES, 1));
+    if (table == NULL) {
+        return 0;
+    }
+    return new ColorTable(table, false);
+}
+
+void ColorTable::buildPalette()
+{
+    if (blocks != 0) {
+        return;
+    }
+
+    index = new unsigned short[INDEX_SIZE];
+    map<string, unsigned short> seen;
+    string unique;
+    char block[BLOCK_BYTES];
+
+    for (int bu = 0; bu < UMAX; bu += BLOCK_SIZE) {
+        for (int bv = 0; bv < VMAX; bv += BLOCK_SIZE) {
+            for (int by = 0; by < YMAX; by += BLOCK_SIZE) {
+                char *b = block;
+                for (int u = bu; u < bu + BLOCK_SIZE; ++u) {
+                    for (int v = bv; v < bv + BLOCK_SIZE; ++v) {
+                        memcpy(b, row(u, v) + by, BLOCK_SIZE);
+                        b += BLOCK_SIZE;
+                    }
+                }
+
+                const string key(block, BLOCK_BYTES);
+                map<string, unsigned short>::iterator i = seen.find(key);
+                unsigned short number;
+                if (i == seen.end()) {
+                    number = static_cast<unsigned short>(seen.size());
+                    seen[key] = number;
+                    unique += key;
+                } else {
+                    number = i->second;
+                }
+                index[((bu >> BLOCK_BITS) * INDEX_V + (bv >> BLOCK_BITS)) *
+                      INDEX_Y + (by >> BLOCK_BITS)] = number;
+            }
+        }
+    }
+
+    numBlocks = seen.size();
+    blocks = new unsigned char[unique.size()];
+    memcpy(blocks, unique.data(), unique.size());
+    releaseTable();
+}
+
+unsigned int ColorTable::getFootprint() const
+{
+    if (blocks != 0) {
+        return INDEX_SIZE * sizeof(index[0]) + numBlocks * BLOCK_BYTES;
+    }
+    return BYTES;
+}
@@ -0,0 +1,114 @@
+#ifndef ColorTable_h_DEFINED
+#define ColorTable_h_DEFINED
+
+#include <string>
+
+//
+// COLOR TABLE CONSTANTS
+// remember to change both values when chaning the color tables
+
+//these must be changed everytime we load a new table
+#ifdef SMALL_TABLES
+#define YSHIFT  3
+#define USHIFT  2
+#define VSHIFT  2
+#define YMAX  32
+#define UMAX  64
+#define VMAX  64
+#else
+#define YSHIFT  1
+#define USHIFT  1
+#define VSHIFT  1
+#define YMAX  128
+#define UMAX  128
+#define VMAX  128
+#endif
+
+/**
+ * A color table, the color of every (u, v, y) at table resolution.
+ *
+ * The .mtb files hold the table as it is used, in UVY order with a row of
+ * YMAX colors for every (u, v), so load() maps the file straight into
+ * memory instead of reading it in.  Tables from a buffer or a compressed
+ * file are kept on the heap in the same layout.
+ *
+ * buildPalette() swaps the full table for a two level one: the table is cut
+ * into blocks of 8x8x8 entries, identical blocks (nearly all of them are a
+ * single color) are stored once and an index says which stored block each
+ * one is.  A real table comes down to a few hundred blocks, small enough to
+ * stay in the L2 cache, for an extra load per lookup.
+ *
+ * A table is never changed once built, so it can be read from any thread.
+ */
+class ColorTable
+{
+public:
+    enum {
+        BYTES = UMAX * VMAX * YMAX,
+        BLOCK_BITS = 3,
+        BLOCK_SIZE = 1 << BLOCK_BITS,
+        BLOCK_MASK = BLOCK_SIZE - 1,
+        BLOCK_BYTES = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE,
+        INDEX_V = VMAX >> BLOCK_BITS,
+        INDEX_Y = YMAX >> BLOCK_BITS,
+        INDEX_SIZE = (UMAX >> BLOCK_BITS) * INDEX_V * INDEX_Y
+    };
+
+    // All return NULL if the table can't be read
+    static ColorTable* load(const std::string &filename);
+    static ColorTable* loadCompressed(const std::string &filename);
+    static ColorTable* fromBuffer(const unsigned char *uvy);
+    // Every entry the first color, for before a table is loaded
+    static ColorTable* blank();
+
+    ~ColorTable();
+
+    void buildPalette();
+    bool hasPalette() const { return blocks != 0; }
+    unsigned int getNumBlocks() const { return numBlocks; }
+    // Bytes of memory the lookups go through
+    unsigned int getFootprint() const;
+
+    // The YMAX colors of (u, v), in the full table
+    const unsigned char* row(int u, int v) const {
+        return uvy + (u * VMAX + v) * YMAX;
+    }
+
+    // Where the palette keeps the block number and the color of (y, u, v)
+    const unsigned short* indexEntry(int y, int u, int v) const {
+        return index + ((u >> BLOCK_BITS) * INDEX_V +
+                        (v >> BLOCK_BITS)) * INDEX_Y + (y >> BLOCK_BITS);
+    }
+    const unsigned char* paletteEntry(int y, int u, int v) const {
+        return blocks + *indexEntry(y, u, v) * BLOCK_BYTES +
+            ((u & BLOCK_MASK) << (2 * BLOCK_BITS)) +
+            ((v & BLOCK_MASK) << BLOCK_BITS) + (y & BLOCK_MASK);
+    }
+
+    // The color of (y, u, v), in the palette
+    unsigned char paletteLookup(int y, int u, int v) const {
+        return *paletteEntry(y, u, v);
+    }
+
+    unsigned char lookup(int y, int u, int v) const {
+        return blocks ? paletteLookup(y, u, v) : row(u, v)[y];
+    }
+
+private:
+    ColorTable(unsigned char *_uvy, bool _mapped);
+    // Not copyable
+    ColorTable(const ColorTable &other);
+    ColorTable& operator=(const ColorTable &other);
+
+    void releaseTable();
+
+private:
+    unsigned char *uvy;
+    bool mapped;
+
+    unsigned short *index;
+    unsigned char *blocks;
+    unsigned int numBlocks;
+};
+
+#endif // ColorTable_h_DEFINED
@@ -77,19 +77,25 @@ void Cross::createObject() {
 	}
 	if (CROSSDEBUG)
 		cout << blobs->number() << " white blobs" << endl;
-	// loop through all the blobs and test the ones that are the right
-	// basic size
-	for (int i = 0; i < blobs->number(); i++) {
-		Blob candidate = blobs->get(i);
+	// screen all the blobs on size at once, then test the ones that are the
+	// right basic size
+	blobs->buildTable();
+	const BlobTable& t = blobs->table();
+	unsigned char* keep = blobs->keep();
+	const int n = blobs->number();
+	for (int i = 0; i < n; i++) {
+		const int w = t.width[i], h = t.height[i];
+		keep[i] = (w < maxWidth) & (h < maxHeight) & (w > minWidth) &
+			(h > minHeight) & (w < maxRatio * h) & (h < maxRatio * w);
+	}
+	for (int i = 0; i < n; i++) {
 		if (CROSSDEBUG) {
-			cout << "Blob " << candidate.width() << " " << candidate.height() << endl;
-			cout << "Coords " << candidate.getLeft() << " " << candidate.getTop() << endl;
+			cout << "Blob " << t.width[i] << " " << t.height[i] << endl;
+			cout << "Coords " << blobs->get(i).getLeft() << " "
+				 << blobs->get(i).getTop() << endl;
 		}
-		if (candidate.width() < maxWidth && candidate.height() < maxHeight &&
-			candidate.width() > minWidth && candidate.height() > minHeight &&
-			candidate.width() < maxRatio * candidate.height()  &&
-			candidate.height() < maxRatio * candidate.width()) {
-			checkForX(candidate);
+		if (keep[i]) {
+			checkForX(blobs->get(i));
 		}
 	}
 }
@@ -100,7 +106,7 @@ void Cross::createObject() {
  */
 
 
-void Cross::checkForX(Blob b) {
+void Cross::checkForX(const Blob& b) {
 
 	const float greenThreshold = 0.75f;
 	int x = b.getLeftTopX();
@@ -269,14 +275,18 @@ void Cross::allocateColorRuns()
  * @param minpercent  how good it needs to be
  * @return            was it good enough?
  */
-bool Cross::rightBlobColor(Blob tempobj, float minpercent) {
+bool Cross::rightBlobColor(const Blob& tempobj, float minpercent) {
     int x = tempobj.getLeft();
     int y = tempobj.getTop();
     int spanX = tempobj.width();
     int spanY = tempobj.height();
     if (spanX < 1 || spanY < 1) return false;
-    int ny, nx, starty, startx;
     int good = 0, total = 0;
+#ifdef USE_COLOR_INTEGRALS
+    good = thresh->colorCounts.countRect(WHITE, x, y, spanX, spanY);
+    total = ColorCounts::clippedArea(x, y, x + spanX, y + spanY);
+#else
+    int ny, nx, starty, startx;
     for (int i = 0; i < spanY; i++) {
         starty = y + i;
         startx = x;
@@ -291,6 +301,7 @@ bool Cross::rightBlobColor(Blob tempobj, float minpercent) {
             }
         }
     }
+#endif
     float percent = (float)good / (float) (total);
     if (percent > minpercent) {
         return true;
@@ -39,10 +39,11 @@ public:
 
 	void init();
 	void createObject();
-	void checkForX(Blob b);
+	void checkForX(const Blob& b);
 	void newRun(int x, int y, int h);
+	int getNumberOfRuns() { return numberOfRuns; }
 	void allocateColorRuns();
-	bool rightBlobColor(Blob b, float perc);
+	bool rightBlobColor(const Blob& b, float perc);
 
 private:
     // class pointers
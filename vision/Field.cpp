@@ -80,6 +80,10 @@ Field::Field(Vision* vis, Threshold * thr)
 	openField = false;
 	debugShot = false;
 #endif
+	trackHorizon = true;
+	haveLastHorizon = false;
+	trackedFrames = 0;
+	probeOffset = 0;
 }
 
 /*
@@ -346,48 +350,63 @@ void Field::findFieldEdges(int poseHorizon) {
  */
 
 void Field::findConvexHull(int pH) {
-	int RUNSIZE = 3;
-	int SCANSIZE = 10;
-	int NOISE = 2;
-	int HULLS = IMAGE_WIDTH / SCANSIZE + 1;
-
-	int good, ok, top;
-	unsigned char pixel;
-	point<int> convex[HULLS];
 	// we need a better criteria for what the top is
 	for (int i = 0; i < HULLS; i++) {
-		good = 0;
-		ok = 0;
-		int poseProject = yProject(0, pH, i * SCANSIZE);
-		if (pH <= 0) poseProject = 0;
-		for (top = max(poseProject, 0);
-			 good < RUNSIZE && top < IMAGE_HEIGHT; top++) {
-			// scan until we find a run of green pixels
-			int x = i * SCANSIZE;
-			if (i == HULLS - 1)
-				x--;
-			pixel = thresh->thresholded[top][x];
-			if (pixel == GREEN) {
-				good++;
-			} else if (pixel == BLUEGREEN || pixel == GREY) {
-				ok++;
-				if (ok > NOISE) {
-					good = 0;
-					ok = 0;
-				}
-			} else {
+		hullTops[i] = scanHullColumn(i, pH);
+	}
+	buildConvexHull();
+}
+
+/** Scan down one of the hull columns from the horizon until we hit a run of
+	green.
+	@param i     which hull column
+	@param pH    the horizon determined by findGreenHorizon
+	@return      the top of the green run, or IMAGE_HEIGHT if there wasn't one
+ */
+int Field::scanHullColumn(int i, int pH) {
+	const int RUNSIZE = 3;
+	const int NOISE = 2;
+
+	int good = 0, ok = 0, top;
+	unsigned char pixel;
+	int poseProject = yProject(0, pH, i * HULL_SCAN_SIZE);
+	if (pH <= 0) poseProject = 0;
+	int x = i * HULL_SCAN_SIZE;
+	if (i == HULLS - 1)
+		x--;
+	for (top = max(poseProject, 0);
+		 good < RUNSIZE && top < IMAGE_HEIGHT; top++) {
+		// scan until we find a run of green pixels
+		pixel = thresh->thresholded[top][x];
+		if (pixel == GREEN) {
+			good++;
+		} else if (pixel == BLUEGREEN || pixel == GREY) {
+			ok++;
+			if (ok > NOISE) {
 				good = 0;
 				ok = 0;
 			}
-		}
-		if (good == RUNSIZE) {
-			convex[i] = point<int>(i * SCANSIZE, top - good);
-			if (poseProject < 0 && top - good < 10)
-				convex[i] = point<int>(i * SCANSIZE, 0);
 		} else {
-			convex[i] = point<int>(i * SCANSIZE, IMAGE_HEIGHT);
+			good = 0;
+			ok = 0;
 		}
 	}
+	if (good == RUNSIZE) {
+		if (poseProject < 0 && top - good < 10)
+			return 0;
+		return top - good;
+	}
+	return IMAGE_HEIGHT;
+}
+
+/** Take the convex hull of the tops found in the hull columns and
+	interpolate it to get the top of the field in every column.
+ */
+void Field::buildConvexHull() {
+	point<int> convex[HULLS];
+	for (int i = 0; i < HULLS; i++) {
+		convex[i] = point<int>(i * HULL_SCAN_SIZE, hullTops[i]);
+	}
 	// now do the Graham scanning algorithm
 	int M = 2;
 	for (int i = 2; i < HULLS; i++) {
@@ -488,20 +507,124 @@ int Field::ccw(point<int> p1, point<int> p2, point<int> p3) {
  *
  * This method also serves to initialize new field information for
  * the current image.
+ *
+ * The field edge hardly moves from one frame to the next, so when we can we
+ * just follow it (see trackGreenHorizon) and only search from scratch when
+ * that doesn't work out.
  */
 
 int Field::findGreenHorizon(int pH, float sl) {
-	const int MIN_PIXELS_INITIAL = 2;
-	const int SCAN_INTERVAL_X = 10;
-	const int SCAN_INTERVAL_Y = 4;
-    // we're more demanding of Green because there is so much
-	const int MIN_GREEN_SIZE = 10;
-	const int MIN_PIXELS_PRECISE = 20;
-
 	slope = sl;
 	// re init shooting info
     for (int i = 0; i < IMAGE_WIDTH; i++)
         shoot[i] = true;
+
+#ifdef USE_HORIZON_TRACKING
+	PROF_ENTER(vision->profiler, P_HORIZON_TRACK);
+	const bool tracked = trackHorizon && trackGreenHorizon(pH, sl);
+	PROF_EXIT(vision->profiler, P_HORIZON_TRACK);
+	if (tracked) {
+		trackedFrames++;
+	} else {
+		PROF_ENTER(vision->profiler, P_HORIZON_SEARCH);
+		searchGreenHorizon(pH);
+		PROF_EXIT(vision->profiler, P_HORIZON_SEARCH);
+		trackedFrames = 0;
+	}
+	haveLastHorizon = true;
+	lastPoseHorizon = pH;
+	lastSlope = sl;
+#else
+	searchGreenHorizon(pH);
+#endif
+	return horizon;
+}
+
+/* Follow the horizon from the last frame.  Between frames the field only
+ * moves in the image because the head (or body) moved, and the pose horizon
+ * tells us how much that was.  So we shift last frame's horizon and hull by
+ * the change in the pose horizon, check the horizon line really is the top
+ * of the green, and rescan some of the hull columns to make sure they agree.
+ * Which columns get rescanned rotates from frame to frame.
+ * @param pH     the pose horizon
+ * @param sl     the slope of the pose horizon
+ * @return       true if the shifted horizon held up and is now in use
+ */
+bool Field::trackGreenHorizon(int pH, float sl) {
+	if (!haveLastHorizon || trackedFrames >= MAX_TRACKED_FRAMES) {
+		return false;
+	}
+	const int shift = pH - lastPoseHorizon;
+	if (abs(shift) > MAX_TRACK_SHIFT || fabs(sl - lastSlope) > MAX_TRACK_SLOPE) {
+		return false;
+	}
+	// no horizon, or one at the edge of the image, isn't worth following
+	const int predicted = horizon + shift;
+	if (horizon <= 0 || predicted < 2 || predicted > IMAGE_HEIGHT - 3) {
+		return false;
+	}
+	// just above the horizon should be off the field, just below on it
+	if (greenLine(predicted - 2) || !greenLine(predicted + 2)) {
+		return false;
+	}
+
+	int tops[HULLS];
+	for (int i = 0; i < HULLS; i++) {
+		if (hullTops[i] == IMAGE_HEIGHT) {
+			tops[i] = IMAGE_HEIGHT;
+		} else {
+			tops[i] = min(max(hullTops[i] + shift, 0), IMAGE_HEIGHT);
+		}
+	}
+	for (int i = probeOffset; i < HULLS; i += HORIZON_PROBE_STRIDE) {
+		const int top = scanHullColumn(i, predicted);
+		if (abs(top - tops[i]) > HORIZON_PROBE_TOLERANCE) {
+			if (debugHorizon) {
+				cout << "Horizon tracking lost at column " << i * HULL_SCAN_SIZE
+					 << " " << tops[i] << " " << top << endl;
+			}
+			return false;
+		}
+		tops[i] = top;
+	}
+	probeOffset = (probeOffset + 1) % HORIZON_PROBE_STRIDE;
+
+	for (int i = 0; i < HULLS; i++) {
+		hullTops[i] = tops[i];
+	}
+	horizon = predicted;
+	buildConvexHull();
+	return true;
+}
+
+/* Is there lots of green along the line through row y with the horizon's
+ * slope?  Uses the same test as the precise part of searchGreenHorizon.
+ */
+bool Field::greenLine(int y) {
+	int run = 0, greenPixels = 0;
+	int scanY = y;
+	for (int l = 0; l < IMAGE_WIDTH && scanY < IMAGE_HEIGHT && scanY > -1 &&
+			 run < MIN_GREEN_SIZE && greenPixels < MIN_PIXELS_PRECISE; l += 3) {
+		if (thresh->thresholded[scanY][l] == GREEN) {
+			run++;
+			greenPixels++;
+		} else {
+			run = 0;
+		}
+		scanY = yProject(0, y, l + 3);
+	}
+	return run >= MIN_GREEN_SIZE || greenPixels >= MIN_PIXELS_PRECISE;
+}
+
+/* Search for the horizon from scratch, starting at the pose horizon.
+ * @param pH     the pose horizon
+ * @return       the green horizon, also left in horizon
+ */
+int Field::searchGreenHorizon(int pH) {
+	const int MIN_PIXELS_INITIAL = 2;
+	const int SCAN_INTERVAL_X = 10;
+	const int SCAN_INTERVAL_Y = 4;
+
     //variable definitions
     int run, greenPixels, scanY;
     register int i, j;
@@ -11,6 +11,26 @@ class Field;  // forward reference
 #endif
 #include "Profiler.h"
 #include "NaoPose.h"
+
+// green horizon constants
+// we're more demanding of Green because there is so much
+static const int MIN_GREEN_SIZE = 10;
+static const int MIN_PIXELS_PRECISE = 20;
+// columns between the scans that make up the convex hull of the field
+static const int HULL_SCAN_SIZE = 10;
+static const int HULLS = IMAGE_WIDTH / HULL_SCAN_SIZE + 1;
+
+// horizon tracking constants
+// how far the pose horizon may move between frames and still be tracked
+static const int MAX_TRACK_SHIFT = 12;
+static const float MAX_TRACK_SLOPE = 0.05f;
+// do a full search at least this often no matter how well tracking goes
+static const int MAX_TRACKED_FRAMES = 15;
+// every Nth hull column is checked against the image each frame
+static const int HORIZON_PROBE_STRIDE = 4;
+// how far (in pixels) a probe may be off before tracking is abandoned
+static const int HORIZON_PROBE_TOLERANCE = 2;
+
 class Field
 {
     friend class Vision;
@@ -20,8 +40,13 @@ public:
 
     // main methods
     int findGreenHorizon(int pH, float sl);
+	int searchGreenHorizon(int pH);
+	bool trackGreenHorizon(int pH, float sl);
+	bool greenLine(int y);
 	void findFieldEdges(int poseHorizon);
 	void findConvexHull(int pH);
+	int scanHullColumn(int i, int pH);
+	void buildConvexHull();
 	int horizonAt(int x);
 	int ccw(point<int> p1, point<int> p2, point<int> p3);
 
@@ -39,6 +64,9 @@ public:
     void drawLess(int x, int y, int c);
     void drawMore(int x, int y, int c);
 
+    void setHorizonTracking(bool _bool) { trackHorizon = _bool; }
+    bool getHorizonTracking() { return trackHorizon; }
+
 private:
 
     // class pointers
@@ -56,6 +84,16 @@ private:
 
     bool shoot[IMAGE_WIDTH];
 	int  topEdge[IMAGE_WIDTH+1];
+	// highest green found in each hull column, before the hull is taken
+	int  hullTops[HULLS];
+
+	// horizon tracking
+	bool trackHorizon;
+	bool haveLastHorizon;
+	int lastPoseHorizon;
+	float lastSlope;
+	int trackedFrames;
+	int probeOffset;
 };
 
 #endif // Field_h_DEFINED
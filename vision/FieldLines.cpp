@@ -114,9 +114,21 @@ FieldLines::FieldLines(Vision *visPtr, shared_ptr<NaoPose> posePtr,
     debugIdentifyCorners = false;
     debugCornerAndObjectDistances = false;
     debugCcScan = false;
+    debugCompareLineFit = false;
     standardView = true;//false;
 #endif
 
+    lineFitMode = LINE_FIT_INDEXED;
+
+    lineTracking = true;
+    trackedLineFrames = 0;
+    for (int x = 0; x < IMAGE_WIDTH; ++x) {
+        explainedColumn[x] = false;
+    }
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        explainedRow[y] = false;
+    }
+
     // Makes setprecision dictate number of decimal places
     cout.setf(ios::fixed);
 }
@@ -124,6 +136,12 @@ FieldLines::FieldLines(Vision *visPtr, shared_ptr<NaoPose> posePtr,
 // Main Line Loop. Calls all of the smaller line functions.  Order matters.
 void FieldLines::lineLoop() {
 
+#ifdef USE_LINE_TRACKING
+	PROF_ENTER(profiler,P_TRACK_LINES);
+	trackLines();
+	PROF_EXIT(profiler,P_TRACK_LINES);
+#endif
+
 	PROF_ENTER(profiler,P_VERT_LINES);
     vector<linePoint> vertLinePoints;
     findVerticalLinePoints(vertLinePoints);
@@ -147,6 +165,17 @@ void FieldLines::lineLoop() {
     createLines(linePoints); // Lines is a global member of FieldLines
 	PROF_EXIT(profiler,P_CREATE_LINES);
 
+#ifdef USE_LINE_TRACKING
+    // Lines found again by tracking go in with the new ones; joinLines
+    // merges any that the scans found as well
+    for (vector< shared_ptr<VisualLine> >::iterator i = trackedLines.begin();
+         i != trackedLines.end(); ++i) {
+        (*i)->setColor(static_cast<int>(linesList.size()) + BLUEGREEN);
+        (*i)->setColorString(Utility::getColorString((*i)->color));
+        linesList.push_back(*i);
+    }
+#endif
+
 	PROF_ENTER(profiler,P_JOIN_LINES);
 	joinLines();
 	PROF_EXIT(profiler,P_JOIN_LINES);
@@ -170,6 +199,151 @@ void FieldLines::lineLoop() {
 
 }
 
+/* Carry last frame's lines over to this frame.  Every point of every line
+ * from last frame is projected into the image through the current pose, so
+ * head motion is accounted for, and the line is looked for around it.  Lines
+ * with enough of their points found are kept and rebuilt from those points.
+ * A kept line that is more horizontal than vertical explains the scan columns
+ * across its width, a more vertical one the scan rows across its height.
+ * Columns and rows that also cross a line that was lost are not explained,
+ * so the scans still look for it there.  Every MAX_TRACKED_LINE_FRAMES frames
+ * nothing is tracked and the scans cover the whole image.
+ */
+void FieldLines::trackLines() {
+    for (int x = 0; x < IMAGE_WIDTH; ++x) {
+        explainedColumn[x] = false;
+    }
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        explainedRow[y] = false;
+    }
+    trackedLines.clear();
+
+    if (!lineTracking || linesList.empty() ||
+        trackedLineFrames >= MAX_TRACKED_LINE_FRAMES) {
+        trackedLineFrames = 0;
+        return;
+    }
+
+    bool lostColumn[IMAGE_WIDTH];
+    bool lostRow[IMAGE_HEIGHT];
+    for (int x = 0; x < IMAGE_WIDTH; ++x) {
+        lostColumn[x] = false;
+    }
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        lostRow[y] = false;
+    }
+
+    for (vector< shared_ptr<VisualLine> >::const_iterator i = linesList.begin();
+         i != linesList.end(); ++i) {
+        Rectangle span;
+        shared_ptr<VisualLine> line = trackLine(**i, span);
+
+        if (line) {
+            if (line->isVerticallyOriented()) {
+                for (int y = span.top; y <= span.bottom; ++y) {
+                    explainedRow[y] = true;
+                }
+            } else {
+                for (int x = span.left; x <= span.right; ++x) {
+                    explainedColumn[x] = true;
+                }
+            }
+            trackedLines.push_back(line);
+        } else {
+            for (int x = span.left; x <= span.right; ++x) {
+                lostColumn[x] = true;
+            }
+            for (int y = span.top; y <= span.bottom; ++y) {
+                lostRow[y] = true;
+            }
+        }
+    }
+
+    for (int x = 0; x < IMAGE_WIDTH; ++x) {
+        explainedColumn[x] = explainedColumn[x] && !lostColumn[x];
+    }
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        explainedRow[y] = explainedRow[y] && !lostRow[y];
+    }
+
+    if (trackedLines.empty()) {
+        trackedLineFrames = 0;
+    } else {
+        trackedLineFrames++;
+    }
+}
+
+shared_ptr<VisualLine> FieldLines::trackLine(const VisualLine &line,
+                                             Rectangle &span) {
+    span.left = IMAGE_WIDTH;
+    span.right = -1;
+    span.top = IMAGE_HEIGHT;
+    span.bottom = -1;
+
+    list<linePoint> found;
+    int onScreen = 0;
+    for (vector<linePoint>::const_iterator i = line.points.begin();
+         i != line.points.end(); ++i) {
+        point<int> predicted;
+        if (!pose->projectToImage(i->distance, i->bearing, 0.0f, predicted) ||
+            predicted.x < 0 || predicted.x >= IMAGE_WIDTH ||
+            predicted.y < 0 || predicted.y >= IMAGE_HEIGHT) {
+            continue;
+        }
+        ++onScreen;
+        span.left = min(span.left, predicted.x);
+        span.right = max(span.right, predicted.x);
+        span.top = min(span.top, predicted.y);
+        span.bottom = max(span.bottom, predicted.y);
+
+        const linePoint p = probeLinePoint(predicted.x, predicted.y,
+                                           i->foundWithScan);
+        if (p != VisualLine::DUMMY_LINEPOINT) {
+            found.push_back(p);
+        }
+    }
+
+    const int numFound = static_cast<int>(found.size());
+    if (numFound < static_cast<int>(VisualLine::NUM_POINTS_TO_BE_VALID_LINE) ||
+        numFound * 100 < onScreen * TRACK_MIN_FOUND_PERCENT) {
+        return shared_ptr<VisualLine>();
+    }
+
+    // VisualLine expects its points in x order
+    found.sort();
+    shared_ptr<VisualLine> tracked(new VisualLine(found));
+    setLineCoordinates(tracked);
+    return tracked;
+}
+
+linePoint FieldLines::probeLinePoint(int x, int y, ScanDirection dir) {
+    // Try the predicted pixel first, then further and further away from it
+    for (int offset = 0; offset <= TRACK_PROBE_RANGE;
+         offset = (offset <= 0) ? 1 - offset : -offset) {
+        const int probeX = (dir == HORIZONTAL) ? x + offset : x;
+        const int probeY = (dir == HORIZONTAL) ? y : y + offset;
+        if (probeX < 0 || probeX >= IMAGE_WIDTH ||
+            probeY < 0 || probeY >= IMAGE_HEIGHT ||
+            !isLineColor(vision->thresh->thresholded[probeY][probeX])) {
+            continue;
+        }
+
+        const linePoint p = findLinePointFromMiddleOfLine(probeX, probeY, dir);
+        if (p == VisualLine::DUMMY_LINEPOINT) {
+            return p;
+        }
+        const int width = static_cast<int>(p.lineWidth);
+        if ((dir == HORIZONTAL &&
+             !isReasonableHorizontalWidth(p.x, p.y, p.distance, width)) ||
+            (dir == VERTICAL &&
+             !isReasonableVerticalWidth(p.x, p.y, p.distance, width))) {
+            return VisualLine::DUMMY_LINEPOINT;
+        }
+        return p;
+    }
+    return VisualLine::DUMMY_LINEPOINT;
+}
+
 // While lineLoop is called before object recognition so that ObjectFragments
 // can make use of VisualLines and VisualCorners, the methods called from
 // here use VisualFieldObject and as such must be performed after the ObjectFragments
@@ -232,6 +406,10 @@ void FieldLines::findVerticalLinePoints(vector <linePoint> &points) {
         if (x > IMAGE_WIDTH - 1) {
             x = IMAGE_WIDTH - 1;
         }
+        // A tracked line already accounts for this column
+        if (explainedColumn[x]) {
+            continue;
+        }
 
         int greenWhiteY = NO_EDGE;
         int whiteGreenY = NO_EDGE;
@@ -440,6 +618,10 @@ void FieldLines::findHorizontalLinePoints(vector <linePoint> &points) {
     int visualHorizon = vision->thresh->getVisionHorizon();
     int highestPoint = max(0, min(poseHorizon, visualHorizon));
     for (int y = IMAGE_HEIGHT - 1; y > highestPoint; y -= ROW_SKIP) {
+        // A tracked line already accounts for this row
+        if (explainedRow[y]) {
+            continue;
+        }
 
         int greenWhiteX = NO_EDGE;
         int whiteGreenX = NO_EDGE;
@@ -997,8 +1179,59 @@ const bool FieldLines::isDownhillEdge(const int new_y_value,
 
 // Attempts to create lines out of a list of linePoints.  In order for points
 // to be fit onto a line, they must pass a battery of sanity checks
-// Fills in the linesList of the FieldLines object
+// Fills in the linesList of the FieldLines object using the engine selected
+// by lineFitMode.
 void FieldLines::createLines(list <linePoint> &linePoints) {
+#ifdef OFFLINE
+    // Run the reference engine on a copy of the points so that the output
+    // of the selected engine can be checked against it
+    const bool compare = debugCompareLineFit && lineFitMode != LINE_FIT_LEGACY;
+    list<linePoint> legacyPoints;
+    vector< shared_ptr<VisualLine> > legacyLines;
+    long long legacyTime = 0;
+    if (compare) {
+        legacyPoints = linePoints;
+        const long long legacyStart = micro_time();
+        createLinesLegacy(legacyPoints);
+        legacyTime = micro_time() - legacyStart;
+        legacyLines = linesList;
+    }
+    const long long fitStart = micro_time();
+#endif
+
+    switch (lineFitMode) {
+    case LINE_FIT_LEGACY:
+        createLinesLegacy(linePoints);
+        break;
+    case LINE_FIT_RANSAC:
+        createLinesRansac(linePoints);
+        break;
+    case LINE_FIT_INDEXED:
+    default:
+        createLinesIndexed(linePoints);
+        break;
+    }
+
+#ifdef OFFLINE
+    if (compare) {
+        const long long fitTime = micro_time() - fitStart;
+        bool same = legacyLines.size() == linesList.size() &&
+            legacyPoints.size() == linePoints.size();
+        for (unsigned int i = 0; same && i < linesList.size(); ++i) {
+            same = *legacyLines[i] == *linesList[i] &&
+                legacyLines[i]->points.size() == linesList[i]->points.size();
+        }
+        cout << "createLines: legacy " << legacyLines.size() << " lines in "
+             << legacyTime << "us, mode " << lineFitMode << " "
+             << linesList.size() << " lines in " << fitTime << "us"
+             << (same ? "" : " -- OUTPUT DIFFERS") << endl;
+    }
+#endif
+}
+
+// The original line grouping loop. Kept as the reference implementation for
+// createLinesIndexed(), which must produce identical output.
+void FieldLines::createLinesLegacy(list <linePoint> &linePoints) {
     vector < shared_ptr<VisualLine> > lines;
 
 
@@ -1246,6 +1479,373 @@ void FieldLines::createLines(list <linePoint> &linePoints) {
     linesList = lines;
 }
 
+// The width, angle and green sanity checks from createLinesLegacy(), in the
+// same order. The line runs from start to back; point is the candidate.
+// Uses the distance stored in each linePoint, which is the same pixEstimate
+// the legacy loop recomputes for every pair.
+const bool FieldLines::canExtendLine(const linePoint &start,
+                                     const linePoint &back,
+                                     const linePoint &point,
+                                     const bool firstSegment) const
+{
+    // SANITY CHECK: points of similar width, allowing the line to grow as
+    // it comes toward us
+    const float distanceDifference = point.distance - back.distance;
+    const float lineWidthDifference = point.lineWidth - back.lineWidth;
+
+    if ((distanceDifference < 0 &&
+         (lineWidthDifference < -2 || lineWidthDifference > 5)) ||
+        (distanceDifference >= 0 &&
+         (lineWidthDifference > 2 || lineWidthDifference < -5))) {
+        if (debugCreateLines)
+            cout << "\tcanExtendLine: line widths " << back.lineWidth
+                 << " and " << point.lineWidth << " too different" << endl;
+        return false;
+    }
+
+    const float segmentLength =
+        Utility::getLength(static_cast<float>(back.x),
+                           static_cast<float>(back.y),
+                           static_cast<float>(point.x),
+                           static_cast<float>(point.y));
+
+    // ANGLE CHECK: no check on the first segment or between points that
+    // are so close the angle error would dominate
+    if (!firstSegment && segmentLength > MIN_PIXEL_DIST_TO_CHECK_ANGLE) {
+        const float curLineAngle = Utility::getAngle(start.x, start.y,
+                                                     back.x, back.y);
+        const float segmentAngle = Utility::getAngle(back.x, back.y,
+                                                     point.x, point.y);
+        const float difference = min(fabs(curLineAngle - segmentAngle),
+                                     180 - (fabs(curLineAngle -
+                                                 segmentAngle)));
+        if (difference > MAX_ANGLE_LINE_SEGMENT) {
+            if (debugCreateLines)
+                cout << "\tcanExtendLine: angle difference " << difference
+                     << " too large" << endl;
+            return false;
+        }
+    }
+
+    // SANITY CHECK: no green between the end of the line and the new point,
+    // skipped for thin, close, horizontally separated points
+    float percentGreen;
+    if (point.lineWidth < MIN_PIXEL_WIDTH_FOR_GREEN_CHECK &&
+        back.lineWidth < MIN_PIXEL_WIDTH_FOR_GREEN_CHECK &&
+        abs(point.x - back.x) > abs(point.y - back.y) &&
+        segmentLength < MIN_SEPARATION_TO_NOT_CHECK) {
+        percentGreen = 0;
+    } else {
+        percentGreen = percentColorBetween(back.x, back.y,
+                                           point.x, point.y, GREEN);
+    }
+
+    if (percentGreen > MAX_GREEN_PERCENT_ALLOWED_IN_LINE) {
+        if (debugCreateLines)
+            cout << "\tcanExtendLine: found " << percentGreen
+                 << "% green between points" << endl;
+        return false;
+    }
+    return true;
+}
+
+void FieldLines::addCreatedLine(vector< shared_ptr<VisualLine> > &lines,
+                                list<linePointNode> &legitimateLinePoints,
+                                const LeastSquaresSums &sums)
+{
+    shared_ptr<VisualLine> aLine(new VisualLine(legitimateLinePoints, sums));
+    setLineCoordinates(aLine);
+    if (debugCreateLines) {
+        cout << "\tadding line " << lines.size() << " with "
+             << legitimateLinePoints.size() << " line points.\n";
+    }
+
+    drawLinePoints(legitimateLinePoints);
+    aLine->setColor(static_cast<int>(lines.size()) + BLUEGREEN);
+    aLine->setColorString(Utility::getColorString(aLine->color));
+    lines.push_back(aLine);
+
+    if (debugCreateLines) {
+        drawSurroundingBox(aLine, CYAN);
+        drawFieldLine(aLine, aLine->color);
+    }
+}
+
+// Same grouping as createLinesLegacy(). The points arrive sorted by x, so
+// they are indexed once and threaded on a doubly linked list of indices.
+// Points that go into a line are unlinked in constant time, so later scans
+// never revisit them, and every scan still stops at the first point more
+// than GROUP_MAX_X_OFFSET to the right of the line's end. Each line's least
+// squares sums are kept as it grows, so the VisualLine is not fit again.
+// A start that makes no line still leaves its points for the next start to
+// scan, as the legacy loop does, so a frame with many points inside one
+// GROUP_MAX_X_OFFSET window and no lines still costs the square of them.
+void FieldLines::createLinesIndexed(list <linePoint> &linePoints)
+{
+    vector< shared_ptr<VisualLine> > lines;
+
+    const int numPoints = static_cast<int>(linePoints.size());
+    // Index numPoints is the sentinel at both ends of the list
+    const int END = numPoints;
+
+    vector<linePointNode> nodes;
+    nodes.reserve(numPoints);
+    for (linePointNode i = linePoints.begin(); i != linePoints.end(); ++i) {
+        nodes.push_back(i);
+    }
+
+    vector<int> next(numPoints + 1);
+    vector<int> prev(numPoints + 1);
+    for (int i = 0; i <= numPoints; ++i) {
+        next[i] = (i + 1) % (numPoints + 1);
+        prev[i] = (i + numPoints) % (numPoints + 1);
+    }
+
+    vector<int> legitimate;
+    legitimate.reserve(numPoints);
+
+    for (int first = next[END]; first != END; ) {
+        legitimate.clear();
+        legitimate.push_back(first);
+
+        const linePoint &start = *nodes[first];
+        int back = first;
+        // The line's fit, grown with it
+        LeastSquaresSums sums;
+        sums.add(start);
+
+        for (int cur = next[first]; cur != END; cur = next[cur]) {
+            const linePoint &point = *nodes[cur];
+
+            if (abs(point.x - nodes[back]->x) > GROUP_MAX_X_OFFSET)
+                break;
+
+            if (canExtendLine(start, *nodes[back], point,
+                              legitimate.size() == 1)) {
+                legitimate.push_back(cur);
+                sums.add(point);
+                back = cur;
+            }
+        }
+
+        if (legitimate.size() < VisualLine::NUM_POINTS_TO_BE_VALID_LINE) {
+            first = next[first];
+            continue;
+        }
+
+        list<linePointNode> legitimateLinePoints;
+        for (vector<int>::const_iterator i = legitimate.begin();
+             i != legitimate.end(); ++i) {
+            legitimateLinePoints.push_back(nodes[*i]);
+        }
+        addCreatedLine(lines, legitimateLinePoints, sums);
+
+        // Unlink the used points, first point last, so that its next index
+        // ends up at the first remaining point after it
+        for (vector<int>::reverse_iterator i = legitimate.rbegin();
+             i != legitimate.rend(); ++i) {
+            next[prev[*i]] = next[*i];
+            prev[next[*i]] = prev[*i];
+            linePoints.erase(nodes[*i]);
+        }
+        first = next[first];
+    }
+
+    if (debugCreateLines) {
+        cout << linePoints.size() << " points remain after forming "
+             << lines.size() << " lines" << endl;
+    }
+
+    linesList = lines;
+}
+
+// Repeatedly hypothesizes lines through pairs of nearby unused points, keeps
+// the one with the most inliers, refits it and accepts the longest green free
+// run of inliers along it. Points are bucketed by x so that the second point
+// of each pair comes from within GROUP_MAX_X_OFFSET of the first.
+void FieldLines::createLinesRansac(list <linePoint> &linePoints)
+{
+    vector< shared_ptr<VisualLine> > lines;
+
+    vector<linePointNode> nodes;
+    nodes.reserve(linePoints.size());
+    for (linePointNode i = linePoints.begin(); i != linePoints.end(); ++i) {
+        nodes.push_back(i);
+    }
+    const int numPoints = static_cast<int>(nodes.size());
+
+    // bucketStart[b] is the index of the first point with
+    // x >= b * GROUP_MAX_X_OFFSET; the points are already sorted by x
+    const int numBuckets = IMAGE_WIDTH / GROUP_MAX_X_OFFSET + 2;
+    vector<int> bucketStart(numBuckets + 1, numPoints);
+    for (int i = numPoints - 1; i >= 0; --i) {
+        const int b = max(0, min(numBuckets - 1,
+                                 nodes[i]->x / GROUP_MAX_X_OFFSET));
+        for (int j = b; j >= 0 && bucketStart[j] > i; --j) {
+            bucketStart[j] = i;
+        }
+    }
+
+    vector<bool> used(numPoints, false);
+    int numUnused = numPoints;
+    unsigned int seed = RANSAC_SEED;
+    int failures = 0;
+
+    vector<int> inliers;
+    vector< pair<float, int> > ordered;
+    inliers.reserve(numPoints);
+    ordered.reserve(numPoints);
+
+    while (numUnused >= static_cast<int>(VisualLine::NUM_POINTS_TO_BE_VALID_LINE)
+           && failures < RANSAC_MAX_FAILURES) {
+
+        // Line hypotheses are stored as a unit normal (nx, ny) and offset c
+        // so that a point's distance to the line is |nx*x + ny*y - c|
+        float bestNx = 0.0f, bestNy = 0.0f, bestC = 0.0f;
+        int bestCount = 0;
+
+        for (int iter = 0; iter < RANSAC_ITERATIONS; ++iter) {
+            seed = seed * 1103515245u + 12345u;
+            const int a = static_cast<int>((seed >> 8) % numPoints);
+            if (used[a])
+                continue;
+
+            const int bucket = nodes[a]->x / GROUP_MAX_X_OFFSET;
+            const int lo = bucketStart[max(0, bucket - 1)];
+            const int hi = bucketStart[min(numBuckets, bucket + 2)];
+            if (hi - lo < 2)
+                continue;
+            seed = seed * 1103515245u + 12345u;
+            const int b = lo + static_cast<int>((seed >> 8) % (hi - lo));
+            if (b == a || used[b])
+                continue;
+
+            const float dx = static_cast<float>(nodes[b]->x - nodes[a]->x);
+            const float dy = static_cast<float>(nodes[b]->y - nodes[a]->y);
+            const float len = hypotf(dx, dy);
+            if (len <= MIN_PIXEL_DIST_TO_CHECK_ANGLE)
+                continue;
+
+            const float nx = -dy / len;
+            const float ny = dx / len;
+            const float c = nx * nodes[a]->x + ny * nodes[a]->y;
+
+            int count = 0;
+            for (int i = 0; i < numPoints; ++i) {
+                if (!used[i] &&
+                    fabs(nx * nodes[i]->x + ny * nodes[i]->y - c) <=
+                    RANSAC_MAX_INLIER_DIST)
+                    ++count;
+            }
+            if (count > bestCount) {
+                bestCount = count;
+                bestNx = nx;
+                bestNy = ny;
+                bestC = c;
+            }
+        }
+
+        if (bestCount < static_cast<int>(VisualLine::NUM_POINTS_TO_BE_VALID_LINE)) {
+            ++failures;
+            continue;
+        }
+
+        // Refit the hypothesis to its inliers with running least squares
+        // sums (total least squares, so vertical lines are handled too)
+        float n = 0, sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+        for (int i = 0; i < numPoints; ++i) {
+            const float x = static_cast<float>(nodes[i]->x);
+            const float y = static_cast<float>(nodes[i]->y);
+            if (used[i] ||
+                fabs(bestNx * x + bestNy * y - bestC) > RANSAC_MAX_INLIER_DIST)
+                continue;
+            n += 1; sx += x; sy += y;
+            sxx += x * x; syy += y * y; sxy += x * y;
+        }
+        const float mx = sx / n;
+        const float my = sy / n;
+        const float covXX = sxx / n - mx * mx;
+        const float covYY = syy / n - my * my;
+        const float covXY = sxy / n - mx * my;
+        // Direction of greatest spread of the inliers
+        const float theta = 0.5f * atan2f(2.0f * covXY, covXX - covYY);
+        const float ux = cosf(theta);
+        const float uy = sinf(theta);
+        const float nx = -uy;
+        const float ny = ux;
+        const float c = nx * mx + ny * my;
+
+        // Order the refit inliers along the line
+        ordered.clear();
+        for (int i = 0; i < numPoints; ++i) {
+            const float x = static_cast<float>(nodes[i]->x);
+            const float y = static_cast<float>(nodes[i]->y);
+            if (!used[i] && fabs(nx * x + ny * y - c) <= RANSAC_MAX_INLIER_DIST)
+                ordered.push_back(make_pair(ux * x + uy * y, i));
+        }
+        sort(ordered.begin(), ordered.end());
+
+        // Split the inliers wherever neighbours are too far apart or have
+        // green between them, and keep the longest run
+        int bestRunStart = 0, bestRunLength = 0;
+        int runStart = 0;
+        for (int i = 1; i <= static_cast<int>(ordered.size()); ++i) {
+            bool split = i == static_cast<int>(ordered.size());
+            if (!split) {
+                const linePoint &p = *nodes[ordered[i - 1].second];
+                const linePoint &q = *nodes[ordered[i].second];
+                split = ordered[i].first - ordered[i - 1].first >
+                    GROUP_MAX_X_OFFSET ||
+                    percentColorBetween(p.x, p.y, q.x, q.y, GREEN) >
+                    MAX_GREEN_PERCENT_ALLOWED_IN_LINE;
+            }
+            if (split) {
+                if (i - runStart > bestRunLength) {
+                    bestRunStart = runStart;
+                    bestRunLength = i - runStart;
+                }
+                runStart = i;
+            }
+        }
+
+        if (bestRunLength < static_cast<int>(VisualLine::NUM_POINTS_TO_BE_VALID_LINE)) {
+            ++failures;
+            continue;
+        }
+
+        // VisualLine expects its points sorted by x, which index order gives
+        inliers.clear();
+        for (int i = bestRunStart; i < bestRunStart + bestRunLength; ++i) {
+            inliers.push_back(ordered[i].second);
+        }
+        sort(inliers.begin(), inliers.end());
+
+        list<linePointNode> legitimateLinePoints;
+        LeastSquaresSums sums;
+        for (vector<int>::const_iterator i = inliers.begin();
+             i != inliers.end(); ++i) {
+            legitimateLinePoints.push_back(nodes[*i]);
+            sums.add(*nodes[*i]);
+            used[*i] = true;
+        }
+        numUnused -= bestRunLength;
+        addCreatedLine(lines, legitimateLinePoints, sums);
+        failures = 0;
+    }
+
+    for (int i = 0; i < numPoints; ++i) {
+        if (used[i])
+            linePoints.erase(nodes[i]);
+    }
+
+    if (debugCreateLines) {
+        cout << linePoints.size() << " points remain after forming "
+             << lines.size() << " lines" << endl;
+    }
+
+    linesList = lines;
+}
+
 /**
  * Construct a visual line from a list of line points.
  * Then uses the end points of the line to set the
@@ -21,6 +21,16 @@ static const int BAD_DISTANCE = -23523134;
 // for percentColor(), ortho directions
 enum TestDirection {TEST_UP, TEST_DOWN, TEST_LEFT, TEST_RIGHT};
 
+// Which engine createLines() uses to group line points into lines.
+// LINE_FIT_LEGACY is the original list walk, LINE_FIT_INDEXED produces the
+// same lines from an index over the x sorted points and LINE_FIT_RANSAC
+// searches for consensus lines, which copes better with cluttered frames.
+enum LineFitMode {
+    LINE_FIT_LEGACY,
+    LINE_FIT_INDEXED,
+    LINE_FIT_RANSAC
+};
+
 struct linePoint;
 
 #include "Common.h" //
@@ -190,6 +200,30 @@ private:
 
     static const int DEBUG_GROUP_LINES_BOX_WIDTH = 4;
 
+    ////////////////////////////////////////////////////////////
+    // RANSAC line fitting constants
+    ////////////////////////////////////////////////////////////
+    // Number of line hypotheses tested before picking the best one
+    static const int RANSAC_ITERATIONS = 40;
+    // A point farther than this many pixels from a hypothesis is an outlier
+    static const int RANSAC_MAX_INLIER_DIST = 2;
+    // Give up looking for more lines after this many rejected hypotheses
+    static const int RANSAC_MAX_FAILURES = 3;
+    // Seed for the hypothesis sampler, fixed so every frame is repeatable
+    static const unsigned int RANSAC_SEED = 0x4e42u;
+
+    ////////////////////////////////////////////////////////////
+    // Line tracking constants
+    ////////////////////////////////////////////////////////////
+    // Run the full scans at least this often, even while tracking holds, so
+    // lines that come into view inside tracked regions are picked up
+    static const int MAX_TRACKED_LINE_FRAMES = 10;
+    // Pixels searched on either side of a predicted point for line color
+    static const int TRACK_PROBE_RANGE = 6;
+    // Percentage of a line's predicted points (those landing on the screen)
+    // that must be found again for the line to be kept
+    static const int TRACK_MIN_FOUND_PERCENT = 50;
+
     ////////////////////////////////////////////////////////////
     // Identify corners constants
     ////////////////////////////////////////////////////////////
@@ -238,8 +272,50 @@ public:
 
     // Attempts to create lines out of a list of linePoints.  In order for
     // points to be fit onto a line, they must pass a battery of sanity checks
+    // Dispatches to the engine chosen with setLineFitMode(). Points used in
+    // a line are removed from linePoints.
     void createLines(std::list<linePoint> &linePoints);
 
+    // The original createLines() implementation, which walks the remaining
+    // list of points for every potential starting point.
+    void createLinesLegacy(std::list<linePoint> &linePoints);
+
+    // Produces exactly the lines createLinesLegacy() does, but links the x
+    // sorted points through an index so used points are unlinked in
+    // constant time, uses the distances cached in each linePoint instead
+    // of asking the pose for them on every comparison, and fits each line
+    // from running sums kept as it grows.
+    void createLinesIndexed(std::list<linePoint> &linePoints);
+
+    // Finds lines by random sample consensus over the x bucketed points,
+    // refits the best hypothesis with least squares and keeps the longest
+    // run of inliers that has no green between neighbouring points.
+    void createLinesRansac(std::list<linePoint> &linePoints);
+
+    void setLineFitMode(LineFitMode mode) { lineFitMode = mode; }
+    const LineFitMode getLineFitMode() const { return lineFitMode; }
+
+    // Follows last frame's lines into this image through the pose and keeps
+    // those that are still there. The scan columns and rows that cross only
+    // kept lines are marked so the vertical and horizontal scans skip them.
+    void trackLines();
+
+    // Projects the points of a line from last frame into the image and looks
+    // for the line around each one. Returns the line built from the points
+    // found, or an empty pointer if too few were. span is set to the box
+    // around the projected points that landed on the screen.
+    boost::shared_ptr<VisualLine> trackLine(const VisualLine &line,
+                                            Rectangle &span);
+
+    // Searches up to TRACK_PROBE_RANGE pixels either way along dir from
+    // (x, y) for a line pixel and measures the line there as
+    // findLinePointFromMiddleOfLine does. Returns VisualLine::DUMMY_LINEPOINT
+    // if there is no line or its width is unreasonable.
+    linePoint probeLinePoint(int x, int y, ScanDirection dir);
+
+    void setLineTracking(bool _bool) { lineTracking = _bool; }
+    const bool getLineTracking() const { return lineTracking; }
+
     void setLineCoordinates(boost::shared_ptr<VisualLine> aLine);
 
     // Attempts to fit the left over points that were not used within the
@@ -542,6 +618,9 @@ public:
     void setStandardView(bool _bool) {
         standardView = _bool;
     }
+    // When set, every frame also runs the legacy engine and reports any
+    // difference in output along with the time each engine took.
+    void setDebugCompareLineFit(bool _bool) { debugCompareLineFit = _bool; }
 
     const bool getDebugVertEdgeDetect() const { return debugVertEdgeDetect; }
     const bool getDebugHorEdgeDetect() const { return debugHorEdgeDetect; }
@@ -560,6 +639,7 @@ public:
         return debugCornerAndObjectDistances;
     }
     const bool getStandardView() { return standardView; }
+    const bool getDebugCompareLineFit() const { return debugCompareLineFit; }
 #endif
 
     const std::vector < boost::shared_ptr<VisualLine> >* getLines() const { return &linesList; }
@@ -682,6 +762,18 @@ private:
                                            const float dist,
                                            const int width) const;
 
+    // The width, angle and green sanity checks createLines() applies before
+    // adding point to the line running from start to back.
+    const bool canExtendLine(const linePoint &start, const linePoint &back,
+                             const linePoint &point,
+                             const bool firstSegment) const;
+
+    // Turns the given points, whose least squares sums are sums, into a
+    // VisualLine, adds it to lines and draws it
+    void addCreatedLine(std::vector< boost::shared_ptr<VisualLine> > &lines,
+                        std::list<linePointNode> &legitimateLinePoints,
+                        const LeastSquaresSums &sums);
+
 
 
 
@@ -695,6 +787,16 @@ private:
     std::list <VisualCorner> cornersList;
     std::list <linePoint> unusedPointsList;
 
+    LineFitMode lineFitMode;
+
+    bool lineTracking;
+    // Frames in a row in which at least one line was tracked
+    int trackedLineFrames;
+    std::vector <boost::shared_ptr<VisualLine> > trackedLines;
+    // Scan columns and rows that only cross tracked lines this frame
+    bool explainedColumn[IMAGE_WIDTH];
+    bool explainedRow[IMAGE_HEIGHT];
+
 private:
 
     // debug variables
@@ -711,6 +813,7 @@ private:
     bool debugRiskyCorners;
     bool debugCornerAndObjectDistances;
     bool debugFitUnusedPoints;
+    bool debugCompareLineFit;
     // Normal users of cortex do not need to see as much debugging information
     // as I have been drawing; now there will be fewer colors etc to keep
     // track of
@@ -734,6 +837,7 @@ private:
     static const bool debugRiskyCorners = false;
     static const bool debugCornerAndObjectDistances = false;
     static const bool debugFitUnusedPoints = false;
+    static const bool debugCompareLineFit = false;
 
     static const bool standardView = false;
 
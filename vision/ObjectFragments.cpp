@@ -289,6 +289,17 @@ int ObjectFragments::xProject(point <int> point, int newy) {
     return point.x - ROUND2(slope * (float)(newy - point.y));
 }
 
+/* Whether the projections above are the identity for every offset up to
+ * span, i.e. the horizon is level enough that a sheared walk over that many
+ * pixels stays on one row or column.
+ * @param span     the largest offset that will be projected
+ * @return         true if no offset up to span moves the projected point
+ */
+bool ObjectFragments::unsheared(int span)
+{
+    return fabs(slope) * static_cast<float>(span) < 0.5f;
+}
+
 /* Project a line given a start coord and a new x value
  * @param startx   the x point to start at
  * @param starty   the y point to start at
@@ -943,7 +954,7 @@ void ObjectFragments::squareGoal(int x, int y, int c, int c2, Blob & obj)
  * @param certainty       how certain are we of its ID?
  * @param distCertainty   how certain are we of how big we think it is?
  */
-bool ObjectFragments::updateObject(VisualFieldObject* one, Blob two,
+bool ObjectFragments::updateObject(VisualFieldObject* one, const Blob& two,
                                    certainty _certainty,
                                    distanceCertainty _distCertainty) {
     // before we do this let's make sure that the object is really our color
@@ -970,7 +981,7 @@ bool ObjectFragments::updateObject(VisualFieldObject* one, Blob two,
  * @param pole     the object we are checking
  * @return         a constant indicating where the uncertainties (if any) lie
  */
-distanceCertainty ObjectFragments::checkDist(Blob pole)
+distanceCertainty ObjectFragments::checkDist(const Blob& pole)
 {
     const int ERROR_TOLERANCE = 6;
 	int left = pole.getLeft();
@@ -1017,7 +1028,7 @@ distanceCertainty ObjectFragments::checkDist(Blob pole)
  * @return    a constant indicating size - SMALL, MEDIUM, or LARGE
  */
 // EXAMINED: change these constants
-int ObjectFragments::characterizeSize(Blob b) {
+int ObjectFragments::characterizeSize(const Blob& b) {
     int w = b.getRightTopX() - b.getLeftTopX() + 1;
     int h = b.getLeftBottomY() - b.getLeftTopY() + 1;
     const int largePostHeight = 30;
@@ -1041,7 +1052,7 @@ int ObjectFragments::characterizeSize(Blob b) {
  * @return    a constant indicating size - SMALL, MEDIUM, or LARGE
  */
 
-bool ObjectFragments::qualityPost(Blob b, int c)
+bool ObjectFragments::qualityPost(const Blob& b, int c)
 {
     const float PERCENT_NEEDED = 0.6f;  // percent of pixels that must be right
 
@@ -1066,7 +1077,7 @@ bool ObjectFragments::qualityPost(Blob b, int c)
  * @return    a constant indicating size - SMALL, MEDIUM, or LARGE
  */
 
-bool ObjectFragments::checkSize(Blob b, int c)
+bool ObjectFragments::checkSize(const Blob& b, int c)
 {
     const int ERROR_TOLERANCE = 6;     // how many bad pixels to scan over
 	const int FAR_ENOUGH = 10;         // how far to scan to be sure
@@ -1136,7 +1147,7 @@ int ObjectFragments::grabPost(int c, int c2, int left,
  *  @param b   the square post
  *  @return   either RIGHT or LEFT if a crossbar found, or NOPOST if not
  */
-int ObjectFragments::classifyByCrossbar(Blob b)
+int ObjectFragments::classifyByCrossbar(const Blob& b)
 {
     const int MINIMUM_WIDTH = 10;
 	const int HEIGHT_DIVISOR = 5;
@@ -1205,7 +1216,7 @@ int ObjectFragments::classifyByCrossbar(Blob b)
    same side as the post.
  */
 
-int ObjectFragments::classifyByLineIntersection(Blob post) {
+int ObjectFragments::classifyByLineIntersection(const Blob& post) {
 
 	const int MAXIMUM_Y_DIFF = 30;
 
@@ -1264,7 +1275,7 @@ int ObjectFragments::classifyByLineIntersection(Blob post) {
     @return        the id of the post (or lack of id)
  */
 
-int ObjectFragments::classifyByCheckingCorners(Blob post)
+int ObjectFragments::classifyByCheckingCorners(const Blob& post)
 {
     const int MAXIMUM_Y_DIFFERENCE = 30;  // max offset between corner and post
 	const int X_TOLERANCE = 5;            // how close do X values need to be
@@ -1370,7 +1381,7 @@ int ObjectFragments::classifyByOtherRuns(int left, int right, int height)
 int ObjectFragments::classifyFirstPost(int c,int c2,
                                        VisualFieldObject* left,
                                        VisualFieldObject* right,
-                                       VisualCrossbar* mid, Blob pole)
+                                       VisualCrossbar* mid, const Blob& pole)
 {
     const int MIN_BLOB_SIZE = 10;
 
@@ -1679,7 +1690,7 @@ void ObjectFragments::postSwap(VisualFieldObject * p1, VisualFieldObject * p2){
  * @param b    the potential post
  * @return     did we find some green?
  */
-bool ObjectFragments::greenCheck(Blob b)
+bool ObjectFragments::greenCheck(const Blob& b)
 {
     const int ERROR_TOLERANCE = 5;
 	const int EXTRA_LINES = 10;
@@ -1694,6 +1705,20 @@ bool ObjectFragments::greenCheck(Blob b)
     int w = b.width();
     int y = 0;
     int x = b.getLeftBottomX();
+#ifdef USE_COLOR_INTEGRALS
+	// On a level horizon each scan is a straight column, and it finds two
+	// greens before ERROR_TOLERANCE others exactly when there are two in
+	// its first ERROR_TOLERANCE + 1 pixels.
+	if (unsheared(max(w, ERROR_TOLERANCE + 1))) {
+		y = b.getLeftBottomY();
+		for (int i = 0; i < w; i+= 2) {
+			if (thresh->colorCounts.countRect(GREEN, x + i, y, 1,
+											  ERROR_TOLERANCE + 1) > 1)
+				return true;
+		}
+	} else
+#endif
+	{
 	stop scan;
 	// do the actual scanning under the blob
     for (int i = 0; i < w; i+= 2) {
@@ -1702,6 +1727,7 @@ bool ObjectFragments::greenCheck(Blob b)
         if (scan.good > 1)
             return true;
     }
+	}
     // try one more in case its a white line
     int bad = 0;
     for (int i = 0; i < EXTRA_LINES && bad < MAX_BAD_PIXELS; i++) {
@@ -1720,7 +1746,7 @@ bool ObjectFragments::greenCheck(Blob b)
  * @param minpercent  how good it needs to be
  * @return            was it good enough?
  */
-bool ObjectFragments::rightBlobColor(Blob tempobj, float minpercent) {
+bool ObjectFragments::rightBlobColor(const Blob& tempobj, float minpercent) {
     int x = tempobj.getLeftTopX();
     int y = tempobj.getLeftTopY();
     int spanX = tempobj.width();
@@ -1733,6 +1759,13 @@ bool ObjectFragments::rightBlobColor(Blob tempobj, float minpercent) {
 	}
     int ny, nx, starty, startx;
     int good = 0, total = 0;
+#ifdef USE_COLOR_INTEGRALS
+	// A level blob is a plain rectangle
+	if (unsheared(max(spanX, spanY)) && ColorCounts::hasTable(color)) {
+		good = thresh->colorCounts.countRect(color, x, y, spanX, spanY);
+		total = ColorCounts::clippedArea(x, y, x + spanX, y + spanY);
+	} else
+#endif
     for (int i = 0; i < spanY; i++) {
         starty = y + i;
         startx = xProject(x, y, starty);
@@ -1762,7 +1795,7 @@ bool ObjectFragments::rightBlobColor(Blob tempobj, float minpercent) {
  * @param b     the post
  * @return      true if its big enough, false otherwise
  */
-bool ObjectFragments::postBigEnough(Blob b) {
+bool ObjectFragments::postBigEnough(const Blob& b) {
     if (b.getLeftTopX() == BADVALUE || (b.getRightTopX() - b.getLeftTopX() + 1 <
 									MIN_GOAL_WIDTH) ||
         b.getLeftBottomY() - b.getLeftTopY() + 1 < MIN_GOAL_HEIGHT) {
@@ -1776,7 +1809,7 @@ bool ObjectFragments::postBigEnough(Blob b) {
  *  then punt this object
  */
 
-bool ObjectFragments::badDistance(Blob b) {
+bool ObjectFragments::badDistance(const Blob& b) {
 	int x = b.getLeftBottomX();
 	int y = b.getLeftBottomY();
 	int bottom = b.getBottom();
@@ -1802,7 +1835,7 @@ bool ObjectFragments::badDistance(Blob b) {
  * @return         true if it is reasonably located, false otherwise
  */
 
-bool ObjectFragments::locationOk(Blob b)
+bool ObjectFragments::locationOk(const Blob& b)
 {
     const int MIN_HORIZON = -50;
 	const int TALL_POST = 55;
@@ -1938,7 +1971,7 @@ bool ObjectFragments::secondPostFarEnough(point <int> left1, point <int> right1,
  * @param b    the blob we worked on.
  * @return     true when the processing worked, false otherwise
  */
-bool ObjectFragments::blobOk(Blob b) {
+bool ObjectFragments::blobOk(const Blob& b) {
     if (b.getLeftTopX() > BADVALUE && b.getLeftBottomX() > BADVALUE)
         return true;
     return false;
@@ -2101,7 +2134,7 @@ void ObjectFragments::printObjs() {
 /* Print debugging information for a blob.
  * @param b    the blob
  */
-void ObjectFragments::printBlob(Blob b) {
+void ObjectFragments::printBlob(const Blob& b) {
 #if defined OFFLINE
     cout << "Outputting blob" << endl;
     cout << b.getLeftTopX() << " " << b.getLeftTopY() << " " << b.getRightTopX() << " "
@@ -2156,7 +2189,7 @@ void ObjectFragments::drawRect(int x, int y, int w, int h, int c) {
  * @param b    the blob
  * @param c    the color to paint
  */
-void ObjectFragments::drawBlob(Blob b, int c) {
+void ObjectFragments::drawBlob(const Blob& b, int c) {
 #ifdef OFFLINE
     thresh->drawLine(b.getLeftTopX(), b.getLeftTopY(),
                      b.getRightTopX(), b.getRightTopY(),
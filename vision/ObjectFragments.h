@@ -52,12 +52,14 @@ public:
     void init(float s);
 
     void newRun(int x, int endY, int height);
+    int getNumberOfRuns() { return numberOfRuns; }
 
     // scan operations
     int yProject(int startx, int starty, int newy);
     int yProject(point <int> point, int newy);
     int xProject(int startx, int starty, int newx);
     int xProject(point <int> point, int newx);
+    bool unsheared(int span);
     void vertScan(int x, int y, int dir, int stopper, int c, int c2, stop & scan);
     void horizontalScan(int x, int y, int dir, int stopper, int c, int c2, int l,
                         int r, stop & scan);
@@ -80,24 +82,24 @@ public:
     void createObject();
 
     // miscelaneous goal processing  methods
-    bool qualityPost(Blob b, int c);
-    bool checkSize(Blob b, int c);
+    bool qualityPost(const Blob& b, int c);
+    bool checkSize(const Blob& b, int c);
     int getBigRun(int left, int right);
-    bool updateObject(VisualFieldObject* a, Blob b, certainty _certainty,
-                      distanceCertainty _distCertainty);
-    distanceCertainty checkDist(Blob pole);
+    bool updateObject(VisualFieldObject* a, const Blob& b,
+                      certainty _certainty, distanceCertainty _distCertainty);
+    distanceCertainty checkDist(const Blob& pole);
 
     // post recognition routines
-    int classifyByCrossbar(Blob b);
+    int classifyByCrossbar(const Blob& b);
     int classifyByOtherRuns(int left, int right, int height);
-    int classifyByLineIntersection(Blob b);
-    int classifyByCheckingCorners(Blob b);
+    int classifyByLineIntersection(const Blob& b);
+    int classifyByCheckingCorners(const Blob& b);
 
-    int characterizeSize(Blob b);
+    int characterizeSize(const Blob& b);
 
     int classifyFirstPost(int c, int c2,
                           VisualFieldObject* left, VisualFieldObject* right,
-                          VisualCrossbar* mid, Blob pole);
+                          VisualCrossbar* mid, const Blob& pole);
 
     // the big kahuna
     void goalScan(VisualFieldObject *left, VisualFieldObject *right,
@@ -108,31 +110,31 @@ public:
                          distanceCertainty dc);
 
     // sanity checks
-    bool rightBlobColor(Blob obj, float per);
-    bool postBigEnough(Blob b);
+    bool rightBlobColor(const Blob& obj, float per);
+    bool postBigEnough(const Blob& b);
     bool horizonBottomOk(int spanX, int spanY, int minHeight, int left, int right,
                          int bottom, int top);
     bool postRatiosOk(float ratio);
     bool secondPostFarEnough(point <int> l1, point <int> r1,
                              point <int> l2, point <int> r2, int p);
-    bool blobOk(Blob b);
-	bool badDistance(Blob b);
-    bool locationOk(Blob b);
+    bool blobOk(const Blob& b);
+	bool badDistance(const Blob& b);
+    bool locationOk(const Blob& b);
     bool relativeSizesOk(int x1, int y1, int s2, int y2, int t1, int t2, int f);
 
     // misc.
     int distance(int x1, int x2, int x3, int x4);
     float getSlope() { return slope; }
-	bool greenCheck(Blob b);
+	bool greenCheck(const Blob& b);
 
 
     // debugging methods
     void printObjs();
     void drawPoint(int x, int y, int c);
     void drawRect(int x, int y, int w, int h, int c);
-    void drawBlob(Blob b, int c);
+    void drawBlob(const Blob& b, int c);
     void drawLine(int x, int y, int x1, int y1, int c);
-    void printBlob(Blob b);
+    void printBlob(const Blob& b);
     void printObject(VisualFieldObject * objs);
     void paintRun(int x,int y, int h, int c);
     void drawRun(const run& run, int c);
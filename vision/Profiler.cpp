@@ -12,10 +12,14 @@ static const char *PCOMPONENT_NAMES[] = {
   "ThreshRuns",
   "Threshold",
   "FGHorizon",
+  "Horizon Track",
+  "Horizon Search",
   "Runs",
+  "Pyramid",
   "Object",
 
   "Lines",
+  "Track Lines",
   "Vert Lines",
   "Hor Lines",
   "Create Lines",
@@ -51,10 +55,14 @@ static const ProfiledComponent PCOMPONENT_SUB_ORDER[] = {
 	/*P_THRESHRUNS				--> */ P_VISION,
 	/*P_THRESHOLD				--> */ P_THRESHRUNS,
 	/*P_FGHORIZON				--> */ P_THRESHRUNS,
+	/*P_HORIZON_TRACK			--> */ P_FGHORIZON,
+	/*P_HORIZON_SEARCH			--> */ P_FGHORIZON,
 	/*P_RUNS					--> */ P_THRESHRUNS,
+	/*P_PYRAMID					--> */ P_THRESHRUNS,
 	/*P_OBJECT					--> */ P_VISION,
 
 	/*P_LINES					--> */ P_VISION,
+	/*P_TRACK_LINES,			--> */ P_LINES,
 	/*P_VERT_LINES,				--> */ P_LINES,
 	/*P_HOR_LINES,				--> */ P_LINES,
 	/*P_CREATE_LINES,			--> */ P_LINES,
@@ -115,7 +123,10 @@ static const ProfiledComponent PCOMPONENT_SUB_ORDER[] = {
  *
  * Some of this could probably be made easier by adding individual frame
  * counters for each component, but I think it's overhead and anything more
- * complicated should just use actual C++/gcc/gdb profiling.
+ * complicated should just use actual C++/gcc/gdb profiling.  We do count how
+ * many times each component is exited, though, since some (e.g. the horizon
+ * search) only run on some frames and an average per frame hides how much
+ * each run costs.
  *
  * That's all for now, folks.
  */
@@ -149,6 +160,8 @@ Profiler::reset ()
     enterTime[i] = 0;
     lastTime[i] = 0;
     sumTime[i] = 0;
+    lastCalls[i] = 0;
+    sumCalls[i] = 0;
   }
 }
 
@@ -175,6 +188,8 @@ Profiler::nextFrame() {
       for (int i = 0; i < NUM_PCOMPONENTS; i++) {
         sumTime[i] += lastTime[i];
         lastTime[i] = 0;
+        sumCalls[i] += lastCalls[i];
+        lastCalls[i] = 0;
       }
       // continue to the next frame
       current_frame++;
@@ -228,14 +243,18 @@ Profiler::printSummary ()
       printf("  %-*s:      0%% (0000000000us total, 000000us avg.)\n",
           (max_length-depths[i]*2), PCOMPONENT_NAMES[i]);
     else if (parent_sum == 0)
-      printf("  %-*s: 100.00%% (%.10llu total, %.6llu avg.)\n",
+      printf("  %-*s: 100.00%% (%.10llu total, %.6llu avg., %lld runs,"
+             " %.6llu per run)\n",
           (max_length-depths[i]*2), PCOMPONENT_NAMES[i], sumTime[i],
-          (sumTime[i] / (current_frame+1)));
+          (sumTime[i] / (current_frame+1)), sumCalls[i],
+          (sumTime[i] / (sumCalls[i] > 0 ? sumCalls[i] : 1)));
     else
-      printf("  %-*s: %6.2f%% (%.10llu total, %.6llu avg.)\n",
+      printf("  %-*s: %6.2f%% (%.10llu total, %.6llu avg., %lld runs,"
+             " %.6llu per run)\n",
           (max_length-depths[i]*2), PCOMPONENT_NAMES[i],
           ((float)sumTime[i] / parent_sum * 100), sumTime[i],
-          (sumTime[i] / (current_frame+1)));
+          (sumTime[i] / (current_frame+1)), sumCalls[i],
+          (sumTime[i] / (sumCalls[i] > 0 ? sumCalls[i] : 1)));
   }
 }
 
@@ -22,11 +22,15 @@ enum ProfiledComponent {
   P_THRESHRUNS,
   P_THRESHOLD,
   P_FGHORIZON,
+  P_HORIZON_TRACK,
+  P_HORIZON_SEARCH,
   P_RUNS,
+  P_PYRAMID,
   P_OBJECT,
 
   P_LINES,
 
+  P_TRACK_LINES,
   P_VERT_LINES,
   P_HOR_LINES,
   P_CREATE_LINES,
@@ -74,6 +78,7 @@ class Profiler {
     }
     inline bool exitComponent(ProfiledComponent c) {
       lastTime[c] = timeFunction() - enterTime[c];
+      lastCalls[c]++;
       return profiling;
     }
 
@@ -89,6 +94,10 @@ class Profiler {
     long long enterTime[NUM_PCOMPONENTS];
     long long lastTime[NUM_PCOMPONENTS];
     long long sumTime[NUM_PCOMPONENTS];
+    // how many times each component ran, for components that don't run
+    // exactly once a frame
+    int lastCalls[NUM_PCOMPONENTS];
+    long long sumCalls[NUM_PCOMPONENTS];
 };
 
 #endif
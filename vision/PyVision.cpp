@@ -151,22 +151,7 @@ PyPose_new (NaoPose *p)
     self = (PyPose *)PyPoseType.tp_alloc(&PyPoseType, 0);
     if (self != NULL) {
         self->pose = p;
-
-        self->leftHorizonY = PyInt_FromLong(p->getLeftHorizonY());
-        self->rightHorizonY = PyInt_FromLong(p->getRightHorizonY());
-        self->horizonSlope = PyFloat_FromDouble(p->getHorizonSlope());
-        self->bodyCenterHeight = PyFloat_FromDouble(p->getBodyCenterHeight());
-        //self->panAngle = PyFloat_FromDouble(p->getPan());
-		self->cameraInWorldFrameZ =
-			PyFloat_FromDouble(p->getFocalPointInWorldFrameZ());
-
-        if (self->leftHorizonY == NULL || self->rightHorizonY == NULL ||
-            self->horizonSlope == NULL //|| self->bodyCenterHeight == NULL ||
-            //self->panAngle == NULL
-            ) {
-            PyPose_dealloc(self);
-            self = NULL;
-        }
+        PyPose_update(self);
     }
 
     return (PyObject *)self;
@@ -175,22 +160,13 @@ PyPose_new (NaoPose *p)
 extern void
 PyPose_update (PyPose *self)
 {
-    Py_XDECREF(self->leftHorizonY);
-    self->leftHorizonY = PyInt_FromLong(self->pose->getLeftHorizonY());
-
-    Py_XDECREF(self->rightHorizonY);
-    self->rightHorizonY = PyInt_FromLong(self->pose->getRightHorizonY());
-
-    Py_XDECREF(self->horizonSlope);
-    self->horizonSlope = PyFloat_FromDouble(self->pose->getHorizonSlope());
+    self->leftHorizonY = self->pose->getLeftHorizonY();
+    self->rightHorizonY = self->pose->getRightHorizonY();
+    self->horizonSlope = self->pose->getHorizonSlope();
 
-	Py_XDECREF(self->cameraInWorldFrameZ);
 	self->cameraInWorldFrameZ =
-		PyFloat_FromDouble(self->pose->getFocalPointInWorldFrameZ());
-
-    Py_XDECREF(self->bodyCenterHeight);
-    self->bodyCenterHeight = PyFloat_FromDouble(
-        self->pose->getBodyCenterHeight());
+		self->pose->getFocalPointInWorldFrameZ();
+    self->bodyCenterHeight = self->pose->getBodyCenterHeight();
 
     //Py_XDECREF(self->panAngle);
     //self->panAngle = PyFloat_FromDouble(self->pose->getPan());
@@ -209,11 +185,6 @@ PyPose_new (PyTypeObject *type, PyObject *args, PyObject *kwds)
 extern void
 PyPose_dealloc (PyPose *self)
 {
-    Py_XDECREF(self->leftHorizonY);
-    Py_XDECREF(self->rightHorizonY);
-    Py_XDECREF(self->horizonSlope);
-    Py_XDECREF(self->bodyCenterHeight);
-	Py_XDECREF(self->cameraInWorldFrameZ);
 //Py_XDECREF(self->panAngle);
 
     self->ob_type->tp_free((PyObject *)self);
@@ -256,8 +227,8 @@ PyVisualCorner_new (PyFieldLines *fl, int i, const VisualCorner &corner)
 
         list<const ConcreteCorner*> possibilities = corner.getPossibleCorners();
 
-        self->dist = PyFloat_FromDouble(corner.getDistance());
-        self->bearing = PyFloat_FromDouble(corner.getBearingDeg());
+        self->dist = corner.getDistance();
+        self->bearing = corner.getBearingDeg();
 
         self->possibilities = PyList_New(possibilities.size());
         if (self->possibilities != NULL) {
@@ -269,8 +240,7 @@ PyVisualCorner_new (PyFieldLines *fl, int i, const VisualCorner &corner)
             }
         }
 
-        if (self->dist == NULL || self->bearing == NULL ||
-            self->possibilities == NULL) {
+        if (self->possibilities == NULL) {
             PyVisualCorner_dealloc(self);
             self = NULL;
         }
@@ -291,11 +261,8 @@ PyVisualCorner_new (PyFieldLines *fl, int i, const VisualCorner &corner)
 extern void
 PyVisualCorner_update (PyVisualCorner *self, const VisualCorner &corner)
 {
-    Py_XDECREF(self->dist);
-    self->dist = PyFloat_FromDouble(corner.getDistance());
-
-    Py_XDECREF(self->bearing);
-    self->bearing = PyFloat_FromDouble(corner.getBearingDeg());
+    self->dist = corner.getDistance();
+    self->bearing = corner.getBearingDeg();
 
     list<const ConcreteCorner*> possibilities = corner.getPossibleCorners();
     if (self->possibilities == NULL)
@@ -329,8 +296,6 @@ PyVisualCorner_new (PyTypeObject *type, PyObject *args, PyObject *kwds)
 extern void
 PyVisualCorner_dealloc (PyVisualCorner *self)
 {
-    Py_XDECREF(self->dist);
-    Py_XDECREF(self->bearing);
     Py_XDECREF(self->possibilities);
 
     self->ob_type->tp_free((PyObject*)self);
@@ -371,14 +336,9 @@ PyConcreteCorner_new (const ConcreteCorner *corner)
         &PyConcreteCornerType, 0);
     if (self != NULL) {
 
-        self->id = PyInt_FromLong(corner->getID());
-        self->fieldX = PyFloat_FromDouble(corner->getFieldX());
-        self->fieldY = PyFloat_FromDouble(corner->getFieldY());
-
-        if (self->id == NULL || self->fieldX == NULL || self->fieldY == NULL) {
-            PyConcreteCorner_dealloc(self);
-            self = NULL;
-        }
+        self->id = corner->getID();
+        self->fieldX = corner->getFieldX();
+        self->fieldY = corner->getFieldY();
     }
 
     return (PyObject *)self;
@@ -396,10 +356,6 @@ PyConcreteCorner_new (PyTypeObject *type, PyObject *args, PyObject *kwds)
 extern void
 PyConcreteCorner_dealloc (PyConcreteCorner *self)
 {
-    Py_XDECREF(self->id);
-    Py_XDECREF(self->fieldX);
-    Py_XDECREF(self->fieldY);
-
     self->ob_type->tp_free((PyObject*)self);
 }
 
@@ -427,18 +383,7 @@ PyVisualLine_new (PyFieldLines *fl, int i, shared_ptr<VisualLine> line)
         self->fl = fl;
         self->i = i;
 
-        self->x1 = PyInt_FromLong(line->start.x);
-        self->y1 = PyInt_FromLong(line->start.y);
-        self->x2 = PyInt_FromLong(line->end.x);
-        self->y2 = PyInt_FromLong(line->end.y);
-        self->slope = PyFloat_FromDouble(line->getSlope());
-        self->length = PyFloat_FromDouble(line->length);
-
-        if (self->x1 == NULL || self->y1 == NULL || self->x2 == NULL ||
-            self->y2 == NULL || self->slope == NULL || self->length == NULL) {
-            PyVisualLine_dealloc(self);
-            self = NULL;
-        }
+        PyVisualLine_update(self, line);
     }
 
     return (PyObject *)self;
@@ -454,23 +399,12 @@ PyVisualLine_update (PyVisualLine *self)
 extern void
 PyVisualLine_update (PyVisualLine *self, shared_ptr<VisualLine> line)
 {
-    Py_XDECREF(self->x1);
-    self->x1 = PyInt_FromLong(line->start.x);
-
-    Py_XDECREF(self->y1);
-    self->y1 = PyInt_FromLong(line->start.y);
-
-    Py_XDECREF(self->x2);
-    self->x2 = PyInt_FromLong(line->end.x);
-
-    Py_XDECREF(self->y2);
-    self->y2 = PyInt_FromLong(line->end.y);
-
-    Py_XDECREF(self->slope);
-    self->slope = PyFloat_FromDouble(line->getSlope());
-
-    Py_XDECREF(self->length);
-    self->length = PyFloat_FromDouble(line->length);
+    self->x1 = line->start.x;
+    self->y1 = line->start.y;
+    self->x2 = line->end.x;
+    self->y2 = line->end.y;
+    self->slope = line->getSlope();
+    self->length = line->length;
 }
 
 // backend methods
@@ -485,13 +419,6 @@ PyVisualLine_new (PyTypeObject *type, PyObject *args, PyObject *kwds)
 extern void
 PyVisualLine_dealloc (PyVisualLine *self)
 {
-    Py_XDECREF(self->x1);
-    Py_XDECREF(self->y1);
-    Py_XDECREF(self->x2);
-    Py_XDECREF(self->y2);
-    Py_XDECREF(self->slope);
-    Py_XDECREF(self->length);
-
     self->ob_type->tp_free((PyObject*)self);
 }
 
@@ -532,7 +459,7 @@ PyFieldLines_new (shared_ptr<FieldLines> fl)
 		const vector< shared_ptr<VisualLine> > *lines = fl->getLines();
 
         // Corners
-        self->numCorners = PyInt_FromLong(corners->size());
+        self->numCorners = corners->size();
         unsigned int i = 0;
         for (list<VisualCorner>::const_iterator c = corners->begin();
              c != corners->end(); c++,i++) {
@@ -553,7 +480,7 @@ PyFieldLines_new (shared_ptr<FieldLines> fl)
         }
 
         // Lines
-        self->numLines = PyInt_FromLong(lines->size());
+        self->numLines = lines->size();
         for (unsigned int i = 0; i < lines->size(); i++) {
             PyObject *l = PyVisualLine_new(self, i, lines->at(i));
             if (l != NULL)
@@ -571,8 +498,7 @@ PyFieldLines_new (shared_ptr<FieldLines> fl)
             }
         }
 
-        if (self->numCorners == NULL || self->numLines == NULL ||
-            self->corners == NULL || self->lines == NULL) {
+        if (self->corners == NULL || self->lines == NULL) {
             PyFieldLines_dealloc(self);
             self = NULL;
         }
@@ -587,10 +513,8 @@ PyFieldLines_update (PyFieldLines *self)
     const list<VisualCorner> *corners = self->fl->getCorners();
     const vector< shared_ptr<VisualLine> > *lines = self->fl->getLines();
 
-    Py_XDECREF(self->numCorners);
-    self->numCorners = PyInt_FromLong(corners->size());
-    Py_XDECREF(self->numLines);
-    self->numLines = PyInt_FromLong(lines->size());
+    self->numCorners = corners->size();
+    self->numLines = lines->size();
 
     // Update all the corners, adding new ones if necessary
     unsigned int i = 0;
@@ -637,8 +561,6 @@ PyFieldLines_new (PyTypeObject *type, PyObject *args, PyObject *kwds)
 extern void
 PyFieldLines_dealloc (PyFieldLines *self)
 {
-    Py_XDECREF(self->numLines);
-    Py_XDECREF(self->numCorners);
     Py_XDECREF(self->lines);
     Py_XDECREF(self->corners);
 
@@ -673,8 +595,8 @@ PyThreshold_new (Threshold *t)
         self->thresh = t;
 
         // TODO - change to using actual image width
-        self->width = PyInt_FromLong(IMAGE_WIDTH);
-        self->height = PyInt_FromLong(IMAGE_HEIGHT);
+        self->width = IMAGE_WIDTH;
+        self->height = IMAGE_HEIGHT;
 
 #if 0//ROBOT(NAO)
         npy_intp dims[] = { IMAGE_HEIGHT, IMAGE_WIDTH };
@@ -689,11 +611,6 @@ PyThreshold_new (Threshold *t)
             NULL
             );
 #endif
-
-        if (self->width == NULL || self->height == NULL) {
-            PyThreshold_dealloc(self);
-            self = NULL;
-        }
     }
 
     return (PyObject *)self;
@@ -702,11 +619,8 @@ PyThreshold_new (Threshold *t)
 extern void
 PyThreshold_update (PyThreshold *self)
 {
-    Py_XDECREF(self->width);
-    self->width = PyInt_FromLong(IMAGE_WIDTH);
-
-    Py_XDECREF(self->height);
-    self->height = PyInt_FromLong(IMAGE_HEIGHT);
+    self->width = IMAGE_WIDTH;
+    self->height = IMAGE_HEIGHT;
 }
 
 // backend methods
@@ -721,8 +635,6 @@ PyThreshold_new (PyTypeObject *type, PyObject *args, PyObject *kwds)
 extern void
 PyThreshold_dealloc (PyThreshold *self)
 {
-    Py_XDECREF(self->width);
-    Py_XDECREF(self->height);
 
 #if 0//ROBOT(NAO)
     Py_XDECREF(self->thresholded);
@@ -785,26 +697,7 @@ PyBall_new (VisualBall *b)
     self = (PyBall *)PyBallType.tp_alloc(&PyBallType, 0);
     if (self != NULL) {
         self->ball = b;
-
-        self->centerX = PyInt_FromLong(b->getCenterX());
-        self->centerY = PyInt_FromLong(b->getCenterY());
-        self->width = PyFloat_FromDouble(b->getWidth());
-        self->height = PyFloat_FromDouble(b->getHeight());
-        self->focDist = PyFloat_FromDouble(b->getFocDist());
-        self->dist = PyFloat_FromDouble(b->getDistance());
-        self->bearing = PyFloat_FromDouble(b->getBearingDeg());
-        self->elevation = PyFloat_FromDouble(b->getElevationDeg());
-        self->confidence = PyInt_FromLong(b->getConfidence());
-
-        if (self->centerX == NULL || self->centerY == NULL ||
-            self->width == NULL || self->height == NULL ||
-            self->focDist == NULL || self->dist == NULL ||
-            self->bearing == NULL || self->elevation == NULL ||
-            self->confidence == NULL) {
-
-            PyBall_dealloc(self);
-            self = NULL;
-        }
+        PyBall_update(self);
     }
 
     return (PyObject *)self;
@@ -813,32 +706,15 @@ PyBall_new (VisualBall *b)
 extern void
 PyBall_update (PyBall *self)
 {
-    Py_XDECREF(self->centerX);
-    self->centerX = PyInt_FromLong(self->ball->getCenterX());
-
-    Py_XDECREF(self->centerY);
-    self->centerY = PyInt_FromLong(self->ball->getCenterY());
-
-    Py_XDECREF(self->width);
-    self->width = PyFloat_FromDouble(self->ball->getWidth());
-
-    Py_XDECREF(self->height);
-    self->height = PyFloat_FromDouble(self->ball->getHeight());
-
-    Py_XDECREF(self->focDist);
-    self->focDist = PyFloat_FromDouble(self->ball->getFocDist());
-
-    Py_XDECREF(self->dist);
-    self->dist = PyFloat_FromDouble(self->ball->getDistance());
-
-    Py_XDECREF(self->bearing);
-    self->bearing = PyFloat_FromDouble(self->ball->getBearingDeg());
-
-    Py_XDECREF(self->elevation);
-    self->elevation = PyFloat_FromDouble(self->ball->getElevationDeg());
-
-    Py_XDECREF(self->confidence);
-    self->confidence = PyInt_FromLong(self->ball->getConfidence());
+    self->centerX = self->ball->getCenterX();
+    self->centerY = self->ball->getCenterY();
+    self->width = self->ball->getWidth();
+    self->height = self->ball->getHeight();
+    self->focDist = self->ball->getFocDist();
+    self->dist = self->ball->getDistance();
+    self->bearing = self->ball->getBearingDeg();
+    self->elevation = self->ball->getElevationDeg();
+    self->confidence = self->ball->getConfidence();
 }
 
 // backend methods
@@ -856,15 +732,6 @@ PyBall_dealloc (PyBall *self)
     if (self == NULL)
         return;
 
-    Py_XDECREF(self->centerX);
-    Py_XDECREF(self->centerY);
-    Py_XDECREF(self->width);
-    Py_XDECREF(self->height);
-    Py_XDECREF(self->focDist);
-    Py_XDECREF(self->dist);
-    Py_XDECREF(self->bearing);
-    Py_XDECREF(self->elevation);
-    Py_XDECREF(self->confidence);
     self->ob_type->tp_free((PyObject*)self);
 }
 
@@ -894,26 +761,7 @@ PyFieldObject_new (VisualFieldObject *o)
     self = (PyFieldObject *)PyFieldObjectType.tp_alloc(&PyFieldObjectType, 0);
     if (self != NULL) {
         self->object = o;
-
-        self->centerX = PyInt_FromLong(o->getCenterX());
-        self->centerY = PyInt_FromLong(o->getCenterY());
-        self->width = PyFloat_FromDouble(o->getWidth());
-        self->height = PyFloat_FromDouble(o->getHeight());
-        self->focDist = PyFloat_FromDouble(o->getFocDist());
-        self->dist = PyFloat_FromDouble(o->getDistance());
-        self->bearing = PyFloat_FromDouble(o->getBearingDeg());
-        self->certainty = PyInt_FromLong(o->getIDCertainty());
-        self->distCertainty = PyInt_FromLong(o->getDistanceCertainty());
-
-        if (self->centerX == NULL || self->centerY == NULL ||
-            self->width == NULL || self->height == NULL ||
-            self->focDist == NULL || self->dist == NULL ||
-            self->bearing == NULL || self->certainty == NULL ||
-            self->distCertainty == NULL) {
-
-            PyFieldObject_dealloc(self);
-            self = NULL;
-        }
+        PyFieldObject_update(self);
     }
 
     return (PyObject *)self;
@@ -922,32 +770,15 @@ PyFieldObject_new (VisualFieldObject *o)
 extern void
 PyFieldObject_update (PyFieldObject *self)
 {
-    Py_XDECREF(self->centerX);
-    self->centerX = PyInt_FromLong(self->object->getCenterX());
-
-    Py_XDECREF(self->centerY);
-    self->centerY = PyInt_FromLong(self->object->getCenterY());
-
-    Py_XDECREF(self->width);
-    self->width = PyFloat_FromDouble(self->object->getWidth());
-
-    Py_XDECREF(self->height);
-    self->height = PyFloat_FromDouble(self->object->getHeight());
-
-    Py_XDECREF(self->focDist);
-    self->focDist = PyFloat_FromDouble(self->object->getFocDist());
-
-    Py_XDECREF(self->dist);
-    self->dist = PyFloat_FromDouble(self->object->getDistance());
-
-    Py_XDECREF(self->bearing);
-    self->bearing = PyFloat_FromDouble(self->object->getBearingDeg());
-
-    Py_XDECREF(self->certainty);
-    self->certainty = PyInt_FromLong(self->object->getIDCertainty());
-
-    Py_XDECREF(self->distCertainty);
-    self->distCertainty = PyInt_FromLong(self->object->getDistanceCertainty());
+    self->centerX = self->object->getCenterX();
+    self->centerY = self->object->getCenterY();
+    self->width = self->object->getWidth();
+    self->height = self->object->getHeight();
+    self->focDist = self->object->getFocDist();
+    self->dist = self->object->getDistance();
+    self->bearing = self->object->getBearingDeg();
+    self->certainty = self->object->getIDCertainty();
+    self->distCertainty = self->object->getDistanceCertainty();
 }
 
 // backend methods
@@ -965,15 +796,6 @@ PyFieldObject_dealloc (PyFieldObject *self)
     if (self == NULL)
         return;
 
-    Py_XDECREF(self->centerX);
-    Py_XDECREF(self->centerY);
-    Py_XDECREF(self->width);
-    Py_XDECREF(self->height);
-    Py_XDECREF(self->focDist);
-    Py_XDECREF(self->dist);
-    Py_XDECREF(self->bearing);
-    Py_XDECREF(self->certainty);
-    Py_XDECREF(self->distCertainty);
     self->ob_type->tp_free((PyObject*)self);
 }
 
@@ -1003,8 +825,8 @@ PyVision_new (Vision *v)
 
         //self->width = PyInt_FromLong(v->getWidth());
         //self->height = PyInt_FromLong(v->getHeight());
-        self->width = PyInt_FromLong(IMAGE_WIDTH);
-        self->height = PyInt_FromLong(IMAGE_HEIGHT);
+        self->width = IMAGE_WIDTH;
+        self->height = IMAGE_HEIGHT;
 
         self->bgrp = PyFieldObject_new(v->bgrp);
         self->bglp = PyFieldObject_new(v->bglp);
@@ -1026,8 +848,7 @@ PyVision_new (Vision *v)
         self->fieldLines = PyFieldLines_new(v->fieldLines);
         self->pose = PyPose_new(v->pose.get());
 
-        if (self->width == NULL      || self->height == NULL ||
-            self->bgrp == NULL       || self->bglp == NULL   ||
+        if (self->bgrp == NULL       || self->bglp == NULL   ||
             self->ygrp == NULL       || self->yglp == NULL   ||
 
             self->bgCrossbar == NULL || self->ygCrossbar == NULL ||
@@ -1088,8 +909,6 @@ PyVision_dealloc (PyVision* self)
     if (self == NULL)
         return;
 
-    Py_XDECREF(self->width);
-    Py_XDECREF(self->height);
     Py_XDECREF(self->bgrp);
     Py_XDECREF(self->bglp);
     Py_XDECREF(self->ygrp);
@@ -1384,31 +1203,7 @@ extern PyObject * PyCrossbar_new (VisualCrossbar *b)
     self = (PyCrossbar *)PyCrossbarType.tp_alloc(&PyCrossbarType, 0);
     if (self != NULL) {
         self->crossbar = b;
-
-        self->x = PyInt_FromLong(b->getX());
-        self->y = PyInt_FromLong(b->getY());
-        self->centerX = PyInt_FromLong(b->getCenterX());
-        self->centerY = PyInt_FromLong(b->getCenterY());
-        self->angleX = PyFloat_FromDouble(b->getAngleXDeg());
-        self->angleY = PyFloat_FromDouble(b->getAngleYDeg());
-        self->width = PyFloat_FromDouble(b->getWidth());
-        self->height = PyFloat_FromDouble(b->getHeight());
-        self->focDist = PyFloat_FromDouble(b->getFocDist());
-        self->dist = PyFloat_FromDouble(b->getDistance());
-        self->bearing = PyFloat_FromDouble(b->getBearingDeg());
-        self->elevation = PyFloat_FromDouble(b->getElevationDeg());
-        self->leftOpening = PyFloat_FromDouble(b->getLeftOpening());
-        self->rightOpening = PyFloat_FromDouble(b->getRightOpening());
-        self->shoot = PyInt_FromLong(b->shotAvailable());
-
-        if (self->centerX == NULL || self->centerY == NULL ||
-            self->width == NULL || self->height == NULL ||
-            self->focDist == NULL || self->dist == NULL ||
-            self->bearing == NULL || self->elevation == NULL) {
-
-            PyCrossbar_dealloc(self);
-            self = NULL;
-        }
+        PyCrossbar_update(self);
     }
 
     return (PyObject *)self;
@@ -1416,51 +1211,21 @@ extern PyObject * PyCrossbar_new (VisualCrossbar *b)
 
 extern void PyCrossbar_update (PyCrossbar *self)
 {
-    Py_XDECREF(self->x);
-    self->x = PyInt_FromLong(self->crossbar->getX());
-
-    Py_XDECREF(self->y);
-    self->y = PyInt_FromLong(self->crossbar->getY());
-
-    Py_XDECREF(self->centerX);
-    self->centerX = PyInt_FromLong(self->crossbar->getCenterX());
-
-    Py_XDECREF(self->centerY);
-    self->centerY = PyInt_FromLong(self->crossbar->getCenterY());
-
-    Py_XDECREF(self->angleX);
-    self->angleX = PyFloat_FromDouble(self->crossbar->getAngleXDeg());
-
-    Py_XDECREF(self->angleX);
-    self->angleY = PyFloat_FromDouble(self->crossbar->getAngleYDeg());
-
-    Py_XDECREF(self->width);
-    self->width = PyFloat_FromDouble(self->crossbar->getWidth());
-
-    Py_XDECREF(self->height);
-    self->height = PyFloat_FromDouble(self->crossbar->getHeight());
-
-    Py_XDECREF(self->focDist);
-    self->focDist = PyFloat_FromDouble(self->crossbar->getFocDist());
-
-    Py_XDECREF(self->dist);
-    self->dist = PyFloat_FromDouble(self->crossbar->getDistance());
-
-    Py_XDECREF(self->bearing);
-    self->bearing = PyFloat_FromDouble(self->crossbar->getBearingDeg());
-
-    Py_XDECREF(self->elevation);
-    self->elevation = PyFloat_FromDouble(self->crossbar->getElevationDeg());
-
-    Py_XDECREF(self->leftOpening);
-    self->leftOpening = PyInt_FromLong(self->crossbar->getLeftOpening());
-
-    Py_XDECREF(self->rightOpening);
-    self->rightOpening = PyInt_FromLong(self->crossbar->getRightOpening());
-
-    Py_XDECREF(self->shoot);
-    self->shoot = PyInt_FromLong(self->crossbar->shotAvailable());
-
+    self->x = self->crossbar->getX();
+    self->y = self->crossbar->getY();
+    self->centerX = self->crossbar->getCenterX();
+    self->centerY = self->crossbar->getCenterY();
+    self->angleX = self->crossbar->getAngleXDeg();
+    self->angleY = self->crossbar->getAngleYDeg();
+    self->width = self->crossbar->getWidth();
+    self->height = self->crossbar->getHeight();
+    self->focDist = self->crossbar->getFocDist();
+    self->dist = self->crossbar->getDistance();
+    self->bearing = self->crossbar->getBearingDeg();
+    self->elevation = self->crossbar->getElevationDeg();
+    self->leftOpening = self->crossbar->getLeftOpening();
+    self->rightOpening = self->crossbar->getRightOpening();
+    self->shoot = self->crossbar->shotAvailable();
 }
 
 // backend methods
@@ -1503,28 +1268,7 @@ extern PyObject * PyVisualRobot_new (VisualRobot *b)
     self = (PyVisualRobot *)PyVisualRobotType.tp_alloc(&PyVisualRobotType, 0);
     if (self != NULL) {
         self->robot = b;
-
-        self->x = PyInt_FromLong(b->getX());
-        self->y = PyInt_FromLong(b->getY());
-        self->centerX = PyInt_FromLong(b->getCenterX());
-        self->centerY = PyInt_FromLong(b->getCenterY());
-        self->angleX = PyFloat_FromDouble(b->getAngleXDeg());
-        self->angleY = PyFloat_FromDouble(b->getAngleYDeg());
-        self->width = PyFloat_FromDouble(b->getWidth());
-        self->height = PyFloat_FromDouble(b->getHeight());
-        self->focDist = PyFloat_FromDouble(b->getFocDist());
-        self->dist = PyFloat_FromDouble(b->getDistance());
-        self->bearing = PyFloat_FromDouble(b->getBearingDeg());
-        self->elevation = PyFloat_FromDouble(b->getElevationDeg());
-
-        if (self->centerX == NULL || self->centerY == NULL ||
-            self->width == NULL || self->height == NULL ||
-            self->focDist == NULL || self->dist == NULL ||
-            self->bearing == NULL || self->elevation == NULL) {
-
-            PyVisualRobot_dealloc(self);
-            self = NULL;
-        }
+        PyVisualRobot_update(self);
     }
 
     return (PyObject *)self;
@@ -1532,41 +1276,18 @@ extern PyObject * PyVisualRobot_new (VisualRobot *b)
 
 extern void PyVisualRobot_update (PyVisualRobot *self)
 {
-    Py_XDECREF(self->x);
-    self->x = PyInt_FromLong(self->robot->getX());
-
-    Py_XDECREF(self->y);
-    self->y = PyInt_FromLong(self->robot->getY());
-
-    Py_XDECREF(self->centerX);
-    self->centerX = PyInt_FromLong(self->robot->getCenterX());
-
-    Py_XDECREF(self->centerY);
-    self->centerY = PyInt_FromLong(self->robot->getCenterY());
-
-    Py_XDECREF(self->angleX);
-    self->angleX = PyFloat_FromDouble(self->robot->getAngleXDeg());
-
-    Py_XDECREF(self->angleX);
-    self->angleY = PyFloat_FromDouble(self->robot->getAngleYDeg());
-
-    Py_XDECREF(self->width);
-    self->width = PyFloat_FromDouble(self->robot->getWidth());
-
-    Py_XDECREF(self->height);
-    self->height = PyFloat_FromDouble(self->robot->getHeight());
-
-    Py_XDECREF(self->focDist);
-    self->focDist = PyFloat_FromDouble(self->robot->getFocDist());
-
-    Py_XDECREF(self->dist);
-    self->dist = PyFloat_FromDouble(self->robot->getDistance());
-
-    Py_XDECREF(self->bearing);
-    self->bearing = PyFloat_FromDouble(self->robot->getBearingDeg());
-
-    Py_XDECREF(self->elevation);
-    self->elevation = PyFloat_FromDouble(self->robot->getElevationDeg());
+    self->x = self->robot->getX();
+    self->y = self->robot->getY();
+    self->centerX = self->robot->getCenterX();
+    self->centerY = self->robot->getCenterY();
+    self->angleX = self->robot->getAngleXDeg();
+    self->angleY = self->robot->getAngleYDeg();
+    self->width = self->robot->getWidth();
+    self->height = self->robot->getHeight();
+    self->focDist = self->robot->getFocDist();
+    self->dist = self->robot->getDistance();
+    self->bearing = self->robot->getBearingDeg();
+    self->elevation = self->robot->getElevationDeg();
 }
 
 // backend methods
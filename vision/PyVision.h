@@ -30,6 +30,13 @@
 #define offsetof_in_object(OBJECT, MEMBER)                  \
     ((size_t) ((char *)&(OBJECT.MEMBER) - (char*)&OBJECT))
 
+/*
+  Attributes that are plain numbers are kept as C ints and floats in the
+  wrapper objects and exposed as T_INT and T_FLOAT members, so Python only
+  builds an int or float for the attributes a behavior actually reads.
+  Updating a wrapper each frame copies numbers and allocates nothing.
+*/
+
 
 
 //
@@ -42,12 +49,12 @@ typedef struct PyPose_t {
     NaoPose *pose;
 
     // Horizon y coordinates
-    PyObject *leftHorizonY, *rightHorizonY;
+    int leftHorizonY, rightHorizonY;
     // Slope of the horizon line
-    PyObject *horizonSlope;
-	PyObject *cameraInWorldFrameZ;
+    float horizonSlope;
+	float cameraInWorldFrameZ;
     // Height of body in space
-    PyObject *bodyCenterHeight;
+    float bodyCenterHeight;
     // Angle of head to body
     //PyObject *panAngle;
 } PyPose;
@@ -77,15 +84,15 @@ static PyMethodDef PyPose_methods[] = {
 // Member list
 static PyMemberDef PyPose_members[] = {
 
-    {"leftHorizonY", T_OBJECT_EX, offsetof(PyPose, leftHorizonY), READONLY,
+    {"leftHorizonY", T_INT, offsetof(PyPose, leftHorizonY), READONLY,
      "Left horizon y coordinate"},
-    {"rightHorizonY", T_OBJECT_EX, offsetof(PyPose, rightHorizonY), READONLY,
+    {"rightHorizonY", T_INT, offsetof(PyPose, rightHorizonY), READONLY,
      "Right horizon y coordinate"},
-    {"horizonSlope", T_OBJECT_EX, offsetof(PyPose, horizonSlope), READONLY,
+    {"horizonSlope", T_FLOAT, offsetof(PyPose, horizonSlope), READONLY,
      "Slope of the horizon line"},
-	{"cameraInWorldFrameZ",T_OBJECT_EX, offsetof(PyPose, cameraInWorldFrameZ),
+	{"cameraInWorldFrameZ",T_FLOAT, offsetof(PyPose, cameraInWorldFrameZ),
 	 READONLY, "z coordinate of camera in global coord frame"},
-    {"bodyCenterHeight", T_OBJECT_EX, offsetof(PyPose, bodyCenterHeight),
+    {"bodyCenterHeight", T_FLOAT, offsetof(PyPose, bodyCenterHeight),
       READONLY, "Height of center of body in space"},
     //{"panAngle", T_OBJECT_EX, offsetof(PyPose, panAngle), READONLY,
     //   "Angle of the head to body"},
@@ -148,11 +155,11 @@ typedef struct PyFieldLines_t {
     PyObject_HEAD
     boost::shared_ptr<FieldLines> fl;
 
-    PyObject *numLines;
+    int numLines;
     PyObject *lines;
     std::vector<PyObject*> raw_corners;
 
-    PyObject *numCorners;
+    int numCorners;
     PyObject *corners;
     std::vector<PyObject*> raw_lines;
 
@@ -198,7 +205,7 @@ static PyMethodDef PyFieldLines_methods[] = {
 // Member list
 static PyMemberDef PyFieldLines_members[] = {
 
-    {"numLines", T_OBJECT_EX, offsetof_in_object(dummy_fieldlines, numLines),
+    {"numLines", T_INT, offsetof_in_object(dummy_fieldlines, numLines),
      READONLY,
      "The number of lines detected in the current image"},
     {"lines", T_OBJECT_EX, offsetof_in_object(dummy_fieldlines, lines),
@@ -206,7 +213,7 @@ static PyMemberDef PyFieldLines_members[] = {
      "List of lines in the image.  Note, the list contains references to\n"
      "MAX_FIELD_LINES Line objects.  Only the first `numLines' lines\n"
      "reflect accurate updated values of lines currently seen."},
-    {"numCorners", T_OBJECT_EX, offsetof_in_object(dummy_fieldlines, numCorners),
+    {"numCorners", T_INT, offsetof_in_object(dummy_fieldlines, numCorners),
      READONLY,
      "The Number of corners detected in the current image"},
     {"corners", T_OBJECT_EX, offsetof_in_object(dummy_fieldlines, corners),
@@ -275,8 +282,8 @@ typedef struct PyVisualCorner_t {
     int i;
     // Visual x and y coordinates (not included for now)
     // PyObject *x, *y;
-    // Distance and bearing objects
-    PyObject *dist, *bearing;
+    // Distance and bearing
+    float dist, bearing;
     // Certainty objects (not included for now)
     //PyObject *distCert, *idCert;
     // List of possible ConcreteCorner's
@@ -315,9 +322,9 @@ static PyMethodDef PyVisualCorner_methods[] = {
 // Member list
 static PyMemberDef PyVisualCorner_members[] = {
 
-    {"dist", T_OBJECT_EX, offsetof(PyVisualCorner, dist), READONLY,
+    {"dist", T_FLOAT, offsetof(PyVisualCorner, dist), READONLY,
      "Distance to the center of the corner"},
-    {"bearing", T_OBJECT_EX, offsetof(PyVisualCorner, bearing), READONLY,
+    {"bearing", T_FLOAT, offsetof(PyVisualCorner, bearing), READONLY,
      "Bearing to the center of the corner"},
     {"possibilities", T_OBJECT_EX, offsetof(PyVisualCorner, possibilities),
      READONLY,
@@ -383,9 +390,9 @@ typedef struct PyConcreteCorner_t {
     PyFieldLines *fl;
 
     // The id of this corner, out of all corners
-    PyObject *id;
+    int id;
     // Concrete x and y coordinates (localization-wise)
-    PyObject *fieldX, *fieldY;
+    float fieldX, fieldY;
 
 } PyConcreteCorner;
 
@@ -399,11 +406,11 @@ extern void      PyConcreteCorner_dealloc(PyConcreteCorner *self);
 // Member list
 static PyMemberDef PyConcreteCorner_members[] = {
 
-    {"id", T_OBJECT_EX, offsetof(PyConcreteCorner, id), READONLY,
+    {"id", T_INT, offsetof(PyConcreteCorner, id), READONLY,
      "The unique ID of this ConcreteCorner."},
-    {"fieldX", T_OBJECT_EX, offsetof(PyConcreteCorner, fieldX), READONLY,
+    {"fieldX", T_FLOAT, offsetof(PyConcreteCorner, fieldX), READONLY,
      "Field x coordinate of the location of this ConcreteCorner."},
-    {"fieldY", T_OBJECT_EX, offsetof(PyConcreteCorner, fieldY), READONLY,
+    {"fieldY", T_FLOAT, offsetof(PyConcreteCorner, fieldY), READONLY,
      "Field y coordinate of the location of this ConcreteCorner."},
 
     /* Sentinel */
@@ -467,9 +474,9 @@ typedef struct PyVisualLine_t {
     // The index of this VisualLine in FieldLines.getLines()
     unsigned int i;
     // X and Y coordinates
-    PyObject *x1, *y1, *x2, *y2;
+    int x1, y1, x2, y2;
     // Line slope and length
-    PyObject *slope, *length;
+    float slope, length;
 
 } PyVisualLine;
 
@@ -506,17 +513,17 @@ static PyMethodDef PyVisualLine_methods[] = {
 // Member list
 static PyMemberDef PyVisualLine_members[] = {
 
-    {"x1", T_OBJECT_EX, offsetof(PyVisualLine, x1), READONLY,
+    {"x1", T_INT, offsetof(PyVisualLine, x1), READONLY,
      "First x coordinate"},
-    {"y1", T_OBJECT_EX, offsetof(PyVisualLine, y1), READONLY,
+    {"y1", T_INT, offsetof(PyVisualLine, y1), READONLY,
      "First y coordinate"},
-    {"x2", T_OBJECT_EX, offsetof(PyVisualLine, x2), READONLY,
+    {"x2", T_INT, offsetof(PyVisualLine, x2), READONLY,
      "Second x coordinate"},
-    {"y2", T_OBJECT_EX, offsetof(PyVisualLine, y2), READONLY,
+    {"y2", T_INT, offsetof(PyVisualLine, y2), READONLY,
      "Second x coordinate"},
-    {"slope", T_OBJECT_EX, offsetof(PyVisualLine, slope), READONLY,
+    {"slope", T_FLOAT, offsetof(PyVisualLine, slope), READONLY,
      "Line slope"},
-    {"length", T_OBJECT_EX, offsetof(PyVisualLine, length), READONLY,
+    {"length", T_FLOAT, offsetof(PyVisualLine, length), READONLY,
      "Line length"},
 
     /* Sentinel */
@@ -576,8 +583,8 @@ static PyTypeObject PyVisualLineType = {
 typedef struct PyThreshold_t {
     PyObject_HEAD
     Threshold *thresh;
-    PyObject *width;
-    PyObject *height;
+    int width;
+    int height;
 #if ROBOT(NAO)
     PyObject *thresholded;
 #endif
@@ -616,9 +623,9 @@ static PyMethodDef PyThreshold_methods[] = {
 // Member list
 static PyMemberDef PyThreshold_members[] = {
 
-    {"width", T_OBJECT_EX, offsetof(PyThreshold, width), READONLY,
+    {"width", T_INT, offsetof(PyThreshold, width), READONLY,
      "Image width"},
-    {"height", T_OBJECT_EX, offsetof(PyThreshold, height), READONLY,
+    {"height", T_INT, offsetof(PyThreshold, height), READONLY,
      "Image height"},
 #if ROBOT(NAO)
     {"thresholded", T_OBJECT_EX, offsetof(PyThreshold, thresholded), READONLY,
@@ -682,15 +689,15 @@ static PyTypeObject PyThresholdType = {
 typedef struct PyBall_t {
     PyObject_HEAD
     VisualBall *ball;
-    PyObject *centerX;
-    PyObject *centerY;
-    PyObject *width;
-    PyObject *height;
-    PyObject *focDist;
-    PyObject *dist;
-    PyObject *bearing;
-    PyObject *elevation;
-    PyObject *confidence;
+    int centerX;
+    int centerY;
+    float width;
+    float height;
+    float focDist;
+    float dist;
+    float bearing;
+    float elevation;
+    int confidence;
 } PyBall;
 
 // C++ - accessible interface
@@ -716,23 +723,23 @@ static PyMethodDef PyBall_methods[] = {
 // Member list
 static PyMemberDef PyBall_members[] = {
 
-    {"centerX", T_OBJECT_EX, offsetof(PyBall, centerX), READONLY,
+    {"centerX", T_INT, offsetof(PyBall, centerX), READONLY,
      "Ball center X coordinate"},
-    {"centerY", T_OBJECT_EX, offsetof(PyBall, centerY), READONLY,
+    {"centerY", T_INT, offsetof(PyBall, centerY), READONLY,
      "Ball center Y coordinate"},
-    {"width", T_OBJECT_EX, offsetof(PyBall, width), READONLY,
+    {"width", T_FLOAT, offsetof(PyBall, width), READONLY,
      "Ball width"},
-    {"height", T_OBJECT_EX, offsetof(PyBall, height), READONLY,
+    {"height", T_FLOAT, offsetof(PyBall, height), READONLY,
      "Ball height"},
-    {"focDist", T_OBJECT_EX, offsetof(PyBall, focDist), READONLY,
+    {"focDist", T_FLOAT, offsetof(PyBall, focDist), READONLY,
      "Ball focal distance"},
-    {"dist", T_OBJECT_EX, offsetof(PyBall, dist), READONLY,
+    {"dist", T_FLOAT, offsetof(PyBall, dist), READONLY,
      "Ball linear distance"},
-    {"bearing", T_OBJECT_EX, offsetof(PyBall, bearing), READONLY,
+    {"bearing", T_FLOAT, offsetof(PyBall, bearing), READONLY,
      "Ball bearing to body"},
-    {"elevation", T_OBJECT_EX, offsetof(PyBall, elevation), READONLY,
+    {"elevation", T_FLOAT, offsetof(PyBall, elevation), READONLY,
      "Ball elevation"},
-    {"confidence", T_OBJECT_EX, offsetof(PyBall, confidence), READONLY,
+    {"confidence", T_INT, offsetof(PyBall, confidence), READONLY,
      "Ball confidence (that it exists)"},
 
     /* Sentinal */
@@ -792,15 +799,15 @@ static PyTypeObject PyBallType = {
 typedef struct PyFieldObject_t {
     PyObject_HEAD
     VisualFieldObject *object;
-    PyObject *centerX;
-    PyObject *centerY;
-    PyObject *width;
-    PyObject *height;
-    PyObject *focDist;
-    PyObject *dist;
-    PyObject *bearing;
-    PyObject *certainty;
-    PyObject *distCertainty;
+    int centerX;
+    int centerY;
+    float width;
+    float height;
+    float focDist;
+    float dist;
+    float bearing;
+    int certainty;
+    int distCertainty;
 } PyFieldObject;
 
 // C++ - accessible inteface
@@ -828,23 +835,23 @@ static PyMethodDef PyFieldObject_methods[] = {
 // Attribute list
 static PyMemberDef PyFieldObject_members[] = {
 
-    {"centerX", T_OBJECT_EX, offsetof(PyFieldObject, centerX), READONLY,
+    {"centerX", T_INT, offsetof(PyFieldObject, centerX), READONLY,
      "Object center X coordinate"},
-    {"centerY", T_OBJECT_EX, offsetof(PyFieldObject, centerY), READONLY,
+    {"centerY", T_INT, offsetof(PyFieldObject, centerY), READONLY,
      "Object center Y coordinate"},
-    {"width", T_OBJECT_EX, offsetof(PyFieldObject, width), READONLY,
+    {"width", T_FLOAT, offsetof(PyFieldObject, width), READONLY,
      "Object width"},
-    {"height", T_OBJECT_EX, offsetof(PyFieldObject, height), READONLY,
+    {"height", T_FLOAT, offsetof(PyFieldObject, height), READONLY,
      "Object height"},
-    {"focDist", T_OBJECT_EX, offsetof(PyFieldObject, focDist), READONLY,
+    {"focDist", T_FLOAT, offsetof(PyFieldObject, focDist), READONLY,
      "Object focal distance"},
-    {"dist", T_OBJECT_EX, offsetof(PyFieldObject, dist), READONLY,
+    {"dist", T_FLOAT, offsetof(PyFieldObject, dist), READONLY,
      "Object linear distance"},
-    {"bearing", T_OBJECT_EX, offsetof(PyFieldObject, bearing), READONLY,
+    {"bearing", T_FLOAT, offsetof(PyFieldObject, bearing), READONLY,
      "Object bearing to body"},
-    {"certainty", T_OBJECT_EX, offsetof(PyFieldObject, certainty), READONLY,
+    {"certainty", T_INT, offsetof(PyFieldObject, certainty), READONLY,
      "Object certainty (that it exists)"},
-    {"distCertainty", T_OBJECT_EX, offsetof(PyFieldObject, distCertainty),
+    {"distCertainty", T_INT, offsetof(PyFieldObject, distCertainty),
      READONLY, "Object distance certainty"},
 
     /* Sentinal */
@@ -902,8 +909,8 @@ static PyTypeObject PyFieldObjectType = {
 typedef struct PyVision_t {
     PyObject_HEAD
     Vision *vision;
-    PyObject *width;
-    PyObject *height;
+    int width;
+    int height;
 
     // Pose object
     PyObject *pose;
@@ -978,9 +985,9 @@ static PyMethodDef PyVision_methods[] = {
 static PyMemberDef PyVision_members[] = {
 
     // Direct attribute
-    {"width", T_OBJECT_EX, offsetof(PyVision, width), READONLY,
+    {"width", T_INT, offsetof(PyVision, width), READONLY,
      "Image width"},
-    {"height", T_OBJECT_EX, offsetof(PyVision, height), READONLY,
+    {"height", T_INT, offsetof(PyVision, height), READONLY,
      "Image height"},
 
     // Class reference attributes
@@ -1098,21 +1105,21 @@ PyMODINIT_FUNC MODULE_INIT(vision) (void);
 typedef struct PyCrossbar_t {
     PyObject_HEAD // Our stuff is below
     VisualCrossbar *crossbar;
-    PyObject *x;
-    PyObject *y;
-    PyObject *centerX;
-    PyObject *centerY;
-    PyObject *angleX;
-    PyObject *angleY;
-    PyObject *width;
-    PyObject *height;
-    PyObject *focDist;
-    PyObject *dist;
-    PyObject *bearing;
-    PyObject *elevation;
-    PyObject *leftOpening;
-    PyObject *rightOpening;
-    PyObject *shoot;
+    int x;
+    int y;
+    int centerX;
+    int centerY;
+    float angleX;
+    float angleY;
+    float width;
+    float height;
+    float focDist;
+    float dist;
+    float bearing;
+    float elevation;
+    float leftOpening;
+    float rightOpening;
+    int shoot;
 
 } PyCrossbar;
 
@@ -1138,35 +1145,35 @@ static PyMethodDef PyCrossbar_methods[] = {
 
 // Member list
 static PyMemberDef PyCrossbar_members[] = {
-    {"x", T_OBJECT_EX, offsetof(PyCrossbar, x), READONLY,
+    {"x", T_INT, offsetof(PyCrossbar, x), READONLY,
      "Crossbar screen X coordinate"},
-    {"y", T_OBJECT_EX, offsetof(PyCrossbar, y), READONLY,
+    {"y", T_INT, offsetof(PyCrossbar, y), READONLY,
      "Crossbar screen Y coordinate"},
-    {"centerX", T_OBJECT_EX, offsetof(PyCrossbar, centerX), READONLY,
+    {"centerX", T_INT, offsetof(PyCrossbar, centerX), READONLY,
      "Crossbar center X coordinate"},
-    {"centerY", T_OBJECT_EX, offsetof(PyCrossbar, centerY), READONLY,
+    {"centerY", T_INT, offsetof(PyCrossbar, centerY), READONLY,
      "Crossbar center Y coordinate"},
-    {"angleX", T_OBJECT_EX, offsetof(PyCrossbar, angleX), READONLY,
+    {"angleX", T_FLOAT, offsetof(PyCrossbar, angleX), READONLY,
      "Crossbar angleX"},
-    {"angleY", T_OBJECT_EX, offsetof(PyCrossbar, angleY), READONLY,
+    {"angleY", T_FLOAT, offsetof(PyCrossbar, angleY), READONLY,
      "Crossbar angleY"},
-    {"width", T_OBJECT_EX, offsetof(PyCrossbar, width), READONLY,
+    {"width", T_FLOAT, offsetof(PyCrossbar, width), READONLY,
      "Crossbar width"},
-    {"height", T_OBJECT_EX, offsetof(PyCrossbar, height), READONLY,
+    {"height", T_FLOAT, offsetof(PyCrossbar, height), READONLY,
      "Crossbar height"},
-    {"focDist", T_OBJECT_EX, offsetof(PyCrossbar, focDist), READONLY,
+    {"focDist", T_FLOAT, offsetof(PyCrossbar, focDist), READONLY,
      "Crossbar focal distance"},
-    {"dist", T_OBJECT_EX, offsetof(PyCrossbar, dist), READONLY,
+    {"dist", T_FLOAT, offsetof(PyCrossbar, dist), READONLY,
      "Crossbar linear distance"},
-    {"bearing", T_OBJECT_EX, offsetof(PyCrossbar, bearing), READONLY,
+    {"bearing", T_FLOAT, offsetof(PyCrossbar, bearing), READONLY,
      "Crossbar bearing to body"},
-    {"elevation", T_OBJECT_EX, offsetof(PyCrossbar, elevation), READONLY,
+    {"elevation", T_FLOAT, offsetof(PyCrossbar, elevation), READONLY,
      "Crossbar elevation"},
-    {"leftOpening", T_OBJECT_EX, offsetof(PyCrossbar, leftOpening), READONLY,
+    {"leftOpening", T_FLOAT, offsetof(PyCrossbar, leftOpening), READONLY,
      "Crossbar left opening"},
-    {"rightOpening", T_OBJECT_EX, offsetof(PyCrossbar, rightOpening), READONLY,
+    {"rightOpening", T_FLOAT, offsetof(PyCrossbar, rightOpening), READONLY,
      "Crossbar right opening"},
-    {"shoot", T_OBJECT_EX, offsetof(PyCrossbar, shoot), READONLY,
+    {"shoot", T_INT, offsetof(PyCrossbar, shoot), READONLY,
      "Crossbar shot available"},
 
     /* Sentinal */
@@ -1224,18 +1231,18 @@ static PyTypeObject PyCrossbarType = {
 typedef struct PyVisualRobot_t {
     PyObject_HEAD // Our stuff is below
     VisualRobot *robot;
-    PyObject *x;
-    PyObject *y;
-    PyObject *centerX;
-    PyObject *centerY;
-    PyObject *angleX;
-    PyObject *angleY;
-    PyObject *width;
-    PyObject *height;
-    PyObject *focDist;
-    PyObject *dist;
-    PyObject *bearing;
-    PyObject *elevation;
+    int x;
+    int y;
+    int centerX;
+    int centerY;
+    float angleX;
+    float angleY;
+    float width;
+    float height;
+    float focDist;
+    float dist;
+    float bearing;
+    float elevation;
 
 } PyVisualRobot;
 
@@ -1261,29 +1268,29 @@ static PyMethodDef PyVisualRobot_methods[] = {
 
 // Member list
 static PyMemberDef PyVisualRobot_members[] = {
-    {"x", T_OBJECT_EX, offsetof(PyVisualRobot, x), READONLY,
+    {"x", T_INT, offsetof(PyVisualRobot, x), READONLY,
      "VisualRobot screen X coordinate"},
-    {"y", T_OBJECT_EX, offsetof(PyVisualRobot, y), READONLY,
+    {"y", T_INT, offsetof(PyVisualRobot, y), READONLY,
      "VisualRobot screen Y coordinate"},
-    {"centerX", T_OBJECT_EX, offsetof(PyVisualRobot, centerX), READONLY,
+    {"centerX", T_INT, offsetof(PyVisualRobot, centerX), READONLY,
      "VisualRobot center X coordinate"},
-    {"centerY", T_OBJECT_EX, offsetof(PyVisualRobot, centerY), READONLY,
+    {"centerY", T_INT, offsetof(PyVisualRobot, centerY), READONLY,
      "VisualRobot center Y coordinate"},
-    {"angleX", T_OBJECT_EX, offsetof(PyVisualRobot, angleX), READONLY,
+    {"angleX", T_FLOAT, offsetof(PyVisualRobot, angleX), READONLY,
      "VisualRobot angleX"},
-    {"angleY", T_OBJECT_EX, offsetof(PyVisualRobot, angleY), READONLY,
+    {"angleY", T_FLOAT, offsetof(PyVisualRobot, angleY), READONLY,
      "VisualRobot angleY"},
-    {"width", T_OBJECT_EX, offsetof(PyVisualRobot, width), READONLY,
+    {"width", T_FLOAT, offsetof(PyVisualRobot, width), READONLY,
      "VisualRobot width"},
-    {"height", T_OBJECT_EX, offsetof(PyVisualRobot, height), READONLY,
+    {"height", T_FLOAT, offsetof(PyVisualRobot, height), READONLY,
      "VisualRobot height"},
-    {"focDist", T_OBJECT_EX, offsetof(PyVisualRobot, focDist), READONLY,
+    {"focDist", T_FLOAT, offsetof(PyVisualRobot, focDist), READONLY,
      "VisualRobot focal distance"},
-    {"dist", T_OBJECT_EX, offsetof(PyVisualRobot, dist), READONLY,
+    {"dist", T_FLOAT, offsetof(PyVisualRobot, dist), READONLY,
      "VisualRobot linear distance"},
-    {"bearing", T_OBJECT_EX, offsetof(PyVisualRobot, bearing), READONLY,
+    {"bearing", T_FLOAT, offsetof(PyVisualRobot, bearing), READONLY,
      "VisualRobot bearing to body"},
-    {"elevation", T_OBJECT_EX, offsetof(PyVisualRobot, elevation), READONLY,
+    {"elevation", T_FLOAT, offsetof(PyVisualRobot, elevation), READONLY,
      "VisualRobot elevation"},
     /* Sentinal */
     { NULL }
@@ -233,12 +233,24 @@ void Robots::robot(int bigGreen)
    around somewhere as befits our robots.
  */
 
-bool Robots::noWhite(Blob b) {
+bool Robots::noWhite(const Blob& b) {
 	const int MINWHITE = 5;
 
 	int left = b.getLeft(), right = b.getRight();
 	int top = b.getTop(), bottom = b.getBottom();
 	int width = b.width();
+#ifdef USE_COLOR_INTEGRALS
+	ColorCounts &counts = thresh->colorCounts;
+	for (int i = 1; i < 10; i++) {
+		if (counts.countRow(WHITE, top - i, left, right) > width / 2 ||
+			counts.countRow(WHITE, bottom + i, left, right) > width / 2)
+			return false;
+	}
+	// perhaps there is white inside (hands do this sometime)
+	for (int i = top; i <= bottom; i++) {
+		if (counts.countRow(WHITE, i, left, right) > width / 4) return false;
+	}
+#else
 	int tops, bottoms;
 	for (int i = 1; i < 10; i++) {
 		tops = 0; bottoms = 0;
@@ -260,6 +272,7 @@ bool Robots::noWhite(Blob b) {
 			if (tops > width / 4) return false;
 		}
 	}
+#endif
 	return true;
 }
 
@@ -478,7 +491,7 @@ void Robots::mergeBigBlobs()
  * TODO: write this
  */
 
-bool Robots::noGreen(Blob a, Blob b) {
+bool Robots::noGreen(const Blob& a, const Blob& b) {
 	// first determine where the blobs are relative to each other
 	// the way we create robot blobs means that blob a will always
 	// be to the left of blob b (or they will overlap)
@@ -576,7 +589,7 @@ bool Robots::checkHorizontal(int left, int right, int top, int bottom) {
 	but at high resolution.  Obviously it should be a constant.
  */
 
-bool Robots::closeEnough(Blob a, Blob b)
+bool Robots::closeEnough(const Blob& a, const Blob& b)
 {
     // EXAMINED: change constant to lower res stuff
     const int closeDistMax = 40;
@@ -598,7 +611,7 @@ bool Robots::closeEnough(Blob a, Blob b)
     at this stage.  And guesses at high rez to boot.
  */
 
-bool Robots::bigEnough(Blob a, Blob b)
+bool Robots::bigEnough(const Blob& a, const Blob& b)
 {
     // EXAMINED: change constant to lower res stuff // at half right now
     const int minBlobArea = 10;
@@ -619,7 +632,7 @@ bool Robots::bigEnough(Blob a, Blob b)
     @return    whether it meets our criteria
  */
 
-bool Robots::viableRobot(Blob a)
+bool Robots::viableRobot(const Blob& a)
 {
     const int blobPix = 10;
     const float blobAreaMin = 0.10f;
@@ -704,7 +717,7 @@ int Robots::distance(int x1, int x2, int x3, int x4) {
 /* Print debugging information for a blob.
  * @param b    the blob
  */
-void Robots::printBlob(Blob b) {
+void Robots::printBlob(const Blob& b) {
 #if defined OFFLINE
 /*    cout << "Outputting blob" << endl;
     cout << b.getLeftTopX() << " " << b.getLeftTopY() << " " << b.getRightTopX() << " "
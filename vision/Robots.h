@@ -41,24 +41,24 @@ public:
 	void preprocess();
 	void robot(int bg);
 	void expandRobotBlob(int which);
-	bool noWhite(Blob b);
+	bool noWhite(const Blob& b);
 	void expandHorizontally(int which, int dir);
 	int expandVertically(int which, int dir);
 	bool goodScan(int c, int w, int o, int g, int gr, int t);
 	void updateRobots(int w, int i);
 	void mergeBigBlobs();
-	bool closeEnough(Blob a, Blob b);
-	bool bigEnough(Blob a, Blob b);
-	bool noGreen(Blob a, Blob b);
+	bool closeEnough(const Blob& a, const Blob& b);
+	bool bigEnough(const Blob& a, const Blob& b);
+	bool noGreen(const Blob& a, const Blob& b);
 	bool checkHorizontal(int l, int r, int t, int b);
 	bool checkVertical(int l, int r, int t, int b);
-	bool viableRobot(Blob a);
+	bool viableRobot(const Blob& a);
 	void createObject();
 	void newRun(int x, int y, int h);
 	void setColor(int c);
 	void allocateColorRuns();
 	int distance(int x, int x1, int x2, int x3);
-	void printBlob(Blob a);
+	void printBlob(const Blob& a);
 
 private:
     // class pointers
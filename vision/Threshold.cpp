@@ -65,13 +65,33 @@ using boost::shared_ptr;
 
 // Constructor for Threshold class. passed an instance of Vision and Pose
 Threshold::Threshold(Vision* vis, shared_ptr<NaoPose> posPtr)
-    : vision(vis), pose(posPtr)
+    :
+    // These only keep the image's address; threshold() fills it in
+#ifdef USE_COLOR_INTEGRALS
+      colorCounts(&thresholded[0]),
+#endif
+#ifdef USE_CLASS_PYRAMID
+      pyramid(&thresholded[0]),
+#endif
+      vision(vis), pose(posPtr), table(ColorTable::blank()), pendingTable(0)
 {
 
     // storing locally
 #ifdef OFFLINE
     visualHorizonDebug = false;
 	debugSelf = true;
+    debugBallRoi = false;
+    debugComparePyramid = false;
+    pyramidSkips = 0;
+    pyramidMisses = 0;
+#endif
+    ballPredicted = false;
+    ballRoiActive = false;
+    crossesWanted = true;
+    numBallRescanRuns = 0;
+    ballRescanOverflow = false;
+#ifdef USE_COLOR_TABLE_PALETTE
+    table->buildPalette();
 #endif
 
     // loads the color table on the MS into memory
@@ -105,9 +125,17 @@ Threshold::Threshold(Vision* vis, shared_ptr<NaoPose> posPtr)
     }
 }
 
+Threshold::~Threshold()
+{
+    delete table;
+    delete pendingTable;
+}
+
 /* Main vision loop, called by Vision.cc
  */
 void Threshold::visionLoop() {
+    // drawing goes to the debug overlay until the frame is done
+    initDebugImage();
 
     // threshold image and create runs
     thresholdAndRuns();
@@ -140,6 +168,10 @@ void Threshold::visionLoop() {
     if (visualHorizonDebug) {
         drawVisualHorizon();
     }
+    if (debugBallRoi && ballRoiActive) {
+        drawBox(ballRoiLeft, ballRoiRight, ballRoiBottom, ballRoiTop,
+                BALL_ROI_COLOR);
+    }
     transposeDebugImage();
 #endif
 }
@@ -162,6 +194,15 @@ void Threshold::thresholdAndRuns() {
     threshold();
     PROF_EXIT(vision->profiler, P_THRESHOLD);
 
+#ifdef USE_COLOR_INTEGRALS
+    colorCounts.invalidate();
+#endif
+#ifdef USE_CLASS_PYRAMID
+    PROF_ENTER(vision->profiler, P_PYRAMID);
+    pyramid.build();
+    PROF_EXIT(vision->profiler, P_PYRAMID);
+#endif
+
 	initColors();
 
     // Determine where the field horizon is
@@ -189,22 +230,43 @@ void Threshold::threshold() {
     unsigned char *tPtr, *tEnd; // pointers into thresholded array
     const unsigned char *yPtr; // pointers into image array
 
+    // Take up a table swapped in since the last frame
+    ColorTable *next = __sync_lock_test_and_set(&pendingTable,
+                                                static_cast<ColorTable*>(0));
+    if (next != 0) {
+        delete table;
+        table = next;
+    }
+    const ColorTable *t = table;
+
     // My loop variable initializations
     yPtr = &yplane[0];
 
     tPtr = &thresholded[0][0];
     tEnd = &thresholded[IMAGE_HEIGHT-1][IMAGE_WIDTH-1] + 1;
 
+#ifdef USE_COLOR_TABLE_PALETTE
+	while (tPtr < tEnd)
+	{
+		const int u = yPtr[UOFFSET] >> 1;
+		const int v = yPtr[VOFFSET] >> 1;
+        *tPtr++ = t->paletteLookup(yPtr[YOFFSET1] >> 1, u, v);
+        *tPtr++ = t->paletteLookup(yPtr[YOFFSET2] >> 1, u, v);
+        yPtr += 4;
+	}
+#else
 	// Loop optimizations thanks to Bill Silver. Uses constant offesets to
-	// speed up the table lookups. Operates on bigTable in UVY order for
+	// speed up the table lookups. Operates on the table in UVY order for
 	// more optimizations.
 	while (tPtr < tEnd)
 	{
-		unsigned char* p = bigTable[yPtr[UOFFSET] >> 1][yPtr[VOFFSET] >> 1];
+		const unsigned char* p = t->row(yPtr[UOFFSET] >> 1,
+										yPtr[VOFFSET] >> 1);
         *tPtr++ = p[yPtr[YOFFSET1] >> 1];
         *tPtr++ = p[yPtr[YOFFSET2] >> 1];
         yPtr += 4;
 	}
+#endif
 }
 
 /* Image runs.  As explained in the comments for the threshold() method, I
@@ -215,16 +277,240 @@ void Threshold::threshold() {
  * We get a convex hull for the top, and look out for our own body parts for the
  * bottom.  The we scan a bit more intelligently for field objects (e.g.
  * balls will only be in the confines of the field).
+ * Before scanning a column we check a coarse version of the image, and leave
+ * out the scans that have none of their colors to find.
  */
 void Threshold::runs() {
   //detectSelf();
+    // when we know roughly where the ball should be only look hard there
+    findBallRoi();
+    numBallRescanRuns = 0;
+    ballRescanOverflow = false;
+#ifdef OFFLINE
+    pyramidSkips = 0;
+    pyramidMisses = 0;
+#endif
     // split up the loops
     for (int i = 0; i < IMAGE_WIDTH; i += 1) {
 		int topEdge = max(0, field->horizonAt(i));
-		findBallsCrosses(i, topEdge);
-		findGoals(i, topEdge);
+		const bool balls = scanBallColumn(i);
+		const bool scanBallsCrosses = (balls || crossesWanted) &&
+			needBallsCrosses(i, topEdge, balls, crossesWanted);
+		const bool scanGoals = needGoals(i);
+		ballRescanStart[i] = numBallRescanRuns;
+		ballColumnWalked[i] = scanBallsCrosses;
+#ifdef OFFLINE
+		if (debugComparePyramid) {
+			ballColumnWalked[i] = true;
+			comparePyramidColumn(i, topEdge, balls, scanBallsCrosses,
+								 scanGoals);
+			continue;
+		}
+#endif
+		if (scanBallsCrosses) {
+			findBallsCrosses(i, topEdge, balls, crossesWanted);
+		}
+		if (scanGoals) {
+			findGoals(i, topEdge);
+		}
     }
+    ballRescanStart[IMAGE_WIDTH] = numBallRescanRuns;
+#ifdef OFFLINE
+    if (debugComparePyramid) {
+		cout << "Pyramid skipped " << pyramidSkips << " of "
+			 << 2 * IMAGE_WIDTH << " column scans, " << pyramidMisses
+			 << " of them would have found runs" << endl;
+    }
+#endif
+}
 
+/* Could findBallsCrosses() find anything in this column?  It only makes runs
+ * out of ORANGE (and ORANGERED) and WHITE between the top edge and the
+ * lower bound, so if the pyramid has none of those there we can skip it.
+ * The scan only goes below the lower bound when the pixel at the bound is
+ * ORANGE, which the check already includes.
+ */
+bool Threshold::needBallsCrosses(int column, int topEdge, bool balls,
+								 bool crosses) {
+#ifdef USE_CLASS_PYRAMID
+	unsigned int mask = 0;
+	if (balls) {
+		mask |= ClassPyramid::bit(ORANGE) | ClassPyramid::bit(ORANGERED);
+	}
+	if (crosses) {
+		mask |= ClassPyramid::bit(WHITE);
+	}
+	return pyramid.columnHas(PYRAMID_SKIP_LEVEL, column,
+							 min(topEdge, lowerBound[column]),
+							 lowerBound[column], mask);
+#else
+	return true;
+#endif
+}
+
+/* Could findGoals() find anything in this column?  It needs more than ten
+ * BLUE or YELLOW pixels above the lower bound to make a run.
+ */
+bool Threshold::needGoals(int column) {
+#ifdef USE_CLASS_PYRAMID
+	return pyramid.columnHas(PYRAMID_SKIP_LEVEL, column, 0, lowerBound[column],
+							 ClassPyramid::bit(BLUE) | ClassPyramid::bit(YELLOW));
+#else
+	return true;
+#endif
+}
+
+#ifdef OFFLINE
+/* Run both full resolution scans on a column regardless of what the pyramid
+ * said, and complain about any scan that was going to be skipped but made
+ * runs.  With the checks above there should never be any.
+ */
+void Threshold::comparePyramidColumn(int column, int topEdge, bool balls,
+									 bool scanBallsCrosses, bool scanGoals) {
+	const int ballsCrossesBefore = orange->getNumberOfRuns() +
+		cross->getNumberOfRuns();
+	findBallsCrosses(column, topEdge, balls, crossesWanted);
+	if (!scanBallsCrosses) {
+		pyramidSkips++;
+		if (orange->getNumberOfRuns() + cross->getNumberOfRuns() !=
+			ballsCrossesBefore) {
+			pyramidMisses++;
+			cout << "Pyramid skipped ball/cross runs in column " << column
+				 << endl;
+		}
+	}
+
+	const int goalsBefore = blue->getNumberOfRuns() +
+		yellow->getNumberOfRuns();
+	findGoals(column, topEdge);
+	if (!scanGoals) {
+		pyramidSkips++;
+		if (blue->getNumberOfRuns() + yellow->getNumberOfRuns() !=
+			goalsBefore) {
+			pyramidMisses++;
+			cout << "Pyramid skipped goal runs in column " << column << endl;
+		}
+	}
+}
+#endif
+
+/* Hand over where the ball should be in the next image, as a distance and
+ * bearing from the body along with how far off that might be (all in cm).
+ * Each prediction is only used for one frame.
+ */
+void Threshold::setBallPrediction(float dist, float bearing, float uncert) {
+	ballPredicted = true;
+	predictedBallDist = dist;
+	predictedBallBearing = bearing;
+	predictedBallUncert = uncert;
+}
+
+/* Project the ball prediction into the image as a box of columns and rows
+ * in which the ball should show up.  Tracking is turned off if there is no
+ * fresh prediction, if it is too uncertain to narrow things down, or if
+ * the box is off screen.
+ */
+void Threshold::findBallRoi() {
+	ballRoiActive = false;
+#ifdef USE_BALL_ROI
+	if (!ballPredicted) {
+		return;
+	}
+	ballPredicted = false;
+
+	const float nearDist = predictedBallDist - predictedBallUncert;
+	const float farDist = predictedBallDist + predictedBallUncert;
+	if (nearDist < BALL_ROI_MIN_DIST) {
+		return;
+	}
+	const float spread = atan(predictedBallUncert / nearDist);
+
+	// project the corners of the region the ball could be in, both at the
+	// ground and at the top of the ball
+	const float dists[2] = {nearDist, farDist};
+	const float bearings[2] = {predictedBallBearing - spread,
+							   predictedBallBearing + spread};
+	const float heights[2] = {0.0f, 2.0f * BALL_RADIUS_CM};
+	int left = IMAGE_WIDTH, right = -1, top = IMAGE_HEIGHT, bottom = -1;
+	for (int d = 0; d < 2; d++) {
+		for (int b = 0; b < 2; b++) {
+			for (int h = 0; h < 2; h++) {
+				point <int> pix;
+				if (!pose->projectToImage(dists[d], bearings[b], heights[h],
+										  pix)) {
+					return;
+				}
+				left = min(left, pix.x);
+				right = max(right, pix.x);
+				top = min(top, pix.y);
+				bottom = max(bottom, pix.y);
+			}
+		}
+	}
+
+	ballRoiLeft = max(0, left - BALL_ROI_MARGIN);
+	ballRoiRight = min(IMAGE_WIDTH - 1, right + BALL_ROI_MARGIN);
+	ballRoiTop = max(0, top - BALL_ROI_MARGIN);
+	ballRoiBottom = min(IMAGE_HEIGHT - 1, bottom + BALL_ROI_MARGIN);
+
+	// off screen, or so big that we might as well scan everything
+	if (ballRoiLeft > ballRoiRight || ballRoiTop > ballRoiBottom ||
+		ballRoiRight - ballRoiLeft > IMAGE_WIDTH / 2) {
+		return;
+	}
+	ballRoiActive = true;
+#endif
+}
+
+/* The ball wasn't where we expected it, so throw out the orange runs and do
+ * a full density scan for it.  Columns that were walked anyway (for crosses)
+ * already had all of their orange runs kept, so they are handed over again
+ * in order rather than walked twice; only the columns that were skipped are
+ * walked now.
+ */
+void Threshold::rescanBalls() {
+	ballRoiActive = false;
+	orange->init(pose->getHorizonSlope());
+	vision->ball->init();
+#ifdef OFFLINE
+	ballRescanWalks = 0;
+#endif
+	for (int i = 0; i < IMAGE_WIDTH; i++) {
+		if (ballColumnWalked[i] && !ballRescanOverflow) {
+			for (int r = ballRescanStart[i]; r < ballRescanStart[i + 1]; r++) {
+				orange->newRun(ballRescanRuns[r].x, ballRescanRuns[r].y,
+							   ballRescanRuns[r].h);
+			}
+			continue;
+		}
+		const int topEdge = max(0, field->horizonAt(i));
+		if (needBallsCrosses(i, topEdge, true, false)) {
+			findBallsCrosses(i, topEdge, true, false);
+#ifdef OFFLINE
+			ballRescanWalks++;
+#endif
+		}
+	}
+#ifdef OFFLINE
+	if (debugBallRoi) {
+		cout << "Ball rescan walked " << ballRescanWalks << " columns and "
+			 << "reused " << (ballRescanOverflow ? 0 : numBallRescanRuns)
+			 << " runs" << endl;
+	}
+#endif
+}
+
+/* Keep an orange run found while tracking the ball for rescanBalls().
+ */
+void Threshold::keepBallRun(int x, int y, int h) {
+	if (numBallRescanRuns == BALL_RESCAN_RUNS) {
+		ballRescanOverflow = true;
+		return;
+	}
+	run &r = ballRescanRuns[numBallRescanRuns++];
+	r.x = x;
+	r.y = y;
+	r.h = h;
 }
 
 /** Ideally goals will be either right at the field edge, or will have part above
@@ -324,7 +610,8 @@ void Threshold::findGoals(int column, int topEdge) {
  * @param topEdge    the top of the field in that scanline
  */
 
-void Threshold::findBallsCrosses(int column, int topEdge) {
+void Threshold::findBallsCrosses(int column, int topEdge, bool balls,
+								 bool crosses) {
 	// scan down finding balls and crosses
 	unsigned char lastPixel = GREEN;
 	int currentRun = 0;
@@ -388,12 +675,17 @@ void Threshold::findBallsCrosses(int column, int topEdge) {
 					}
 				}
 				if (currentRun > 2) {
-					orange->newRun(column, j, currentRun);
+					if (balls) {
+						orange->newRun(column, j, currentRun);
+					}
+					if (ballRoiActive) {
+						keepBallRun(column, j, currentRun);
+					}
 				}
 				break;
 			case WHITE:
 				// add to the cross data structure
-				if (currentRun > 2) {
+				if (currentRun > 2 && crosses) {
 					cross->newRun(column, j, currentRun);
 				}
 				break;
@@ -656,10 +948,14 @@ void Threshold::objectRecognition() {
         vision->ygCrossbar->init();
     }
 
-    if (horizon < IMAGE_HEIGHT)
-        orange->createBall(horizon);
-    else
-		orange->createBall(pose->getHorizonY(0));
+    const int ballHorizon = horizon < IMAGE_HEIGHT ? horizon :
+		pose->getHorizonY(0);
+    orange->createBall(ballHorizon);
+    // if tracking didn't confirm the ball, look everywhere before giving up
+    if (ballRoiActive && vision->ball->getWidth() <= 0) {
+        rescanBalls();
+        orange->createBall(ballHorizon);
+    }
 
     if (ylp || yrp) {
         field->bestShot(vision->ygrp, vision->yglp, vision->ygCrossbar, YELLOW);
@@ -1000,18 +1296,16 @@ void Threshold::initColors() {
 	cross->init();
 }
 
-/* This function loads a table file with the given file name
- * into memory(the big Table array)
+/* This function maps a table file with the given file name
+ * into memory, to be used from the next frame on.
  * for example, filename can be "/MS/merged.mtb".
  * it means the merged.mtb file in the root directory of the Memory stick
  * @param filename      the file to load
  */
 void Threshold::initTable(std::string filename) {
 
-    FILE* fp;
-    //cout << filename << endl;
-    fp = fopen(filename.c_str(), "r");   //open table for reading
-    if (fp == NULL) {
+    ColorTable *next = ColorTable::load(filename);
+    if (next == NULL) {
         print("initTable() FAILED to open filename: %s", filename.c_str());
 #ifdef OFFLINE
         exit(0);
@@ -1019,98 +1313,61 @@ void Threshold::initTable(std::string filename) {
         return;
 #endif
     }
-
-    //actually read the table into memory
-    for(int i=0; i< UMAX; i++)
-        for(int j=0; j<VMAX; j++){
-            fread(bigTable[i][j], sizeof(unsigned char), YMAX, fp);
-        }
+    swapTable(next);
 
 #ifndef OFFLINE
     print("Loaded colortable %s",filename.c_str());
 #endif
-
-    fclose(fp);
 }
 
 
 void Threshold::initTableFromBuffer(byte * tbfr)
 {
-
-    byte* source = tbfr;
-    for(int i=0; i< UMAX; i++)
-        for(int j=0; j<VMAX; j++){
-            //pointer to beginning of row:
-            byte* dest = bigTable[i][j];
-            //copy over a whole row into big table from the buffer
-            memcpy(dest,source,UMAX);
-            source+=UMAX;//advance the source bugger
-        }
+    ColorTable *next = ColorTable::fromBuffer(tbfr);
+    if (next != NULL) {
+        swapTable(next);
+    }
 }
 
-/* This function loads a table file with the given file name
- * into memory(the big Table array)
+/* This function loads a compressed table file with the given file name
+ * into memory, to be used from the next frame on.
  * for example, filename can be "/MS/merged.mtb".
  * it means the merged.mtb file in the root directory of the Memory stick
  * @param filename      the file to load
  */
 void Threshold::initCompressedTable(std::string filename){
 #ifndef NO_ZLIB
-    FILE* fp;
-    //cout << filename << endl;
-    fp = fopen(filename.c_str(), "r");   //open table for reading
-    if (fp == NULL) {
-        printf("initTable() FAILED to open filename: %s , exiting",
-               filename.c_str());
-#ifdef OFFLINE
-        exit(0);
-#else
-        // crash
-        int x = 0;
-        x = 1/x;
-#endif
-    }
-
-    unsigned char *fileData = NULL;
-    int length;
-    fileData = Zlib::readCompressedFile(fp, length);
-    if(!fileData) {
-        //crash
-        print("something went wrong with decompression\n");
+    ColorTable *next = ColorTable::loadCompressed(filename);
+    if (next == NULL) {
+        print("initCompressedTable() FAILED to load filename: %s",
+              filename.c_str());
 #ifdef OFFLINE
         exit(0);
 #else
-        // crash
-        int x = 0;
-        x = 1/x;
+        return;
 #endif
     }
-    else
-        printf("everything went fine\n");
-
-
-    unsigned char *fileTraverse = fileData;
-
-
-    for(int i=0; i< UMAX; i++) {
-        //printf("vtoro");
-        for(int j=0; j<VMAX; j++){
-            //64 bytes per chunk
-            //fread(bigTable[i][j], sizeof(unsigned char), vMax, fp);
-            for(int k=0; k<YMAX; k++) {
-                bigTable[i][j][k] = *fileTraverse;
-                fileTraverse++;
-            }
-        }
-    }
+    swapTable(next);
 
     print("Loaded colortable %s",filename.c_str());
-    free(fileData);
-
-    fclose(fp);
 #endif /* NO_ZLIB */
 }
 
+/* Leaves a new table for the vision thread to pick up at the start of its
+ * next frame, which frees the table it replaces.  Safe to call from any
+ * thread; if two tables are swapped in before a frame the later one wins.
+ * @param next      the new table, which Threshold now owns
+ */
+void Threshold::swapTable(ColorTable *next) {
+#ifdef USE_COLOR_TABLE_PALETTE
+    next->buildPalette();
+#endif
+    // Everything written to the table happens before it is handed over
+    __sync_synchronize();
+    ColorTable *unused = __sync_lock_test_and_set(&pendingTable, next);
+    delete unused;
+}
+
 const uchar* Threshold::getYUV() {
     return yuv;
 }
@@ -1189,7 +1446,7 @@ void Threshold::initDebugImage(){
  * to the real image.
  */
 void Threshold::transposeDebugImage(){
-#if defined OFFLINE && defined DEBUG_IMAGE
+#ifdef OFFLINE
     for(int x = 0 ; x < IMAGE_WIDTH;x++)
         for(int y = 0; y < IMAGE_HEIGHT;y++)
             if(debugImage[y][x]!=GREY){
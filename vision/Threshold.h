@@ -14,31 +14,11 @@ class Threshold;  // forward reference
 #include "Field.h"
 #include "Cross.h"
 #include "Robots.h"
-#ifndef NO_ZLIB
-#include "Zlib.h"
-#endif
+#include "ColorCounts.h"
+#include "ClassPyramid.h"
+#include "ColorTable.h"
 #include "Profiler.h"
 #include "NaoPose.h"
-//
-// COLOR TABLE CONSTANTS
-// remember to change both values when chaning the color tables
-
-//these must be changed everytime we load a new table
-#ifdef SMALL_TABLES
-#define YSHIFT  3
-#define USHIFT  2
-#define VSHIFT  2
-#define YMAX  32
-#define UMAX  64
-#define VMAX  64
-#else
-#define YSHIFT  1
-#define USHIFT  1
-#define VSHIFT  1
-#define YMAX  128
-#define UMAX  128
-#define VMAX  128
-#endif
 
 //
 // THRESHOLDING CONSTANTS
@@ -57,6 +37,21 @@ static const int MIN_X_OPEN = 40;
 
 static const int VISUAL_HORIZON_COLOR = BROWN;
 
+// ball tracking constants
+// outside of the predicted ball region only every Nth column is run for orange
+static const int BALL_SPARSE_STEP = 4;
+// pixels of slack around the projected ball region
+static const int BALL_ROI_MARGIN = 8;
+// don't trust projections of predictions closer than this (cm)
+static const float BALL_ROI_MIN_DIST = 15.0f;
+static const float BALL_RADIUS_CM = 3.25f;
+static const int BALL_ROI_COLOR = PINK;
+// orange runs kept from a tracked frame in case the ball has to be rescanned
+static const int BALL_RESCAN_RUNS = IMAGE_WIDTH * 8;
+
+// pyramid level checked before scanning a column at full resolution
+static const int PYRAMID_SKIP_LEVEL = ClassPyramid::QUARTER;
+
 static const int UOFFSET=3;
 static const int VOFFSET=1;
 static const int YOFFSET1=0;
@@ -79,7 +74,7 @@ class Threshold
     friend class Vision;
 public:
     Threshold(Vision* vis, boost::shared_ptr<NaoPose> posPtr);
-    virtual ~Threshold() {}
+    virtual ~Threshold();
 
     // main methods
     void visionLoop();
@@ -87,7 +82,19 @@ public:
     inline void runs();
     void thresholdAndRuns();
 	void findGoals(int column, int top);
-	void findBallsCrosses(int column, int top);
+	void findBallsCrosses(int column, int top, bool balls = true,
+						  bool crosses = true);
+	void setBallPrediction(float dist, float bearing, float uncert);
+	void setCrossesWanted(bool wanted) { crossesWanted = wanted; }
+	void findBallRoi();
+	inline bool scanBallColumn(int column) {
+		return !ballRoiActive || column % BALL_SPARSE_STEP == 0 ||
+			(column >= ballRoiLeft && column <= ballRoiRight);
+	}
+	void rescanBalls();
+	void keepBallRun(int x, int y, int h);
+	bool needBallsCrosses(int column, int top, bool balls, bool crosses);
+	bool needGoals(int column);
 	void detectSelf();
 	void setBoundaryPoints(int x1, int y1, int x2, int y2, int x3, int y3);
     void objectRecognition();
@@ -97,6 +104,8 @@ public:
     void initTable(std::string filename);
     void initTableFromBuffer(byte* tbfr);
     void initCompressedTable(std::string filename);
+    // Hands over a new table, which vision starts using at its next frame
+    void swapTable(ColorTable *next);
 
     void storeFieldObjects();
     void setFieldObjectInfo(VisualFieldObject *objPtr);
@@ -128,6 +137,12 @@ public:
     void setConstant(int c);
     void setHorizonDebug(bool _bool) { visualHorizonDebug = _bool; }
     bool getHorizonDebug() { return visualHorizonDebug; }
+    void setBallRoiDebug(bool _bool) { debugBallRoi = _bool; }
+    bool getBallRoiDebug() { return debugBallRoi; }
+    void setComparePyramid(bool _bool) { debugComparePyramid = _bool; }
+    bool getComparePyramid() { return debugComparePyramid; }
+    void comparePyramidColumn(int column, int top, bool balls,
+                              bool scanBallsCrosses, bool scanGoals);
 #endif
 
     void initDebugImage();
@@ -173,6 +188,14 @@ public:
 	Cross* cross;
     // main array
     unsigned char thresholded[IMAGE_HEIGHT][IMAGE_WIDTH];
+#ifdef USE_COLOR_INTEGRALS
+    // color counts over thresholded, valid once threshold() is done
+    ColorCounts colorCounts;
+#endif
+#ifdef USE_CLASS_PYRAMID
+    // coarse color maps of thresholded, rebuilt after threshold()
+    ClassPyramid pyramid;
+#endif
 
 #ifdef OFFLINE
     //write lines, points, boxes to this array to avoid changing the real image
@@ -189,7 +212,11 @@ private:
     const uchar* yuv;
     const uchar* yplane, *uplane, *vplane;
 
-    unsigned char bigTable[UMAX][VMAX][YMAX];
+    // The table thresholding uses, only ever touched by the vision thread.
+    // New tables are left in pendingTable and taken up between frames, so
+    // a table can be swapped from another thread without tearing.
+    ColorTable *table;
+    ColorTable * volatile pendingTable;
 
     // open field variables
     int openField[IMAGE_WIDTH];
@@ -217,10 +244,32 @@ private:
     int previousRun;
     int newPixel;
 
+    // ball tracking variables
+    bool ballPredicted;
+    float predictedBallDist;
+    float predictedBallBearing;
+    float predictedBallUncert;
+    bool ballRoiActive;
+    int ballRoiLeft, ballRoiRight, ballRoiTop, ballRoiBottom;
+    // when no one will use a cross, columns only get walked for the ball
+    bool crossesWanted;
+    // every orange run of the columns walked while tracking, in scan order,
+    // so a miss only has to walk the columns that weren't
+    run ballRescanRuns[BALL_RESCAN_RUNS];
+    int numBallRescanRuns;
+    bool ballRescanOverflow;
+    int ballRescanStart[IMAGE_WIDTH + 1];
+    bool ballColumnWalked[IMAGE_WIDTH];
+
 #ifdef OFFLINE
     // Visual horizon debugging
     bool visualHorizonDebug;
 	bool debugSelf;
+    bool debugBallRoi;
+    int ballRescanWalks;
+    // rerun the scans the pyramid skips and report anything they find
+    bool debugComparePyramid;
+    int pyramidSkips, pyramidMisses;
 #endif
 };
 
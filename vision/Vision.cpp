@@ -133,6 +133,14 @@ void Vision::setImage(const byte *image) {
     thresh->setYUV(image);
 }
 
+void Vision::setBallPrediction(float dist, float bearing, float uncert) {
+    thresh->setBallPrediction(dist, bearing, uncert);
+}
+
+void Vision::setCrossesWanted(bool wanted) {
+    thresh->setCrossesWanted(wanted);
+}
+
 std::string Vision::getThreshColor(int _id) {
     switch (_id) {
     case WHITE: return "WHITE";
@@ -229,49 +237,13 @@ void Vision::drawCrossbar(VisualCrossbar* obj, int color) {
 }
 
 /* drawBox()
-   --helper method for drawing rectangles on the thresholded array
-   for AiboConnect visualization.
+   --helper method for drawing rectangles in the debug overlay for
+   visualization, so the thresholded array later passes read is untouched.
    --takes as input the left,right (x1,x2),bottom,top (y1,y2)
    --the rectangle drawn is a non-filled box.
 */
 void Vision::drawBox(int left, int right, int bottom, int top, int c) {
-    if (left < 0) {
-        left = 0;
-    }
-    if (top < 0) {
-        top = 0;
-    }
-    int width = right-left;
-    int height = bottom-top;
-
-    for (int i = left; i < left + width; i++) {
-        if (top >= 0 &&
-            top < IMAGE_HEIGHT &&
-            i >= 0 &&
-            i < IMAGE_WIDTH) {
-            thresh->thresholded[top][i] = static_cast<unsigned char>(c);
-        }
-        if ((top + height) >= 0 &&
-            (top + height) < IMAGE_HEIGHT &&
-            i >= 0 &&
-            i < IMAGE_WIDTH) {
-            thresh->thresholded[top + height][i] = static_cast<unsigned char>(c);
-        }
-    }
-    for (int i = top; i < top + height; i++) {
-        if (i >= 0 &&
-            i < IMAGE_HEIGHT &&
-            left >= 0 &&
-            left < IMAGE_WIDTH) {
-            thresh->thresholded[i][left] = static_cast<unsigned char>(c);
-        }
-        if (i >= 0 &&
-            i < IMAGE_HEIGHT &&
-            (left+width) >= 0 &&
-            (left+width) < IMAGE_WIDTH) {
-            thresh->thresholded[i][left + width] = static_cast<unsigned char>(c);
-        }
-    }
+    thresh->drawBox(left, right, bottom, top, c);
 } // drawBox
 
 
@@ -296,159 +268,22 @@ void Vision::drawCenters() {
 
 
 /* drawRect()
-   --helper method for drawing rectangles on the thresholded array
-   for AiboConnect visualization.
+   --helper method for drawing rectangles in the debug overlay for
+   visualization.
    --takes as input the getX,getY (top left x,y coords),
    the width and height of the object,
    and lastly the color of the rectangle you want to use.
    --the rectangle drawn is a non-filled box.
 */
 void Vision::drawRect(int left, int top, int width, int height, int c) {
-    if (left < 0) {
-        width += left;
-        left = 0;
-    }
-    if (top < 0) {
-        height += top;
-        top = 0;
-    }
-
-    for (int i = left; i < left + width; i++) {
-        if (top >= 0 && top < IMAGE_HEIGHT && i >= 0 && i < IMAGE_WIDTH) {
-            thresh->thresholded[top][i] = static_cast<unsigned char>(c);
-        }
-        if ((top + height) >= 0 &&
-            (top + height) < IMAGE_HEIGHT &&
-            i >= 0 &&
-            i < IMAGE_WIDTH) {
-            thresh->thresholded[top + height][i] = static_cast<unsigned char>(c);
-        }
-    }
-    for (int i = top; i < top + height; i++) {
-        if (i >= 0 &&
-            i < IMAGE_HEIGHT &&
-            left >= 0 &&
-            left < IMAGE_WIDTH) {
-            thresh->thresholded[i][left] = static_cast<unsigned char>(c);
-        }
-        if (i >= 0 &&
-            i < IMAGE_HEIGHT &&
-            (left+width) >= 0 &&
-            (left+width) < IMAGE_WIDTH) {
-            thresh->thresholded[i][left + width] = static_cast<unsigned char>(c);
-        }
-    }
-#if ROBOT(NAO)
-    left--;
-    width+=2;
-    height+=2;
-    top--;
-    if (left < 0) {
-        width += left;
-        left = 0;
-    }
-    if (top < 0) {
-        height += top;
-        top = 0;
-    }
-    for (int i = left; i < left + width; i++) {
-        if (top >= 0 && top < IMAGE_HEIGHT && i >= 0 && i < IMAGE_WIDTH) {
-            thresh->thresholded[top][i] = static_cast<unsigned char>(c);
-        }
-        if ((top + height) >= 0 &&
-            (top + height) < IMAGE_HEIGHT &&
-            i >= 0 &&
-            i < IMAGE_WIDTH) {
-            thresh->thresholded[top + height][i] = static_cast<unsigned char>(c);
-        }
-    }
-    for (int i = top; i < top + height; i++) {
-        if (i >= 0 &&
-            i < IMAGE_HEIGHT &&
-            left >= 0 &&
-            left < IMAGE_WIDTH) {
-            thresh->thresholded[i][left] = static_cast<unsigned char>(c);
-        }
-        if (i >= 0 &&
-            i < IMAGE_HEIGHT &&
-            (left+width) >= 0 &&
-            (left+width) < IMAGE_WIDTH) {
-            thresh->thresholded[i][left + width] = static_cast<unsigned char>(c);
-        }
-    }
-#endif
+    thresh->drawRect(left, top, width, height, c);
 } // drawRect
 
 /* drawLine()
    --helper visualization method for drawing a line given two points and a color
 */
 void Vision::drawLine(int x, int y, int x1, int y1, int c) {
-    float slope = (float)(y - y1) / (float)(x - x1);
-    int sign = 1;
-    if ((abs(y - y1)) > (abs(x - x1))) {
-        slope = 1.0f / slope;
-        if (y > y1) sign = -1;
-        for (int i = y; i != y1; i += sign) {
-            int newx = x + static_cast<int>(slope * static_cast<float>(i - y) );
-            if (newx >= 0 && newx < IMAGE_WIDTH && i >= 0 && i < IMAGE_HEIGHT)
-                thresh->thresholded[i][newx] = static_cast<unsigned char>(c);
-        }
-    } else if (slope != 0) {
-        //slope = 1.0 / slope;
-        if (x > x1) sign = -1;
-        for (int i = x; i != x1; i += sign) {
-            int newy = y + static_cast<int>(slope * static_cast<float>(i - x));
-            if (newy >= 0 && newy < IMAGE_HEIGHT && i >= 0 && i < IMAGE_WIDTH)
-                thresh->thresholded[newy][i] = static_cast<unsigned char>(c);
-        }
-    }
-    else if (slope == 0) {
-        int startX = min(x, x1);
-        int endX = max(x, x1);
-        for (int i = startX; i <= endX; i++) {
-            if (y >= 0 && y < IMAGE_HEIGHT && i >= 0 && i < IMAGE_WIDTH) {
-                thresh->thresholded[y][i] = static_cast<unsigned char>(c);
-            }
-        }
-    }
-/*
-    // This code is supposed to, I guess, make the line thicker since the Nao's
-    // image was 640x480 at some point and you couldn't see the drawing
-    // but it's not done well. if you look closely it looks like two blue
-    // lines are drawn next to each other but it's clearly not one solid line
-#if ROBOT(NAO)
-    y--;
-    y1--;
-    x--;
-    x1--;
-    if ((abs(y - y1)) > (abs(x - x1))) {
-        slope = 1.0 / slope;
-        if (y > y1) sign = -1;
-        for (int i = y; i != y1; i += sign) {
-            int newx = x + (int)(slope * (i - y));
-            if (newx >= 0 && newx < IMAGE_WIDTH && i >= 0 && i < IMAGE_HEIGHT)
-                thresh->thresholded[i][newx] = c;
-        }
-    } else if (slope != 0) {
-        //slope = 1.0 / slope;
-        if (x > x1) sign = -1;
-        for (int i = x; i != x1; i += sign) {
-            int newy = y + (int)(slope * (i - x));
-            if (newy >= 0 && newy < IMAGE_HEIGHT && i >= 0 && i < IMAGE_WIDTH)
-                thresh->thresholded[newy][i] = c;
-        }
-    }
-    else if (slope == 0) {
-        int startX = min(x, x1);
-        int endX = max(x, x1);
-        for (int i = startX; i <= endX; i++) {
-            if (y >= 0 && y < IMAGE_HEIGHT && i >= 0 && i < IMAGE_WIDTH) {
-                thresh->thresholded[y][i] = c;
-            }
-        }
-    }
-#endif
-*/
+    thresh->drawLine(x, y, x1, y1, c);
 }
 
 // Convenience method to draw a VisualLine to the screen.
@@ -460,25 +295,7 @@ void Vision::drawLine(boost::shared_ptr<VisualLine> line, const int color) {
    -draws a crosshair or a 'point' at some given x, y, and with a given color
 */
 void Vision::drawPoint(int x, int y, int c) {
-    if (y > 0 && x > 0 && y < (IMAGE_HEIGHT) && x < (IMAGE_WIDTH)) {
-        thresh->thresholded[y][x] = static_cast<unsigned char>(c);
-    }if (y+1 > 0 && x > 0 && y+1 < (IMAGE_HEIGHT) && x < (IMAGE_WIDTH)) {
-        thresh->thresholded[y+1][x] = static_cast<unsigned char>(c);
-    }if (y+2 > 0 && x > 0 && y+2 < (IMAGE_HEIGHT) && x < (IMAGE_WIDTH)) {
-        thresh->thresholded[y+2][x] = static_cast<unsigned char>(c);
-    }if (y-1 > 0 && x > 0 && y-1 < (IMAGE_HEIGHT) && x < (IMAGE_WIDTH)) {
-        thresh->thresholded[y-1][x] = static_cast<unsigned char>(c);
-    }if (y-2 > 0 && x > 0 && y-2 < (IMAGE_HEIGHT) && x < (IMAGE_WIDTH)) {
-        thresh->thresholded[y-2][x] = static_cast<unsigned char>(c);
-    }if (y > 0 && x+1 > 0 && y < (IMAGE_HEIGHT) && x+1 < (IMAGE_WIDTH)) {
-        thresh->thresholded[y][x+1] = static_cast<unsigned char>(c);
-    }if (y > 0 && x+2 > 0 && y < (IMAGE_HEIGHT) && x+2 < (IMAGE_WIDTH)) {
-        thresh->thresholded[y][x+2] = static_cast<unsigned char>(c);
-    }if (y > 0 && x-1 > 0 && y < (IMAGE_HEIGHT) && x-1 < (IMAGE_WIDTH)) {
-        thresh->thresholded[y][x-1] = static_cast<unsigned char>(c);
-    }if (y > 0 && x-2 > 0 && y < (IMAGE_HEIGHT) && x-2 < (IMAGE_WIDTH)) {
-        thresh->thresholded[y][x-2] = static_cast<unsigned char>(c);
-    }
+    thresh->drawPoint(x, y, c);
 }
 
 // Convenience method to draw linePoints
@@ -495,11 +312,7 @@ void Vision::drawPoint(const VisualCorner &c, const int color) {
    --given a color as well
 */
 void Vision::drawVerticalLine(int x, int c) {
-    if (x >= 0 && x < IMAGE_WIDTH) {
-        for (int i = 0; i < IMAGE_HEIGHT; i++) {
-            thresh->thresholded[i][x] = static_cast<unsigned char>(c);
-        }
-    }
+    thresh->drawLine(x, 0, x, IMAGE_HEIGHT, c);
 }
 
 /* drawHorizontalLine()
@@ -507,13 +320,9 @@ void Vision::drawVerticalLine(int x, int c) {
    --given a color as well
 */
 void Vision::drawHorizontalLine(int y, int c) {
-    if (y >= 0 && y < IMAGE_HEIGHT) {
-        for (int i = 0; i < IMAGE_WIDTH; i++) {
-            thresh->thresholded[y][i] = static_cast<unsigned char>(c);
-            if (y + 1 < IMAGE_HEIGHT - 1) {
-                thresh->thresholded[y+1][i] = static_cast<unsigned char>(c);
-            }
-        }
+    thresh->drawLine(0, y, IMAGE_WIDTH - 1, y, c);
+    if (y + 1 < IMAGE_HEIGHT - 1) {
+        thresh->drawLine(0, y + 1, IMAGE_WIDTH - 1, y + 1, c);
     }
 }
 
@@ -530,9 +339,11 @@ void Vision::drawCrossHairs(int x, int y, int c) {
    --use drawPoint() if you really want to see the point well.
 */
 void Vision::drawDot(int x, int y, int c) {
+#ifdef OFFLINE
     if (y > 0 && x > 0 && y < (IMAGE_HEIGHT) && x < (IMAGE_WIDTH)) {
-        thresh->thresholded[y][x] = static_cast<unsigned char>(c);
+        thresh->debugImage[y][x] = static_cast<unsigned char>(c);
     }
+#endif
 }
 
 void Vision::drawFieldLines() {
@@ -110,6 +110,10 @@ public:
     inline void setColorTablePath(std::string path) { colorTable = path; }
     inline void setPlayerNumber(int n) { player = n; }
     inline void setDogID(int _id) { id = _id; }
+    // where the ball should appear in the next image, see Threshold
+    void setBallPrediction(float dist, float bearing, float uncert);
+    // whether a field cross seen in the next image would be used
+    void setCrossesWanted(bool wanted);
     inline void setRobotName(std::string _name) { name = _name; }
 
     //
@@ -49,7 +49,7 @@ void VisualCross::init()
  *
  * @param b The blob to update our object from.
  */
-void VisualCross::updateCross(Blob *b)
+void VisualCross::updateCross(const Blob *b)
 {
     setLeftTopX(b->getLeftTopX());
     setLeftTopY(b->getLeftTopY());
@@ -52,7 +52,7 @@ public:
     void setRightBottomY(int _y){ rightBottom.y = _y; }
     void setDistanceWithSD(float _distance);
     void setBearingWithSD(float _bearing);
-    void updateCross(Blob *b);
+    void updateCross(const Blob *b);
     void setPossibleCrosses(const std::list <const ConcreteCross *> *
                             _possibleCrosses) {
         possibleCrosses = _possibleCrosses;
@@ -176,7 +176,7 @@ void VisualFieldObject::setIDCertainty(certainty _cert)
     }
 }
 
-void VisualFieldObject::updateObject(Blob * b, certainty _certainty,
+void VisualFieldObject::updateObject(const Blob * b, certainty _certainty,
                                      distanceCertainty _distCertainty)
 {
     // before we do this let's make sure that the object is really our color
@@ -44,7 +44,7 @@ public:
     // INITIALIZATION (happens every frame)
     void init();
     void printDebugInfo(FILE * out);
-    void updateObject(Blob* b, certainty _certainty,
+    void updateObject(const Blob* b, certainty _certainty,
                       distanceCertainty _distCertainty);
 
     // SETTERS
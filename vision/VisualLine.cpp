@@ -27,6 +27,19 @@ VisualLine::VisualLine(list<list<linePoint>::iterator> &nodes)
     init();
 }
 
+VisualLine::VisualLine(list<list<linePoint>::iterator> &nodes,
+                       const LeastSquaresSums &sums)
+    : VisualLandmark<lineID>(UNKNOWN_LINE),ccLine(false),
+      possibleLines(ConcreteLine::concreteLines().begin(),
+					ConcreteLine::concreteLines().end())
+{
+    for (list<list<linePoint>::iterator>::iterator i = nodes.begin();
+         i != nodes.end(); i++) {
+        points.push_back(**i);
+    }
+    init(sums.fit());
+}
+
 VisualLine::VisualLine() : VisualLandmark<lineID>(UNKNOWN_LINE),ccLine(false),
       possibleLines(ConcreteLine::concreteLines().begin(),
 					ConcreteLine::concreteLines().end())
@@ -108,6 +121,12 @@ void VisualLine::addPoints(const vector <linePoint> &additionalPoints)
 
 
 void VisualLine::init()
+{
+    init(leastSquaresFit(points));
+}
+
+// equation is the least squares fit (m, b) of points
+void VisualLine::init(const pair <float, float> &equation)
 {
     // Points are sorted by x
     left = points[0].x;
@@ -117,7 +136,6 @@ void VisualLine::init()
     top = min_element(points.begin(), points.end(), YOrder())->y;
     bottom = max_element(points.begin(), points.end(), YOrder())->y;
 
-    pair <float, float> equation = leastSquaresFit(points);
     a = equation.first;
     b = equation.second;
 
@@ -298,31 +316,16 @@ getLineComponents(const VisualLine &aLine)
 pair<float,float>
 VisualLine::leastSquaresFit(const vector<linePoint> &thePoints)
 {
-    // Use least squares to fit the line to the points
-    // from http://www.efunda.com/math/leastsquares/lstsqr1dcurve.cfm
-    // y = mx + b
-    // we need to find m and b
-    float numPoints = static_cast<float>(thePoints.size());
-    float ySum = 0.0;
-    float xSum = 0.0;
-    float xYSum = 0.0;
-    float xSquaredSum = 0.0;
-
+    LeastSquaresSums sums;
     for (vector <linePoint>::const_iterator i = thePoints.begin();
          i != thePoints.end(); i++) {
-        xSum += static_cast<float>(i->x);
-        ySum += static_cast<float>(i->y);
-        xYSum += static_cast<float>(i->x * i->y);
-        xSquaredSum += static_cast<float>(i->x * i->x);
+        sums.add(*i);
     }
-    /*
-      for (int i = 0; i < numPoints; i++) {
-      xSum += thePoints[i].x;
-      ySum += thePoints[i].y;
-      xYSum += thePoints[i].x * thePoints[i].y;
-      xSquaredSum += (thePoints[i].x * thePoints[i].x);
-      }*/
+    return sums.fit();
+}
 
+pair<float,float> LeastSquaresSums::fit() const
+{
     float b = ((ySum * xSquaredSum) - (xSum * xYSum)) /
 		((numPoints * xSquaredSum) - (xSum * xSum)) ;
 
@@ -70,6 +70,27 @@ struct linePoint {
         }
 };
 
+// Running sums for the least squares fit of y = mx + b, so that a line can
+// be fit as its points are found instead of summing them again at the end
+struct LeastSquaresSums {
+    LeastSquaresSums() : numPoints(0.0f), xSum(0.0f), ySum(0.0f),
+                         xYSum(0.0f), xSquaredSum(0.0f) { }
+
+    void add(const linePoint &p) {
+        numPoints += 1.0f;
+        xSum += static_cast<float>(p.x);
+        ySum += static_cast<float>(p.y);
+        xYSum += static_cast<float>(p.x * p.y);
+        xSquaredSum += static_cast<float>(p.x * p.x);
+    }
+
+    // returns a pair <m, b>
+    std::pair <float, float> fit() const;
+
+    float numPoints;
+    float xSum, ySum, xYSum, xSquaredSum;
+};
+
 class YOrder {
 public:
     const bool operator() (const linePoint& first, const linePoint& second) const;
@@ -86,6 +107,9 @@ public: // Constants
 
 public:
     VisualLine(std::list<std::list<linePoint>::iterator> &listOfIterators);
+    // sums already holds every point of listOfIterators
+    VisualLine(std::list<std::list<linePoint>::iterator> &listOfIterators,
+               const LeastSquaresSums &sums);
     VisualLine(std::list<linePoint> &listOfPoints);
     VisualLine();
 	VisualLine(float _dist, float _bearing);
@@ -135,6 +159,7 @@ public:
 
 private: // Member functions
     void init();
+    void init(const std::pair <float, float> &equation);
     void calculateWidths();
 
 	inline const float getLength();
@@ -28,7 +28,7 @@ void VisualRobot::init()
  *
  * @param b The blob to update our object from.
  */
-void VisualRobot::updateRobot(Blob b)
+void VisualRobot::updateRobot(const Blob& b)
 {
     setLeftTopX(b.getLeftTopX());
     setLeftTopY(b.getLeftTopY());
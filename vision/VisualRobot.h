@@ -54,7 +54,7 @@ public:
     void setRightBottomY(int _y){ rightBottom.y = _y; }
     void setDistanceWithSD(float _distance);
     void setBearingWithSD(float _bearing);
-    void updateRobot(Blob b);
+    void updateRobot(const Blob& b);
 
     // GETTERS
     const int getLeftTopX() const{ return leftTop.x; }
@@ -38,6 +38,42 @@ OPTION(
   ON
   )
 
+OPTION(
+  USE_COLOR_INTEGRALS
+  "Count blob colors with per frame summed area tables"
+  ON
+  )
+
+OPTION(
+  USE_BALL_ROI
+  "Concentrate ball detection where the ball filter predicts it"
+  ON
+  )
+
+OPTION(
+  USE_CLASS_PYRAMID
+  "Skip column scans that a coarse color map shows can't find anything"
+  ON
+  )
+
+OPTION(
+  USE_HORIZON_TRACKING
+  "Follow the green horizon from frame to frame instead of searching anew"
+  ON
+  )
+
+OPTION(
+  USE_LINE_TRACKING
+  "Follow field lines from frame to frame and only scan where they don't reach"
+  ON
+  )
+
+OPTION(
+  USE_COLOR_TABLE_PALETTE
+  "Threshold from a small two level copy of the color table"
+  OFF
+  )
+
 # Options pertaining to running the vision code OFFLINE
 OPTION( OFFLINE
     "Debug flag for vision when we are running offline"
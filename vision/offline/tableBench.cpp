@@ -0,0 +1,391 @@
+/**
+ * tableBench.cpp - compare the ways of holding a color table
+ *
+ * Loads a color table the old way, reading it in a row at a time, and by
+ * mapping it with ColorTable, and builds the two level palette from it.
+ * Checks that all three classify every (y, u, v) the same, then thresholds
+ * the given frames with the full table and with the palette, the way
+ * Threshold::threshold() does, and prints for each the time per frame,
+ * both with the table in cache and after the cache has been flushed as the
+ * rest of a vision frame would, and how much of the table a frame touches.
+ *
+ * Without a table or frames it makes up a table with a few colors and
+ * frames of a field, which are enough to time but not to judge a palette by.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "Common.h"
+#include "VisionDef.h"
+#include "ColorTable.h"
+
+using namespace std;
+
+static const int NUM_LOAD_RUNS = 20;
+static const int NUM_TIMING_RUNS = 20;
+static const int NUM_SYNTHETIC_FRAMES = 10;
+// Bigger than any cache the robot has
+static const int FLUSH_BYTES = 8 * 1024 * 1024;
+static const int CACHE_LINE = 64;
+
+// The same offsets Threshold uses into a pair of pixels
+static const int UOFFSET = 3;
+static const int VOFFSET = 1;
+static const int YOFFSET1 = 0;
+static const int YOFFSET2 = 2;
+
+typedef unsigned char Thresholded[IMAGE_HEIGHT * IMAGE_WIDTH];
+typedef vector<vector<unsigned char> > Frames;
+
+static unsigned int seed = 12345;
+static int noise(int range)
+{
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<int>((seed >> 16) % (2 * range + 1)) - range;
+}
+
+static int clamp(int x)
+{
+    return x < 0 ? 0 : (x > 255 ? 255 : x);
+}
+
+struct Blob {
+    int color;
+    int y, u, v;
+    int radius;
+};
+
+// Rough regions of YUV space for some of the colors
+static const Blob BLOBS[] = {
+    { GREEN, 110, 100, 100, 28 },
+    { WHITE, 210, 128, 128, 30 },
+    { ORANGE, 130, 90, 190, 30 },
+    { YELLOW, 170, 60, 150, 25 },
+    { BLUE, 80, 170, 100, 25 },
+};
+static const int NUM_BLOBS = sizeof(BLOBS) / sizeof(BLOBS[0]);
+
+static string makeTable()
+{
+    vector<unsigned char> uvy(ColorTable::BYTES, GREY);
+    for (int u = 0; u < UMAX; ++u) {
+        for (int v = 0; v < VMAX; ++v) {
+            for (int y = 0; y < YMAX; ++y) {
+                for (int b = 0; b < NUM_BLOBS; ++b) {
+                    const int dy = (y << YSHIFT) - BLOBS[b].y;
+                    const int du = (u << USHIFT) - BLOBS[b].u;
+                    const int dv = (v << VSHIFT) - BLOBS[b].v;
+                    const int r = BLOBS[b].radius;
+                    if (dy * dy / 4 + du * du + dv * dv < r * r) {
+                        uvy[(u * VMAX + v) * YMAX + y] = BLOBS[b].color;
+                    }
+                }
+            }
+        }
+    }
+
+    char name[] = "/tmp/tableBenchXXXXXX";
+    const int fd = mkstemp(name);
+    if (fd < 0 ||
+        write(fd, &uvy[0], uvy.size()) != static_cast<int>(uvy.size())) {
+        printf("could not write a table to %s\n", name);
+        exit(1);
+    }
+    close(fd);
+    return name;
+}
+
+static void setPixel(unsigned char *f, int x, int y, const Blob &b)
+{
+    unsigned char *pair = &f[y * IMAGE_ROW_OFFSET + (x & ~1) * 2];
+    pair[(x & 1) ? YOFFSET2 : YOFFSET1] = clamp(b.y + noise(12));
+    pair[UOFFSET] = clamp(b.u + noise(6));
+    pair[VOFFSET] = clamp(b.v + noise(6));
+}
+
+// Sky, a goal post, a field with a line across it and a ball
+static void makeFrame(unsigned char *f, int n)
+{
+    const Blob sky = { GREY, 150, 135, 120, 0 };
+    const int horizon = IMAGE_HEIGHT / 3 + n;
+    const int line = IMAGE_HEIGHT * 2 / 3 - n;
+    const int post = IMAGE_WIDTH / 4 + 3 * n;
+    const int ballX = IMAGE_WIDTH / 2 + 5 * n, ballY = IMAGE_HEIGHT * 3 / 4;
+    const int ballR = IMAGE_HEIGHT / 12;
+
+    for (int y = 0; y < IMAGE_HEIGHT; ++y) {
+        for (int x = 0; x < IMAGE_WIDTH; ++x) {
+            const int dx = x - ballX, dy = y - ballY;
+            const Blob *b = &sky;
+            if (dx * dx + dy * dy < ballR * ballR) {
+                b = &BLOBS[2];
+            } else if (x >= post && x < post + 12 && y < horizon + 10) {
+                b = &BLOBS[n % 2 ? 3 : 4];
+            } else if (y > line && y < line + 4) {
+                b = &BLOBS[1];
+            } else if (y > horizon) {
+                b = &BLOBS[0];
+            }
+            setPixel(f, x, y, *b);
+        }
+    }
+}
+
+static bool readFrame(const char *path, unsigned char *f)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return false;
+    }
+    const bool ok = fread(f, 1, IMAGE_BYTE_SIZE, fp) == IMAGE_BYTE_SIZE;
+    fclose(fp);
+    return ok;
+}
+
+// What Threshold::initTable used to do
+static bool readTable(const string &path,
+                      unsigned char (*bigTable)[VMAX][YMAX])
+{
+    FILE *fp = fopen(path.c_str(), "r");
+    if (fp == NULL) {
+        return false;
+    }
+    bool ok = true;
+    for (int i = 0; i < UMAX; i++) {
+        for (int j = 0; j < VMAX; j++) {
+            ok = ok && fread(bigTable[i][j], sizeof(unsigned char), YMAX,
+                             fp) == YMAX;
+        }
+    }
+    fclose(fp);
+    return ok;
+}
+
+static void thresholdFull(const ColorTable *t, const unsigned char *f,
+                          Thresholded out)
+{
+    const unsigned char *yPtr = f;
+    unsigned char *tPtr = out;
+    unsigned char *tEnd = out + IMAGE_HEIGHT * IMAGE_WIDTH;
+    while (tPtr < tEnd) {
+        const unsigned char *p = t->row(yPtr[UOFFSET] >> 1,
+                                        yPtr[VOFFSET] >> 1);
+        *tPtr++ = p[yPtr[YOFFSET1] >> 1];
+        *tPtr++ = p[yPtr[YOFFSET2] >> 1];
+        yPtr += 4;
+    }
+}
+
+static void thresholdPalette(const ColorTable *t, const unsigned char *f,
+                             Thresholded out)
+{
+    const unsigned char *yPtr = f;
+    unsigned char *tPtr = out;
+    unsigned char *tEnd = out + IMAGE_HEIGHT * IMAGE_WIDTH;
+    while (tPtr < tEnd) {
+        const int u = yPtr[UOFFSET] >> 1;
+        const int v = yPtr[VOFFSET] >> 1;
+        *tPtr++ = t->paletteLookup(yPtr[YOFFSET1] >> 1, u, v);
+        *tPtr++ = t->paletteLookup(yPtr[YOFFSET2] >> 1, u, v);
+        yPtr += 4;
+    }
+}
+
+/**
+ * Cache lines of the table a frame's lookups land in
+ */
+static unsigned int linesTouched(const ColorTable *t, const unsigned char *f)
+{
+    set<size_t> lines;
+    for (int i = 0; i < IMAGE_BYTE_SIZE; i += 4) {
+        const int u = f[i + UOFFSET] >> 1, v = f[i + VOFFSET] >> 1;
+        const int ys[] = { f[i + YOFFSET1] >> 1, f[i + YOFFSET2] >> 1 };
+        for (int k = 0; k < 2; ++k) {
+            if (t->hasPalette()) {
+                lines.insert(reinterpret_cast<size_t>(
+                                 t->indexEntry(ys[k], u, v)) / CACHE_LINE);
+                lines.insert(reinterpret_cast<size_t>(
+                                 t->paletteEntry(ys[k], u, v)) / CACHE_LINE);
+            } else {
+                lines.insert(reinterpret_cast<size_t>(
+                                 t->row(u, v) + ys[k]) / CACHE_LINE);
+            }
+        }
+    }
+    return lines.size();
+}
+
+static void flushCache(vector<unsigned char> &junk)
+{
+    for (size_t i = 0; i < junk.size(); i += CACHE_LINE) {
+        junk[i]++;
+    }
+}
+
+// Microseconds per frame to threshold all the frames with t
+static float timeFrames(const ColorTable *t, const Frames &frames,
+                        bool flush, unsigned int &sink)
+{
+    vector<unsigned char> junk(flush ? FLUSH_BYTES : 0);
+    static Thresholded out;
+    long long total = 0;
+    for (int run = 0; run < NUM_TIMING_RUNS; ++run) {
+        for (unsigned int f = 0; f < frames.size(); ++f) {
+            if (flush) {
+                flushCache(junk);
+            }
+            const long long begin = micro_time();
+            if (t->hasPalette()) {
+                thresholdPalette(t, &frames[f][0], out);
+            } else {
+                thresholdFull(t, &frames[f][0], out);
+            }
+            total += micro_time() - begin;
+            sink += out[f];
+        }
+    }
+    return static_cast<float>(total) /
+        static_cast<float>(NUM_TIMING_RUNS * frames.size());
+}
+
+static int checkTables(const string &path, const ColorTable *mapped,
+                       const ColorTable *palette)
+{
+    static unsigned char bigTable[UMAX][VMAX][YMAX];
+    if (!readTable(path, bigTable)) {
+        printf("could not read %s\n", path.c_str());
+        return 1;
+    }
+    int differences = 0;
+    for (int u = 0; u < UMAX; ++u) {
+        for (int v = 0; v < VMAX; ++v) {
+            for (int y = 0; y < YMAX; ++y) {
+                differences += (mapped->lookup(y, u, v) != bigTable[u][v][y] ||
+                                palette->lookup(y, u, v) != bigTable[u][v][y]);
+            }
+        }
+    }
+    if (differences > 0) {
+        printf("%d entries differ from the table as read\n", differences);
+        return 1;
+    }
+    printf("mapped table and palette agree with the table as read\n");
+    return 0;
+}
+
+static void timeLoads(const string &path)
+{
+    static unsigned char bigTable[UMAX][VMAX][YMAX];
+    long long begin = micro_time();
+    for (int run = 0; run < NUM_LOAD_RUNS; ++run) {
+        readTable(path, bigTable);
+    }
+    const long long read = micro_time() - begin;
+
+    begin = micro_time();
+    for (int run = 0; run < NUM_LOAD_RUNS; ++run) {
+        delete ColorTable::load(path);
+    }
+    const long long mapped = micro_time() - begin;
+
+    ColorTable *t = ColorTable::load(path);
+    begin = micro_time();
+    t->buildPalette();
+    const long long palette = micro_time() - begin;
+    delete t;
+
+    printf("\nloading the table:\n");
+    printf("  read a row at a time %8.1fus\n",
+           static_cast<float>(read) / NUM_LOAD_RUNS);
+    printf("  mapped               %8.1fus\n",
+           static_cast<float>(mapped) / NUM_LOAD_RUNS);
+    printf("  building the palette %8.1fus\n", static_cast<float>(palette));
+}
+
+int main(int argc, char *argv[])
+{
+    const bool synthetic = argc < 2;
+    const string path = synthetic ? makeTable() : string(argv[1]);
+
+    ColorTable *full = ColorTable::load(path);
+    ColorTable *palette = ColorTable::load(path);
+    if (full == NULL || palette == NULL) {
+        printf("could not map %s\n", path.c_str());
+        return 1;
+    }
+    palette->buildPalette();
+    printf("table %s: %d of %d blocks distinct, palette %.1fKB, "
+           "full table %.1fKB\n", path.c_str(), palette->getNumBlocks(),
+           ColorTable::INDEX_SIZE, palette->getFootprint() / 1024.0f,
+           full->getFootprint() / 1024.0f);
+
+    int failures = checkTables(path, full, palette);
+
+    Frames frames;
+    vector<unsigned char> frame(IMAGE_BYTE_SIZE);
+    for (int i = 2; i < argc; ++i) {
+        if (!readFrame(argv[i], &frame[0])) {
+            printf("could not read a frame from %s\n", argv[i]);
+            continue;
+        }
+        frames.push_back(frame);
+    }
+    if (argc <= 2) {
+        for (int i = 0; i < NUM_SYNTHETIC_FRAMES; ++i) {
+            makeFrame(&frame[0], i);
+            frames.push_back(frame);
+        }
+    }
+
+    static Thresholded a, b;
+    float fullLines = 0.0f, paletteLines = 0.0f;
+    int mismatches = 0;
+    for (unsigned int f = 0; f < frames.size(); ++f) {
+        thresholdFull(full, &frames[f][0], a);
+        thresholdPalette(palette, &frames[f][0], b);
+        mismatches += memcmp(a, b, sizeof(a)) != 0;
+        fullLines += linesTouched(full, &frames[f][0]);
+        paletteLines += linesTouched(palette, &frames[f][0]);
+    }
+    if (mismatches > 0) {
+        printf("%d frames threshold differently\n", mismatches);
+        failures++;
+    }
+
+    unsigned int sink = 0;
+    const float n = static_cast<float>(frames.size());
+    printf("\n%d %s frames, per frame:\n", static_cast<int>(frames.size()),
+           argc > 2 ? "recorded" : "made up");
+    printf("                  in cache   flushed   table touched\n");
+    printf("  full table     %8.1fus %8.1fus %8.1fKB\n",
+           timeFrames(full, frames, false, sink),
+           timeFrames(full, frames, true, sink),
+           fullLines / n * CACHE_LINE / 1024.0f);
+    printf("  palette        %8.1fus %8.1fus %8.1fKB\n",
+           timeFrames(palette, frames, false, sink),
+           timeFrames(palette, frames, true, sink),
+           paletteLines / n * CACHE_LINE / 1024.0f);
+
+    timeLoads(path);
+    if (sink == 12345) {
+        printf("\n");
+    }
+
+    delete full;
+    delete palette;
+    if (synthetic) {
+        unlink(path.c_str());
+    }
+
+    if (failures > 0) {
+        printf("\n%d FAILURES\n", failures);
+        return 1;
+    }
+    printf("\nall ok\n");
+    return 0;
+}